@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+
+"""
+Decompress a compressed ulog file (.ulgz, written with SDLOG_COMPRESS=1) into a
+regular .ulg file. The file format is documented in src/modules/logger/messages.h
+(ulog_compressed_file_header_s). No dependencies besides python3.
+"""
+
+import argparse
+import struct
+import sys
+
+FILE_MAGIC = b'ULogLZ4'
+BLOCK_SYNC = bytes([0xB7, ord('L'), ord('Z'), 0x4B])
+BLOCK_STORED = 1 << 31
+FILE_HEADER_LEN = 12
+BLOCK_HEADER_LEN = 16
+
+
+def fnv1a(data):
+    h = 0x811c9dc5
+    for b in data:
+        h = ((h ^ b) * 0x1000193) & 0xffffffff
+    return h
+
+
+def lz4_decompress_block(src, max_size):
+    out = bytearray()
+    i = 0
+    while i < len(src):
+        token = src[i]
+        i += 1
+        length = token >> 4
+        if length == 15:
+            while True:
+                s = src[i]
+                i += 1
+                length += s
+                if s != 255:
+                    break
+        out += src[i:i + length]
+        i += length
+        if i >= len(src):
+            break
+        offset = src[i] | (src[i + 1] << 8)
+        i += 2
+        if offset == 0 or offset > len(out):
+            raise ValueError('invalid match offset')
+        length = token & 15
+        if length == 15:
+            while True:
+                s = src[i]
+                i += 1
+                length += s
+                if s != 255:
+                    break
+        length += 4
+        start = len(out) - offset
+        for k in range(length):
+            out.append(out[start + k])
+        if len(out) > max_size:
+            raise ValueError('block too large')
+    return bytes(out)
+
+
+def decompress(data, out):
+    if len(data) < FILE_HEADER_LEN or data[0:7] != FILE_MAGIC or data[7] != 1:
+        raise ValueError('not a compressed ulog file')
+    max_block_size, = struct.unpack_from('<I', data, 8)
+    pos = FILE_HEADER_LEN
+    num_blocks = 0
+    num_corrupt = 0
+    while pos + BLOCK_HEADER_LEN <= len(data):
+        sync = data[pos:pos + 4]
+        data_size, payload_size, checksum = struct.unpack_from('<III', data, pos + 4)
+        stored = (data_size & BLOCK_STORED) != 0
+        data_size &= ~BLOCK_STORED
+        payload_start = pos + BLOCK_HEADER_LEN
+        payload = data[payload_start:payload_start + payload_size]
+        decoded = None
+        if sync == BLOCK_SYNC and data_size <= max_block_size and len(payload) == payload_size \
+                and fnv1a(payload) == checksum:
+            try:
+                decoded = payload if stored else lz4_decompress_block(payload, data_size)
+            except (ValueError, IndexError):
+                decoded = None
+        if decoded is not None and len(decoded) == data_size:
+            out.write(decoded)
+            num_blocks += 1
+            pos = payload_start + payload_size
+            continue
+        if sync == BLOCK_SYNC and len(payload) < payload_size:
+            print('File is truncated, decoded up to the last complete block')
+            break
+        # corrupt block: continue at the next sync marker
+        num_corrupt += 1
+        pos = data.find(BLOCK_SYNC, pos + 1)
+        if pos < 0:
+            break
+    print('Decompressed {:} blocks, skipped {:} corrupt blocks'.format(num_blocks, num_corrupt))
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser(description="""CLI tool to decompress an ulog file\n""")
+    parser.add_argument("ulog_file", help=".ulgz compressed ulog file")
+    parser.add_argument("-o", "--output", help="output file (default: input file name without the trailing z)",
+                        default=None)
+
+    args = parser.parse_args()
+
+    output = args.output
+    if output is None:
+        output = args.ulog_file[:-1] if args.ulog_file.endswith('z') else args.ulog_file + '.ulg'
+
+    with open(args.ulog_file, 'rb') as f:
+        data = f.read()
+
+    try:
+        with open(output, 'wb') as out:
+            decompress(data, out)
+    except ValueError as e:
+        print(e)
+        sys.exit(1)
@@ -0,0 +1,322 @@
+#! /usr/bin/env python3
+"""
+Runs the EKF2 replay on all .ulg files in the supplied directory, in parallel on all cores.
+
+Every log is replayed by its own px4 instance (px4 -i <instance>) in its own working directory
+<output>/<log name>/, using the replay_params.txt parameter override file given with --params (see
+Replay::setUserParams). No simulator or network is required: the replay module drives the lockstep time.
+
+Outputs per log, in <output>/<log name>/:
+ - <log name>_replayed.ulg: the log written during replay (estimator topics)
+ - innovations.csv: innovation statistics of the replayed log
+ - out.log: px4 console output
+Outputs <output>/summary.csv with the innovation statistics aggregated over all logs.
+"""
+
+import argparse
+import csv
+import glob
+import multiprocessing
+import os
+import shutil
+import subprocess
+import sys
+import time
+from concurrent.futures import ProcessPoolExecutor, as_completed
+from typing import Dict, List, Optional, Tuple
+
+import numpy as np
+from pyulog import ULog
+
+INNOVATION_TOPIC = 'estimator_innovations'
+TEST_RATIO_TOPIC = 'estimator_innovation_test_ratios'
+STATS_FIELDS = ['samples', 'mean', 'rms', 'max_abs', 'test_ratio_mean', 'test_ratio_max', 'rejected_pct']
+
+_instance = None
+
+
+def get_arguments():
+    parser = argparse.ArgumentParser(description='Replay the ulog files in a directory with EKF2 replay, in parallel')
+    parser.add_argument('directory_path', help='directory with the .ulg files (searched recursively)')
+    parser.add_argument('-p', '--params', type=str, default=None,
+                        help='parameter override file, used as replay_params.txt for every log. If not given, '
+                             'the EKF2 parameters of each log are used.')
+    parser.add_argument('-o', '--output', type=str, default='replay_results',
+                        help='output directory (default: %(default)s)')
+    parser.add_argument('-j', '--jobs', type=int, default=multiprocessing.cpu_count(),
+                        help='number of logs replayed in parallel (default: number of cores)')
+    parser.add_argument('-b', '--build-dir', type=str, default=None,
+                        help='px4 build directory (default: build/px4_sitl_replay)')
+    parser.add_argument('--instance-offset', type=int, default=100,
+                        help='first px4 instance id to use, to not interfere with other instances '
+                             '(default: %(default)s)')
+    parser.add_argument('--timeout', type=float, default=3600,
+                        help='maximum replay duration per log in seconds (default: %(default)s)')
+    return parser.parse_args()
+
+
+def find_logs(directory: str, output_dir: str) -> List[str]:
+    """
+    finds the logs to replay, skipping logs in the output directory and decompressed copies
+    :param directory:
+    :param output_dir:
+    :return: list of log files
+    """
+    output_dir = os.path.realpath(output_dir)
+    logs = []
+
+    for pattern in ('**/*.ulg', '**/*.ulgz'):
+        for log in glob.glob(os.path.join(directory, pattern), recursive=True):
+            if os.path.realpath(log).startswith(output_dir + os.sep) or log.endswith('_decompressed.ulg'):
+                continue
+            logs.append(log)
+
+    return sorted(logs)
+
+
+def log_name(log: str, directory: str) -> str:
+    """
+    :return: a unique name for a log, derived from the path relative to the input directory
+    """
+    relative_path = os.path.relpath(log, directory)
+    return os.path.splitext(relative_path)[0].replace(os.sep, '_')
+
+
+def init_worker(instance_counter, instance_offset: int) -> None:
+    """
+    assigns a px4 instance id to each worker process. A worker replays one log at a time, so its instances
+    never run concurrently.
+    """
+    global _instance
+    with instance_counter.get_lock():
+        _instance = instance_offset + instance_counter.value
+        instance_counter.value += 1
+
+
+def run_replay(log: str, working_dir: str, build_dir: str, params_file: Optional[str], timeout: float) -> str:
+    """
+    replays a log with a px4 instance in working_dir
+    :return: the log written during replay
+    """
+    if os.path.exists(working_dir):
+        shutil.rmtree(working_dir)
+
+    os.makedirs(working_dir)
+
+    if params_file is not None:
+        shutil.copy(params_file, os.path.join(working_dir, 'replay_params.txt'))
+
+    env = os.environ.copy()
+    env['replay'] = os.path.realpath(log)
+    env['replay_mode'] = 'ekf2'
+    env.pop('PX4_SIM_MODEL', None)
+    env['PATH'] = os.path.join(build_dir, 'bin') + os.pathsep + env.get('PATH', '')
+
+    command = [os.path.join(build_dir, 'bin', 'px4'), '-i', str(_instance), '-d',
+               os.path.join(build_dir, 'etc'), '-s', 'etc/init.d-posix/rcS']
+
+    with open(os.path.join(working_dir, 'out.log'), 'w') as out:
+        try:
+            subprocess.run(command, cwd=working_dir, env=env, stdout=out, stderr=subprocess.STDOUT,
+                           stdin=subprocess.DEVNULL, timeout=timeout, check=False)
+        except subprocess.TimeoutExpired:
+            raise RuntimeError('replay timed out after {:.0f} s'.format(timeout))
+
+    replayed_logs = glob.glob(os.path.join(working_dir, 'log', '**', '*.ulg'), recursive=True)
+
+    if not replayed_logs:
+        raise RuntimeError('no log written, see {:s}'.format(os.path.join(working_dir, 'out.log')))
+
+    return max(replayed_logs, key=os.path.getmtime)
+
+
+def innovation_statistics(ulog_file: str) -> Dict[str, Dict[str, float]]:
+    """
+    computes statistics of the innovations of the first estimator instance. Samples where an innovation is 0 are
+    considered inactive (the corresponding measurement is not fused) and skipped.
+    :param ulog_file:
+    :return: statistics per innovation field
+    """
+    ulog = ULog(ulog_file, [INNOVATION_TOPIC, TEST_RATIO_TOPIC])
+
+    try:
+        innovations = ulog.get_dataset(INNOVATION_TOPIC, 0).data
+    except (KeyError, IndexError, ValueError):
+        raise RuntimeError('{:s} not found in {:s}'.format(INNOVATION_TOPIC, ulog_file))
+
+    try:
+        test_ratios = ulog.get_dataset(TEST_RATIO_TOPIC, 0).data
+    except (KeyError, IndexError, ValueError):
+        test_ratios = {}
+
+    statistics = {}
+
+    for field, values in innovations.items():
+        if field.startswith('timestamp'):
+            continue
+
+        active = np.isfinite(values) & (values != 0)
+        values = values[active].astype(np.float64)
+
+        if values.size == 0:
+            continue
+
+        stats = {'samples': values.size, 'mean': np.mean(values), 'rms': np.sqrt(np.mean(values ** 2)),
+                 'max_abs': np.max(np.abs(values)), 'test_ratio_mean': float('nan'),
+                 'test_ratio_max': float('nan'), 'rejected_pct': float('nan')}
+
+        # the test ratio of a vector innovation is stored in the first component
+        ratio_field = field.replace('[1]', '[0]').replace('[2]', '[0]')
+        ratios = test_ratios.get(ratio_field)
+
+        if ratios is not None and ratios.size == active.size:
+            ratios = ratios[active]
+            ratios = ratios[np.isfinite(ratios)].astype(np.float64)
+
+            if ratios.size > 0:
+                stats['test_ratio_mean'] = np.mean(ratios)
+                stats['test_ratio_max'] = np.max(ratios)
+                stats['rejected_pct'] = 100. * np.count_nonzero(ratios > 1.) / ratios.size
+
+        statistics[field] = stats
+
+    return statistics
+
+
+def write_statistics(filename: str, statistics: Dict[str, Dict[str, float]], extra_fields: List[str] = ()) -> None:
+    """
+    writes statistics to a csv file, one row per innovation field
+    """
+    extra_fields = list(extra_fields)
+
+    with open(filename, 'w', newline='') as file:
+        writer = csv.writer(file)
+        writer.writerow(['innovation'] + extra_fields + STATS_FIELDS)
+
+        for field, stats in sorted(statistics.items()):
+            writer.writerow([field] + [stats[key] for key in extra_fields + STATS_FIELDS])
+
+
+def process_log(log: str, name: str, output_dir: str, build_dir: str, params_file: Optional[str],
+                timeout: float) -> Tuple[str, Dict[str, Dict[str, float]], float]:
+    """
+    replays a log and analyses the innovations (runs in a worker process)
+    :return: log name, innovation statistics and replay duration
+    """
+    working_dir = os.path.join(output_dir, name)
+    start = time.monotonic()
+    replayed_log = run_replay(log, working_dir, build_dir, params_file, timeout)
+    duration = time.monotonic() - start
+
+    result_file = os.path.join(working_dir, name + '_replayed.ulg')
+    os.replace(replayed_log, result_file)
+
+    statistics = innovation_statistics(result_file)
+    write_statistics(os.path.join(working_dir, 'innovations.csv'), statistics)
+
+    return name, statistics, duration
+
+
+def aggregate_statistics(results: Dict[str, Dict[str, Dict[str, float]]]) -> Dict[str, Dict[str, float]]:
+    """
+    combines the statistics of all logs, weighted by the number of samples per log
+    :param results: statistics per log
+    :return: statistics per innovation field
+    """
+    summary = {}
+    fields = sorted({field for statistics in results.values() for field in statistics})
+
+    for field in fields:
+        per_log = [statistics[field] for statistics in results.values() if field in statistics]
+        samples = np.array([stats['samples'] for stats in per_log], dtype=np.float64)
+        values = {key: np.array([stats[key] for stats in per_log], dtype=np.float64) for key in STATS_FIELDS}
+
+        def weighted_mean(x: np.ndarray) -> float:
+            valid = np.isfinite(x)
+            return np.sum(x[valid] * samples[valid]) / np.sum(samples[valid]) if np.any(valid) else float('nan')
+
+        def nanmax(x: np.ndarray) -> float:
+            return np.nanmax(x) if np.any(np.isfinite(x)) else float('nan')
+
+        summary[field] = {
+            'logs': len(per_log),
+            'samples': int(np.sum(samples)),
+            'mean': weighted_mean(values['mean']),
+            'rms': np.sqrt(weighted_mean(values['rms'] ** 2)),
+            'max_abs': nanmax(values['max_abs']),
+            'test_ratio_mean': weighted_mean(values['test_ratio_mean']),
+            'test_ratio_max': nanmax(values['test_ratio_max']),
+            'rejected_pct': weighted_mean(values['rejected_pct']),
+        }
+
+    return summary
+
+
+def main() -> None:
+
+    args = get_arguments()
+
+    file_dir = os.path.realpath(os.path.dirname(__file__))
+    build_dir = os.path.realpath(args.build_dir if args.build_dir is not None else
+                                 os.path.join(file_dir, '..', '..', 'build', 'px4_sitl_replay'))
+
+    if not os.path.isfile(os.path.join(build_dir, 'bin', 'px4')):
+        print('px4 binary not found in {:s}, build it with \'make px4_sitl_replay\''.format(build_dir))
+        sys.exit(1)
+
+    params_file = os.path.realpath(args.params) if args.params is not None else None
+
+    if params_file is not None and not os.path.isfile(params_file):
+        print('parameter file {:s} not found'.format(params_file))
+        sys.exit(1)
+
+    output_dir = os.path.realpath(args.output)
+    os.makedirs(output_dir, exist_ok=True)
+
+    logs = find_logs(args.directory_path, output_dir)
+    print("found {:d} log files in {:s}, replaying with {:d} jobs".format(len(logs), args.directory_path, args.jobs))
+
+    results = {}
+    failed = []
+    start = time.monotonic()
+    instance_counter = multiprocessing.Value('i', 0)
+
+    with ProcessPoolExecutor(max_workers=args.jobs, initializer=init_worker,
+                             initargs=(instance_counter, args.instance_offset)) as executor:
+        futures = {executor.submit(process_log, log, log_name(log, args.directory_path), output_dir, build_dir,
+                                   params_file, args.timeout): log for log in logs}
+
+        for future in as_completed(futures):
+            log = futures[future]
+            try:
+                name, statistics, duration = future.result()
+                results[name] = statistics
+                print('[{:d}/{:d}] {:s}: replayed in {:.1f} s'.format(
+                    len(results) + len(failed), len(logs), log, duration))
+            except Exception as e:
+                failed.append(log)
+                print('[{:d}/{:d}] {:s}: failed: {}'.format(len(results) + len(failed), len(logs), log, e))
+
+    summary = aggregate_statistics(results)
+    write_statistics(os.path.join(output_dir, 'summary.csv'), summary, ['logs'])
+
+    print('')
+    print('{:d} logs replayed, {:d} failed, {:.1f} s'.format(len(results), len(failed), time.monotonic() - start))
+    print('')
+    print('{:<22s} {:>5s} {:>9s} {:>12s} {:>12s} {:>10s} {:>10s}'.format(
+        'innovation', 'logs', 'samples', 'rms', 'max abs', 'ratio mean', 'rejected'))
+
+    for field, stats in sorted(summary.items()):
+        print('{:<22s} {:>5d} {:>9d} {:>12.4g} {:>12.4g} {:>10.3f} {:>9.2f}%'.format(
+            field, stats['logs'], stats['samples'], stats['rms'], stats['max_abs'], stats['test_ratio_mean'],
+            stats['rejected_pct']))
+
+    print('')
+    print('results written to {:s}'.format(output_dir))
+
+    if failed:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -43,6 +43,10 @@ class AtomicBitset
 {
 public:
 
+	static constexpr uint8_t BITS_PER_ELEMENT = 32;
+	static constexpr size_t ARRAY_SIZE = ((N % BITS_PER_ELEMENT) == 0) ? (N / BITS_PER_ELEMENT) :
+					     (N / BITS_PER_ELEMENT + 1);
+
 	AtomicBitset() = default;
 
 	size_t count() const
@@ -50,12 +54,7 @@ public:
 		size_t total = 0;
 
 		for (const auto &x : _data) {
-			uint32_t y = x.load();
-
-			while (y) {
-				total += y & 1;
-				y >>= 1;
-			}
+			total += __builtin_popcount(x.load());
 		}
 
 		return total;
@@ -80,6 +79,16 @@ public:
 		}
 	}
 
+	// set a bit and return its previous value
+	bool test_and_set(size_t pos)
+	{
+		const uint32_t bitmask = element_mask(pos);
+		return _data[array_index(pos)].fetch_or(bitmask) & bitmask;
+	}
+
+	// the BITS_PER_ELEMENT bits starting at position index * BITS_PER_ELEMENT
+	uint32_t element(size_t index) const { return _data[index].load(); }
+
 	void reset()
 	{
 		// set bits to false
@@ -89,9 +98,6 @@ public:
 	}
 
 private:
-	static constexpr uint8_t BITS_PER_ELEMENT = 32;
-	static constexpr size_t ARRAY_SIZE = ((N % BITS_PER_ELEMENT) == 0) ? (N / BITS_PER_ELEMENT) :
-					     (N / BITS_PER_ELEMENT + 1);
 	static constexpr size_t ALLOCATED_BITS = ARRAY_SIZE * BITS_PER_ELEMENT;
 
 	size_t array_index(size_t position) const { return position / BITS_PER_ELEMENT; }
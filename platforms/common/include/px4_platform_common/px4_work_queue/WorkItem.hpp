@@ -109,6 +109,7 @@ protected:
 	}
 
 	friend void WorkQueue::Run();
+	friend class WorkerPool;
 	virtual void Run() = 0;
 
 	/**
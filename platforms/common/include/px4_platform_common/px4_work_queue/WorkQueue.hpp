@@ -36,6 +36,7 @@
 #include "WorkQueueManager.hpp"
 
 #include <containers/BlockingList.hpp>
+#include <drivers/drv_hrt.h>
 #include <containers/List.hpp>
 #include <containers/IntrusiveQueue.hpp>
 #include <px4_platform_common/atomic.h>
@@ -47,6 +48,7 @@ namespace px4
 {
 
 class WorkItem;
+class WorkerPool;
 
 class WorkQueue : public IntrusiveSortedListNode<WorkQueue *>
 {
@@ -73,6 +75,30 @@ public:
 
 	void print_status(bool last = false);
 
+#if defined(PX4_WORK_QUEUE_POOL)
+	/**
+	 * @return true if the work runs on the shared worker pool, the queue has no thread of its own then
+	 */
+	bool pooled() const { return _pool != nullptr; }
+
+	size_t num_items();
+#endif // PX4_WORK_QUEUE_POOL
+
+	/**
+	 * Enable the wakeup latency histogram of all queues (disabled by default to keep the timestamp out of Add()).
+	 */
+	static void enable_latency_histogram(bool enable) { _latency_histogram_enabled.store(enable); }
+	static bool latency_histogram_enabled() { return _latency_histogram_enabled.load(); }
+
+#if defined(__PX4_LINUX)
+	/**
+	 * Restrict the queue thread to a set of CPUs.
+	 * @param cpu_mask bitmask of CPUs, 0 for all of them
+	 * @return true on success
+	 */
+	bool set_cpu_affinity(uint32_t cpu_mask);
+#endif // __PX4_LINUX
+
 	// WorkQueues sorted numerically by relative priority (-1 to -255)
 	bool operator<=(const WorkQueue &rhs) const { return _config.relative_priority >= rhs.get_config().relative_priority; }
 
@@ -82,6 +108,12 @@ private:
 
 	inline void SignalWorkerThread();
 
+	void record_wakeup_latency(hrt_abstime latency);
+
+	// wakeup latency histogram bucket upper bounds (us), the last bucket is unbounded
+	static constexpr uint16_t LATENCY_BUCKETS_US[] {10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+	static constexpr int NUM_LATENCY_BUCKETS = sizeof(LATENCY_BUCKETS_US) / sizeof(LATENCY_BUCKETS_US[0]) + 1;
+
 #ifdef __PX4_NUTTX
 	// In NuttX work can be enqueued from an ISR
 	void work_lock() { _flags = enter_critical_section(); }
@@ -101,10 +133,26 @@ private:
 	BlockingList<WorkItem *>	_work_items;
 	px4::atomic_bool		_should_exit{false};
 
+	// time from scheduling work on the idle queue until its thread runs (protected by work_lock)
+	bool				_idle{true};
+	hrt_abstime			_signal_time{0};
+	uint32_t			_latency_histogram[NUM_LATENCY_BUCKETS] {};
+	uint32_t			_latency_max{0};
+
+	static px4::atomic_bool		_latency_histogram_enabled;
+
+#if defined(__PX4_LINUX)
+	pthread_t			_thread{pthread_self()}; // constructed by the queue thread (unless pooled)
+#endif // __PX4_LINUX
+
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 	int _lockstep_component {-1};
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
+#if defined(PX4_WORK_QUEUE_POOL)
+	WorkerPool *_pool {nullptr}; ///< the queue's work runs on a shared worker pool, there's no queue thread
+#endif // PX4_WORK_QUEUE_POOL
+
 };
 
 } // namespace px4
@@ -35,6 +35,11 @@
 
 #include <stdint.h>
 
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT) && !defined(ENABLE_LOCKSTEP_SCHEDULER)
+// non real-time work queues can optionally share a pool of worker threads (see WorkerPoolStart())
+#define PX4_WORK_QUEUE_POOL
+#endif
+
 namespace px4
 {
 
@@ -44,6 +49,7 @@ struct wq_config_t {
 	const char *name;
 	uint16_t stacksize;
 	int8_t relative_priority; // relative to max
+	uint32_t cpu_affinity{0}; // bitmask of CPUs the thread may run on, 0 for any (Linux only)
 };
 
 namespace wq_configurations
@@ -109,6 +115,40 @@ int WorkQueueManagerStop();
  */
 int WorkQueueManagerStatus();
 
+/**
+ * Enable or disable the wakeup latency histogram shown by the status output.
+ */
+int WorkQueueLatencyHistogram(bool enable);
+
+#if defined(PX4_WORK_QUEUE_POOL)
+/**
+ * Start a pool of worker threads shared by the given work queues instead of a thread per queue.
+ * Only queues created after this call use the pool, so it needs to run before they are started.
+ *
+ * @param num_workers	Number of worker threads.
+ * @param queues	Work queue names (eg wq:lp_default), queues above wq:hp_default priority are rejected.
+ * @param num_queues	Number of names, if 0 hp_default and lp_default are shared.
+ */
+int WorkerPoolStart(int num_workers, const char *const queues[], int num_queues);
+#endif // PX4_WORK_QUEUE_POOL
+
+#if defined(__PX4_LINUX)
+/**
+ * Override the CPU affinity of a work queue, applied immediately if it's already running.
+ *
+ * @param name		The work queue name (eg wq:rate_ctrl).
+ * @param cpu_mask	Bitmask of CPUs, 0 to restore the configured affinity.
+ */
+int WorkQueueSetAffinity(const char *name, uint32_t cpu_mask);
+
+/**
+ * Reserve CPUs for the work queues with an affinity on them: all other work queues are kept off these CPUs.
+ *
+ * @param cpu_mask	Bitmask of isolated CPUs, 0 to disable.
+ */
+int WorkQueueIsolateCpus(uint32_t cpu_mask);
+#endif // __PX4_LINUX
+
 /**
  * Create (or find) a work queue with a particular configuration.
  *
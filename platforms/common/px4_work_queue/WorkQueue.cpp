@@ -34,6 +34,8 @@
 #include <px4_platform_common/px4_work_queue/WorkQueue.hpp>
 #include <px4_platform_common/px4_work_queue/WorkItem.hpp>
 
+#include "WorkerPool.hpp"
+
 #include <string.h>
 
 #include <px4_platform_common/tasks.h>
@@ -43,15 +45,27 @@
 namespace px4
 {
 
+constexpr uint16_t WorkQueue::LATENCY_BUCKETS_US[];
+
+px4::atomic_bool WorkQueue::_latency_histogram_enabled{false};
+
 WorkQueue::WorkQueue(const wq_config_t &config) :
 	_config(config)
 {
-	// set the threads name
+#if defined(PX4_WORK_QUEUE_POOL)
+	// a pooled queue is created by the wq manager, it has no thread of its own
+	_pool = WorkerPool::find(_config);
+
+	if (_pool == nullptr)
+#endif // PX4_WORK_QUEUE_POOL
+	{
+		// set the threads name
 #ifdef __PX4_DARWIN
-	pthread_setname_np(_config.name);
+		pthread_setname_np(_config.name);
 #else
-	pthread_setname_np(pthread_self(), _config.name);
+		pthread_setname_np(pthread_self(), _config.name);
 #endif
+	}
 
 #ifndef __PX4_NUTTX
 	px4_sem_init(&_qlock, 0, 1);
@@ -105,6 +119,16 @@ void WorkQueue::Detach(WorkItem *item)
 	_work_items.remove(item);
 
 	if (_work_items.size() == 0) {
+#if defined(PX4_WORK_QUEUE_POOL)
+
+		if (_pool != nullptr) {
+			// there's no thread to stop, pooled queues are kept until the wq manager stops
+			work_unlock();
+			return;
+		}
+
+#endif // PX4_WORK_QUEUE_POOL
+
 		// shutdown, no active WorkItems
 		PX4_DEBUG("stopping: %s, last active WorkItem closing", _config.name);
 
@@ -125,8 +149,24 @@ void WorkQueue::Detach(WorkItem *item)
 	}
 }
 
+#if defined(PX4_WORK_QUEUE_POOL)
+size_t WorkQueue::num_items()
+{
+	return _work_items.size();
+}
+#endif // PX4_WORK_QUEUE_POOL
+
 void WorkQueue::Add(WorkItem *item)
 {
+#if defined(PX4_WORK_QUEUE_POOL)
+
+	if (_pool != nullptr) {
+		_pool->Add(item);
+		return;
+	}
+
+#endif // PX4_WORK_QUEUE_POOL
+
 	work_lock();
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
@@ -138,11 +178,31 @@ void WorkQueue::Add(WorkItem *item)
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
 	_q.push(item);
+
+	if (_idle && (_signal_time == 0) && _latency_histogram_enabled.load()) {
+		_signal_time = hrt_absolute_time();
+	}
+
 	work_unlock();
 
 	SignalWorkerThread();
 }
 
+void WorkQueue::record_wakeup_latency(hrt_abstime latency)
+{
+	int bucket = 0;
+
+	while ((bucket < NUM_LATENCY_BUCKETS - 1) && (latency >= LATENCY_BUCKETS_US[bucket])) {
+		bucket++;
+	}
+
+	_latency_histogram[bucket]++;
+
+	if (latency > _latency_max) {
+		_latency_max = (latency < UINT32_MAX) ? latency : UINT32_MAX;
+	}
+}
+
 void WorkQueue::SignalWorkerThread()
 {
 	int sem_val;
@@ -154,6 +214,15 @@ void WorkQueue::SignalWorkerThread()
 
 void WorkQueue::Remove(WorkItem *item)
 {
+#if defined(PX4_WORK_QUEUE_POOL)
+
+	if (_pool != nullptr) {
+		_pool->Remove(item);
+		return;
+	}
+
+#endif // PX4_WORK_QUEUE_POOL
+
 	work_lock();
 	_q.remove(item);
 	work_unlock();
@@ -161,6 +230,20 @@ void WorkQueue::Remove(WorkItem *item)
 
 void WorkQueue::Clear()
 {
+#if defined(PX4_WORK_QUEUE_POOL)
+
+	if (_pool != nullptr) {
+		LockGuard lg{_work_items.mutex()};
+
+		for (WorkItem *item : _work_items) {
+			_pool->Remove(item);
+		}
+
+		return;
+	}
+
+#endif // PX4_WORK_QUEUE_POOL
+
 	work_lock();
 
 	while (!_q.empty()) {
@@ -178,6 +261,13 @@ void WorkQueue::Run()
 
 		work_lock();
 
+		if (_signal_time != 0) {
+			record_wakeup_latency(hrt_elapsed_time(&_signal_time));
+			_signal_time = 0;
+		}
+
+		_idle = false;
+
 		// process queued work
 		while (!_q.empty()) {
 			WorkItem *work = _q.pop();
@@ -198,6 +288,8 @@ void WorkQueue::Run()
 
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
+		_idle = true;
+
 		work_unlock();
 	}
 
@@ -207,9 +299,44 @@ void WorkQueue::Run()
 void WorkQueue::print_status(bool last)
 {
 	const size_t num_items = _work_items.size();
-	PX4_INFO_RAW("%-16s\n", get_name());
+#if defined(PX4_WORK_QUEUE_POOL)
+
+	if (_pool != nullptr) {
+		PX4_INFO_RAW("%-16s (worker pool)\n", get_name());
+
+	} else
+#endif // PX4_WORK_QUEUE_POOL
+	{
+		PX4_INFO_RAW("%-16s\n", get_name());
+	}
 	unsigned i = 0;
 
+	// wakeup latency histogram, reset after printing
+	work_lock();
+	uint32_t histogram[NUM_LATENCY_BUCKETS];
+	memcpy(histogram, _latency_histogram, sizeof(histogram));
+	memset(_latency_histogram, 0, sizeof(_latency_histogram));
+	const uint32_t latency_max = _latency_max;
+	_latency_max = 0;
+	work_unlock();
+
+	uint32_t wakeups = 0;
+
+	for (int bucket = 0; bucket < NUM_LATENCY_BUCKETS; bucket++) {
+		wakeups += histogram[bucket];
+	}
+
+	if (wakeups > 0) {
+		PX4_INFO_RAW(last ? "    " : "|   ");
+		PX4_INFO_RAW("      wakeup latency (us):");
+
+		for (int bucket = 0; bucket < NUM_LATENCY_BUCKETS - 1; bucket++) {
+			PX4_INFO_RAW(" <%" PRIu16 ":%" PRIu32, LATENCY_BUCKETS_US[bucket], histogram[bucket]);
+		}
+
+		PX4_INFO_RAW(" >:%" PRIu32 " max:%" PRIu32 "\n", histogram[NUM_LATENCY_BUCKETS - 1], latency_max);
+	}
+
 	for (WorkItem *item : _work_items) {
 		i++;
 
@@ -231,4 +358,29 @@ void WorkQueue::print_status(bool last)
 	}
 }
 
+#if defined(__PX4_LINUX)
+bool WorkQueue::set_cpu_affinity(uint32_t cpu_mask)
+{
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+
+	const int num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+
+	for (int cpu = 0; (cpu < num_cpus) && (cpu < 32); cpu++) {
+		if ((cpu_mask == 0) || (cpu_mask & (1u << cpu))) {
+			CPU_SET(cpu, &cpuset);
+		}
+	}
+
+	int ret = pthread_setaffinity_np(_thread, sizeof(cpuset), &cpuset);
+
+	if (ret != 0) {
+		PX4_ERR("%s: setting CPU affinity 0x%" PRIx32 " failed (%i)", get_name(), cpu_mask, ret);
+		return false;
+	}
+
+	return true;
+}
+#endif // __PX4_LINUX
+
 } // namespace px4
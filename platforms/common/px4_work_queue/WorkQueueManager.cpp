@@ -35,11 +35,14 @@
 
 #include <px4_platform_common/px4_work_queue/WorkQueue.hpp>
 
+#include "WorkerPool.hpp"
+
 #include <drivers/drv_hrt.h>
 #include <px4_platform_common/posix.h>
 #include <px4_platform_common/tasks.h>
 #include <px4_platform_common/time.h>
 #include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_config.h>
 #include <containers/BlockingList.hpp>
 #include <containers/BlockingQueue.hpp>
 #include <lib/drivers/device/Device.hpp>
@@ -50,6 +53,11 @@
 
 using namespace time_literals;
 
+#if defined(__PX4_LINUX) && !defined(CONFIG_ARCH_BOARD_PX4_SITL)
+// real-time policy for the queue threads on Linux targets, SITL keeps the scheduling of the simulator process
+#define WQ_EXPLICIT_SCHED
+#endif
+
 namespace px4
 {
 
@@ -61,6 +69,109 @@ static BlockingQueue<const wq_config_t *, 1> *_wq_manager_create_queue{nullptr};
 
 static px4::atomic_bool _wq_manager_should_exit{true};
 
+#if defined(__PX4_LINUX)
+// CPU affinity overrides set at runtime (eg from the startup script)
+struct wq_affinity_override_t {
+	char name[24];
+	uint32_t cpu_mask;
+};
+
+static constexpr int WQ_AFFINITY_OVERRIDES_MAX = 8;
+static wq_affinity_override_t _wq_affinity_overrides[WQ_AFFINITY_OVERRIDES_MAX] {};
+static uint32_t _wq_isolated_cpus{0};
+static pthread_mutex_t _wq_affinity_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// _wq_affinity_mutex must be held
+static uint32_t
+WorkQueueAffinityLocked(const wq_config_t &config)
+{
+	uint32_t cpu_mask = config.cpu_affinity;
+
+	for (const wq_affinity_override_t &affinity : _wq_affinity_overrides) {
+		if ((affinity.cpu_mask != 0) && (strcmp(affinity.name, config.name) == 0)) {
+			cpu_mask = affinity.cpu_mask;
+			break;
+		}
+	}
+
+	if ((cpu_mask == 0) && (_wq_isolated_cpus != 0)) {
+		// keep everything without an explicit affinity off the isolated CPUs
+		const int num_cpus = math::min((int)sysconf(_SC_NPROCESSORS_CONF), 32);
+		const uint32_t all_cpus = (num_cpus >= 32) ? UINT32_MAX : ((1u << num_cpus) - 1);
+		cpu_mask = all_cpus & ~_wq_isolated_cpus;
+	}
+
+	return cpu_mask;
+}
+
+static void
+WorkQueueApplyAffinity()
+{
+	if (_wq_manager_wqs_list == nullptr) {
+		return;
+	}
+
+	LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+	pthread_mutex_lock(&_wq_affinity_mutex);
+
+	for (WorkQueue *wq : *_wq_manager_wqs_list) {
+#if defined(PX4_WORK_QUEUE_POOL)
+
+		if (wq->pooled()) {
+			continue;
+		}
+
+#endif // PX4_WORK_QUEUE_POOL
+
+		wq->set_cpu_affinity(WorkQueueAffinityLocked(wq->get_config()));
+	}
+
+	pthread_mutex_unlock(&_wq_affinity_mutex);
+}
+
+int
+WorkQueueSetAffinity(const char *name, uint32_t cpu_mask)
+{
+	pthread_mutex_lock(&_wq_affinity_mutex);
+
+	wq_affinity_override_t *affinity = nullptr;
+
+	for (wq_affinity_override_t &a : _wq_affinity_overrides) {
+		if ((strcmp(a.name, name) == 0) || ((affinity == nullptr) && (a.name[0] == '\0'))) {
+			affinity = &a;
+		}
+	}
+
+	if (affinity == nullptr) {
+		pthread_mutex_unlock(&_wq_affinity_mutex);
+		PX4_ERR("too many affinity overrides (max %d)", WQ_AFFINITY_OVERRIDES_MAX);
+		return PX4_ERROR;
+	}
+
+	strncpy(affinity->name, name, sizeof(affinity->name) - 1);
+	affinity->cpu_mask = cpu_mask;
+
+	pthread_mutex_unlock(&_wq_affinity_mutex);
+
+	WorkQueueApplyAffinity();
+
+	return PX4_OK;
+}
+
+int
+WorkQueueIsolateCpus(uint32_t cpu_mask)
+{
+	pthread_mutex_lock(&_wq_affinity_mutex);
+	_wq_isolated_cpus = cpu_mask;
+	pthread_mutex_unlock(&_wq_affinity_mutex);
+
+	WorkQueueApplyAffinity();
+
+	return PX4_OK;
+}
+#endif // __PX4_LINUX
+
 
 static WorkQueue *
 FindWorkQueueByName(const char *name)
@@ -224,6 +335,17 @@ WorkQueueRunner(void *context)
 	wq_config_t *config = static_cast<wq_config_t *>(context);
 	WorkQueue wq(*config);
 
+#if defined(__PX4_LINUX)
+	pthread_mutex_lock(&_wq_affinity_mutex);
+	const uint32_t cpu_mask = WorkQueueAffinityLocked(*config);
+	pthread_mutex_unlock(&_wq_affinity_mutex);
+
+	if (cpu_mask != 0) {
+		wq.set_cpu_affinity(cpu_mask);
+	}
+
+#endif // __PX4_LINUX
+
 	// add to work queue list
 	_wq_manager_wqs_list->add(&wq);
 
@@ -246,6 +368,122 @@ WorkQueueRunner(int argc, char *argv[])
 }
 #endif
 
+#if !defined(__PX4_NUTTX) || defined(CONFIG_BUILD_FLAT)
+// create a work queue thread with SCHED_FIFO at the given priority (also used by the worker pool)
+int
+WorkQueueThreadCreate(pthread_t *thread, const char *name, int sched_priority, size_t stacksize,
+		      void *(*start_routine)(void *), void *arg)
+{
+	pthread_attr_t attr;
+	int ret_attr_init = pthread_attr_init(&attr);
+
+	int ret_setstacksize = pthread_attr_setstacksize(&attr, stacksize);
+
+	if (ret_setstacksize != 0) {
+		PX4_ERR("setting stack size for %s failed (%i)", name, ret_setstacksize);
+	}
+
+	if (ret_attr_init != 0) {
+		PX4_ERR("attr init for %s failed (%i)", name, ret_attr_init);
+	}
+
+	sched_param param;
+	int ret_getschedparam = pthread_attr_getschedparam(&attr, &param);
+
+	if (ret_getschedparam != 0) {
+		PX4_ERR("getting sched param for %s failed (%i)", name, ret_getschedparam);
+	}
+
+#ifndef __PX4_QURT
+
+	// schedule policy FIFO
+	int ret_setschedpolicy = pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+
+	if (ret_setschedpolicy != 0) {
+		PX4_ERR("failed to set sched policy SCHED_FIFO (%i)", ret_setschedpolicy);
+	}
+
+#endif // ! QuRT
+
+#if defined(WQ_EXPLICIT_SCHED)
+	// without this the thread inherits the policy and priority of the wq manager and the above is ignored
+	int ret_setinheritsched = pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+
+	if (ret_setinheritsched != 0) {
+		PX4_ERR("failed to set explicit sched for %s (%i)", name, ret_setinheritsched);
+	}
+
+#endif // WQ_EXPLICIT_SCHED
+
+	// priority
+	param.sched_priority = sched_priority;
+	int ret_setschedparam = pthread_attr_setschedparam(&attr, &param);
+
+	if (ret_setschedparam != 0) {
+		PX4_ERR("setting sched params for %s failed (%i)", name, ret_setschedparam);
+	}
+
+	// create thread
+	int ret_create = pthread_create(thread, &attr, start_routine, arg);
+
+#if defined(WQ_EXPLICIT_SCHED)
+
+	if (ret_create == EPERM) {
+		// real-time scheduling not permitted (no CAP_SYS_NICE), fall back to the inherited policy
+		static bool warned = false;
+
+		if (!warned) {
+			PX4_WARN("no permission for SCHED_FIFO, work queues use the default scheduling");
+			warned = true;
+		}
+
+		pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+		ret_create = pthread_create(thread, &attr, start_routine, arg);
+	}
+
+#endif // WQ_EXPLICIT_SCHED
+
+	// destroy thread attributes
+	int ret_destroy = pthread_attr_destroy(&attr);
+
+	if (ret_destroy != 0) {
+		PX4_ERR("failed to destroy thread attributes for %s (%i)", name, ret_destroy);
+	}
+
+	return ret_create;
+}
+#endif // !__PX4_NUTTX || CONFIG_BUILD_FLAT
+
+#if defined(PX4_WORK_QUEUE_POOL)
+// pooled queues have no thread that ends with the last work item, delete the unused ones
+static void
+WorkQueueDeleteUnusedPooled()
+{
+	WorkQueue *unused;
+
+	do {
+		unused = nullptr;
+
+		{
+			LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+			for (WorkQueue *wq : *_wq_manager_wqs_list) {
+				if (wq->pooled() && (wq->num_items() == 0)) {
+					unused = wq;
+					break;
+				}
+			}
+		}
+
+		if (unused != nullptr) {
+			_wq_manager_wqs_list->remove(unused);
+			delete unused;
+		}
+
+	} while (unused != nullptr);
+}
+#endif // PX4_WORK_QUEUE_POOL
+
 static int
 WorkQueueManagerRun(int, char **)
 {
@@ -256,6 +494,16 @@ WorkQueueManagerRun(int, char **)
 		// create new work queues as needed
 		const wq_config_t *wq = _wq_manager_create_queue->pop();
 
+#if defined(PX4_WORK_QUEUE_POOL)
+
+		if ((wq != nullptr) && (WorkerPool::find(*wq) != nullptr)) {
+			// the worker pool runs the work, no thread needed
+			_wq_manager_wqs_list->add(new WorkQueue(*wq));
+			continue;
+		}
+
+#endif // PX4_WORK_QUEUE_POOL
+
 		if (wq != nullptr) {
 			// create new work queue
 
@@ -277,63 +525,17 @@ WorkQueueManagerRun(int, char **)
 
 			// use pthreads for NuttX flat and posix builds. For NuttX protected build, use tasks or kernel threads
 #if !defined(__PX4_NUTTX) || defined(CONFIG_BUILD_FLAT)
-			pthread_attr_t attr;
-			int ret_attr_init = pthread_attr_init(&attr);
-
-			int ret_setstacksize = pthread_attr_setstacksize(&attr, stacksize);
-
-			if (ret_setstacksize != 0) {
-				PX4_ERR("setting stack size for %s failed (%i)", wq->name, ret_setstacksize);
-			}
-
-			if (ret_attr_init != 0) {
-				PX4_ERR("attr init for %s failed (%i)", wq->name, ret_attr_init);
-			}
-
-			sched_param param;
-			int ret_getschedparam = pthread_attr_getschedparam(&attr, &param);
-
-			if (ret_getschedparam != 0) {
-				PX4_ERR("getting sched param for %s failed (%i)", wq->name, ret_getschedparam);
-			}
-
-#ifndef __PX4_QURT
-
-			// schedule policy FIFO
-			int ret_setschedpolicy = pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
-
-			if (ret_setschedpolicy != 0) {
-				PX4_ERR("failed to set sched policy SCHED_FIFO (%i)", ret_setschedpolicy);
-			}
-
-#endif // ! QuRT
-
-			// priority
-			param.sched_priority = sched_priority;
-			int ret_setschedparam = pthread_attr_setschedparam(&attr, &param);
-
-			if (ret_setschedparam != 0) {
-				PX4_ERR("setting sched params for %s failed (%i)", wq->name, ret_setschedparam);
-			}
-
-			// create thread
 			pthread_t thread;
-			int ret_create = pthread_create(&thread, &attr, WorkQueueRunner, (void *)wq);
+			int ret_create = WorkQueueThreadCreate(&thread, wq->name, sched_priority, stacksize, WorkQueueRunner,
+							       (void *)wq);
 
 			if (ret_create == 0) {
-				PX4_DEBUG("starting: %s, priority: %d, stack: %zu bytes", wq->name, param.sched_priority, stacksize);
+				PX4_DEBUG("starting: %s, priority: %d, stack: %zu bytes", wq->name, sched_priority, stacksize);
 
 			} else {
 				PX4_ERR("failed to create thread for %s (%i): %s", wq->name, ret_create, strerror(ret_create));
 			}
 
-			// destroy thread attributes
-			int ret_destroy = pthread_attr_destroy(&attr);
-
-			if (ret_destroy != 0) {
-				PX4_ERR("failed to destroy thread attributes for %s (%i)", wq->name, ret_create);
-			}
-
 #else
 			// create thread
 
@@ -396,6 +598,14 @@ WorkQueueManagerStop()
 {
 	if (!_wq_manager_should_exit.load()) {
 
+#if defined(PX4_WORK_QUEUE_POOL)
+
+		if (_wq_manager_wqs_list != nullptr) {
+			WorkQueueDeleteUnusedPooled();
+		}
+
+#endif // PX4_WORK_QUEUE_POOL
+
 		// error can't shutdown until all WorkItems are removed/stopped
 		if ((_wq_manager_wqs_list != nullptr) && (_wq_manager_wqs_list->size() > 0)) {
 			PX4_ERR("can't shutdown with active WQs");
@@ -423,6 +633,10 @@ WorkQueueManagerStop()
 			delete _wq_manager_wqs_list;
 		}
 
+#if defined(PX4_WORK_QUEUE_POOL)
+		WorkerPool::stop();
+#endif // PX4_WORK_QUEUE_POOL
+
 		_wq_manager_should_exit.store(true);
 
 		if (_wq_manager_create_queue != nullptr) {
@@ -468,6 +682,10 @@ WorkQueueManagerStatus()
 			wq->print_status(last_wq);
 		}
 
+#if defined(PX4_WORK_QUEUE_POOL)
+		WorkerPool::status();
+#endif // PX4_WORK_QUEUE_POOL
+
 	} else {
 		PX4_INFO("not running");
 	}
@@ -475,4 +693,11 @@ WorkQueueManagerStatus()
 	return PX4_OK;
 }
 
+int
+WorkQueueLatencyHistogram(bool enable)
+{
+	WorkQueue::enable_latency_histogram(enable);
+	return PX4_OK;
+}
+
 } // namespace px4
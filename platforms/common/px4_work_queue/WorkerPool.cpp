@@ -0,0 +1,458 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2021 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "WorkerPool.hpp"
+
+#if defined(PX4_WORK_QUEUE_POOL)
+
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/posix.h>
+#include <px4_platform_common/tasks.h>
+#include <lib/mathlib/mathlib.h>
+
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace px4
+{
+
+// published once the pool is fully set up, read by work queue threads when they start
+static px4::atomic<WorkerPool *> _worker_pool{nullptr};
+
+// work queues that are allowed to share the pool (no real-time requirements)
+static constexpr const wq_config_t *shareable_wqs[] {
+	&wq_configurations::hp_default,
+	&wq_configurations::uavcan,
+	&wq_configurations::UART0,
+	&wq_configurations::UART1,
+	&wq_configurations::UART2,
+	&wq_configurations::UART3,
+	&wq_configurations::UART4,
+	&wq_configurations::UART5,
+	&wq_configurations::UART6,
+	&wq_configurations::UART7,
+	&wq_configurations::UART8,
+	&wq_configurations::UART_UNKNOWN,
+	&wq_configurations::lp_default,
+};
+
+static const wq_config_t *find_shareable(const char *name)
+{
+	for (const wq_config_t *config : shareable_wqs) {
+		// allow the name with or without the "wq:" prefix
+		if ((strcmp(config->name, name) == 0) || (strcmp(config->name + 3, name) == 0)) {
+			return config;
+		}
+	}
+
+	return nullptr;
+}
+
+int WorkerPool::start(int num_workers, const char *const queues[], int num_queues)
+{
+	if (_worker_pool.load() != nullptr) {
+		PX4_WARN("already running");
+		return PX4_ERROR;
+	}
+
+	if ((num_workers < 1) || (num_workers > MAX_WORKERS)) {
+		PX4_ERR("invalid number of workers %d (1-%d)", num_workers, MAX_WORKERS);
+		return PX4_ERROR;
+	}
+
+	static const char *const default_queues[] {wq_configurations::hp_default.name, wq_configurations::lp_default.name};
+
+	if (num_queues == 0) {
+		queues = default_queues;
+		num_queues = sizeof(default_queues) / sizeof(default_queues[0]);
+	}
+
+	if (num_queues > MAX_QUEUES) {
+		PX4_ERR("too many queues (max %d)", MAX_QUEUES);
+		return PX4_ERROR;
+	}
+
+	WorkerPool *pool = new WorkerPool();
+
+	if (pool == nullptr) {
+		PX4_ERR("alloc failed");
+		return PX4_ERROR;
+	}
+
+	// the workers run with the priority and stack of the most demanding shared queue
+	int8_t relative_priority = INT8_MIN;
+	uint16_t stacksize = 0;
+
+	for (int i = 0; i < num_queues; i++) {
+		const wq_config_t *config = find_shareable(queues[i]);
+
+		if (config == nullptr) {
+			PX4_ERR("%s can't be shared", queues[i]);
+			delete pool;
+			return PX4_ERROR;
+		}
+
+		strncpy(pool->_queues[pool->_num_queues], config->name, sizeof(pool->_queues[0]) - 1);
+		pool->_num_queues++;
+
+		relative_priority = math::max(relative_priority, config->relative_priority);
+		stacksize = math::max(stacksize, config->stacksize);
+	}
+
+	pool->_status_start = hrt_absolute_time();
+
+	// On posix system , the desired stacksize round to the nearest multiplier of the system pagesize
+	const unsigned int page_size = sysconf(_SC_PAGESIZE);
+	const size_t stacksize_adj = math::max((int)PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(stacksize));
+	const size_t stacksize_page = (stacksize_adj + page_size - (stacksize_adj % page_size));
+
+	const int sched_priority = sched_get_priority_max(SCHED_FIFO) + relative_priority;
+
+	// all workers exist before the first one runs, the number of workers never changes
+	pool->_num_workers = num_workers;
+
+	for (int i = 0; i < num_workers; i++) {
+		Worker &worker = pool->_workers[i];
+		worker.pool = pool;
+		worker.index = i;
+		pthread_mutex_init(&worker.lock, nullptr);
+		pthread_cond_init(&worker.cond, nullptr);
+	}
+
+	for (int i = 0; i < num_workers; i++) {
+		Worker &worker = pool->_workers[i];
+
+		int ret_create = WorkQueueThreadCreate(&worker.thread, "wq:pool", sched_priority, stacksize_page,
+						       worker_trampoline, &worker);
+
+		if (ret_create != 0) {
+			PX4_ERR("failed to create worker %d (%i): %s", i, ret_create, strerror(ret_create));
+			pool->shutdown(i);
+			delete pool;
+			return PX4_ERROR;
+		}
+	}
+
+	PX4_DEBUG("worker pool: %d workers, priority: %d, stack: %zu bytes", pool->_num_workers, sched_priority,
+		  stacksize_page);
+
+	_worker_pool.store(pool);
+
+	return PX4_OK;
+}
+
+void WorkerPool::stop()
+{
+	WorkerPool *pool = _worker_pool.load();
+
+	// only one caller takes the pool down
+	if ((pool == nullptr) || !_worker_pool.compare_exchange(&pool, nullptr)) {
+		return;
+	}
+
+	pool->shutdown(pool->_num_workers);
+
+	delete pool;
+}
+
+void WorkerPool::shutdown(int num_started)
+{
+	_should_exit.store(true);
+
+	for (int i = 0; i < _num_workers; i++) {
+		pthread_mutex_lock(&_workers[i].lock);
+		_workers[i].wakeup = true;
+		pthread_cond_signal(&_workers[i].cond);
+		pthread_mutex_unlock(&_workers[i].lock);
+	}
+
+	for (int i = 0; i < num_started; i++) {
+		pthread_join(_workers[i].thread, nullptr);
+	}
+
+	for (int i = 0; i < _num_workers; i++) {
+		pthread_cond_destroy(&_workers[i].cond);
+		pthread_mutex_destroy(&_workers[i].lock);
+	}
+}
+
+WorkerPool *WorkerPool::find(const wq_config_t &config)
+{
+	WorkerPool *pool = _worker_pool.load();
+
+	if (pool != nullptr) {
+		for (int i = 0; i < pool->_num_queues; i++) {
+			if (strcmp(pool->_queues[i], config.name) == 0) {
+				return pool;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+WorkerPool::Worker &WorkerPool::home_worker(const WorkItem *item)
+{
+	// only the address is used, the item might already be deleted
+	const uint32_t hash = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(item) >> 4) * 2654435761u;
+	return _workers[(hash >> 16) % _num_workers];
+}
+
+void WorkerPool::Add(WorkItem *item)
+{
+	Worker &home = home_worker(item);
+
+	pthread_mutex_lock(&home.lock);
+
+	for (int i = 0; i < _num_workers; i++) {
+		if (_workers[i].current.load() == item) {
+			// never run an item concurrently with itself, the worker running it reschedules it
+			_workers[i].rerun = true;
+			pthread_mutex_unlock(&home.lock);
+			return;
+		}
+	}
+
+	// no-op if it's already queued
+	home.q.push(item);
+
+	pthread_mutex_unlock(&home.lock);
+
+	wake_idle_worker(home);
+}
+
+void WorkerPool::Remove(WorkItem *item)
+{
+	Worker &home = home_worker(item);
+
+	pthread_mutex_lock(&home.lock);
+
+	home.q.remove(item);
+
+	for (int i = 0; i < _num_workers; i++) {
+		// the item might be deleted after this, it must not be touched again by the worker running it
+		if (_workers[i].current.load() == item) {
+			_workers[i].rerun = false;
+		}
+	}
+
+	pthread_mutex_unlock(&home.lock);
+}
+
+void WorkerPool::wake_idle_worker(Worker &preferred)
+{
+	uint32_t idle = _idle_workers.load();
+
+	while (idle != 0) {
+		const uint32_t preferred_bit = 1u << preferred.index;
+		const uint32_t bit = (idle & preferred_bit) ? preferred_bit : (idle & -idle);
+
+		// claim the idle worker, so the next Add() wakes a different one
+		if (_idle_workers.compare_exchange(&idle, idle & ~bit)) {
+			Worker &worker = _workers[__builtin_ctz(bit)];
+			pthread_mutex_lock(&worker.lock);
+			worker.wakeup = true;
+			pthread_cond_signal(&worker.cond);
+			pthread_mutex_unlock(&worker.lock);
+			return;
+		}
+	}
+}
+
+WorkItem *WorkerPool::pop_or_steal(Worker &worker, bool &stolen)
+{
+	for (int i = 0; i < _num_workers; i++) {
+		// own queue first, then steal from the others
+		Worker &victim = _workers[(worker.index + i) % _num_workers];
+
+		pthread_mutex_lock(&victim.lock);
+
+		if (!victim.q.empty()) {
+			WorkItem *work = victim.q.pop();
+
+			// hand over under the home worker lock, Add() and Remove() see the item running from now on
+			worker.current.store(work);
+			worker.rerun = false;
+
+			pthread_mutex_unlock(&victim.lock);
+
+			stolen = (i > 0);
+			return work;
+		}
+
+		pthread_mutex_unlock(&victim.lock);
+	}
+
+	return nullptr;
+}
+
+void *WorkerPool::worker_trampoline(void *arg)
+{
+	Worker *worker = static_cast<Worker *>(arg);
+
+	char name[16];
+	snprintf(name, sizeof(name), "wq:pool%d", worker->index);
+#ifdef __PX4_DARWIN
+	pthread_setname_np(name);
+#else
+	pthread_setname_np(pthread_self(), name);
+#endif
+
+	worker->pool->worker_run(*worker);
+
+	return nullptr;
+}
+
+void WorkerPool::worker_run(Worker &worker)
+{
+	const uint32_t idle_bit = 1u << worker.index;
+
+	while (!_should_exit.load()) {
+		bool stolen = false;
+		WorkItem *work = pop_or_steal(worker, stolen);
+
+		if (work == nullptr) {
+			// announce being idle, then look again as work added before that didn't wake anyone
+			_idle_workers.fetch_or(idle_bit);
+			work = pop_or_steal(worker, stolen);
+
+			if (work == nullptr) {
+				pthread_mutex_lock(&worker.lock);
+
+				while (!worker.wakeup && !_should_exit.load()) {
+					pthread_cond_wait(&worker.cond, &worker.lock);
+				}
+
+				worker.wakeup = false;
+				pthread_mutex_unlock(&worker.lock);
+			}
+
+			_idle_workers.fetch_and(~idle_bit);
+
+			if (work == nullptr) {
+				continue;
+			}
+		}
+
+		const hrt_abstime start = hrt_absolute_time();
+		work->RunPreamble();
+		work->Run();
+		// Note: after Run() we cannot access work anymore, as it might have been deleted (unless rerun is still set)
+		const hrt_abstime elapsed = hrt_elapsed_time(&start);
+
+		Worker &home = home_worker(work);
+		pthread_mutex_lock(&home.lock);
+
+		const bool rerun = worker.rerun;
+
+		if (rerun) {
+			home.q.push(work);
+		}
+
+		worker.current.store(nullptr);
+		worker.rerun = false;
+
+		pthread_mutex_unlock(&home.lock);
+
+		if (rerun && (&home != &worker)) {
+			wake_idle_worker(home);
+		}
+
+		pthread_mutex_lock(&worker.lock);
+		worker.busy_time += elapsed;
+		worker.runs++;
+		worker.steals += stolen ? 1 : 0;
+		pthread_mutex_unlock(&worker.lock);
+	}
+}
+
+void WorkerPool::status()
+{
+	WorkerPool *pool = _worker_pool.load();
+
+	if (pool != nullptr) {
+		pool->print_status();
+	}
+}
+
+void WorkerPool::print_status()
+{
+	pthread_mutex_lock(&_status_lock);
+
+	const hrt_abstime now = hrt_absolute_time();
+	const float interval = math::max(now - _status_start, (hrt_abstime)1);
+	_status_start = now;
+
+	PX4_INFO_RAW("\nWorker pool: %d threads, shared by", _num_workers);
+
+	for (int i = 0; i < _num_queues; i++) {
+		PX4_INFO_RAW(" %s", _queues[i]);
+	}
+
+	PX4_INFO_RAW("\n");
+
+	for (int i = 0; i < _num_workers; i++) {
+		Worker &worker = _workers[i];
+
+		pthread_mutex_lock(&worker.lock);
+		const hrt_abstime busy_time = worker.busy_time;
+		const uint32_t runs = worker.runs;
+		const uint32_t steals = worker.steals;
+		const size_t queued = worker.q.size();
+
+		// reset statistics
+		worker.busy_time = 0;
+		worker.runs = 0;
+		worker.steals = 0;
+		pthread_mutex_unlock(&worker.lock);
+
+		PX4_INFO_RAW("%s__ %2d) wq:pool%-2d %5.1f%% busy %8" PRIu32 " runs %8" PRIu32 " steals %4zu queued\n",
+			     (i < _num_workers - 1) ? "|" : "\\", i + 1, i,
+			     (double)(100.f * busy_time / interval), runs, steals, queued);
+	}
+
+	pthread_mutex_unlock(&_status_lock);
+}
+
+int WorkerPoolStart(int num_workers, const char *const queues[], int num_queues)
+{
+	return WorkerPool::start(num_workers, queues, num_queues);
+}
+
+} // namespace px4
+
+#endif // PX4_WORK_QUEUE_POOL
@@ -0,0 +1,146 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2021 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <px4_platform_common/px4_work_queue/WorkQueueManager.hpp>
+
+#if defined(PX4_WORK_QUEUE_POOL)
+
+#include <containers/IntrusiveQueue.hpp>
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+
+#include <pthread.h>
+
+namespace px4
+{
+
+class WorkItem;
+
+/**
+ * Create a thread with SCHED_FIFO and the given priority like the work queue threads (see WorkQueueManager.cpp).
+ * @return 0 on success, otherwise the pthread_create() error
+ */
+int WorkQueueThreadCreate(pthread_t *thread, const char *name, int sched_priority, size_t stacksize,
+			  void *(*start_routine)(void *), void *arg);
+
+/**
+ * Pool of worker threads shared by the non real-time work queues (POSIX only).
+ *
+ * Every WorkItem has a home worker chosen from its address. It is queued on the run queue
+ * of its home worker, and idle workers steal from the other run queues. Each worker has
+ * its own lock and wakeup, there is no pool wide lock. The home worker's lock also
+ * serialises the hand over of an item to the worker running it: scheduling an item that is
+ * currently running only marks it to run again once it returned, so a WorkItem is never run
+ * by two workers at the same time.
+ */
+class WorkerPool
+{
+public:
+	static constexpr int MAX_WORKERS = 16;
+	static constexpr int MAX_QUEUES = 8;
+
+	/**
+	 * Start the pool, queues created afterwards with a matching name share it.
+	 * @param num_workers number of worker threads
+	 * @param queues names of the work queues to share (eg "wq:lp_default")
+	 * @param num_queues number of names, 0 to use hp_default and lp_default
+	 */
+	static int start(int num_workers, const char *const queues[], int num_queues);
+	static void stop();
+
+	/**
+	 * @return the pool if the work queue with the given configuration should use it, nullptr otherwise
+	 */
+	static WorkerPool *find(const wq_config_t &config);
+
+	static void status();
+
+	void Add(WorkItem *item);
+	void Remove(WorkItem *item);
+
+private:
+	struct Worker {
+		WorkerPool *pool{nullptr};
+		pthread_t thread{};
+		int index{0};
+
+		pthread_mutex_t lock{};
+		pthread_cond_t cond{};
+
+		IntrusiveQueue<WorkItem *> q; ///< items with this home worker (protected by lock)
+		bool wakeup{false};           ///< protected by lock
+
+		// only changed with the lock of the item's home worker held
+		px4::atomic<WorkItem *> current{nullptr}; ///< currently running item
+		bool rerun{false};                        ///< current was scheduled again while running
+
+		// statistics since the last status (protected by lock)
+		hrt_abstime busy_time{0};
+		uint32_t runs{0};
+		uint32_t steals{0};
+	};
+
+	WorkerPool() = default;
+	~WorkerPool() = default;
+
+	static void *worker_trampoline(void *arg);
+	void worker_run(Worker &worker);
+
+	Worker &home_worker(const WorkItem *item);
+
+	WorkItem *pop_or_steal(Worker &worker, bool &stolen);
+	void wake_idle_worker(Worker &preferred);
+
+	void shutdown(int num_started);
+
+	void print_status();
+
+	Worker _workers[MAX_WORKERS] {};
+	int _num_workers{0};
+
+	px4::atomic<uint32_t> _idle_workers{0}; ///< bitmask of the workers waiting for work
+
+	char _queues[MAX_QUEUES][24] {};
+	int _num_queues{0};
+
+	pthread_mutex_t _status_lock = PTHREAD_MUTEX_INITIALIZER;
+	hrt_abstime _status_start{0};
+
+	px4::atomic_bool _should_exit{false};
+};
+
+} // namespace px4
+
+#endif // PX4_WORK_QUEUE_POOL
@@ -131,6 +131,41 @@ public:
 
 		return (Manager::orb_publish(get_topic(), _handle, &data) == PX4_OK);
 	}
+
+	/**
+	 * Loan the next queue slot to write the message in place instead of copying it in publish().
+	 * The slot still holds an older message, so every field has to be written before commit().
+	 * Other publishers and readers of the topic block until the loan is committed.
+	 * @return The message to fill, nullptr if a loan isn't possible (use publish() instead).
+	 */
+	T *loan()
+	{
+		// the publication lock is already held by the outstanding loan
+		if (_loaned != nullptr) {
+			return _loaned;
+		}
+
+		if (!advertised()) {
+			advertise();
+		}
+
+		_loaned = static_cast<T *>(Manager::orb_loan(_handle));
+		return _loaned;
+	}
+
+	/**
+	 * Publish the message returned by loan(), does nothing if the loan failed.
+	 */
+	void commit()
+	{
+		if (_loaned != nullptr) {
+			Manager::orb_commit(_handle, _loaned);
+			_loaned = nullptr;
+		}
+	}
+
+private:
+	T *_loaned{nullptr};
 };
 
 /**
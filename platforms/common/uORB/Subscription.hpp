@@ -150,6 +150,24 @@ public:
 	 */
 	bool copy(void *dst) { return advertised() && Manager::orb_data_copy(_node, dst, _last_generation); }
 
+	/**
+	 * Borrow the struct in place instead of copying it, same queue semantics as copy().
+	 * Later publications can overwrite the data, check borrow_valid() after reading it.
+	 * @return The message, nullptr if not available (use copy() instead).
+	 */
+	const void *borrow() { return advertised() ? Manager::orb_data_borrow(_node, _last_generation) : nullptr; }
+
+	/**
+	 * Borrow the struct in place if there is a new update, see borrow().
+	 */
+	const void *borrow_update() { return updated() ? Manager::orb_data_borrow(_node, _last_generation) : nullptr; }
+
+	/**
+	 * Check that the struct returned by the last borrow() was not overwritten while it was read.
+	 * If this fails the data must be discarded.
+	 */
+	bool borrow_valid() const { return valid() && Manager::orb_data_borrow_valid(_node, _last_generation); }
+
 	/**
 	 * Change subscription instance
 	 * @param instance The new multi-Subscription instance
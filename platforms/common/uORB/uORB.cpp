@@ -94,6 +94,30 @@ int uorb_top(char **topic_filter, int num_filters)
 	return OK;
 }
 
+#ifdef ORB_TELEMETRY
+int uorb_stats(char **topic_filter, int num_filters)
+{
+	if (g_dev != nullptr) {
+		g_dev->printTelemetry(topic_filter, num_filters);
+
+	} else {
+		PX4_INFO("uorb is not running");
+	}
+
+	return OK;
+}
+
+int uorb_stats_collect(struct uorb_stats_s *report)
+{
+	if ((g_dev == nullptr) || (report == nullptr)) {
+		return PX4_ERROR;
+	}
+
+	g_dev->collectTelemetry(*report);
+	return PX4_OK;
+}
+#endif /* ORB_TELEMETRY */
+
 orb_advert_t orb_advertise(const struct orb_metadata *meta, const void *data)
 {
 	return uORB::Manager::get_instance()->orb_advertise(meta, data);
@@ -117,6 +117,18 @@ int uorb_start(void);
 int uorb_status(void);
 int uorb_top(char **topic_filter, int num_filters);
 
+#ifdef ORB_TELEMETRY
+struct uorb_stats_s;
+
+int uorb_stats(char **topic_filter, int num_filters);
+
+/**
+ * Fill a uorb_stats report with the publication/copy telemetry since the previous call.
+ * @return PX4_OK on success, PX4_ERROR if uORB is not running
+ */
+int uorb_stats_collect(struct uorb_stats_s *report);
+#endif /* ORB_TELEMETRY */
+
 /**
  * ORB topic advertiser handle.
  *
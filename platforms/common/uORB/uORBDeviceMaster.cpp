@@ -435,6 +435,161 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 
 #undef CLEAR_LINE
 
+#ifdef ORB_TELEMETRY
+void uORB::DeviceMaster::printTelemetry(char **topic_filter, int num_filters)
+{
+	bool print_all = false;
+	bool reset = false;
+
+	// strip the flags from the topic filters
+	int num_topic_filters = 0;
+
+	for (int i = 0; i < num_filters; ++i) {
+		if (!strcmp("-a", topic_filter[i])) {
+			print_all = true;
+
+		} else if (!strcmp("-r", topic_filter[i])) {
+			reset = true;
+
+		} else {
+			topic_filter[num_topic_filters++] = topic_filter[i];
+		}
+	}
+
+	/* Add all nodes to a list while locked, and then print them in unlocked state, to avoid potential
+	 * dead-locks (where printing blocks) */
+	lock();
+	DeviceNodeStatisticsData *first_node = nullptr;
+	DeviceNodeStatisticsData *cur_node = nullptr;
+	size_t max_topic_name_length = 0;
+	int num_topics = 0;
+	int ret = addNewDeviceNodes(&first_node, num_topics, max_topic_name_length, topic_filter, num_topic_filters);
+	unlock();
+
+	if (ret != 0) {
+		PX4_ERR("addNewDeviceNodes failed (%i)", ret);
+	}
+
+	uint64_t total_published = 0;
+	uint64_t total_copied = 0;
+	uint64_t total_dropped = 0;
+
+	PX4_INFO_RAW("%-*s INST #SUB #Q   PUB kB  COPY kB  COPY/PUB   LAG  DROP  #CB CB AVG CB MAX (us)\n",
+		     (int)max_topic_name_length - 2, "TOPIC NAME");
+
+	cur_node = first_node;
+
+	while (cur_node) {
+		DeviceNode *node = cur_node->node;
+		DeviceNode::Telemetry &telemetry = node->telemetry();
+
+		const uint32_t published = telemetry.bytes_published.load();
+		const uint32_t copied = telemetry.bytes_copied.load();
+		const uint32_t dropped = telemetry.dropped_generations.load();
+		const uint32_t callback_runs = telemetry.callback_runs;
+
+		if (print_all || (published > 0) || (copied > 0)) {
+			PX4_INFO_RAW("%-*s %2i %4i %2i %8.1f %8.1f %9.1f %5" PRIu32 " %5" PRIu32 " %4" PRIu32 " %6" PRIu32 " %6i\n",
+				     (int)max_topic_name_length, node->get_meta()->o_name, (int)node->get_instance(),
+				     (int)node->subscriber_count(), (int)node->get_queue_size(),
+				     (double)(published / 1000.f), (double)(copied / 1000.f),
+				     (double)((published > 0) ? (float)copied / published : 0.f),
+				     telemetry.lagging_copies.load(), dropped, callback_runs,
+				     (callback_runs > 0) ? telemetry.callback_time_us / callback_runs : 0,
+				     (int)telemetry.callback_max_us);
+		}
+
+		total_published += published;
+		total_copied += copied;
+		total_dropped += dropped;
+
+		if (reset) {
+			node->reset_telemetry();
+		}
+
+		DeviceNodeStatisticsData *prev = cur_node;
+		cur_node = cur_node->next;
+		delete prev;
+	}
+
+	PX4_INFO_RAW("total: %.1f kB published, %.1f kB copied, %" PRIu64 " dropped\n",
+		     (double)(total_published / 1000.f), (double)(total_copied / 1000.f), total_dropped);
+}
+
+void uORB::DeviceMaster::collectTelemetry(uorb_stats_s &report)
+{
+	const hrt_abstime now = hrt_absolute_time();
+
+	report = {};
+	report.interval_us = (_last_telemetry_report > 0) ? now - _last_telemetry_report : 0;
+	_last_telemetry_report = now;
+
+	lock();
+
+	for (DeviceNode *node : _node_list) {
+		DeviceNode::Telemetry &telemetry = node->telemetry();
+
+		const uint32_t published = telemetry.bytes_published.load();
+		const uint32_t copied = telemetry.bytes_copied.load();
+		const uint32_t dropped = telemetry.dropped_generations.load();
+
+		// unsigned differences handle the counters wrapping around
+		const uint32_t published_delta = published - telemetry.reported_bytes_published;
+		const uint32_t copied_delta = copied - telemetry.reported_bytes_copied;
+		const uint32_t dropped_delta = dropped - telemetry.reported_dropped_generations;
+		const uint16_t callback_max_us = telemetry.callback_interval_max_us;
+
+		telemetry.reported_bytes_published = published;
+		telemetry.reported_bytes_copied = copied;
+		telemetry.reported_dropped_generations = dropped;
+		telemetry.callback_interval_max_us = 0;
+
+		if ((published_delta == 0) && (copied_delta == 0)) {
+			continue;
+		}
+
+		report.num_topics++;
+		report.bytes_published += published_delta;
+		report.bytes_copied += copied_delta;
+		report.dropped_generations += dropped_delta;
+
+		// keep the entries sorted by copied bytes, insert into the top list
+		int i = report.count;
+
+		if (i == uorb_stats_s::MAX_TOPICS) {
+			if (copied_delta <= report.topic_bytes_copied[i - 1]) {
+				continue;
+			}
+
+			i--;
+
+		} else {
+			report.count++;
+		}
+
+		for (; (i > 0) && (copied_delta > report.topic_bytes_copied[i - 1]); i--) {
+			report.orb_id[i] = report.orb_id[i - 1];
+			report.instance[i] = report.instance[i - 1];
+			report.topic_bytes_published[i] = report.topic_bytes_published[i - 1];
+			report.topic_bytes_copied[i] = report.topic_bytes_copied[i - 1];
+			report.topic_dropped_generations[i] = report.topic_dropped_generations[i - 1];
+			report.callback_max_us[i] = report.callback_max_us[i - 1];
+		}
+
+		report.orb_id[i] = static_cast<uint16_t>(node->id());
+		report.instance[i] = node->get_instance();
+		report.topic_bytes_published[i] = published_delta;
+		report.topic_bytes_copied[i] = copied_delta;
+		report.topic_dropped_generations[i] = dropped_delta;
+		report.callback_max_us[i] = callback_max_us;
+	}
+
+	unlock();
+
+	report.timestamp = hrt_absolute_time();
+}
+#endif /* ORB_TELEMETRY */
+
 uORB::DeviceNode *uORB::DeviceMaster::getDeviceNode(const char *nodepath)
 {
 	lock();
@@ -53,6 +53,10 @@ class Manager;
 #include <containers/IntrusiveSortedList.hpp>
 #include <px4_platform_common/atomic_bitset.h>
 
+#ifdef ORB_TELEMETRY
+#include <uORB/topics/uorb_stats.h>
+#endif /* ORB_TELEMETRY */
+
 using px4::AtomicBitset;
 
 /**
@@ -115,6 +119,22 @@ public:
 	 */
 	void showTop(char **topic_filter, int num_filters);
 
+#ifdef ORB_TELEMETRY
+	/**
+	 * Print the publication/copy telemetry of each topic.
+	 * @param topic_filter list of topic filters: substrings for topics to match, '-a' to print topics without
+	 *        traffic as well and '-r' to reset the counters afterwards.
+	 * @param num_filters
+	 */
+	void printTelemetry(char **topic_filter, int num_filters);
+
+	/**
+	 * Fill a telemetry report with the traffic since the previous call.
+	 * Only one caller is expected (there is a single set of reported values per topic).
+	 */
+	void collectTelemetry(uorb_stats_s &report);
+#endif /* ORB_TELEMETRY */
+
 private:
 	// Private constructor, uORB::Manager takes care of its creation
 	DeviceMaster();
@@ -142,6 +162,10 @@ private:
 	IntrusiveSortedList<uORB::DeviceNode *> _node_list;
 	AtomicBitset<ORB_TOPICS_COUNT> _node_exists[ORB_MULTI_MAX_INSTANCES];
 
+#ifdef ORB_TELEMETRY
+	hrt_abstime _last_telemetry_report {0};
+#endif /* ORB_TELEMETRY */
+
 	px4_sem_t	_lock; /**< lock to protect access to all class members (also for derived classes) */
 
 	void		lock() { do {} while (px4_sem_wait(&_lock) != 0); }
@@ -175,6 +175,66 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 	 *
 	 * Note that filp will usually be NULL.
 	 */
+	if (!allocate_data()) {
+		return -ENOMEM;
+	}
+
+	/* If write size does not match, that is an error */
+	if (_meta->o_size != buflen) {
+		return -EIO;
+	}
+
+	/* Perform an atomic copy. Publishers are serialized, readers validate against _publish_seq. */
+	for (;;) {
+		ATOMIC_ENTER;
+
+		if ((_publish_seq.load() & 1) == 0) {
+			_publish_seq.fetch_add(1); // odd: publication in progress
+
+			/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
+			unsigned generation = _generation.fetch_add(1);
+
+			memcpy(_data + (_meta->o_size * (generation % _queue_size)), buffer, _meta->o_size);
+
+			_publish_seq.fetch_add(1); // even: publication complete
+
+#ifdef ORB_TELEMETRY
+			_telemetry.bytes_published.fetch_add(_meta->o_size);
+#endif /* ORB_TELEMETRY */
+
+			call_callbacks();
+
+			/* Mark at least one data has been published */
+			_data_valid = true;
+
+			ATOMIC_LEAVE;
+			break;
+		}
+
+		// a loan is outstanding, wait until the loaning publisher commits
+		ATOMIC_LEAVE;
+
+#ifdef __PX4_NUTTX
+
+		if (up_interrupt_context()) {
+			return -EBUSY;
+		}
+
+#endif /* __PX4_NUTTX */
+
+		lock();
+		unlock();
+	}
+
+	/* notify any poll waiters */
+	poll_notify(POLLIN);
+
+	return _meta->o_size;
+}
+
+bool
+uORB::DeviceNode::allocate_data()
+{
 	if (nullptr == _data) {
 
 #ifdef __PX4_NUTTX
@@ -195,39 +255,175 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 		}
 
 #endif /* __PX4_NUTTX */
+	}
 
-		/* failed or could not allocate */
-		if (nullptr == _data) {
-			return -ENOMEM;
-		}
+	/* failed or could not allocate */
+	return (_data != nullptr);
+}
+
+void *
+uORB::DeviceNode::loan()
+{
+#ifdef __PX4_NUTTX
+
+	if (up_interrupt_context()) {
+		return nullptr;
 	}
 
-	/* If write size does not match, that is an error */
-	if (_meta->o_size != buflen) {
-		return -EIO;
+#endif /* __PX4_NUTTX */
+
+	if (!allocate_data()) {
+		return nullptr;
 	}
 
-	/* Perform an atomic copy. */
+	// held until commit(), this serializes the loan against other publishers and locked readers
+	lock();
+	_loaned.store(true);
+
+#ifdef __PX4_NUTTX
+	// writers on NuttX only disable interrupts, make sure none of them is halfway through
 	ATOMIC_ENTER;
-	/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
-	unsigned generation = _generation.fetch_add(1);
+#endif /* __PX4_NUTTX */
 
-	memcpy(_data + (_meta->o_size * (generation % _queue_size)), buffer, _meta->o_size);
+	_publish_seq.fetch_add(1); // odd: publication in progress
 
-	// callbacks
-	for (auto item : _callbacks) {
-		item->call();
+#ifdef __PX4_NUTTX
+	ATOMIC_LEAVE;
+#endif /* __PX4_NUTTX */
+
+	// the slot the next generation is written to (the oldest message in the queue)
+	return _data + (_meta->o_size * (_generation.load() % _queue_size));
+}
+
+void
+uORB::DeviceNode::commit(void *loaned)
+{
+	// without an outstanding loan the lock isn't held and the sequence is even, leave both alone
+	if ((loaned == nullptr) || !_loaned.load()) {
+		return;
+	}
+
+	// the loaned slot can't change until the generation is bumped
+	uint8_t *slot = _data + (_meta->o_size * (_generation.load() % _queue_size));
+
+	if (loaned != slot) {
+		PX4_ERR("%s: commit of a slot that isn't loaned", _meta->o_name);
+		return;
+	}
+
+#ifdef ORB_COMMUNICATOR
+	/*
+	 * send it over the Multi-ORB link while the slot is still ours
+	 */
+	uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
+
+	if (ch != nullptr) {
+		if (ch->send_message(_meta->o_name, _meta->o_size, slot) != 0) {
+			PX4_ERR("Error Sending [%s] topic data over comm_channel", _meta->o_name);
+		}
 	}
 
+#endif /* ORB_COMMUNICATOR */
+
+#ifdef __PX4_NUTTX
+	ATOMIC_ENTER;
+#endif /* __PX4_NUTTX */
+
+	_generation.fetch_add(1);
+
+	_publish_seq.fetch_add(1); // even: publication complete
+
+#ifdef ORB_TELEMETRY
+	_telemetry.bytes_published.fetch_add(_meta->o_size);
+#endif /* ORB_TELEMETRY */
+
+	call_callbacks();
+
 	/* Mark at least one data has been published */
 	_data_valid = true;
 
+#ifdef __PX4_NUTTX
 	ATOMIC_LEAVE;
+#endif /* __PX4_NUTTX */
+
+	_loaned.store(false);
+	unlock();
 
 	/* notify any poll waiters */
 	poll_notify(POLLIN);
+}
 
-	return _meta->o_size;
+void
+uORB::DeviceNode::call_callbacks()
+{
+#ifdef ORB_TELEMETRY
+
+	if (_callbacks.empty()) {
+		return;
+	}
+
+	const hrt_abstime callbacks_start = hrt_absolute_time();
+#endif /* ORB_TELEMETRY */
+
+	for (auto item : _callbacks) {
+		item->call();
+	}
+
+#ifdef ORB_TELEMETRY
+	const hrt_abstime elapsed = hrt_elapsed_time(&callbacks_start);
+	const uint16_t elapsed_us = (elapsed < UINT16_MAX) ? elapsed : UINT16_MAX;
+
+	_telemetry.callback_runs++;
+	_telemetry.callback_time_us += elapsed;
+
+	if (elapsed_us > _telemetry.callback_max_us) {
+		_telemetry.callback_max_us = elapsed_us;
+	}
+
+	if (elapsed_us > _telemetry.callback_interval_max_us) {
+		_telemetry.callback_interval_max_us = elapsed_us;
+	}
+
+#endif /* ORB_TELEMETRY */
+}
+
+#ifdef ORB_TELEMETRY
+void
+uORB::DeviceNode::reset_telemetry()
+{
+	ATOMIC_ENTER;
+	_telemetry.bytes_published.store(0);
+	_telemetry.bytes_copied.store(0);
+	_telemetry.lagging_copies.store(0);
+	_telemetry.dropped_generations.store(0);
+	_telemetry.callback_runs = 0;
+	_telemetry.callback_time_us = 0;
+	_telemetry.callback_max_us = 0;
+	_telemetry.callback_interval_max_us = 0;
+	_telemetry.reported_bytes_published = 0;
+	_telemetry.reported_bytes_copied = 0;
+	_telemetry.reported_dropped_generations = 0;
+	ATOMIC_LEAVE;
+}
+#endif /* ORB_TELEMETRY */
+
+void
+uORB::DeviceNode::copy_locked(void *dst, unsigned &generation)
+{
+	for (;;) {
+		ATOMIC_ENTER;
+
+		if ((_publish_seq.load() & 1) == 0) {
+			copy_unlocked(dst, generation);
+			ATOMIC_LEAVE;
+			return;
+		}
+
+		// only possible while a loan is outstanding (the publication lock is held by the loaning publisher)
+		ATOMIC_LEAVE;
+		lock();
+		unlock();
+	}
 }
 
 int
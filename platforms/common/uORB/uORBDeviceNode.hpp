@@ -228,43 +228,140 @@ public:
 	bool copy(void *dst, unsigned &generation)
 	{
 		if ((dst != nullptr) && (_data != nullptr)) {
-			if (_queue_size == 1) {
-				ATOMIC_ENTER;
-				memcpy(dst, _data, _meta->o_size);
-				generation = _generation.load();
-				ATOMIC_LEAVE;
-				return true;
-
-			} else {
-				ATOMIC_ENTER;
-				const unsigned current_generation = _generation.load();
-
-				if (current_generation == generation) {
-					/* The subscriber already read the latest message, but nothing new was published yet.
-					* Return the previous message
-					*/
-					--generation;
-				}
+#ifdef ORB_TELEMETRY
+			const unsigned requested_generation = generation;
+#endif /* ORB_TELEMETRY */
 
-				// Compatible with normal and overflow conditions
-				if (!is_in_range(current_generation - _queue_size, generation, current_generation - 1)) {
-					// Reader is too far behind: some messages are lost
-					generation = current_generation - _queue_size;
-				}
+			if (!copy_lockfree(dst, generation)) {
+				// the node is busy, block on the publisher instead
+				copy_locked(dst, generation);
+			}
+
+#ifdef ORB_TELEMETRY
+			record_copy(requested_generation, generation);
+#endif /* ORB_TELEMETRY */
+
+			return true;
+		}
 
-				memcpy(dst, _data + (_meta->o_size * (generation % _queue_size)), _meta->o_size);
-				ATOMIC_LEAVE;
+		return false;
 
-				++generation;
+	}
 
-				return true;
+	/**
+	 * Borrow a const view of the message for the given generation in place,
+	 * following the same queue semantics as copy().
+	 * The view stays readable, but may be overwritten by later publications once
+	 * the queue wraps around. Check borrow_valid() after using the data.
+	 *
+	 * @param generation
+	 *   The generation that was borrowed (same semantics as copy()).
+	 * @return
+	 *   Pointer to the message, nullptr if there is no data or a publication is in progress.
+	 */
+	const void *borrow(unsigned &generation) const
+	{
+		// nothing was published yet, the slots hold no message
+		if ((_data == nullptr) || !_data_valid) {
+			return nullptr;
+		}
+
+		// the generation first: if the sequence is even afterwards every publication it counts has completed
+		const unsigned current_generation = _generation.load();
+
+		if (_publish_seq.load() & 1) {
+			return nullptr;
+		}
+
+		unsigned index;
+
+		if (_queue_size == 1) {
+			index = current_generation - 1;
+
+		} else {
+			index = generation;
+
+			if (current_generation == index) {
+				--index;
+			}
+
+			if (!is_in_range(current_generation - _queue_size, index, current_generation - 1)) {
+				index = current_generation - _queue_size;
 			}
 		}
 
-		return false;
+		generation = index + 1;
 
+		return _data + (_meta->o_size * (index % _queue_size));
 	}
 
+	/**
+	 * Check whether a view returned by borrow() was not overwritten in the meantime.
+	 * @param generation The generation returned by borrow()
+	 * @return true if all the data read through the view is consistent
+	 */
+	bool borrow_valid(unsigned generation) const
+	{
+		// order the data reads before checking the publications
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		// the sequence first: an odd value means the slot of _generation (or _generation - 1) is being written
+		const unsigned seq = _publish_seq.load();
+		const unsigned current_generation = _generation.load();
+
+		// the slot of generation - 1 is reused by the publication of generation - 1 + _queue_size
+		return (current_generation + (seq & 1) - generation) < _queue_size;
+	}
+
+	/**
+	 * Loan the next queue slot to a publisher, which writes the message in place
+	 * and publishes it with commit(). Until then other publishers and readers that
+	 * need the lock are blocked, so keep the loan short and always commit it.
+	 * The slot still holds an old message, every field has to be written.
+	 *
+	 * A topic published with loans must not also be published from interrupt
+	 * context, and the loaning thread must not publish the topic before committing.
+	 *
+	 * @return
+	 *   The slot to write to, nullptr if a loan is not possible (use write() instead).
+	 */
+	void *loan();
+
+	/**
+	 * Publish the message written to the slot returned by loan().
+	 * Does nothing if the loan failed or was already committed.
+	 * @param loaned The slot returned by loan()
+	 */
+	void commit(void *loaned);
+
+#ifdef ORB_TELEMETRY
+	/**
+	 * Publication and copy telemetry (only compiled in with ORB_TELEMETRY).
+	 * The counters run freely and wrap around, users look at differences.
+	 */
+	struct Telemetry {
+		px4::atomic<uint32_t> bytes_published{0};
+		px4::atomic<uint32_t> bytes_copied{0};
+		px4::atomic<uint32_t> lagging_copies{0};      /**< copies of a queued topic that skipped overwritten generations */
+		px4::atomic<uint32_t> dropped_generations{0}; /**< generations overwritten before a subscriber copied them */
+
+		// written by the publisher while holding the publication lock
+		uint32_t callback_runs{0};           /**< publications with registered callbacks */
+		uint32_t callback_time_us{0};        /**< total callback fan-out time */
+		uint16_t callback_max_us{0};
+		uint16_t callback_interval_max_us{0}; /**< reset by every report */
+
+		// values at the last report, used to publish differences
+		uint32_t reported_bytes_published{0};
+		uint32_t reported_bytes_copied{0};
+		uint32_t reported_dropped_generations{0};
+	};
+
+	Telemetry &telemetry() { return _telemetry; }
+
+	void reset_telemetry();
+#endif /* ORB_TELEMETRY */
+
 	// add item to list of work items to schedule on node update
 	bool register_callback(SubscriptionCallback *callback_sub);
 
@@ -280,11 +377,111 @@ protected:
 private:
 	friend uORBTest::UnitTest;
 
+	static constexpr int COPY_RETRIES = 4; /**< lock-free copy attempts before falling back to the lock */
+
+	/**
+	 * Run the registered callbacks, called with the publication lock held.
+	 */
+	void call_callbacks();
+
+#ifdef ORB_TELEMETRY
+	void record_copy(unsigned requested_generation, unsigned generation)
+	{
+		_telemetry.bytes_copied.fetch_add(_meta->o_size);
+
+		// single message topics always return the latest data, skipping generations does not lose anything there
+		if (_queue_size > 1) {
+			const int dropped = (int)(generation - requested_generation) - 1;
+
+			if (dropped > 0) {
+				_telemetry.lagging_copies.fetch_add(1);
+				_telemetry.dropped_generations.fetch_add(dropped);
+			}
+		}
+	}
+
+	Telemetry _telemetry{};
+#endif /* ORB_TELEMETRY */
+
+	/**
+	 * Allocate the queue if this did not happen yet.
+	 * @return false if the allocation failed (or is not possible from interrupt context)
+	 */
+	bool allocate_data();
+
+	/**
+	 * Optimistic lock-free read (sequence lock): publishers make _publish_seq odd
+	 * while they write, so a read that saw the same even value before and after
+	 * the memcpy was not torn. Only retry a few times, a publisher preempted
+	 * in the middle of a write must not be spun on.
+	 * @return false if no consistent copy was made
+	 */
+	bool copy_lockfree(void *dst, unsigned &generation) const
+	{
+		for (int attempt = 0; attempt < COPY_RETRIES; attempt++) {
+			const unsigned seq_begin = _publish_seq.load();
+
+			if ((seq_begin & 1) == 0) {
+				unsigned read_generation = generation;
+				copy_unlocked(dst, read_generation);
+
+				// order the data reads before re-checking the sequence
+				__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+				if (_publish_seq.load() == seq_begin) {
+					generation = read_generation;
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * Copy while holding the publication lock, waits for an outstanding loan.
+	 */
+	void copy_locked(void *dst, unsigned &generation);
+
+	/**
+	 * Copy the message for the given generation without any synchronization,
+	 * callers either hold the lock or validate with _publish_seq.
+	 */
+	void copy_unlocked(void *dst, unsigned &generation) const
+	{
+		if (_queue_size == 1) {
+			memcpy(dst, _data, _meta->o_size);
+			generation = _generation.load();
+
+		} else {
+			const unsigned current_generation = _generation.load();
+
+			if (current_generation == generation) {
+				/* The subscriber already read the latest message, but nothing new was published yet.
+				* Return the previous message
+				*/
+				--generation;
+			}
+
+			// Compatible with normal and overflow conditions
+			if (!is_in_range(current_generation - _queue_size, generation, current_generation - 1)) {
+				// Reader is too far behind: some messages are lost
+				generation = current_generation - _queue_size;
+			}
+
+			memcpy(dst, _data + (_meta->o_size * (generation % _queue_size)), _meta->o_size);
+
+			++generation;
+		}
+	}
+
 	const orb_metadata *_meta; /**< object metadata information */
 
 	uint8_t *_data{nullptr};   /**< allocated object buffer */
 	bool _data_valid{false}; /**< At least one valid data */
 	px4::atomic<unsigned>  _generation{0};  /**< object generation count */
+	px4::atomic<unsigned>  _publish_seq{0}; /**< publication sequence lock, odd while a publication is written */
+	px4::atomic<bool> _loaned{false}; /**< a loan is outstanding, the loaning publisher holds the lock */
 	List<uORB::SubscriptionCallback *>	_callbacks;
 
 	const uint8_t _instance; /**< orb multi instance identifier */
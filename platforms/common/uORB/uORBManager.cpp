@@ -359,6 +359,40 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return static_cast<DeviceNode *>(node_handle)->copy(dst, generation);
 }
 
+void *uORB::Manager::orb_loan(orb_advert_t handle)
+{
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return nullptr; // not allowed to publish, let the caller fall back to orb_publish()
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	if (handle == nullptr) {
+		return nullptr;
+	}
+
+	return static_cast<DeviceNode *>(handle)->loan();
+}
+
+void uORB::Manager::orb_commit(orb_advert_t handle, void *loaned)
+{
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return;
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	if (handle == nullptr) {
+		return;
+	}
+
+	static_cast<DeviceNode *>(handle)->commit(loaned);
+}
+
 // add item to list of work items to schedule on node update
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
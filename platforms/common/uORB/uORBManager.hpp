@@ -347,6 +347,28 @@ public:
 
 	static bool orb_data_copy(void *node_handle, void *dst, unsigned &generation);
 
+	static const void *orb_data_borrow(const void *node_handle, unsigned &generation) { return static_cast<const DeviceNode *>(node_handle)->borrow(generation); }
+
+	static bool orb_data_borrow_valid(const void *node_handle, unsigned generation) { return static_cast<const DeviceNode *>(node_handle)->borrow_valid(generation); }
+
+	/**
+	 * Loan the next queue slot of a publication to write the message in place.
+	 * The loan must be published with orb_commit() before the topic is published again.
+	 *
+	 * @param handle  The handle returned from orb_advertise.
+	 * @return    Pointer to the slot, nullptr if a loan is not possible (publish a copy instead).
+	 */
+	static void *orb_loan(orb_advert_t handle);
+
+	/**
+	 * Publish a message written in place after orb_loan().
+	 * Does nothing if loaned is nullptr, i.e. the loan failed.
+	 *
+	 * @param handle  The handle returned from orb_advertise.
+	 * @param loaned  The pointer returned by orb_loan().
+	 */
+	static void orb_commit(orb_advert_t handle, void *loaned);
+
 	static bool register_callback(void *node_handle, SubscriptionCallback *callback_sub);
 
 	static void unregister_callback(void *node_handle, SubscriptionCallback *callback_sub);
@@ -40,6 +40,7 @@
 #include <math.h>
 #include <lib/cdev/CDev.hpp>
 #include <uORB/PublicationMulti.hpp>
+#include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionMultiArray.hpp>
 
 uORBTest::UnitTest &uORBTest::UnitTest::instance()
@@ -206,7 +207,13 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
-	return test_queue_poll_notify();
+	ret = test_queue_poll_notify();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	return test_loan_borrow();
 }
 
 int uORBTest::UnitTest::test_unadvertise()
@@ -1085,6 +1092,252 @@ int uORBTest::UnitTest::latency_test(bool print)
 	return pubsubtest_res;
 }
 
+int uORBTest::UnitTest::test_loan_borrow()
+{
+	test_note("Testing loan/commit & borrow");
+
+	static constexpr int queue_size = 4;
+	uORB::Publication<orb_test_medium_s, queue_size> pub{ORB_ID(orb_test_medium_loan)};
+
+	if (!pub.advertise()) {
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	uORB::Subscription sub{ORB_ID(orb_test_medium_loan)};
+
+	if (sub.borrow() != nullptr) {
+		return test_fail("borrow before the first publication");
+	}
+
+	test_note("  Testing loaned publications...");
+
+	for (int i = 0; i < queue_size; ++i) {
+		orb_test_medium_s *msg = pub.loan();
+
+		if (msg == nullptr) {
+			return test_fail("loan %i failed", i);
+		}
+
+		msg->timestamp = hrt_absolute_time();
+		msg->val = i;
+		memset(msg->junk, i, sizeof(msg->junk));
+		pub.commit();
+	}
+
+	for (int i = 0; i < queue_size; ++i) {
+		const orb_test_medium_s *msg = static_cast<const orb_test_medium_s *>(sub.borrow_update());
+
+		if (msg == nullptr) {
+			return test_fail("borrow %i failed", i);
+		}
+
+		if ((msg->val != i) || (msg->junk[sizeof(msg->junk) - 1] != i)) {
+			return test_fail("borrowed wrong element (got %i, should be %i)", msg->val, i);
+		}
+
+		if (!sub.borrow_valid()) {
+			return test_fail("borrow %i invalidated without publication", i);
+		}
+	}
+
+	if (sub.borrow_update() != nullptr) {
+		return test_fail("spurious borrow update");
+	}
+
+	test_note("  Testing borrow invalidation...");
+
+	orb_test_medium_s t{};
+	t.val = queue_size;
+	pub.publish(t);
+
+	const orb_test_medium_s *msg = static_cast<const orb_test_medium_s *>(sub.borrow_update());
+
+	if ((msg == nullptr) || (msg->val != queue_size)) {
+		return test_fail("borrow after publish failed");
+	}
+
+	// the borrowed slot stays valid until the queue wraps around onto it
+	for (int i = 1; i < queue_size; ++i) {
+		t.val = queue_size + i;
+		pub.publish(t);
+
+		if (!sub.borrow_valid()) {
+			return test_fail("borrow invalidated after %i publications", i);
+		}
+	}
+
+	orb_test_medium_s *loaned = pub.loan();
+
+	if (loaned == nullptr) {
+		return test_fail("loan failed");
+	}
+
+	if ((const void *)loaned != (const void *)msg) {
+		return test_fail("loaned slot is not the oldest element");
+	}
+
+	loaned->val = 2 * queue_size;
+	pub.commit();
+
+	if (sub.borrow_valid()) {
+		return test_fail("overwritten borrow still valid");
+	}
+
+	// a copy still gets the oldest element left in the queue
+	orb_test_medium_s u{};
+
+	if (!sub.update(&u) || (u.val != queue_size + 1)) {
+		return test_fail("copy after overwritten borrow failed (got %i)", u.val);
+	}
+
+	test_note("  Testing commit without a loan...");
+
+	// must neither release the publication lock nor leave the sequence odd
+	pub.commit();
+
+	t.val = 3 * queue_size;
+
+	if (!pub.publish(t)) {
+		return test_fail("publish after commit without a loan failed");
+	}
+
+	while (sub.update(&u)) {}
+
+	if (u.val != 3 * queue_size) {
+		return test_fail("copy after commit without a loan failed (got %i)", u.val);
+	}
+
+	return test_note("PASS loan/commit & borrow");
+}
+
+int uORBTest::UnitTest::contention_test()
+{
+	test_note("---------------- CONTENTION TEST ------------------");
+
+	const int reader_counts[] {1, 4, 8};
+
+	for (int num_readers : reader_counts) {
+		int ret = contention_run(num_readers);
+
+		if (ret != OK) {
+			return ret;
+		}
+	}
+
+	return OK;
+}
+
+int uORBTest::UnitTest::contention_run(int num_readers)
+{
+	using namespace time_literals;
+
+	orb_test_large_s t{};
+	orb_advert_t ptopic = orb_advertise(ORB_ID(orb_test_large), &t);
+
+	if (ptopic == nullptr) {
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	_contention_copies.store(0);
+	_contention_torn.store(0);
+	_contention_readers.store(0);
+	_thread_should_exit = false;
+
+	char *const args[1] = { nullptr };
+
+	for (int i = 0; i < num_readers; i++) {
+		_contention_readers.fetch_add(1);
+
+		int reader_task = px4_task_spawn_cmd("uorb_contention",
+						     SCHED_DEFAULT,
+						     SCHED_PRIORITY_DEFAULT,
+						     2000,
+						     (px4_main_t)&uORBTest::UnitTest::contention_reader_entry,
+						     args);
+
+		if (reader_task < 0) {
+			_contention_readers.fetch_sub(1);
+			_thread_should_exit = true;
+			return test_fail("failed launching task");
+		}
+	}
+
+	// publish as fast as possible for one second, every message carries a
+	// pattern that lets the readers detect torn copies
+	unsigned published = 0;
+	const hrt_abstime start = hrt_absolute_time();
+
+	while (hrt_elapsed_time(&start) < 1_s) {
+		++t.val;
+		memset(t.junk, t.val & 0xff, sizeof(t.junk));
+		t.timestamp = hrt_absolute_time();
+		orb_publish(ORB_ID(orb_test_large), ptopic, &t);
+		published++;
+
+		// let lower priority readers run on single core targets
+		if ((published % 64) == 0) {
+			px4_usleep(1);
+		}
+	}
+
+	const float elapsed_s = hrt_elapsed_time(&start) * 1e-6f;
+	_thread_should_exit = true;
+
+	while (_contention_readers.load() > 0) {
+		px4_usleep(10 * 1000);
+	}
+
+	const unsigned copies = _contention_copies.load();
+
+	orb_unadvertise(ptopic);
+
+	test_note("%d readers: %.0f publish/s, %.0f copy/s (%.0f per reader)", num_readers,
+		  (double)(published / elapsed_s), (double)(copies / elapsed_s), (double)(copies / elapsed_s / num_readers));
+
+	if (_contention_torn.load() > 0) {
+		return test_fail("%u torn copies with %d readers", _contention_torn.load(), num_readers);
+	}
+
+	return OK;
+}
+
+int uORBTest::UnitTest::contention_reader_entry(int argc, char *argv[])
+{
+	uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+	return t.contention_reader_main();
+}
+
+int uORBTest::UnitTest::contention_reader_main()
+{
+	uORB::Subscription sub{ORB_ID(orb_test_large)};
+	orb_test_large_s t{};
+	unsigned copies = 0;
+	unsigned torn = 0;
+
+	while (!_thread_should_exit) {
+		if (sub.copy(&t)) {
+			copies++;
+
+			for (size_t i = 0; i < sizeof(t.junk); i++) {
+				if (t.junk[i] != (t.val & 0xff)) {
+					torn++;
+					break;
+				}
+			}
+		}
+
+		if ((copies % 64) == 0) {
+			px4_usleep(1);
+		}
+	}
+
+	_contention_copies.fetch_add(copies);
+	_contention_torn.fetch_add(torn);
+	_contention_readers.fetch_sub(1);
+
+	return 0;
+}
+
 int uORBTest::UnitTest::test_fail(const char *fmt, ...)
 {
 	va_list ap;
@@ -42,6 +42,7 @@
 #include <uORB/topics/orb_test_medium.h>
 #include <uORB/topics/orb_test_large.h>
 
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/posix.h>
 #include <px4_platform_common/time.h>
@@ -67,6 +68,7 @@ public:
 
 	int test();
 	int latency_test(bool print);
+	int contention_test();
 	int info();
 
 	// Disallow copy
@@ -115,6 +117,17 @@ private:
 	int test_queue_poll_notify();
 	volatile int _num_messages_sent = 0;
 
+	/* zero-copy publication and subscription */
+	int test_loan_borrow();
+
+	/* publish/copy contention benchmark */
+	int contention_run(int num_readers);
+	static int contention_reader_entry(int argc, char *argv[]);
+	int contention_reader_main();
+	px4::atomic<unsigned> _contention_copies{0};
+	px4::atomic<unsigned> _contention_torn{0};
+	px4::atomic<int> _contention_readers{0};
+
 	int test_fail(const char *fmt, ...);
 	int test_note(const char *fmt, ...);
 };
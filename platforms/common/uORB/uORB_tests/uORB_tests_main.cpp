@@ -39,7 +39,7 @@ extern "C" { __EXPORT int uorb_tests_main(int argc, char *argv[]); }
 
 static void usage()
 {
-	PX4_INFO("Usage: uorb_tests [latency_test]");
+	PX4_INFO("Usage: uorb_tests [latency_test|contention_test]");
 }
 
 int
@@ -70,6 +70,14 @@ uorb_tests_main(int argc, char *argv[])
 		return t.latency_test(true);
 	}
 
+	/*
+	 * Test publish/copy throughput with concurrent readers.
+	 */
+	if (argc > 1 && !strcmp(argv[1], "contention_test")) {
+		uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+		return t.contention_test();
+	}
+
 	usage();
 	return -EINVAL;
 }
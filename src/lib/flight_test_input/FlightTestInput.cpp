@@ -0,0 +1,412 @@
+#include <FlightTestInput.hpp>
+
+#include <systemlib/err.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <controllib/block/BlockParam.hpp>
+#include <systemlib/mavlink_log.h>
+#include <uORB/topics/flight_test_input.h>
+#include <uORB/topics/commander_state.h>
+#include <uORB/topics/vehicle_status.h>
+// _doublet_pulse_length(this, "PULSE_LEN"),
+// _doublet_pulse_amplitude(this, "PULSE_AMP"),
+
+static_assert(MultisineSchedule::MAX_AXES == flight_test_input_s::MAX_AXES, "flight_test_input axes mismatch");
+
+FlightTestInput::FlightTestInput() :
+	SuperBlock(NULL, "FTI"),
+	_state(TEST_INPUT_OFF),
+	_mavlink_log_pub(nullptr),
+	_time_running(0),
+	_raw_output(0),
+	_mode(this, "MODE"),
+	_enable(this, "ENABLE"),
+	_injection_point(this, "INJXN_POINT"),
+	_sweep_duration(this, "FS_DURATION"),
+	_sweep_freq_begin(this, "FS_FRQ_BEGIN"),
+	_sweep_freq_end(this, "FS_FRQ_END"),
+	_sweep_freq_ramp(this, "FS_FRQ_RAMP"),
+	_sweep_amplitude_begin(this, "FS_AMP_BEGIN"),
+	_sweep_amplitude_end(this, "FS_AMP_END"),
+	_loop_gain(this, "LOOP_GAIN"),
+	_multisine_points(this, "MS_POINTS"),
+	_multisine_period(this, "MS_PERIOD"),
+	_multisine_amplitude(this, "MS_AMP"),
+	_update_perf(perf_alloc(PC_ELAPSED, "fti: update")),
+	_flight_test_input_pub(nullptr),
+	_main_state(0),
+	_nav_state(0),
+	_vehicle_status_sub(-1),
+	_commander_state_sub(-1)
+{
+	_flight_test_input = {};
+	_vehicle_status = {};
+	_commander_state = {};
+}
+
+FlightTestInput::~FlightTestInput()
+{
+	perf_free(_update_perf);
+}
+
+void
+FlightTestInput::parameters_update()
+{
+	// values used by a running test are captured during init,
+	// so refreshing all parameters here never alters an active sweep
+	updateParams();
+}
+
+void
+FlightTestInput::update(float dt)
+{
+	perf_begin(_update_perf);
+
+	/* check vehicle status for changes to publication state */
+	vehicle_status_poll();
+	commander_state_poll();
+
+	switch (_state) {
+	case TEST_INPUT_OFF:
+
+		if (!_boot_reset_done) {
+			// never start a test armed from before boot. Done on the first update rather than in the
+			// constructor, so constructing a FlightTestInput leaves the stored parameters alone.
+			_enable.set(0);
+			_enable.commit();
+			_loop_gain.set(_loop_gain_default);
+			_loop_gain.commit();
+			_boot_reset_done = true;
+		}
+
+		_state = TEST_INPUT_WAIT;
+
+		break;
+
+	case TEST_INPUT_WAIT:
+
+		if (_enable.get() == 1) {
+			_state = TEST_INPUT_INIT;
+			_fti_set_loop_gain = _loop_gain.get();
+		}
+
+		perf_end(_update_perf);
+		return;
+
+	case TEST_INPUT_INIT:
+		if (!_init_requested) {
+			// Initialize sweep variables and store current autopilot mode
+			mavlink_log_info(&_mavlink_log_pub, "#Flight test input injection intializing");
+
+			// only use TI (test input) param values as they were set during init
+			_fti_set_mode = _mode.get();
+			_fti_set_injection_point = _injection_point.get();
+
+			for (int axis = 0; axis < MultisineSchedule::MAX_AXES; axis++) {
+				_fti_set_axis_point[axis] = 0;
+				_axis_raw_output[axis] = 0;
+			}
+		}
+
+		if (_fti_set_mode == flight_test_input_s::MODE_MULTISINE) {
+			if (!_init_requested) {
+				// up to MAX_AXES injection points from the FTI_MS_POINTS bitmask, lowest first
+				_fti_set_num_axes = 0;
+
+				for (int point = 1; point <= 9 && _fti_set_num_axes < MultisineSchedule::MAX_AXES; point++) {
+					if (_multisine_points.get() & (1 << (point - 1))) {
+						_fti_set_axis_point[_fti_set_num_axes++] = point;
+					}
+				}
+
+				_fti_set_injection_point = _fti_set_axis_point[0];
+
+				if (_fti_set_num_axes == 0) {
+					mavlink_log_info(&_mavlink_log_pub, "#Flight test input multisine invalid");
+					_state = TEST_INPUT_COMPLETE;
+					break;
+				}
+
+				// precompute all harmonics and phases so the running state only sums table reads,
+				// the controller keeps polling in this state until the build is done
+				_multisine_builder.request(_fti_set_num_axes, _multisine_period.get(), _sweep_freq_begin.get(),
+							   _sweep_freq_end.get(), _multisine_amplitude.get());
+				_init_requested = true;
+			}
+
+			int components = 0;
+
+			if (!_multisine_builder.result(_multisine_schedule, components)) {
+				break;
+			}
+
+			_init_requested = false;
+
+			if (components == 0) {
+				mavlink_log_info(&_mavlink_log_pub, "#Flight test input multisine invalid");
+				_state = TEST_INPUT_COMPLETE;
+				break;
+			}
+
+		} else {
+			_fti_set_num_axes = 1;
+			_fti_set_axis_point[0] = _fti_set_injection_point;
+
+			// precompute the whole sweep so the running state only does table reads
+			_sweep_schedule.build(_sweep_duration.get(), _sweep_freq_begin.get(), _sweep_freq_end.get(),
+					      _sweep_freq_ramp.get(), _sweep_amplitude_begin.get(), _sweep_amplitude_end.get());
+		}
+
+		// abort sweep if any system mode (main_state or nav_state) change
+		_main_state = _commander_state.main_state;
+		_nav_state = _vehicle_status.nav_state;
+
+		_time_running = 0;
+		_raw_output = 0;
+
+		_state = TEST_INPUT_RUNNING;
+		break;
+
+	case TEST_INPUT_RUNNING:
+		// only run if main state and nav state are unchanged and sweep mode is valid
+		if ((_main_state == _commander_state.main_state)
+		    && (_nav_state == _vehicle_status.nav_state)
+		    && (_enable.get() == 1)
+		    && (_fti_set_mode == 0 || _fti_set_mode == 1 || _fti_set_mode == 2)
+		   ) {
+
+			if (_fti_set_mode == 0) {
+				// Frequency sweep mode
+				computeSweep();
+
+			} else if (_fti_set_mode == 2) {
+				// Multi-axis multisine mode
+				computeMultisine();
+			}
+			// } else if (_fti_set_mode == 1) {
+			// 	// Doublet mode
+			// 	computeDoublet(dt);
+			// }
+
+			// increment time
+			_time_running += dt;
+
+		} else {
+			mavlink_log_info(&_mavlink_log_pub, "#Flight test input aborted");
+			_state = TEST_INPUT_COMPLETE;
+		}
+
+		break;
+
+	case TEST_INPUT_COMPLETE:
+
+		_raw_output = 0;
+
+		_flight_test_input.sweep_time_segment_pct = 0;
+		_flight_test_input.sweep_frequency = 0;
+		_flight_test_input.sweep_amplitude = 0;
+
+		_flight_test_input.doublet_amplitude = 0;
+
+		_flight_test_input.injection_input = 0;
+		_flight_test_input.injection_output = 0;
+
+		for (int axis = 0; axis < MultisineSchedule::MAX_AXES; axis++) {
+			_axis_raw_output[axis] = 0;
+			_flight_test_input.axes[axis].injection_input = 0;
+			_flight_test_input.axes[axis].injection_output = 0;
+		}
+
+		// only return to off state once param is reset to 0
+		if (_enable.get() == 0) {
+			mavlink_log_info(&_mavlink_log_pub, "#Flight test input resetting");
+			_state = TEST_INPUT_OFF;
+			_loop_gain.set(_loop_gain_default);
+			_loop_gain.commit();
+		}
+
+		break;
+	}
+
+	const bool was_running = (_flight_test_input.state == TEST_INPUT_RUNNING);
+
+	// arm the inject() fast path only for the points of a running test
+	_active_points = 0;
+
+	if (_state == TEST_INPUT_RUNNING) {
+		for (int axis = 0; axis < _fti_set_num_axes; axis++) {
+			if ((_fti_set_axis_point[axis] > 0) && (_fti_set_axis_point[axis] <= fti::INJECTION_POINT_MAX)) {
+				_active_points |= fti::injection_point_bit(_fti_set_axis_point[axis]);
+			}
+		}
+	}
+
+	_flight_test_input.timestamp = hrt_absolute_time();
+	_flight_test_input.state = _state;
+	_flight_test_input.mode = _fti_set_mode;
+	_flight_test_input.injection_point = _fti_set_injection_point;
+	_flight_test_input.raw_output = _raw_output;
+
+	for (int axis = 0; axis < MultisineSchedule::MAX_AXES; axis++) {
+		_flight_test_input.axes[axis].timestamp = _flight_test_input.timestamp;
+		_flight_test_input.axes[axis].injection_point = _fti_set_axis_point[axis];
+		_flight_test_input.axes[axis].raw_output = _axis_raw_output[axis];
+	}
+
+	if (_flight_test_input_pub != nullptr) {
+		// PX4_INFO("publishing");
+		orb_publish(ORB_ID(flight_test_input), _flight_test_input_pub, &_flight_test_input);
+
+	} else {
+		// PX4_INFO("advertizing");
+		_flight_test_input_pub = orb_advertise_queue(ORB_ID(flight_test_input), &_flight_test_input,
+					 flight_test_input_s::ORB_QUEUE_LENGTH);
+	}
+
+	// hand the samples of a running sweep (and its end) to the estimator
+	if (was_running || (_state == TEST_INPUT_RUNNING)) {
+		_frequency_response.ScheduleNow();
+	}
+
+	perf_end(_update_perf);
+}
+
+void
+FlightTestInput::computeSweep()
+{
+	SweepSchedule::Sample sample;
+
+	if (_sweep_schedule.sample(_time_running, sample)) {
+		_raw_output = sample.output;
+		_axis_raw_output[0] = _raw_output;
+
+		_flight_test_input.sweep_time_segment_pct = sample.time_segment_pct;
+		_flight_test_input.sweep_amplitude = sample.amplitude;
+		_flight_test_input.sweep_frequency = sample.frequency;
+
+	} else {
+		mavlink_log_info(&_mavlink_log_pub, "#Frequency Sweep complete");
+		_state = TEST_INPUT_COMPLETE;
+		_loop_gain.set(_loop_gain_default);
+		_loop_gain.commit();
+	}
+}
+
+void
+FlightTestInput::computeMultisine()
+{
+	// the multisine repeats every FTI_MS_PERIOD and runs for FTI_FS_DURATION
+	if (_time_running <= _sweep_duration.get()) {
+		for (int axis = 0; axis < _fti_set_num_axes; axis++) {
+			_axis_raw_output[axis] = _multisine_schedule.sample(axis, _time_running);
+		}
+
+		_raw_output = _axis_raw_output[0];
+
+	} else {
+		mavlink_log_info(&_mavlink_log_pub, "#Multisine complete");
+		_state = TEST_INPUT_COMPLETE;
+		_loop_gain.set(_loop_gain_default);
+		_loop_gain.commit();
+	}
+}
+
+// void
+// FlightTestInput::computeDoublet(float dt)
+// {
+// 	//
+// 	//          FTI_PULSE_LEN
+// 	//           |~~~~~~~~~|
+// 	//           |         |
+// 	//           |         |
+// 	//     1s    |         |             1s
+// 	//  ~~~~~~~~~|         |         |~~~~~~~~~~
+// 	//                     |         |
+// 	//                     |         |
+// 	//                     |         |
+// 	//                     |~~~~~~~~~|
+// 	//                     FTI_PULSE_LEN
+// 	//
+
+// 	const float lead_in_time = 1;
+// 	const float lead_out_time = 1;
+
+// 	if (_time_running < lead_in_time) {
+// 		// lead in
+// 		_raw_output = 0;
+
+// 	} else if (_time_running < (lead_in_time + _doublet_pulse_length.get())) {
+// 		_raw_output = _doublet_pulse_amplitude.get();
+
+// 	} else if (_time_running < (lead_in_time + 2 * _doublet_pulse_length.get())) {
+// 		_raw_output = -_doublet_pulse_amplitude.get();
+
+// 	} else if (_time_running < (lead_in_time + 2 * _doublet_pulse_length.get() + lead_out_time)) {
+// 		// lead out
+// 		_raw_output = 0;
+
+// 	} else {
+// 		mavlink_log_info(&_mavlink_log_pub, "#Doublet complete");
+// 		_state = TEST_INPUT_COMPLETE;
+// 	}
+
+// 	// _flight_test_input.doublet_amplitude = _raw_output;
+// }
+
+float
+FlightTestInput::injectActive(const uint8_t injection_point, const float inject_input)
+{
+	float inject_output = inject_input;
+
+	if (_state == TEST_INPUT_RUNNING) {
+		for (int axis = 0; axis < _fti_set_num_axes; axis++) {
+			if (injection_point == _fti_set_axis_point[axis]) {
+				inject_output = (inject_input * _fti_set_loop_gain) + _axis_raw_output[axis];
+
+				// update logging
+				_flight_test_input.axes[axis].injection_input = inject_input;
+				_flight_test_input.axes[axis].injection_output = inject_output;
+
+				if (axis == 0) {
+					_flight_test_input.injection_input = inject_input;
+					_flight_test_input.injection_output = inject_output;
+				}
+
+				break;
+			}
+		}
+	}
+
+	return inject_output;
+}
+
+void
+FlightTestInput::vehicle_status_poll()
+{
+	if (_vehicle_status_sub <= 0) {
+		_vehicle_status_sub = orb_subscribe(ORB_ID(vehicle_status));
+	}
+
+	bool vehicle_status_updated;
+	orb_check(_vehicle_status_sub, &vehicle_status_updated);
+
+	if (vehicle_status_updated) {
+		orb_copy(ORB_ID(vehicle_status), _vehicle_status_sub, &_vehicle_status);
+	}
+}
+
+void
+FlightTestInput::commander_state_poll()
+{
+	if (_commander_state_sub <= 0) {
+		_commander_state_sub = orb_subscribe(ORB_ID(commander_state));
+	}
+
+	bool commander_state_updated;
+	orb_check(_commander_state_sub, &commander_state_updated);
+
+	if (commander_state_updated) {
+		orb_copy(ORB_ID(commander_state), _commander_state_sub, &_commander_state);
+	}
+}
@@ -0,0 +1,164 @@
+/*
+ *  UMKC FASTLAB
+ *  - provides attitude controller frequency injection for the purpose of system identification
+ */
+
+#ifndef FLIGHTTESTINPUT_H
+#define FLIGHTTESTINPUT_H
+
+#include <mathlib/mathlib.h>
+#include <stdint.h>
+
+#include <controllib/block/BlockParam.hpp>
+#include <lib/perf/perf_counter.h>
+#include <systemlib/mavlink_log.h>
+#include <uORB/topics/flight_test_input.h>
+#include <uORB/topics/commander_state.h>
+#include <uORB/topics/vehicle_status.h>
+
+#include "FrequencyResponseEstimator.hpp"
+#include "InjectionPoint.hpp"
+#include "MultisineBuilder.hpp"
+#include "MultisineSchedule.hpp"
+#include "SweepSchedule.hpp"
+
+class __EXPORT FlightTestInput : public control::SuperBlock
+{
+public:
+	FlightTestInput();
+	~FlightTestInput();
+
+	// Update test input computation
+	void update(float dt);
+
+	// Refresh parameters, called from the owner's parameter_update handling
+	void parameters_update();
+
+	/**
+	 * Inject the current test input at a compile time injection point.
+	 * Without a running test on that point this is a single bit test on a
+	 * branch predicted not taken.
+	 */
+	template<fti::InjectionPoint P>
+	inline float inject(const float inject_input)
+	{
+		static_assert(P != fti::InjectionPoint::NONE, "invalid injection point");
+
+		if (__builtin_expect((_active_points & fti::injection_point_bit(P)) != 0, 0)) {
+			return injectActive(static_cast<uint8_t>(P), inject_input);
+		}
+
+		return inject_input;
+	}
+
+	/**
+	 * Inject the current test input into a roll, pitch, yaw triplet.
+	 */
+	template<fti::InjectionPoint ROLL, fti::InjectionPoint PITCH, fti::InjectionPoint YAW>
+	inline void inject(float &roll, float &pitch, float &yaw)
+	{
+		if (__builtin_expect(_active_points != 0, 0)) {
+			roll = inject<ROLL>(roll);
+			pitch = inject<PITCH>(pitch);
+			yaw = inject<YAW>(yaw);
+		}
+	}
+
+private:
+
+	float injectActive(const uint8_t injection_point, const float inject_input);
+
+	enum FlightTestInputState {
+		TEST_INPUT_OFF = 0,
+		TEST_INPUT_WAIT,
+		TEST_INPUT_INIT,
+		TEST_INPUT_RUNNING,
+		TEST_INPUT_COMPLETE
+	} _state;
+
+	void computeSweep();
+	void computeMultisine();
+	// void computeDoublet(float dt);
+
+	orb_advert_t	_mavlink_log_pub;
+	// _doublet_pulse_length(this, "PULSE_LEN"),
+	// _doublet_pulse_amplitude(this, "PULSE_AMP"),
+	float _time_running;
+	float _raw_output;
+
+	//fti_loop_gain
+	float _fti_set_loop_gain;
+	float _loop_gain_default = 1;
+
+	// FTI_ENABLE and FTI_LOOP_GAIN were reset on the first update
+	bool _boot_reset_done{false};
+
+	// mode and injection point captured during test input init
+	int32_t _fti_set_mode{0};
+	int32_t _fti_set_injection_point{0};
+
+	// injection points excited at once, axis 0 is the only one outside multisine mode
+	uint8_t _fti_set_axis_point[MultisineSchedule::MAX_AXES] {};
+	int _fti_set_num_axes{0};
+
+	// injection point bits of a running test, 0 otherwise
+	uint16_t _active_points{0};
+	float _axis_raw_output[MultisineSchedule::MAX_AXES] {};
+
+	// frequency sweep schedule, built during test input init
+	SweepSchedule _sweep_schedule;
+
+	// multi-axis multisine components, built on wq:lp_default during test input init
+	MultisineSchedule _multisine_schedule;
+	MultisineBuilder _multisine_builder;
+	bool _init_requested{false};
+
+	// onboard frequency response of the running sweep, runs on wq:lp_default
+	FrequencyResponseEstimator _frequency_response{_sweep_schedule};
+
+	perf_counter_t _update_perf;
+
+	/** parameters **/
+	control::BlockParamInt _mode;
+	control::BlockParamInt _enable;
+	control::BlockParamInt _injection_point;
+
+	/** frequency sweep parameters **/
+	control::BlockParamFloat _sweep_duration;
+	control::BlockParamFloat _sweep_freq_begin;
+	control::BlockParamFloat _sweep_freq_end;
+	control::BlockParamFloat _sweep_freq_ramp;
+	control::BlockParamFloat _sweep_amplitude_begin;
+	control::BlockParamFloat _sweep_amplitude_end;
+	control::BlockParamFloat _loop_gain;
+
+	/** multisine parameters **/
+	control::BlockParamInt _multisine_points;
+	control::BlockParamFloat _multisine_period;
+	control::BlockParamFloat _multisine_amplitude;
+
+
+	// /** doublet parameters **/
+	// control::BlockParamFloat _doublet_pulse_length;
+	// control::BlockParamFloat _doublet_pulse_amplitude;
+
+	orb_advert_t _flight_test_input_pub;
+	struct flight_test_input_s _flight_test_input;
+
+	// system main_state and nav_state captured during test input init
+	uint8_t _main_state;
+	uint8_t _nav_state;
+
+	// check for vehicle status updates.
+	int _vehicle_status_sub;
+	int _commander_state_sub;
+
+	struct vehicle_status_s _vehicle_status;
+	struct commander_state_s _commander_state;
+
+	void vehicle_status_poll();
+	void commander_state_poll();
+
+};
+
+#endif // FLIGHTTESTINPUT_H
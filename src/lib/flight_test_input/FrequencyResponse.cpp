@@ -0,0 +1,208 @@
+#include "FrequencyResponse.hpp"
+
+#include <mathlib/mathlib.h>
+#include <px4_platform_common/defines.h>
+
+void
+FrequencyResponse::configure(const SweepSchedule &sweep)
+{
+	_duration = sweep.duration();
+
+	const float f_low = math::max(math::min(sweep.frequency_begin(), sweep.frequency_end()), 0.01f);
+	const float f_high = math::max(math::max(sweep.frequency_begin(), sweep.frequency_end()), f_low);
+
+	// a bin needs MIN_CYCLES periods within the sweep, lower bins would never be reported
+	const float f_min = math::constrain(MIN_CYCLES / _duration, f_low, f_high);
+	const float ratio = powf(f_high / f_min, 1.f / (NUM_BINS - 1));
+
+	for (int i = 0; i < NUM_BINS; i++) {
+		Bin &bin = _bins[i];
+		bin = {};
+		bin.frequency = f_min * powf(ratio, static_cast<float>(i));
+		bin.omega = M_TWOPI_F * bin.frequency;
+		bin.lanes[0].index = -1;
+		bin.lanes[1].index = -1;
+
+		if (bin.frequency * _duration < MIN_CYCLES * 0.99f) {
+			// only if the whole swept range is below MIN_CYCLES / duration
+			continue;
+		}
+
+		// the sweep excites the bin while it is between the neighbouring bins,
+		// the edge bins also take everything beyond them
+		const float band_low = (i == 0) ? 0.f : bin.frequency / ratio;
+		const float band_high = (i == NUM_BINS - 1) ? INFINITY : bin.frequency * ratio;
+		const float t_low = sweep.time_at_frequency(band_low);
+		const float t_high = sweep.time_at_frequency(band_high);
+
+		const float window = math::min(math::max(fabsf(t_high - t_low), MIN_CYCLES / bin.frequency), _duration);
+		const float center = 0.5f * (t_low + t_high);
+
+		bin.window_begin = math::constrain(center - 0.5f * window, 0.f, _duration - window);
+
+		// n segments with 50 % overlap cover (n + 1) / 2 segment lengths
+		const int max_segments = static_cast<int>(2.f * window * bin.frequency / CYCLES_PER_SEGMENT) - 1;
+		bin.num_segments = math::max(max_segments, 2);
+		bin.segment_length = 2.f * window / static_cast<float>(bin.num_segments + 1);
+		bin.hann_omega = M_TWOPI_F / bin.segment_length;
+	}
+}
+
+void
+FrequencyResponse::update(float t, float dt, float e, float u)
+{
+	for (Bin &bin : _bins) {
+		if (bin.segment_length <= 0.f) {
+			continue;
+		}
+
+		// segment j starts at j half segment lengths into the window
+		const float window_time = t - bin.window_begin;
+
+		if (window_time < 0.f) {
+			continue;
+		}
+
+		const int half = static_cast<int>(window_time / (0.5f * bin.segment_length));
+
+		if (half > bin.num_segments) {
+			if (bin.in_window) {
+				finish(bin);
+			}
+
+			continue;
+		}
+
+		if (bin.in_window) {
+			rotate(bin.kernel_re, bin.kernel_im, bin.omega * dt);
+			rotate(bin.hann_re, bin.hann_im, bin.hann_omega * dt);
+
+		} else {
+			// the kernel phase is arbitrary, the cross spectrum only depends on the phase difference
+			bin.in_window = true;
+			bin.kernel_re = 1.f;
+			bin.kernel_im = 0.f;
+			bin.hann_re = cosf(bin.hann_omega * window_time);
+			bin.hann_im = sinf(bin.hann_omega * window_time);
+		}
+
+		for (int lane = 0; lane < 2; lane++) {
+			Segment &segment = bin.lanes[lane];
+			int index = ((half & 1) == lane) ? half : half - 1;
+
+			if ((index < 0) || (index >= bin.num_segments)) {
+				index = -1;
+			}
+
+			if (index != segment.index) {
+				closeSegment(bin, segment);
+				segment.index = index;
+			}
+
+			if (index < 0) {
+				continue;
+			}
+
+			// the Hann window of an odd segment is shifted by half a period of hann_omega
+			const float hann_cos = (index & 1) ? -bin.hann_re : bin.hann_re;
+			const float weight = 0.5f * (1.f - hann_cos) * dt;
+
+			// conj(kernel) DFT of the windowed segment
+			segment.e_re += e * bin.kernel_re * weight;
+			segment.e_im -= e * bin.kernel_im * weight;
+			segment.u_re += u * bin.kernel_re * weight;
+			segment.u_im -= u * bin.kernel_im * weight;
+			segment.time += dt;
+		}
+	}
+}
+
+void
+FrequencyResponse::finish()
+{
+	for (Bin &bin : _bins) {
+		finish(bin);
+	}
+}
+
+void
+FrequencyResponse::finish(Bin &bin)
+{
+	for (Segment &segment : bin.lanes) {
+		closeSegment(bin, segment);
+		segment.index = -1;
+	}
+
+	bin.in_window = false;
+}
+
+void
+FrequencyResponse::rotate(float &re, float &im, float angle)
+{
+	// a 7th order polynomial is exact to float precision for the phase steps
+	// of a sweep sampled at the controller rate
+	float c;
+	float s;
+
+	if (fabsf(angle) < 0.5f) {
+		const float x2 = angle * angle;
+		c = 1.f - 0.5f * x2 * (1.f - x2 * (1.f / 12.f) * (1.f - x2 * (1.f / 30.f)));
+		s = angle * (1.f - x2 * (1.f / 6.f) * (1.f - x2 * (1.f / 20.f) * (1.f - x2 * (1.f / 42.f))));
+
+	} else {
+		c = cosf(angle);
+		s = sinf(angle);
+	}
+
+	const float rotated_re = re * c - im * s;
+	const float rotated_im = im * c + re * s;
+
+	// keep the phasor on the unit circle
+	const float scale = 0.5f * (3.f - (rotated_re * rotated_re + rotated_im * rotated_im));
+	re = rotated_re * scale;
+	im = rotated_im * scale;
+}
+
+void
+FrequencyResponse::closeSegment(Bin &bin, Segment &segment)
+{
+	// only segments that saw (almost) all of their samples count,
+	// an aborted sweep or lost samples leave partial ones
+	if ((segment.index >= 0) && (segment.time > 0.9f * bin.segment_length)) {
+		bin.g_ee += segment.e_re * segment.e_re + segment.e_im * segment.e_im;
+		bin.g_uu += segment.u_re * segment.u_re + segment.u_im * segment.u_im;
+
+		// conj(E) * U
+		bin.g_eu_re += segment.e_re * segment.u_re + segment.e_im * segment.u_im;
+		bin.g_eu_im += segment.e_re * segment.u_im - segment.e_im * segment.u_re;
+
+		if (bin.segments < UINT16_MAX) {
+			bin.segments++;
+		}
+	}
+
+	segment.time = 0.f;
+	segment.e_re = 0.f;
+	segment.e_im = 0.f;
+	segment.u_re = 0.f;
+	segment.u_im = 0.f;
+}
+
+bool
+FrequencyResponse::result(int i, float &gain, float &phase, float &coherence) const
+{
+	const Bin &bin = _bins[i];
+
+	// a single segment always has unit coherence, so require averaging
+	if ((bin.segments < 2) || !(bin.g_ee > FLT_EPSILON) || !(bin.g_uu > FLT_EPSILON)) {
+		return false;
+	}
+
+	const float g_eu_sq = bin.g_eu_re * bin.g_eu_re + bin.g_eu_im * bin.g_eu_im;
+
+	gain = 10.f * log10f(g_eu_sq / (bin.g_ee * bin.g_ee));
+	phase = math::degrees(atan2f(bin.g_eu_im, bin.g_eu_re));
+	coherence = g_eu_sq / (bin.g_ee * bin.g_uu);
+
+	return true;
+}
@@ -0,0 +1,104 @@
+/*
+ *  UMKC FASTLAB
+ *  - frequency response of a sweep from a bank of single bin DFTs
+ *
+ *  Every bin is integrated only over the part of the sweep that excites it: the
+ *  time the sweep spends between the neighbouring bins, widened to at least
+ *  MIN_CYCLES periods of the bin frequency. The window is split into Hann windowed
+ *  segments with 50 % overlap whose auto and cross spectra are averaged. The bins
+ *  are log spaced over the part of the swept range the sweep duration can resolve.
+ *  The DFT kernel and the Hann window of a bin are phasors rotated once per sample.
+ */
+
+#ifndef FREQUENCYRESPONSE_H
+#define FREQUENCYRESPONSE_H
+
+#include <stdint.h>
+
+#include "SweepSchedule.hpp"
+
+class FrequencyResponse
+{
+public:
+	static constexpr int NUM_BINS = 32;
+	static constexpr float MIN_CYCLES = 2.f;	///< shortest integration window in bin periods, two segments
+
+	FrequencyResponse() = default;
+	~FrequencyResponse() = default;
+
+	/**
+	 * Place the bins and their integration windows on a sweep. Called at sweep start.
+	 */
+	void configure(const SweepSchedule &sweep);
+
+	/**
+	 * Feed one sample.
+	 *
+	 * @param t sweep time of the sample [s]
+	 * @param dt time since the previous sample [s]
+	 * @param e excitation, the signal after the test input is added
+	 * @param u response, the loop return at the injection point
+	 */
+	void update(float t, float dt, float e, float u);
+
+	/**
+	 * Close the segments still open at the end of the sweep.
+	 */
+	void finish();
+
+	/**
+	 * Response u / e of a bin.
+	 *
+	 * @param gain [dB]
+	 * @param phase [deg]
+	 * @param coherence magnitude squared coherence [0, 1]
+	 * @return false if the bin was not averaged over at least two segments
+	 */
+	bool result(int i, float &gain, float &phase, float &coherence) const;
+
+	float duration() const { return _duration; }
+	float frequency(int i) const { return _bins[i].frequency; }
+	uint16_t segments(int i) const { return _bins[i].segments; }
+
+private:
+	static constexpr float CYCLES_PER_SEGMENT = 1.f;	///< shortest segment in bin periods
+
+	// two segments overlap at any time, one in each lane
+	struct Segment {
+		int index;	///< segment in the bin window, -1 if none is open
+		float time;
+		float e_re, e_im;
+		float u_re, u_im;
+	};
+
+	struct Bin {
+		float frequency;	///< bin center frequency [Hz]
+		float omega;		///< [rad/s]
+		float window_begin;	///< sweep time the integration window starts at [s]
+		float segment_length;	///< [s], 0 if the sweep cannot resolve the bin
+		float hann_omega;	///< [rad/s]
+		int num_segments;
+
+		// DFT kernel and Hann window phasors, running from the first sample in the window
+		bool in_window;
+		float kernel_re, kernel_im;
+		float hann_re, hann_im;
+
+		Segment lanes[2];
+
+		// accumulated auto and cross spectra
+		float g_ee;
+		float g_uu;
+		float g_eu_re, g_eu_im;
+		uint16_t segments;
+	};
+
+	static void finish(Bin &bin);
+	static void rotate(float &re, float &im, float angle);
+	static void closeSegment(Bin &bin, Segment &segment);
+
+	Bin _bins[NUM_BINS] {};
+	float _duration{0.f};
+};
+
+#endif // FREQUENCYRESPONSE_H
@@ -0,0 +1,77 @@
+#include "FrequencyResponseEstimator.hpp"
+
+#include <mathlib/mathlib.h>
+#include <px4_platform_common/defines.h>
+
+FrequencyResponseEstimator::FrequencyResponseEstimator(const SweepSchedule &sweep) :
+	WorkItem("fti_frequency_response", px4::wq_configurations::lp_default),
+	_sweep(sweep)
+{
+}
+
+FrequencyResponseEstimator::~FrequencyResponseEstimator()
+{
+	ScheduleClear();
+	perf_free(_cycle_perf);
+}
+
+void
+FrequencyResponseEstimator::Run()
+{
+	perf_begin(_cycle_perf);
+
+	// drain everything the controller queued since the last run
+	flight_test_input_s fti;
+
+	while (_flight_test_input_sub.update(&fti)) {
+
+		// the bins are placed on the sweep schedule, so only sweeps are estimated
+		if ((fti.state == flight_test_input_s::STATE_RUNNING) && (fti.mode == flight_test_input_s::MODE_SWEEP)) {
+			// the sweep time is what the controller integrated the sweep phase over
+			const float t = fti.sweep_time_segment_pct * _sweep.duration();
+
+			if (!_running) {
+				_response.configure(_sweep);
+				_running = true;
+				_last_time = t;
+				_injection_point = static_cast<uint8_t>(fti.injection_point);
+			}
+
+			const float dt = math::constrain(t - _last_time, 0.f, 0.1f);
+			_last_time = t;
+			_last_segment_pct = fti.sweep_time_segment_pct;
+
+			_response.update(t, dt, fti.injection_output, fti.injection_input);
+
+		} else if (_running) {
+			// the sweep either ran to its end or was aborted by a mode change
+			_response.finish();
+			publish(_last_segment_pct > 0.99f);
+			_running = false;
+		}
+	}
+
+	perf_end(_cycle_perf);
+}
+
+void
+FrequencyResponseEstimator::publish(bool complete)
+{
+	flight_test_frequency_response_s report{};
+	report.injection_point = _injection_point;
+	report.complete = complete;
+
+	for (int i = 0; i < FrequencyResponse::NUM_BINS; i++) {
+		report.frequency[i] = _response.frequency(i);
+		report.segments[i] = _response.segments(i);
+
+		if (!_response.result(i, report.gain[i], report.phase[i], report.coherence[i])) {
+			report.gain[i] = NAN;
+			report.phase[i] = NAN;
+			report.coherence[i] = NAN;
+		}
+	}
+
+	report.timestamp = hrt_absolute_time();
+	_frequency_response_pub.publish(report);
+}
@@ -0,0 +1,56 @@
+/*
+ *  UMKC FASTLAB
+ *  - onboard frequency response estimation of flight test input sweeps
+ *
+ *  Runs on wq:lp_default, never in the controller loop. While a sweep is running
+ *  each flight_test_input sample is fed into a FrequencyResponse bank placed on
+ *  the sweep schedule. When the sweep ends, gain, phase and coherence are
+ *  published on flight_test_frequency_response. All state is sized at compile time.
+ */
+
+#ifndef FREQUENCYRESPONSEESTIMATOR_H
+#define FREQUENCYRESPONSEESTIMATOR_H
+
+#include <stdint.h>
+
+#include <lib/perf/perf_counter.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+#include <uORB/Publication.hpp>
+#include <uORB/Subscription.hpp>
+#include <uORB/topics/flight_test_frequency_response.h>
+#include <uORB/topics/flight_test_input.h>
+
+#include "FrequencyResponse.hpp"
+#include "SweepSchedule.hpp"
+
+class FrequencyResponseEstimator : public px4::WorkItem
+{
+public:
+	static_assert(FrequencyResponse::NUM_BINS == flight_test_frequency_response_s::NUM_BINS, "bin count mismatch");
+
+	/**
+	 * @param sweep schedule of the sweeps to estimate, rebuilt only while no sweep is running
+	 */
+	explicit FrequencyResponseEstimator(const SweepSchedule &sweep);
+	~FrequencyResponseEstimator() override;
+
+private:
+	void Run() override;
+
+	void publish(bool complete);
+
+	uORB::Subscription _flight_test_input_sub{ORB_ID(flight_test_input)};
+	uORB::Publication<flight_test_frequency_response_s> _frequency_response_pub{ORB_ID(flight_test_frequency_response)};
+
+	const SweepSchedule &_sweep;
+	FrequencyResponse _response;
+
+	bool _running{false};
+	float _last_time{0.f};	///< sweep time of the last sample [s]
+	float _last_segment_pct{0.f};
+	uint8_t _injection_point{0};
+
+	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, "fti: frequency response")};
+};
+
+#endif // FREQUENCYRESPONSEESTIMATOR_H
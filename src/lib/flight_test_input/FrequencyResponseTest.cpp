@@ -0,0 +1,150 @@
+/*
+ *  UMKC FASTLAB
+ *  - frequency response estimation of a known first order system excited by a sweep
+ */
+
+#include <gtest/gtest.h>
+
+#include <mathlib/mathlib.h>
+#include <px4_platform_common/defines.h>
+
+#include "FrequencyResponse.hpp"
+#include "SweepSchedule.hpp"
+
+class FrequencyResponseTest : public ::testing::Test
+{
+public:
+	static constexpr float DT = 0.004f;		///< 250 Hz controller loop [s]
+	static constexpr float CORNER = 1.f;		///< first order system corner frequency [Hz]
+
+	/**
+	 * Sweep the first order low pass 1 / (s / w_c + 1), discretized with the bilinear
+	 * transform so it adds no sample delay, and estimate its response.
+	 */
+	void run(float duration, float freq_begin, float freq_end, float freq_ramp)
+	{
+		_sweep.build(duration, freq_begin, freq_end, freq_ramp, 1.f, 1.f);
+		_response.configure(_sweep);
+
+		const float k = 0.5f * DT * M_TWOPI_F * CORNER;
+		SweepSchedule::Sample sample{};
+		float e_prev = 0.f;
+		float u = 0.f;
+
+		for (int i = 0; _sweep.sample(i * DT, sample); i++) {
+			const float e = sample.output;
+			u = ((1.f - k) * u + k * (e + e_prev)) / (1.f + k);
+			e_prev = e;
+
+			_response.update(sample.time_segment_pct * _sweep.duration(), (i == 0) ? 0.f : DT, e, u);
+		}
+
+		_response.finish();
+	}
+
+	/**
+	 * Compare every bin with the analytic response.
+	 */
+	void check(float gain_tolerance, float phase_tolerance)
+	{
+		for (int i = 0; i < FrequencyResponse::NUM_BINS; i++) {
+			const float w = _response.frequency(i) / CORNER;
+			const float gain_expected = -10.f * log10f(1.f + w * w);
+			const float phase_expected = -math::degrees(atanf(w));
+
+			float gain = NAN;
+			float phase = NAN;
+			float coherence = NAN;
+			ASSERT_TRUE(_response.result(i, gain, phase, coherence)) << "bin " << i;
+
+			EXPECT_NEAR(gain, gain_expected, gain_tolerance) << _response.frequency(i) << " Hz";
+			EXPECT_NEAR(phase, phase_expected, phase_tolerance) << _response.frequency(i) << " Hz";
+			EXPECT_GT(coherence, 0.9f) << "bin " << i;
+			EXPECT_GE(_response.segments(i), 2);
+		}
+	}
+
+	SweepSchedule _sweep;
+	FrequencyResponse _response;
+};
+
+TEST_F(FrequencyResponseTest, defaultSweep)
+{
+	// FTI_FS_DURATION, FTI_FS_FRQ_BEGIN, FTI_FS_FRQ_END, FTI_FS_FRQ_RAMP defaults
+	run(10.f, 0.1f, 3.f, 3.f);
+
+	// 0.1 Hz is not resolvable in 10 s, the bins start at two periods per sweep
+	EXPECT_FLOAT_EQ(_response.frequency(0), 0.2f);
+	EXPECT_NEAR(_response.frequency(FrequencyResponse::NUM_BINS - 1), 3.f, 1e-4f);
+	check(1.f, 5.f);
+}
+
+TEST_F(FrequencyResponseTest, longSweep)
+{
+	run(30.f, 0.05f, 10.f, 3.f);
+
+	EXPECT_NEAR(_response.frequency(0), 0.0667f, 1e-4f);
+	check(1.f, 5.f);
+}
+
+TEST_F(FrequencyResponseTest, sweepTooShort)
+{
+	// the whole swept range is below two periods per sweep
+	run(1.f, 0.5f, 1.f, 1.f);
+
+	for (int i = 0; i < FrequencyResponse::NUM_BINS; i++) {
+		float gain;
+		float phase;
+		float coherence;
+		EXPECT_FALSE(_response.result(i, gain, phase, coherence));
+		EXPECT_EQ(_response.segments(i), 0);
+	}
+}
+
+TEST_F(FrequencyResponseTest, abortedSweep)
+{
+	_sweep.build(10.f, 0.1f, 3.f, 3.f, 1.f, 1.f);
+	_response.configure(_sweep);
+
+	SweepSchedule::Sample sample{};
+
+	for (int i = 0; (i * DT < 5.f) && _sweep.sample(i * DT, sample); i++) {
+		_response.update(sample.time_segment_pct * _sweep.duration(), DT, sample.output, sample.output);
+	}
+
+	_response.finish();
+
+	// bins the sweep did not reach are not reported
+	float gain;
+	float phase;
+	float coherence;
+	EXPECT_FALSE(_response.result(FrequencyResponse::NUM_BINS - 1, gain, phase, coherence));
+	EXPECT_EQ(_response.segments(FrequencyResponse::NUM_BINS - 1), 0);
+}
+
+TEST(SweepScheduleTest, timeAtFrequency)
+{
+	SweepSchedule sweep;
+	sweep.build(10.f, 0.1f, 3.f, 3.f, 1.f, 1.f);
+
+	for (float t = 0.5f; t < 10.f; t += 0.5f) {
+		SweepSchedule::Sample sample{};
+		ASSERT_TRUE(sweep.sample(t, sample));
+		EXPECT_NEAR(sweep.time_at_frequency(sample.frequency), t, 1e-3f) << sample.frequency << " Hz";
+	}
+
+	EXPECT_FLOAT_EQ(sweep.time_at_frequency(0.f), 0.f);
+	EXPECT_FLOAT_EQ(sweep.time_at_frequency(INFINITY), 10.f);
+
+	// downward sweep
+	sweep.build(20.f, 8.f, 0.5f, 0.5f, 1.f, 1.f);
+
+	for (float t = 0.5f; t < 20.f; t += 0.5f) {
+		SweepSchedule::Sample sample{};
+		ASSERT_TRUE(sweep.sample(t, sample));
+		EXPECT_NEAR(sweep.time_at_frequency(sample.frequency), t, 2e-3f) << sample.frequency << " Hz";
+	}
+
+	EXPECT_FLOAT_EQ(sweep.time_at_frequency(INFINITY), 0.f);
+	EXPECT_FLOAT_EQ(sweep.time_at_frequency(0.f), 20.f);
+}
@@ -0,0 +1,41 @@
+/*
+ *  UMKC FASTLAB
+ *  - injection points a controller can expose to FlightTestInput
+ *
+ *  Injection points are compile time template arguments of FlightTestInput::inject(),
+ *  so every call site resolves to a constant bit test against the active point mask.
+ *  The numbering matches FTI_INJXN_POINT and the FTI_MS_POINTS bits.
+ */
+
+#ifndef INJECTIONPOINT_H
+#define INJECTIONPOINT_H
+
+#include <stdint.h>
+
+namespace fti
+{
+
+enum class InjectionPoint : uint8_t {
+	NONE = 0,
+
+	ACTUATOR_ROLL = 1,
+	ACTUATOR_PITCH = 2,
+	ACTUATOR_YAW = 3,
+
+	RATE_ROLL = 4,
+	RATE_PITCH = 5,
+	RATE_YAW = 6,
+
+	ATTITUDE_ROLL = 7,
+	ATTITUDE_PITCH = 8,
+	ATTITUDE_YAW = 9,
+};
+
+static constexpr uint8_t INJECTION_POINT_MAX = 9;
+
+constexpr uint16_t injection_point_bit(uint8_t point) { return static_cast<uint16_t>(1u << point); }
+constexpr uint16_t injection_point_bit(InjectionPoint point) { return injection_point_bit(static_cast<uint8_t>(point)); }
+
+} // namespace fti
+
+#endif // INJECTIONPOINT_H
@@ -0,0 +1,58 @@
+#include "MultisineBuilder.hpp"
+
+MultisineBuilder::MultisineBuilder() :
+	WorkItem("fti_multisine_builder", px4::wq_configurations::lp_default)
+{
+}
+
+MultisineBuilder::~MultisineBuilder()
+{
+	ScheduleClear();
+	perf_free(_build_perf);
+}
+
+void
+MultisineBuilder::request(int num_axes, float period, float freq_begin, float freq_end, float amplitude)
+{
+	if (_state.load() == REQUESTED) {
+		return;
+	}
+
+	_num_axes = num_axes;
+	_period = period;
+	_freq_begin = freq_begin;
+	_freq_end = freq_end;
+	_amplitude = amplitude;
+
+	_state.store(REQUESTED);
+	ScheduleNow();
+}
+
+bool
+MultisineBuilder::result(MultisineSchedule &schedule, int &components)
+{
+	if (_state.load() != DONE) {
+		return false;
+	}
+
+	schedule = _schedule;
+	components = _components;
+
+	_state.store(IDLE);
+	return true;
+}
+
+void
+MultisineBuilder::Run()
+{
+	if (_state.load() != REQUESTED) {
+		return;
+	}
+
+	perf_begin(_build_perf);
+	_components = _schedule.build(_num_axes, _period, _freq_begin, _freq_end, _amplitude);
+	perf_end(_build_perf);
+
+	// publishes the schedule to the controller
+	_state.store(DONE);
+}
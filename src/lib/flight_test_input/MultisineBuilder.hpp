@@ -0,0 +1,66 @@
+/*
+ *  UMKC FASTLAB
+ *  - builds the multisine schedule off the controller loop
+ *
+ *  MultisineSchedule::build() searches the crest factor peak over a dense grid,
+ *  which takes milliseconds. The controller requests a build when the test is
+ *  armed and polls for the result on its following cycles, the build itself runs
+ *  on wq:lp_default.
+ */
+
+#ifndef MULTISINEBUILDER_H
+#define MULTISINEBUILDER_H
+
+#include <lib/perf/perf_counter.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+
+#include "MultisineSchedule.hpp"
+
+class MultisineBuilder : public px4::WorkItem
+{
+public:
+	MultisineBuilder();
+	~MultisineBuilder() override;
+
+	/**
+	 * Start building a schedule, arguments as MultisineSchedule::build().
+	 * Ignored while a previous build is still running.
+	 */
+	void request(int num_axes, float period, float freq_begin, float freq_end, float amplitude);
+
+	/**
+	 * Take the result of the last request.
+	 *
+	 * @param schedule receives the schedule once the build is done
+	 * @param components receives the number of components per axis, 0 for an invalid schedule
+	 * @return false while the build is still running or nothing was requested
+	 */
+	bool result(MultisineSchedule &schedule, int &components);
+
+private:
+	enum State : int {
+		IDLE = 0,
+		REQUESTED,
+		DONE
+	};
+
+	void Run() override;
+
+	px4::atomic<int> _state{IDLE};
+
+	// build arguments, only written while IDLE
+	int _num_axes{0};
+	float _period{0.f};
+	float _freq_begin{0.f};
+	float _freq_end{0.f};
+	float _amplitude{0.f};
+
+	// build result, only read when DONE
+	MultisineSchedule _schedule;
+	int _components{0};
+
+	perf_counter_t _build_perf{perf_alloc(PC_ELAPSED, "fti: multisine build")};
+};
+
+#endif // MULTISINEBUILDER_H
@@ -0,0 +1,105 @@
+#include "MultisineSchedule.hpp"
+
+#include <mathlib/mathlib.h>
+
+int
+MultisineSchedule::build(int num_axes, float period, float freq_begin, float freq_end, float amplitude)
+{
+	_num_axes = math::constrain(num_axes, 1, MAX_AXES);
+	_period = math::constrain(period, 1.f, 100.f);
+
+	for (int axis = 0; axis < MAX_AXES; axis++) {
+		_num_components[axis] = 0;
+		_amplitude[axis] = 0.f;
+	}
+
+	// harmonics of the fundamental inside the requested band
+	const int harmonic_begin = math::max(static_cast<int>(ceilf(freq_begin * _period)), 1);
+	const int harmonic_end = math::min(static_cast<int>(floorf(freq_end * _period)), static_cast<int>(UINT16_MAX));
+
+	if (harmonic_end < harmonic_begin) {
+		return 0;
+	}
+
+	// equal share of components for every axis
+	const int per_axis = math::min(MAX_COMPONENTS / MAX_AXES, (harmonic_end - harmonic_begin + 1) / _num_axes);
+
+	if (per_axis < 1) {
+		return 0;
+	}
+
+	// log spaced, strictly increasing harmonics, dealt round robin to the axes
+	const int count = per_axis * _num_axes;
+	const float ratio = (count > 1) ? powf(static_cast<float>(harmonic_end) / static_cast<float>(harmonic_begin),
+					       1.f / static_cast<float>(count - 1)) : 1.f;
+	int harmonic = harmonic_begin - 1;
+
+	for (int i = 0; i < count; i++) {
+		const int log_spaced = static_cast<int>(roundf(harmonic_begin * powf(ratio, static_cast<float>(i))));
+
+		// stay below the band edge with enough room for the remaining components
+		harmonic = math::min(math::max(log_spaced, harmonic + 1), harmonic_end - (count - 1 - i));
+
+		const int axis = i % _num_axes;
+		_components[axis][_num_components[axis]++].harmonic = static_cast<uint16_t>(harmonic);
+	}
+
+	for (int axis = 0; axis < _num_axes; axis++) {
+		// Schroeder phases for equal power components, generalised to the actual
+		// (non contiguous) harmonic numbers: phi_k = -2pi sum_{j<k} (n_k - n_j) / M
+		const int m_total = _num_components[axis];
+
+		for (int k = 0; k < m_total; k++) {
+			float phase = 0.f;
+
+			for (int j = 0; j < k; j++) {
+				phase -= static_cast<float>(_components[axis][k].harmonic - _components[axis][j].harmonic)
+					 / static_cast<float>(m_total);
+			}
+
+			_components[axis][k].phase = phase - floorf(phase);
+		}
+
+		// scale to the requested peak, sampled densely enough for the highest harmonic
+		_amplitude[axis] = 1.f;
+		const int highest = _components[axis][m_total - 1].harmonic;
+		const int grid = math::constrain(8 * highest, 256, 4096);
+		float peak = 0.f;
+
+		for (int n = 0; n < grid; n++) {
+			peak = math::max(peak, fabsf(evaluate(axis, static_cast<float>(n) / static_cast<float>(grid))));
+		}
+
+		_amplitude[axis] = (peak > FLT_EPSILON) ? amplitude / peak : 0.f;
+	}
+
+	return per_axis;
+}
+
+float
+MultisineSchedule::sample(int axis, float t) const
+{
+	if ((axis < 0) || (axis >= _num_axes)) {
+		return 0.f;
+	}
+
+	// all components repeat every period, wrap time first to keep float precision
+	float period_pct = t / _period;
+	period_pct -= floorf(period_pct);
+
+	return evaluate(axis, period_pct);
+}
+
+float
+MultisineSchedule::evaluate(int axis, float period_pct) const
+{
+	const SineTable &sine = SineTable::instance();
+	float sum = 0.f;
+
+	for (int m = 0; m < _num_components[axis]; m++) {
+		const Component &c = _components[axis][m];
+		sum += sine.sin_cycles(static_cast<float>(c.harmonic) * period_pct + c.phase);
+	}
+
+	return _amplitude[axis] * sum;
+}
@@ -0,0 +1,66 @@
+/*
+ *  UMKC FASTLAB
+ *  - simultaneous multi-axis multisine excitation for FlightTestInput
+ *
+ *  All components are harmonics of 1 / period, so the signal repeats every period.
+ *  Harmonics are picked log-spaced over the requested band and dealt round robin
+ *  to the axes, which keeps the axes on disjoint (orthogonal) frequency bins.
+ *  Component phases follow Schroeder's low crest factor rule per axis and each axis
+ *  is scaled to the requested peak amplitude. The component table is built once
+ *  when the test is armed, by MultisineBuilder on wq:lp_default since the peak
+ *  search is too expensive for the controller loop.
+ */
+
+#ifndef MULTISINESCHEDULE_H
+#define MULTISINESCHEDULE_H
+
+#include <stdint.h>
+
+#include "SineTable.hpp"
+
+class MultisineSchedule
+{
+public:
+	static constexpr int MAX_AXES = 3;		///< simultaneously excited injection points
+	static constexpr int MAX_COMPONENTS = 48;	///< harmonics over all axes
+
+	MultisineSchedule() = default;
+	~MultisineSchedule() = default;
+
+	/**
+	 * Build the component table.
+	 *
+	 * @param num_axes number of simultaneously excited axes [1, MAX_AXES]
+	 * @param period multisine period [s], sets the frequency resolution 1 / period
+	 * @param freq_begin lowest excited frequency [Hz]
+	 * @param freq_end highest excited frequency [Hz]
+	 * @param amplitude peak amplitude of each axis signal
+	 * @return number of components per axis, 0 if the band holds no harmonic
+	 */
+	int build(int num_axes, float period, float freq_begin, float freq_end, float amplitude);
+
+	/**
+	 * Output of one axis at time t since start.
+	 */
+	float sample(int axis, float t) const;
+
+	int num_axes() const { return _num_axes; }
+
+private:
+	struct Component {
+		uint16_t harmonic;	///< multiple of the fundamental 1 / period
+		float phase;		///< [cycles]
+	};
+
+	float evaluate(int axis, float period_pct) const;
+
+	Component _components[MAX_AXES][MAX_COMPONENTS / MAX_AXES] {};
+	int _num_components[MAX_AXES] {};
+	float _amplitude[MAX_AXES] {};	///< per component amplitude after crest factor scaling
+
+	int _num_axes{0};
+	float _period{1.f};
+
+};
+
+#endif // MULTISINESCHEDULE_H
@@ -0,0 +1,3 @@
+#include "SineTable.hpp"
+
+const SineTable SineTable::_instance;
@@ -0,0 +1,54 @@
+/*
+ *  UMKC FASTLAB
+ *  - sine lookup table shared by the flight test input schedules
+ */
+
+#ifndef SINETABLE_H
+#define SINETABLE_H
+
+#include <mathlib/mathlib.h>
+#include <px4_platform_common/defines.h>
+
+class SineTable
+{
+public:
+	static constexpr int SIZE = 512;	///< table resolution per period
+
+	/**
+	 * The single table instance shared by all schedules.
+	 */
+	static const SineTable &instance() { return _instance; }
+
+	/**
+	 * Sine of an angle given in cycles (1 cycle = 2pi), any sign or magnitude.
+	 */
+	float sin_cycles(float cycles) const
+	{
+		cycles -= floorf(cycles);
+
+		const float pos = cycles * static_cast<float>(SIZE);
+		const int i = math::min(static_cast<int>(pos), SIZE - 1);
+		const float frac = pos - static_cast<float>(i);
+
+		return _sine[i] + (_sine[i + 1] - _sine[i]) * frac;
+	}
+
+	/**
+	 * Sine of an angle given in radians.
+	 */
+	float sin(float phase) const { return sin_cycles(phase * (1.f / M_TWOPI_F)); }
+
+private:
+	SineTable()
+	{
+		for (int i = 0; i <= SIZE; i++) {
+			_sine[i] = sinf(M_TWOPI_F * static_cast<float>(i) / static_cast<float>(SIZE));
+		}
+	}
+
+	static const SineTable _instance;
+
+	float _sine[SIZE + 1] {};
+};
+
+#endif // SINETABLE_H
@@ -0,0 +1,95 @@
+#include "SweepSchedule.hpp"
+
+#include <mathlib/mathlib.h>
+#include <px4_platform_common/defines.h>
+
+void
+SweepSchedule::build(float duration, float freq_begin, float freq_end, float freq_ramp, float amp_begin,
+		     float amp_end)
+{
+	_duration = math::constrain(duration, 0.01f, 1000.0f);
+	_knot_interval = _duration / static_cast<float>(TABLE_SIZE);
+	_knots_per_second = static_cast<float>(TABLE_SIZE) / _duration;
+
+	// the ramp exponent must keep the phase integral finite
+	const float ramp = math::max(freq_ramp, 0.f);
+	const double ramp_scale = 1.0 / (static_cast<double>(ramp) + 1.0);
+
+	for (int i = 0; i <= TABLE_SIZE; i++) {
+		const float pct = static_cast<float>(i) / static_cast<float>(TABLE_SIZE);
+		const double t = static_cast<double>(pct) * static_cast<double>(_duration);
+
+		const float pct_ramp = powf(pct, ramp);
+
+		_amplitude[i] = (amp_end - amp_begin) * pct + amp_begin;
+		_frequency[i] = (freq_end - freq_begin) * pct_ramp + freq_begin;
+
+		// phase(t) = 2pi * integral of frequency(t), evaluated in closed form so the
+		// knots do not accumulate integration drift over long sweeps,
+		// duration * pct^(ramp + 1) = t * pct^ramp reuses the powf() above
+		const double cycles = static_cast<double>(freq_begin) * t
+				      + static_cast<double>(freq_end - freq_begin) * t * static_cast<double>(pct_ramp) * ramp_scale;
+
+		_phase[i] = static_cast<float>((cycles - floor(cycles)) * 2.0 * M_PI);
+	}
+}
+
+bool
+SweepSchedule::sample(float t, Sample &s) const
+{
+	if (!(t <= _duration)) {
+		return false;
+	}
+
+	const float knot = math::max(t, 0.f) * _knots_per_second;
+	const int i = math::min(static_cast<int>(knot), TABLE_SIZE - 1);
+	const float tau = math::max(t, 0.f) - static_cast<float>(i) * _knot_interval;
+	const float frac = tau * _knots_per_second;
+
+	// frequency is interpolated linearly between knots and integrated exactly,
+	// which keeps the phase error third order in the knot interval
+	const float f_delta = _frequency[i + 1] - _frequency[i];
+	const float phase = _phase[i] + M_TWOPI_F * tau * (_frequency[i] + 0.5f * f_delta * frac);
+
+	s.time_segment_pct = t / _duration;
+	s.frequency = _frequency[i] + f_delta * frac;
+	s.amplitude = _amplitude[i] + (_amplitude[i + 1] - _amplitude[i]) * frac;
+	s.output = s.amplitude * SineTable::instance().sin(phase);
+
+	return true;
+}
+
+float
+SweepSchedule::time_at_frequency(float frequency) const
+{
+	// the knot frequencies are monotonic, flip the sign of a downward sweep
+	const float sign = (_frequency[TABLE_SIZE] >= _frequency[0]) ? 1.f : -1.f;
+	const float f = sign * frequency;
+
+	if (!(f > sign * _frequency[0])) {
+		return 0.f;
+	}
+
+	if (f >= sign * _frequency[TABLE_SIZE]) {
+		return _duration;
+	}
+
+	int low = 0;
+	int high = TABLE_SIZE;
+
+	while (high - low > 1) {
+		const int mid = (low + high) / 2;
+
+		if (sign * _frequency[mid] <= f) {
+			low = mid;
+
+		} else {
+			high = mid;
+		}
+	}
+
+	const float f_delta = _frequency[high] - _frequency[low];
+	const float frac = (fabsf(f_delta) > FLT_EPSILON) ? (frequency - _frequency[low]) / f_delta : 0.f;
+
+	return (static_cast<float>(low) + frac) * _knot_interval;
+}
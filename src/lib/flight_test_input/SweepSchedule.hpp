@@ -0,0 +1,75 @@
+/*
+ *  UMKC FASTLAB
+ *  - precomputed frequency sweep schedule for FlightTestInput
+ *
+ *  The sweep is sampled into a fixed table of knots when the test is armed.
+ *  Each knot holds the exact (wrapped) sweep phase, amplitude and frequency,
+ *  so the per-cycle lookup is an indexed read with a short interpolation
+ *  and a sine table read instead of powf()/sinf().
+ */
+
+#ifndef SWEEPSCHEDULE_H
+#define SWEEPSCHEDULE_H
+
+#include <stdint.h>
+
+#include "SineTable.hpp"
+
+class SweepSchedule
+{
+public:
+	static constexpr int TABLE_SIZE = 256;	///< number of sweep knots
+
+	struct Sample {
+		float output;
+		float time_segment_pct;
+		float frequency;
+		float amplitude;
+	};
+
+	SweepSchedule() = default;
+	~SweepSchedule() = default;
+
+	/**
+	 * Build the sweep schedule. Called once when the test input is armed.
+	 *
+	 * @param duration sweep duration [s]
+	 * @param freq_begin start frequency [Hz]
+	 * @param freq_end end frequency [Hz]
+	 * @param freq_ramp frequency ramp exponent (1 = linear)
+	 * @param amp_begin start amplitude
+	 * @param amp_end end amplitude
+	 */
+	void build(float duration, float freq_begin, float freq_end, float freq_ramp, float amp_begin, float amp_end);
+
+	/**
+	 * Sweep sample at time t since sweep start.
+	 *
+	 * @return false once t is past the sweep duration
+	 */
+	bool sample(float t, Sample &s) const;
+
+	/**
+	 * Time since sweep start at which the sweep passes a frequency, with the same
+	 * linear interpolation between knots as sample().
+	 *
+	 * @return 0 or the duration for frequencies outside the swept range
+	 */
+	float time_at_frequency(float frequency) const;
+
+	float duration() const { return _duration; }
+	float frequency_begin() const { return _frequency[0]; }
+	float frequency_end() const { return _frequency[TABLE_SIZE]; }
+
+private:
+	float _phase[TABLE_SIZE + 1] {};	///< sweep phase at knot, wrapped to [0, 2pi)
+	float _frequency[TABLE_SIZE + 1] {};	///< sweep frequency at knot [Hz]
+	float _amplitude[TABLE_SIZE + 1] {};	///< sweep amplitude at knot
+
+
+	float _duration{0.f};
+	float _knot_interval{1.f};
+	float _knots_per_second{0.f};
+};
+
+#endif // SWEEPSCHEDULE_H
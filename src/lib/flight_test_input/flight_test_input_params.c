@@ -7,10 +7,14 @@
 /**
  * Test Input Mode
  *
- * 0 for injecting frequency sweeps, 1 for doublet
+ * 0 for injecting frequency sweeps, 1 for doublet, 2 for simultaneous
+ * multi-axis multisines on the injection points selected by FTI_MS_POINTS
  *
  * @min 0
- * @max 1
+ * @max 2
+ * @value 0 Frequency sweep
+ * @value 1 Doublet
+ * @value 2 Multi-axis multisine
  * @group Flight Test Input
  */
 PARAM_DEFINE_INT32(FTI_MODE, 0);
@@ -129,6 +133,53 @@ PARAM_DEFINE_FLOAT(FTI_FS_FRQ_RAMP, 3.0f);
  */
 PARAM_DEFINE_FLOAT(FTI_LOOP_GAIN, 1.0f);
 
+/**
+ * Test input multisine injection points
+ *
+ * Injection points excited at once in multisine mode. At most three points
+ * are used, lowest first, each on its own set of frequencies.
+ *
+ * @bit 0 Actuators: roll
+ * @bit 1 Actuators: pitch
+ * @bit 2 Actuators: yaw
+ * @bit 3 Rate cmd: roll
+ * @bit 4 Rate cmd: pitch
+ * @bit 5 Rate cmd: yaw
+ * @bit 6 Attitude cmd: roll
+ * @bit 7 Attitude cmd: pitch
+ * @bit 8 Attitude cmd: yaw
+ * @min 0
+ * @max 511
+ * @group Flight Test Input
+ */
+PARAM_DEFINE_INT32(FTI_MS_POINTS, 56);
+
+/**
+ * Test input multisine period
+ *
+ * Period of the multisine. All components are harmonics of 1/period
+ * between FTI_FS_FRQ_BEGIN and FTI_FS_FRQ_END, the test runs for
+ * FTI_FS_DURATION. Use a duration of at least two periods.
+ *
+ * @unit s
+ * @min 1.0
+ * @max 100.0
+ * @decimal 1
+ * @group Flight Test Input
+ */
+PARAM_DEFINE_FLOAT(FTI_MS_PERIOD, 10.0f);
+
+/**
+ * Test input multisine amplitude
+ *
+ * Peak amplitude of the multisine on each injection point
+ *
+ * @min 0.0
+ * @decimal 2
+ * @group Flight Test Input
+ */
+PARAM_DEFINE_FLOAT(FTI_MS_AMP, 0.0f);
+
 // /**
 //  * Test input doublet pulse length
 //  *
@@ -0,0 +1,279 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2021 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "lz4_block.h"
+
+#include <string.h>
+
+namespace lz4
+{
+
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t LAST_LITERALS = 5; ///< the last bytes of a block are always literals
+static constexpr size_t MF_LIMIT = 12; ///< a match must start at least this many bytes before the end
+static constexpr size_t MAX_OFFSET = 65535;
+static constexpr int HASH_BITS = 12;
+static constexpr unsigned SKIP_TRIGGER = 6; ///< speed up over incompressible data after 2^6 misses
+
+static_assert(HASH_TABLE_SIZE == (1u << HASH_BITS), "hash table size mismatch");
+
+static inline uint32_t read32(const uint8_t *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint32_t hash(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/** write a length extension (the part that does not fit into the token), returns false if it does not fit */
+static inline bool write_length(uint8_t *&op, const uint8_t *oend, size_t length)
+{
+	while (length >= 255) {
+		if (op >= oend) {
+			return false;
+		}
+
+		*op++ = 255;
+		length -= 255;
+	}
+
+	if (op >= oend) {
+		return false;
+	}
+
+	*op++ = (uint8_t)length;
+	return true;
+}
+
+/** write literals and optionally a match (match_length excluding MIN_MATCH, offset 0 for the last sequence) */
+static inline bool write_sequence(uint8_t *&op, const uint8_t *oend, const uint8_t *literals, size_t literal_length,
+				  size_t offset, size_t match_length)
+{
+	if (op >= oend) {
+		return false;
+	}
+
+	uint8_t *token = op++;
+	*token = (uint8_t)((literal_length >= 15 ? 15 : literal_length) << 4);
+
+	if (literal_length >= 15 && !write_length(op, oend, literal_length - 15)) {
+		return false;
+	}
+
+	if ((size_t)(oend - op) < literal_length) {
+		return false;
+	}
+
+	memcpy(op, literals, literal_length);
+	op += literal_length;
+
+	if (offset == 0) {
+		return true;
+	}
+
+	if (oend - op < 2) {
+		return false;
+	}
+
+	*op++ = (uint8_t)offset;
+	*op++ = (uint8_t)(offset >> 8);
+
+	*token |= (uint8_t)(match_length >= 15 ? 15 : match_length);
+
+	if (match_length >= 15 && !write_length(op, oend, match_length - 15)) {
+		return false;
+	}
+
+	return true;
+}
+
+size_t compress(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_capacity, uint16_t *hash_table)
+{
+	if (src_size > MAX_INPUT_SIZE) {
+		return 0;
+	}
+
+	const uint8_t *const end = src + src_size;
+	const uint8_t *anchor = src;
+	uint8_t *op = dst;
+	const uint8_t *const oend = dst + dst_capacity;
+
+	if (src_size > MF_LIMIT) {
+		const uint8_t *const mf_limit = end - MF_LIMIT;
+		const uint8_t *const match_limit = end - LAST_LITERALS;
+		const uint8_t *ip = src + 1;
+		unsigned misses = 0;
+
+		for (size_t i = 0; i < HASH_TABLE_SIZE; ++i) {
+			hash_table[i] = 0;
+		}
+
+		while (ip < mf_limit) {
+			const uint32_t sequence = read32(ip);
+			const uint32_t h = hash(sequence);
+			const uint8_t *ref = src + hash_table[h];
+			hash_table[h] = (uint16_t)(ip - src);
+
+			if (ref >= ip || (size_t)(ip - ref) > MAX_OFFSET || read32(ref) != sequence) {
+				ip += 1 + (misses++ >> SKIP_TRIGGER);
+				continue;
+			}
+
+			misses = 0;
+
+			// extend backwards into the pending literals
+			while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+				--ip;
+				--ref;
+			}
+
+			const uint8_t *match_end = ip + MIN_MATCH;
+			const uint8_t *ref_end = ref + MIN_MATCH;
+
+			while (match_end < match_limit && *match_end == *ref_end) {
+				++match_end;
+				++ref_end;
+			}
+
+			if (!write_sequence(op, oend, anchor, ip - anchor, ip - ref, (match_end - ip) - MIN_MATCH)) {
+				return 0;
+			}
+
+			ip = match_end;
+			anchor = ip;
+
+			if (ip < mf_limit) {
+				// index a position inside the match, improves the ratio for repetitive data
+				hash_table[hash(read32(ip - 2))] = (uint16_t)(ip - 2 - src);
+			}
+		}
+	}
+
+	if (!write_sequence(op, oend, anchor, end - anchor, 0, 0)) {
+		return 0;
+	}
+
+	return op - dst;
+}
+
+int decompress(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_capacity)
+{
+	const uint8_t *ip = src;
+	const uint8_t *const iend = src + src_size;
+	uint8_t *op = dst;
+	const uint8_t *const oend = dst + dst_capacity;
+
+	while (ip < iend) {
+		const uint8_t token = *ip++;
+
+		// literals
+		size_t length = token >> 4;
+
+		if (length == 15) {
+			uint8_t s;
+
+			do {
+				if (ip >= iend) {
+					return -1;
+				}
+
+				s = *ip++;
+				length += s;
+			} while (s == 255);
+		}
+
+		if ((size_t)(iend - ip) < length || (size_t)(oend - op) < length) {
+			return -1;
+		}
+
+		memcpy(op, ip, length);
+		ip += length;
+		op += length;
+
+		if (ip == iend) {
+			// the last sequence has no match
+			break;
+		}
+
+		// match
+		if (iend - ip < 2) {
+			return -1;
+		}
+
+		const size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+
+		if (offset == 0 || offset > (size_t)(op - dst)) {
+			return -1;
+		}
+
+		length = token & 15;
+
+		if (length == 15) {
+			uint8_t s;
+
+			do {
+				if (ip >= iend) {
+					return -1;
+				}
+
+				s = *ip++;
+				length += s;
+			} while (s == 255);
+		}
+
+		length += MIN_MATCH;
+
+		if ((size_t)(oend - op) < length) {
+			return -1;
+		}
+
+		// the match can overlap with the output (run-length encoding), so copy byte-wise
+		const uint8_t *match = op - offset;
+
+		for (size_t i = 0; i < length; ++i) {
+			op[i] = match[i];
+		}
+
+		op += length;
+	}
+
+	return (int)(op - dst);
+}
+
+} // namespace lz4
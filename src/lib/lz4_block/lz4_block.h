@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2021 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file lz4_block.h
+ *
+ * Compressor and decompressor for the LZ4 block format
+ * (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md).
+ *
+ * Blocks are self-contained and can be decoded by any LZ4 implementation (e.g. lz4.block.decompress()
+ * in python). The compressor is a greedy single-pass matcher without heap usage, intended for
+ * streaming data on the fly (logging), not for the best compression ratio.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace lz4
+{
+
+/** maximum input size of a single block (match offsets in the hash table are 16 bit) */
+static constexpr size_t MAX_INPUT_SIZE = 65535;
+
+/** number of entries of the hash table that needs to be passed to compress() */
+static constexpr size_t HASH_TABLE_SIZE = 1 << 12;
+
+/**
+ * @return maximum compressed size for a given input size (incompressible data)
+ */
+static constexpr size_t compress_bound(size_t input_size)
+{
+	return input_size + input_size / 255 + 16;
+}
+
+/**
+ * Compress a block.
+ * @param src input data
+ * @param src_size input size, at most MAX_INPUT_SIZE
+ * @param dst output buffer
+ * @param dst_capacity size of dst. Compression can fail if it is smaller than compress_bound(src_size).
+ * @param hash_table scratch memory of HASH_TABLE_SIZE entries, no need to initialize it
+ * @return compressed size, or 0 if the input is too large or the output does not fit
+ */
+size_t compress(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_capacity, uint16_t *hash_table);
+
+/**
+ * Decompress a block. All input is validated, the output never exceeds dst_capacity.
+ * @param src compressed block
+ * @param src_size size of the compressed block
+ * @param dst output buffer
+ * @param dst_capacity size of dst
+ * @return decompressed size, or -1 if the block is malformed or does not fit into dst
+ */
+int decompress(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_capacity);
+
+} // namespace lz4
@@ -0,0 +1,151 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2021 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <gtest/gtest.h>
+#include "lz4_block.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+class Lz4BlockTest : public ::testing::Test
+{
+public:
+	/** compress and decompress, check the result and return the compressed size */
+	size_t roundTrip(const uint8_t *data, size_t size)
+	{
+		uint8_t compressed[lz4::compress_bound(sizeof(_input))];
+		const size_t compressed_size = lz4::compress(data, size, compressed, sizeof(compressed), _hash_table);
+		EXPECT_GT(compressed_size, 0u);
+		EXPECT_LE(compressed_size, lz4::compress_bound(size));
+
+		uint8_t decompressed[sizeof(_input)];
+		const int decompressed_size = lz4::decompress(compressed, compressed_size, decompressed, sizeof(decompressed));
+		EXPECT_EQ(decompressed_size, (int)size);
+		EXPECT_EQ(memcmp(data, decompressed, size), 0);
+		return compressed_size;
+	}
+
+	uint8_t _input[8192];
+	uint16_t _hash_table[lz4::HASH_TABLE_SIZE];
+};
+
+TEST_F(Lz4BlockTest, Empty)
+{
+	roundTrip(_input, 0);
+}
+
+TEST_F(Lz4BlockTest, ShortInput)
+{
+	for (size_t size = 1; size < 20; ++size) {
+		memset(_input, 'a', size);
+		roundTrip(_input, size);
+	}
+}
+
+TEST_F(Lz4BlockTest, RepetitiveData)
+{
+	for (size_t i = 0; i < sizeof(_input); ++i) {
+		_input[i] = (uint8_t)(i % 7);
+	}
+
+	const size_t compressed_size = roundTrip(_input, sizeof(_input));
+	EXPECT_LT(compressed_size, sizeof(_input) / 20);
+}
+
+TEST_F(Lz4BlockTest, StructuredData)
+{
+	// log-like records: a slowly increasing timestamp and a few slowly changing values
+	for (size_t i = 0; i + 16 <= sizeof(_input); i += 16) {
+		const uint64_t timestamp = 1000000 + i * 250;
+		const uint32_t value = 42 + (i / 512);
+		memcpy(&_input[i], &timestamp, sizeof(timestamp));
+		memcpy(&_input[i + 8], &value, sizeof(value));
+		memcpy(&_input[i + 12], "D\x10\x00\x01", 4);
+	}
+
+	const size_t compressed_size = roundTrip(_input, sizeof(_input));
+	EXPECT_LT(compressed_size, sizeof(_input) / 2);
+}
+
+TEST_F(Lz4BlockTest, RandomData)
+{
+	srand(0);
+
+	for (size_t i = 0; i < sizeof(_input); ++i) {
+		_input[i] = (uint8_t)rand();
+	}
+
+	roundTrip(_input, sizeof(_input));
+
+	for (size_t size = 1; size < sizeof(_input); size = size * 3 + 1) {
+		roundTrip(_input, size);
+	}
+}
+
+TEST_F(Lz4BlockTest, OutputTooSmall)
+{
+	srand(1);
+
+	for (size_t i = 0; i < sizeof(_input); ++i) {
+		_input[i] = (uint8_t)rand();
+	}
+
+	uint8_t compressed[sizeof(_input) / 2];
+	EXPECT_EQ(lz4::compress(_input, sizeof(_input), compressed, sizeof(compressed), _hash_table), 0u);
+}
+
+TEST_F(Lz4BlockTest, MalformedInput)
+{
+	for (size_t i = 0; i < sizeof(_input); ++i) {
+		_input[i] = (uint8_t)(i % 13);
+	}
+
+	uint8_t compressed[lz4::compress_bound(sizeof(_input))];
+	const size_t compressed_size = lz4::compress(_input, sizeof(_input), compressed, sizeof(compressed), _hash_table);
+	ASSERT_GT(compressed_size, 0u);
+
+	uint8_t decompressed[sizeof(_input)];
+
+	// truncated blocks must never decode to the full size
+	for (size_t size = 0; size < compressed_size; ++size) {
+		EXPECT_NE(lz4::decompress(compressed, size, decompressed, sizeof(decompressed)), (int)sizeof(_input));
+	}
+
+	// output buffer too small
+	EXPECT_EQ(lz4::decompress(compressed, compressed_size, decompressed, sizeof(decompressed) - 1), -1);
+
+	// match offset pointing before the start of the output
+	const uint8_t invalid_offset[] = {0x10, 'a', 0x05, 0x00, 0x00};
+	EXPECT_EQ(lz4::decompress(invalid_offset, sizeof(invalid_offset), decompressed, sizeof(decompressed)), -1);
+}
@@ -0,0 +1,226 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/*
+ * @file BiquadFilterBank.hpp
+ *
+ * @brief Cascade of biquad filters applied to several channels at once.
+ *
+ * The delay elements and coefficients of every stage are stored per channel next to each other
+ * (structure of arrays), so a stage filters all channels (eg. the three gyro axes) with 4 wide
+ * vector operations. These map to NEON, Helium or SSE where available and are split into scalar
+ * operations by the compiler otherwise. A block of samples is filtered one stage at a time, which
+ * keeps the coefficients and delay elements of the stage in registers for the whole block.
+ */
+
+#pragma once
+
+#include <mathlib/math/Functions.hpp>
+#include <float.h>
+#include <string.h>
+
+namespace math
+{
+
+template<int MAX_STAGES>
+class BiquadFilterBank
+{
+public:
+	static constexpr int CHANNELS = 4;
+
+	// one sample of all channels
+	typedef float Sample[CHANNELS];
+
+	BiquadFilterBank() = default;
+	~BiquadFilterBank() = default;
+
+	/**
+	 * Set the coefficients of a stage for one channel, in the same format as NotchFilter::getCoefficients().
+	 * The delay elements are kept.
+	 */
+	void setCoefficients(int stage, int channel, const float a[3], const float b[3])
+	{
+		Stage &s = _stages[stage];
+		s.a1[channel] = a[1];
+		s.a2[channel] = a[2];
+		s.b0[channel] = b[0];
+		s.b1[channel] = b[1];
+		s.b2[channel] = b[2];
+
+		_update_active_stages = true;
+	}
+
+	// Copy the coefficients of a filter (NotchFilter, LowPassFilter2p) to a stage
+	template<typename Filter>
+	void setFilter(int stage, int channel, const Filter &filter)
+	{
+		float a[3];
+		float b[3];
+		filter.getCoefficients(a, b);
+		setCoefficients(stage, channel, a, b);
+	}
+
+	// Reset the delay elements of a stage to the steady state of a constant input
+	void reset(int stage, int channel, float sample)
+	{
+		Stage &s = _stages[stage];
+
+		const float input = isFinite(sample) ? sample : 0.f;
+		const float output = input * (s.b0[channel] + s.b1[channel] + s.b2[channel])
+				     / (1.f + s.a1[channel] + s.a2[channel]);
+
+		s.x1[channel] = s.x2[channel] = input;
+		s.y1[channel] = s.y2[channel] = isFinite(output) ? output : input;
+	}
+
+	// Pass through a channel of a stage, the stage is skipped once all its channels are disabled
+	void disable(int stage, int channel)
+	{
+		const float a[3] {1.f, 0.f, 0.f};
+		const float b[3] {1.f, 0.f, 0.f};
+		setCoefficients(stage, channel, a, b);
+		reset(stage, channel, 0.f);
+	}
+
+	// Filter a block of samples in place using the Direct Form I, stages in increasing order
+	void apply(Sample samples[], int num_samples)
+	{
+		if (_update_active_stages) {
+			updateActiveStages();
+		}
+
+		for (int i = 0; i < _num_active_stages; i++) {
+			Stage &s = _stages[_active_stages[i]];
+
+			const Vector4 b0 = load(s.b0);
+			const Vector4 b1 = load(s.b1);
+			const Vector4 b2 = load(s.b2);
+			const Vector4 a1 = load(s.a1);
+			const Vector4 a2 = load(s.a2);
+
+			Vector4 x1 = load(s.x1);
+			Vector4 x2 = load(s.x2);
+			Vector4 y1 = load(s.y1);
+			Vector4 y2 = load(s.y2);
+
+			for (int n = 0; n < num_samples; n++) {
+				const Vector4 x = load(samples[n]);
+				const Vector4 y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+
+				x2 = x1;
+				x1 = x;
+				y2 = y1;
+				y1 = y;
+
+				store(samples[n], y);
+			}
+
+			store(s.x1, x1);
+			store(s.x2, x2);
+			store(s.y1, y1);
+			store(s.y2, y2);
+		}
+	}
+
+	// number of stages that aren't disabled for all channels
+	int activeStages()
+	{
+		if (_update_active_stages) {
+			updateActiveStages();
+		}
+
+		return _num_active_stages;
+	}
+
+private:
+	typedef float Vector4 __attribute__((vector_size(CHANNELS * sizeof(float))));
+
+	// the members are only 4 byte aligned, load and store through memcpy
+	static inline Vector4 load(const float in[CHANNELS])
+	{
+		Vector4 v;
+		memcpy(&v, in, sizeof(v));
+		return v;
+	}
+
+	static inline void store(float out[CHANNELS], const Vector4 &v)
+	{
+		memcpy(out, &v, sizeof(v));
+	}
+
+	// coefficient changes only update the list of stages to run once, before the next block
+	void updateActiveStages()
+	{
+		_num_active_stages = 0;
+
+		for (int i = 0; i < MAX_STAGES; i++) {
+			const Stage &s = _stages[i];
+
+			for (int channel = 0; channel < CHANNELS; channel++) {
+				if ((s.b0[channel] != 1.f) || (s.b1[channel] != 0.f) || (s.b2[channel] != 0.f)
+				    || (s.a1[channel] != 0.f) || (s.a2[channel] != 0.f)) {
+
+					_active_stages[_num_active_stages++] = i;
+					break;
+				}
+			}
+		}
+
+		_update_active_stages = false;
+	}
+
+	struct Stage {
+		// All the coefficients are normalized by a0, so a0 becomes 1 here
+		float a1[CHANNELS] {};
+		float a2[CHANNELS] {};
+
+		float b0[CHANNELS] {1.f, 1.f, 1.f, 1.f};
+		float b1[CHANNELS] {};
+		float b2[CHANNELS] {};
+
+		float x1[CHANNELS] {};
+		float x2[CHANNELS] {};
+		float y1[CHANNELS] {};
+		float y2[CHANNELS] {};
+	};
+
+	Stage _stages[MAX_STAGES] {};
+
+	int _active_stages[MAX_STAGES] {};
+	int _num_active_stages{0};
+
+	bool _update_active_stages{false};
+};
+
+} // namespace math
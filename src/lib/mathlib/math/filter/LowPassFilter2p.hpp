@@ -124,6 +124,17 @@ public:
 
 	float getMagnitudeResponse(float frequency) const;
 
+	// Same format as NotchFilter::getCoefficients()
+	void getCoefficients(float a[3], float b[3]) const
+	{
+		a[0] = 1.f;
+		a[1] = _a1;
+		a[2] = _a2;
+		b[0] = _b0;
+		b[1] = _b1;
+		b[2] = _b2;
+	}
+
 	// Reset the filter state to this value
 	T reset(const T &sample)
 	{
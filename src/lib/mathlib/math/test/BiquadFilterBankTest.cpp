@@ -0,0 +1,218 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * Test code for the biquad filter bank
+ * Run this test only using make tests TESTFILTER=BiquadFilterBank
+ */
+
+#include <gtest/gtest.h>
+
+#include <lib/mathlib/math/filter/BiquadFilterBank.hpp>
+#include <lib/mathlib/math/filter/LowPassFilter2p.hpp>
+#include <lib/mathlib/math/filter/NotchFilter.hpp>
+
+using namespace math;
+
+static constexpr int NUM_NOTCHES = 4;
+static constexpr int NUM_STAGES = NUM_NOTCHES + 1;
+
+static constexpr float SAMPLE_FREQ = 8000.f;
+
+class BiquadFilterBankTest : public ::testing::Test
+{
+public:
+	// same notches and low-pass filter as the filter bank, applied one after another to each channel
+	NotchFilter<float> _notch[3][NUM_NOTCHES];
+	LowPassFilter2p<float> _lpf[3];
+
+	BiquadFilterBank<NUM_STAGES> _bank;
+
+	void configureNotch(int stage, int channel, float notch_freq, float bandwidth)
+	{
+		_notch[channel][stage].setParameters(SAMPLE_FREQ, notch_freq, bandwidth);
+		_bank.setFilter(stage, channel, _notch[channel][stage]);
+	}
+
+	void configureLowPass(int channel, float cutoff_freq)
+	{
+		_lpf[channel].set_cutoff_frequency(SAMPLE_FREQ, cutoff_freq);
+		_bank.setFilter(NUM_NOTCHES, channel, _lpf[channel]);
+	}
+
+	float input(int channel, int n) const
+	{
+		const float t = n / SAMPLE_FREQ;
+		return (channel + 1) * 0.3f + sinf(2.f * M_PI_F * 95.f * t)
+		       + 0.5f * sinf(2.f * M_PI_F * (180.f + 50.f * channel) * t)
+		       + 0.2f * cosf(2.f * M_PI_F * 1200.f * t);
+	}
+
+	// compare the bank to the scalar filters over blocks of different length
+	void compare(int samples, float epsilon)
+	{
+		int n = 0;
+		int block = 1;
+
+		while (n < samples) {
+			BiquadFilterBank<NUM_STAGES>::Sample data[32] {};
+
+			for (int i = 0; i < block; i++) {
+				for (int channel = 0; channel < 3; channel++) {
+					data[i][channel] = input(channel, n + i);
+				}
+			}
+
+			_bank.apply(data, block);
+
+			for (int i = 0; i < block; i++) {
+				for (int channel = 0; channel < 3; channel++) {
+					float expected = input(channel, n + i);
+
+					for (int stage = 0; stage < NUM_NOTCHES; stage++) {
+						if (_notch[channel][stage].getNotchFreq() > 0.f) {
+							expected = _notch[channel][stage].apply(expected);
+						}
+					}
+
+					expected = _lpf[channel].apply(expected);
+
+					EXPECT_NEAR(data[i][channel], expected, epsilon) << "channel " << channel
+							<< " sample " << n + i;
+				}
+			}
+
+			n += block;
+			block = (block % 32) + 1;
+		}
+	}
+};
+
+TEST_F(BiquadFilterBankTest, passThrough)
+{
+	EXPECT_EQ(_bank.activeStages(), 0);
+
+	BiquadFilterBank<NUM_STAGES>::Sample data[2] {{1.f, 2.f, 3.f, 4.f}, {-1.f, -2.f, -3.f, -4.f}};
+	_bank.apply(data, 2);
+
+	for (int channel = 0; channel < BiquadFilterBank<NUM_STAGES>::CHANNELS; channel++) {
+		EXPECT_EQ(data[0][channel], channel + 1.f);
+		EXPECT_EQ(data[1][channel], -(channel + 1.f));
+	}
+}
+
+TEST_F(BiquadFilterBankTest, notchesEqualScalarFilters)
+{
+	// different notches per channel, the scalar notch filter is the same Direct Form I
+	for (int channel = 0; channel < 3; channel++) {
+		for (int stage = 0; stage < NUM_NOTCHES; stage++) {
+			configureNotch(stage, channel, 100.f + 150.f * stage + 20.f * channel, 20.f);
+			_notch[channel][stage].reset(0.f);
+		}
+	}
+
+	EXPECT_EQ(_bank.activeStages(), NUM_NOTCHES);
+
+	compare(2000, 0.f);
+}
+
+TEST_F(BiquadFilterBankTest, cascadeEqualsScalarFilters)
+{
+	for (int channel = 0; channel < 3; channel++) {
+		configureNotch(0, channel, 180.f + 50.f * channel, 30.f);
+		configureNotch(2, channel, 95.f, 15.f);
+		configureLowPass(channel, 300.f);
+
+		const float reset_value = input(channel, 0);
+
+		for (int stage = 0; stage < NUM_NOTCHES; stage++) {
+			_notch[channel][stage].reset(reset_value);
+			_bank.reset(stage, channel, reset_value);
+		}
+
+		_lpf[channel].reset(reset_value);
+		_bank.reset(NUM_NOTCHES, channel, reset_value);
+	}
+
+	// notch 1 only on the y axis, notch 3 disabled
+	configureNotch(1, 1, 400.f, 20.f);
+	_notch[1][1].reset(input(1, 0));
+	_bank.reset(1, 1, input(1, 0));
+
+	EXPECT_EQ(_bank.activeStages(), 4);
+
+	// the low-pass filter is a Direct Form II in the scalar implementation
+	compare(4000, 1e-4f);
+
+	// update the notch frequency without reset, the delay elements are kept
+	for (int channel = 0; channel < 3; channel++) {
+		configureNotch(2, channel, 110.f, 15.f);
+	}
+
+	compare(2000, 1e-4f);
+
+	// disabling the only y axis notch removes the stage
+	_notch[1][1].setParameters(0.f, 0.f, 0.f);
+	_bank.disable(1, 1);
+	EXPECT_EQ(_bank.activeStages(), 3);
+
+	compare(2000, 1e-4f);
+}
+
+TEST_F(BiquadFilterBankTest, resetSteadyState)
+{
+	for (int channel = 0; channel < 3; channel++) {
+		configureNotch(0, channel, 250.f, 40.f);
+		configureLowPass(channel, 100.f);
+
+		_bank.reset(0, channel, channel + 1.f);
+		_bank.reset(NUM_NOTCHES, channel, channel + 1.f);
+	}
+
+	BiquadFilterBank<NUM_STAGES>::Sample data[10];
+
+	for (int i = 0; i < 10; i++) {
+		for (int channel = 0; channel < 3; channel++) {
+			data[i][channel] = channel + 1.f;
+		}
+	}
+
+	_bank.apply(data, 10);
+
+	for (int i = 0; i < 10; i++) {
+		for (int channel = 0; channel < 3; channel++) {
+			EXPECT_NEAR(data[i][channel], channel + 1.f, 1e-4f);
+		}
+	}
+}
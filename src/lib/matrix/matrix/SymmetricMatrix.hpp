@@ -0,0 +1,283 @@
+/**
+ * @file SymmetricMatrix.hpp
+ *
+ * Symmetric matrix with packed upper triangular storage.
+ *
+ * Only the M * (M + 1) / 2 elements on and above the diagonal are stored, row by row,
+ * so element (i, j) and (j, i) are the same memory location and the matrix is
+ * symmetric by construction. Every row of the upper triangle is contiguous, which
+ * lets the compiler vectorise the row wise update loops below.
+ */
+
+#pragma once
+
+#include "math.hpp"
+
+namespace matrix
+{
+
+template <typename Type, size_t M, size_t N>
+class Matrix;
+
+template <typename Type, size_t M>
+class SquareMatrix;
+
+template <typename Type, size_t M>
+class Vector;
+
+template <typename Type, size_t M>
+class SymmetricMatrix
+{
+public:
+	static constexpr size_t SIZE = M * (M + 1) / 2;
+
+	SymmetricMatrix() = default;
+
+	// takes the upper triangle of a square matrix
+	explicit SymmetricMatrix(const SquareMatrix<Type, M> &other)
+	{
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = i; j < M; j++) {
+				_data[index(i, j)] = other(i, j);
+			}
+		}
+	}
+
+	// index of element (i, j) in the packed storage, requires i <= j
+	static constexpr size_t index(size_t i, size_t j)
+	{
+		return i * (2 * M - i + 1) / 2 + (j - i);
+	}
+
+	inline const Type &operator()(size_t i, size_t j) const
+	{
+		assert(i < M);
+		assert(j < M);
+
+		return (i <= j) ? _data[index(i, j)] : _data[index(j, i)];
+	}
+
+	inline Type &operator()(size_t i, size_t j)
+	{
+		assert(i < M);
+		assert(j < M);
+
+		return (i <= j) ? _data[index(i, j)] : _data[index(j, i)];
+	}
+
+	// the upper triangle in row-major order
+	const Type *data() const { return _data; }
+
+	SquareMatrix<Type, M> full() const
+	{
+		SquareMatrix<Type, M> res;
+		const SymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = 0; j < M; j++) {
+				res(i, j) = self(i, j);
+			}
+		}
+
+		return res;
+	}
+
+	Vector<Type, M> row(size_t i) const
+	{
+		Vector<Type, M> res;
+		const SymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t j = 0; j < M; j++) {
+			res(j) = self(i, j);
+		}
+
+		return res;
+	}
+
+	Vector<Type, M> diag() const
+	{
+		Vector<Type, M> res;
+
+		for (size_t i = 0; i < M; i++) {
+			res(i) = _data[index(i, i)];
+		}
+
+		return res;
+	}
+
+	Type trace() const
+	{
+		Type res = 0;
+
+		for (size_t i = 0; i < M; i++) {
+			res += _data[index(i, i)];
+		}
+
+		return res;
+	}
+
+	template<size_t P, size_t Q>
+	Matrix<Type, P, Q> slice(size_t x0, size_t y0) const
+	{
+		static_assert(P <= M, "Slice rows bigger than matrix");
+		static_assert(Q <= M, "Slice cols bigger than matrix");
+		assert(x0 + P <= M);
+		assert(y0 + Q <= M);
+
+		Matrix<Type, P, Q> res;
+		const SymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = 0; i < P; i++) {
+			for (size_t j = 0; j < Q; j++) {
+				res(i, j) = self(x0 + i, y0 + j);
+			}
+		}
+
+		return res;
+	}
+
+	// setting an element also sets its transpose, a block on the diagonal must be symmetric
+	template<size_t P, size_t Q>
+	void setSlice(size_t x0, size_t y0, const Matrix<Type, P, Q> &in)
+	{
+		static_assert(P <= M, "Slice rows bigger than matrix");
+		static_assert(Q <= M, "Slice cols bigger than matrix");
+		assert(x0 + P <= M);
+		assert(y0 + Q <= M);
+
+		SymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = 0; i < P; i++) {
+			for (size_t j = 0; j < Q; j++) {
+				self(x0 + i, y0 + j) = in(i, j);
+			}
+		}
+	}
+
+	template<size_t P, size_t Q>
+	void setSlice(size_t x0, size_t y0, Type val)
+	{
+		static_assert(P <= M, "Slice rows bigger than matrix");
+		static_assert(Q <= M, "Slice cols bigger than matrix");
+		assert(x0 + P <= M);
+		assert(y0 + Q <= M);
+
+		SymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = 0; i < P; i++) {
+			for (size_t j = 0; j < Q; j++) {
+				self(x0 + i, y0 + j) = val;
+			}
+		}
+	}
+
+	void setZero()
+	{
+		memset(_data, 0, sizeof(_data));
+	}
+
+	inline void zero()
+	{
+		setZero();
+	}
+
+	void operator+=(const SymmetricMatrix<Type, M> &other)
+	{
+		for (size_t k = 0; k < SIZE; k++) {
+			_data[k] += other._data[k];
+		}
+	}
+
+	void operator-=(const SymmetricMatrix<Type, M> &other)
+	{
+		for (size_t k = 0; k < SIZE; k++) {
+			_data[k] -= other._data[k];
+		}
+	}
+
+	// set to the symmetric part of the outer product a * b^T, i.e. (a * b^T + b * a^T) / 2
+	void setSymmetricOuterProduct(const Vector<Type, M> &a, const Vector<Type, M> &b)
+	{
+		Type a_data[M];
+		Type b_data[M];
+		a.copyTo(a_data);
+		b.copyTo(b_data);
+
+		Type *row = _data;
+
+		for (size_t i = 0; i < M; i++) {
+			const Type a_half = a_data[i] / Type(2);
+			const Type b_half = b_data[i] / Type(2);
+
+			for (size_t j = i; j < M; j++) {
+				row[j - i] = a_half * b_data[j] + b_half * a_data[j];
+			}
+
+			row += M - i;
+		}
+	}
+
+	// zero all offdiagonal elements and keep corresponding diagonal elements
+	template <size_t Width>
+	void uncorrelateCovariance(size_t first)
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		Vector<Type, Width> diag_elements;
+
+		for (size_t i = 0; i < Width; i++) {
+			diag_elements(i) = _data[index(first + i, first + i)];
+		}
+
+		uncorrelateCovarianceSetVariance(first, diag_elements);
+	}
+
+	template <size_t Width>
+	void uncorrelateCovarianceSetVariance(size_t first, const Vector<Type, Width> &vec)
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		uncorrelate(first, Width);
+
+		for (size_t i = 0; i < Width; i++) {
+			_data[index(first + i, first + i)] = vec(i);
+		}
+	}
+
+	template <size_t Width>
+	void uncorrelateCovarianceSetVariance(size_t first, Type val)
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		uncorrelate(first, Width);
+
+		for (size_t i = first; i < first + Width; i++) {
+			_data[index(i, i)] = val;
+		}
+	}
+
+private:
+	// zero rows and columns first to first + width - 1
+	void uncorrelate(size_t first, size_t width)
+	{
+		// the columns above the first row
+		for (size_t i = 0; i < first; i++) {
+			for (size_t j = first; j < first + width; j++) {
+				_data[index(i, j)] = Type(0);
+			}
+		}
+
+		// the rows, from the diagonal to the end
+		memset(&_data[index(first, first)], 0, (index(first + width - 1, M - 1) - index(first, first) + 1) * sizeof(Type));
+	}
+
+	Type _data[SIZE] {};
+};
+
+template<typename Type, size_t M>
+constexpr size_t SymmetricMatrix<Type, M>::SIZE;
+
+} // namespace matrix
@@ -0,0 +1,193 @@
+#include <matrix/math.hpp>
+#include <gtest/gtest.h>
+
+using namespace matrix;
+
+namespace
+{
+
+static constexpr size_t N = 24;
+
+// random symmetric positive definite matrix, similar in scale to an EKF covariance
+SquareMatrix<float, N> randomCovariance(unsigned seed)
+{
+	srand(seed);
+	SquareMatrix<float, N> A;
+
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j < N; j++) {
+			A(i, j) = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+		}
+	}
+
+	SquareMatrix<float, N> P = A * A.transpose() / static_cast<float>(N);
+
+	for (size_t i = 0; i < N; i++) {
+		P(i, i) += 0.1f;
+	}
+
+	return P;
+}
+
+void expectNear(const SquareMatrix<float, N> &dense, const SymmetricMatrix<float, N> &packed, float eps)
+{
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j < N; j++) {
+			EXPECT_NEAR(dense(i, j), packed(i, j), eps) << "(" << i << ", " << j << ")";
+		}
+	}
+}
+
+} // namespace
+
+TEST(symmetricMatrixTest, packedIndex)
+{
+	SymmetricMatrix<float, 4> a;
+	EXPECT_EQ(a.SIZE, 10);
+	EXPECT_EQ(a.index(0, 0), 0);
+	EXPECT_EQ(a.index(0, 3), 3);
+	EXPECT_EQ(a.index(1, 1), 4);
+	EXPECT_EQ(a.index(2, 2), 7);
+	EXPECT_EQ(a.index(3, 3), 9);
+
+	a(2, 1) = 5.f;
+	EXPECT_FLOAT_EQ(a(1, 2), 5.f);
+	EXPECT_FLOAT_EQ(a.data()[a.index(1, 2)], 5.f);
+}
+
+TEST(symmetricMatrixTest, conversion)
+{
+	const SquareMatrix<float, N> dense = randomCovariance(1);
+	const SymmetricMatrix<float, N> packed(dense);
+	expectNear(dense, packed, 0.f);
+	EXPECT_TRUE(isEqual(packed.full(), dense));
+	EXPECT_TRUE(isEqual(packed.diag(), dense.diag()));
+	EXPECT_FLOAT_EQ(packed.trace(), dense.trace());
+	EXPECT_TRUE(isEqual(packed.row(5), Vector<float, N>(dense.col(5))));
+
+	const Matrix<float, 4, 20> block = packed.slice<4, 20>(0, 4);
+	EXPECT_TRUE(isEqual(block, Matrix<float, 4, 20>(dense.slice<4, 20>(0, 4))));
+}
+
+TEST(symmetricMatrixTest, setSlice)
+{
+	SquareMatrix<float, N> dense = randomCovariance(2);
+	SymmetricMatrix<float, N> packed(dense);
+
+	packed.setSlice<4, N - 4>(0, 4, 0.f);
+	dense.slice<4, N - 4>(0, 4) = 0.f;
+	dense.slice<N - 4, 4>(4, 0) = 0.f;
+	expectNear(dense, packed, 0.f);
+
+	SquareMatrix<float, 2> block;
+	block(0, 0) = 1.f;
+	block(0, 1) = block(1, 0) = 2.f;
+	block(1, 1) = 3.f;
+	packed.setSlice(16, 16, block);
+	dense.slice<2, 2>(16, 16) = block;
+	expectNear(dense, packed, 0.f);
+}
+
+TEST(symmetricMatrixTest, uncorrelateCovariance)
+{
+	SquareMatrix<float, N> dense = randomCovariance(3);
+	SymmetricMatrix<float, N> packed(dense);
+
+	dense.uncorrelateCovariance<3>(13);
+	packed.uncorrelateCovariance<3>(13);
+	expectNear(dense, packed, 0.f);
+
+	dense.uncorrelateCovarianceSetVariance<2>(22, 4.f);
+	packed.uncorrelateCovarianceSetVariance<2>(22, 4.f);
+	expectNear(dense, packed, 0.f);
+
+	dense.uncorrelateCovarianceSetVariance<1>(0, 0.f);
+	packed.uncorrelateCovarianceSetVariance<1>(0, 0.f);
+	expectNear(dense, packed, 0.f);
+
+	const Vector3f var(1.f, 2.f, 3.f);
+	dense.uncorrelateCovarianceSetVariance<3>(7, var);
+	packed.uncorrelateCovarianceSetVariance<3>(7, var);
+	expectNear(dense, packed, 0.f);
+}
+
+TEST(symmetricMatrixTest, symmetricOuterProduct)
+{
+	Vector<float, N> a;
+	Vector<float, N> b;
+
+	for (size_t i = 0; i < N; i++) {
+		a(i) = static_cast<float>(i) - 3.f;
+		b(i) = 0.5f * static_cast<float>(i * i);
+	}
+
+	SymmetricMatrix<float, N> packed;
+	packed.setSymmetricOuterProduct(a, b);
+
+	const SquareMatrix<float, N> ab = Matrix<float, N, 1>(a) * b.transpose();
+	const SquareMatrix<float, N> dense = (ab + ab.transpose()) * 0.5f;
+	expectNear(dense, packed, 1e-4f);
+}
+
+// the covariance update of a sequential scalar measurement as previously done on the dense matrix
+// by the EKF: P -= K * H * P, followed by averaging the two triangles
+TEST(symmetricMatrixTest, covarianceUpdateEquivalence)
+{
+	for (unsigned seed = 0; seed < 20; seed++) {
+		SquareMatrix<float, N> P_dense = randomCovariance(seed);
+		SymmetricMatrix<float, N> P_packed(P_dense);
+
+		SparseVectorf<N, 0, 1, 2, 3, 16, 17, 18, 19, 20, 21> H;
+
+		for (size_t i = 0; i < H.non_zeros(); i++) {
+			H.atCompressedIndex(i) = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+		}
+
+		const float R = 0.05f;
+		const float S = quadraticForm(P_dense, H) + R;
+		Vector<float, N> K = P_dense * H / S;
+
+		if (seed % 2) {
+			// inhibited states are excluded by zeroing their gain
+			K(13) = K(14) = K(15) = 0.f;
+		}
+
+		// dense reference
+		SquareMatrix<float, N> KHP_dense;
+
+		for (size_t row = 0; row < N; row++) {
+			for (size_t column = 0; column < N; column++) {
+				float tmp = 0.f;
+
+				for (size_t i = 0; i < H.non_zeros(); i++) {
+					tmp += K(row) * H.atCompressedIndex(i) * P_dense(H.index(i), column);
+				}
+
+				KHP_dense(row, column) = tmp;
+			}
+		}
+
+		P_dense -= KHP_dense;
+		P_dense.makeBlockSymmetric<N>(0);
+
+		// packed
+		Vector<float, N> HP;
+
+		for (size_t i = 0; i < H.non_zeros(); i++) {
+			HP += H.atCompressedIndex(i) * P_packed.row(H.index(i));
+		}
+
+		SymmetricMatrix<float, N> KHP_packed;
+		KHP_packed.setSymmetricOuterProduct(K, HP);
+		P_packed -= KHP_packed;
+
+		expectNear(P_dense, P_packed, 1e-6f);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+	std::cout << "Run SymmetricMatrix tests" << std::endl;
+	return RUN_ALL_TESTS();
+}
@@ -36,6 +36,7 @@
 #include <uORB/topics/obstacle_distance.h>
 #include <uORB/uORBManager.hpp>
 
+#include <crc32.h>
 #include <gtest/gtest.h>
 
 class ParameterTest : public ::testing::Test
@@ -79,6 +80,31 @@ TEST_F(ParameterTest, testParamReadWrite)
 }
 
 
+TEST_F(ParameterTest, testParamGetChangedValueSize)
+{
+	// GIVEN: a changed int32 parameter
+	param_t param = param_handle(px4::params::SYS_AUTOSTART);
+	int32_t value = 4001;
+	ASSERT_EQ(0, param_set_no_notification(param, &value));
+
+	// AND: a plain int32_t between two canaries
+	struct {
+		uint32_t canary_before;
+		int32_t value;
+		uint32_t canary_after;
+	} read {0xDEADBEEF, -1, 0xDEADBEEF};
+
+	// WHEN: we get the parameter
+	int status = param_get(param, &read.value);
+
+	// THEN: only the value should be written
+	EXPECT_EQ(0, status);
+	EXPECT_EQ(4001, read.value);
+	EXPECT_EQ(0xDEADBEEF, read.canary_before);
+	EXPECT_EQ(0xDEADBEEF, read.canary_after);
+}
+
+
 TEST_F(ParameterTest, testUorbSendReceive)
 {
 	// GIVEN: a uOrb message
@@ -106,3 +132,112 @@ TEST_F(ParameterTest, testUorbSendReceive)
 	// AND: all the bytes should be equal
 	EXPECT_EQ(0, memcmp(&message, &obstacle_distance, sizeof(message)));
 }
+
+// param_hash_check() as computed before it was cached: the CRC32 over the names and values of all used, non-volatile
+// parameters, which is also what ground stations recompute from their parameter cache
+static uint32_t paramHashFull()
+{
+	uint32_t param_hash = 0;
+
+	for (unsigned i = 0; i < param_count(); i++) {
+		const param_t param = param_for_index(i);
+
+		if (!param_used(param) || param_is_volatile(param)) {
+			continue;
+		}
+
+		union param_value_u value {};
+
+		if (param_type(param) == PARAM_TYPE_FLOAT) {
+			param_get(param, &value.f);
+
+		} else {
+			param_get(param, &value.i);
+		}
+
+		const char *name = param_name(param);
+		param_hash = crc32part((const uint8_t *)name, strlen(name), param_hash);
+		param_hash = crc32part((const uint8_t *)&value, param_size(param), param_hash);
+	}
+
+	return param_hash;
+}
+
+TEST_F(ParameterTest, testParamHashCheck)
+{
+	// GIVEN: a used parameter and a parameter that isn't used yet
+	const param_t param = param_find("CP_DIST");
+	param_t unused_param = PARAM_INVALID;
+
+	for (unsigned i = 0; i < param_count(); i++) {
+		if (!param_used(param_for_index(i)) && !param_is_volatile(param_for_index(i))) {
+			unused_param = param_for_index(i);
+			break;
+		}
+	}
+
+	ASSERT_NE(param, PARAM_INVALID);
+	ASSERT_NE(unused_param, PARAM_INVALID);
+
+	float default_value = NAN;
+	ASSERT_EQ(0, param_get(param, &default_value));
+
+	// THEN: the hash matches the full computation, also when queried again
+	const uint32_t hash_default = param_hash_check();
+	EXPECT_EQ(paramHashFull(), hash_default);
+	EXPECT_EQ(hash_default, param_hash_check());
+
+	// WHEN: the parameter is set to a new value
+	float value = 42.f;
+	ASSERT_EQ(0, param_set_no_notification(param, &value));
+
+	// THEN: the hash changes with it
+	const uint32_t hash_changed = param_hash_check();
+	EXPECT_NE(hash_default, hash_changed);
+	EXPECT_EQ(paramHashFull(), hash_changed);
+
+	// WHEN: it is set to the same value again
+	ASSERT_EQ(0, param_set_no_notification(param, &value));
+
+	// THEN: the hash doesn't change
+	EXPECT_EQ(hash_changed, param_hash_check());
+
+	// WHEN: the parameter is reset
+	ASSERT_EQ(0, param_reset_no_notification(param));
+
+	// THEN: the hash is the initial one again
+	EXPECT_EQ(hash_default, param_hash_check());
+	EXPECT_EQ(paramHashFull(), param_hash_check());
+
+	// WHEN: the parameter gets a custom default value
+	value = 3.f;
+	ASSERT_EQ(0, param_set_default_value(param, &value));
+
+	// THEN: the hash changes
+	EXPECT_NE(hash_default, param_hash_check());
+	EXPECT_EQ(paramHashFull(), param_hash_check());
+
+	// WHEN: the custom default is removed again
+	ASSERT_EQ(0, param_set_default_value(param, &default_value));
+
+	// THEN: the hash is the initial one again
+	EXPECT_EQ(hash_default, param_hash_check());
+
+	// WHEN: another parameter gets used
+	param_set_used(unused_param);
+
+	// THEN: it's included in the hash
+	const uint32_t hash_used = param_hash_check();
+	EXPECT_NE(hash_default, hash_used);
+	EXPECT_EQ(paramHashFull(), hash_used);
+
+	// WHEN: all parameters are reset after a change
+	value = 5.f;
+	ASSERT_EQ(0, param_set_no_notification(param, &value));
+	EXPECT_NE(hash_used, param_hash_check());
+	param_reset_all();
+
+	// THEN: the hash matches the full computation
+	EXPECT_EQ(hash_used, param_hash_check());
+	EXPECT_EQ(paramHashFull(), param_hash_check());
+}
@@ -53,7 +53,6 @@
 
 #include <parameters/param.h>
 
-#include "../uthash/utarray.h"
 #include <parameters/tinybson/tinybson.h>
 #include "flashparams.h"
 #include "flashfs.h"
@@ -65,19 +64,9 @@
 # define debug(fmt, args...)            do { } while(0)
 #endif
 
-
-/**
- * Storage for modified parameters.
- */
-struct param_wbuf_s {
-	union param_value_u     val;
-	param_t                 param;
-};
-
 static int
 param_export_internal(param_filter_func filter)
 {
-	struct param_wbuf_s *s = nullptr;
 	bson_encoder_s encoder{};
 	int     result = -1;
 
@@ -85,39 +74,36 @@ param_export_internal(param_filter_func filter)
 
 	bson_encoder_init_buf(&encoder, nullptr, 0);
 
-	/* no modified parameters -> we are done */
-	if (param_values == nullptr) {
-		result = 0;
-		goto out;
-	}
-
-	while ((s = (struct param_wbuf_s *)utarray_next(param_values, s)) != nullptr) {
+	for (param_t param = 0; param < param_count(); param++) {
 
 		int32_t i;
 		float   f;
 
-		if (filter && !filter(s->param)) {
+		/* skip parameters without modified value */
+		const union param_value_u *v = (const union param_value_u *)param_find_changed_external(param);
+
+		if ((v == nullptr) || (filter && !filter(param))) {
 			continue;
 		}
 
 		/* append the appropriate BSON type object */
 
-		switch (param_type(s->param)) {
+		switch (param_type(param)) {
 		case PARAM_TYPE_INT32:
-			i = s->val.i;
+			i = v->i;
 
-			if (bson_encoder_append_int(&encoder, param_name(s->param), i)) {
-				debug("BSON append failed for '%s'", param_name(s->param));
+			if (bson_encoder_append_int(&encoder, param_name(param), i)) {
+				debug("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
 			break;
 
 		case PARAM_TYPE_FLOAT:
-			f = s->val.f;
+			f = v->f;
 
-			if (bson_encoder_append_double(&encoder, param_name(s->param), f)) {
-				debug("BSON append failed for '%s'", param_name(s->param));
+			if (bson_encoder_append_double(&encoder, param_name(param), f)) {
+				debug("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
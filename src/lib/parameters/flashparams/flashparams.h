@@ -54,12 +54,12 @@ __BEGIN_DECLS
 
 /*
  * When using the flash based parameter store we have to force
- * the param_values and 2 functions to be global
+ * these 3 functions to be global
  */
 
-__EXPORT extern UT_array        *param_values;
 __EXPORT int param_set_external(param_t param, const void *val, bool mark_saved, bool notify_changes);
 __EXPORT const void *param_get_value_ptr_external(param_t param);
+__EXPORT const void *param_find_changed_external(param_t param); ///< @return modified value or nullptr if unchanged
 
 /* The interface hooks to the Flash based storage. The caller is responsible for locking */
 __EXPORT int flash_param_save(param_filter_func filter);
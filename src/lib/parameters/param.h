@@ -429,6 +429,8 @@ __EXPORT int 		param_load_default(void);
 /**
  * Generate the hash of all parameters and their values
  *
+ * The hash is cached and only recomputed on the first call after a parameter changed or got used.
+ *
  * @return		CRC32 hash of all param_ids and values
  */
 __EXPORT uint32_t	param_hash_check(void);
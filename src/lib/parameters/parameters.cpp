@@ -90,17 +90,46 @@ static bool autosave_disabled = false;
 static constexpr uint16_t param_info_count = sizeof(px4::parameters) / sizeof(param_info_s);
 static px4::AtomicBitset<param_info_count> params_active;  // params found
 static px4::AtomicBitset<param_info_count> params_changed; // params non-default
-static px4::Bitset<param_info_count> params_custom_default; // params with runtime default value
+static px4::AtomicBitset<param_info_count> params_custom_default; // params with runtime default value
 static px4::AtomicBitset<param_info_count> params_unsaved;
 
-// Storage for modified parameters.
+/**
+ * Rank/select index of params_active: params_active_rank[i] is the number of used parameters in the params_active
+ * elements before element i, the last entry is the total. Parameters are only ever marked used, so param_set_used()
+ * maintains it with a single pass over the following entries. This makes the used index of a parameter
+ * (param_get_used_index()) constant time and param_for_used_index() a binary search, instead of a walk over all
+ * parameters for every one sent during a full MAVLink parameter download.
+ */
+static constexpr size_t params_active_elements = px4::AtomicBitset<param_info_count>::ARRAY_SIZE;
+static constexpr size_t params_per_element = px4::AtomicBitset<param_info_count>::BITS_PER_ELEMENT;
+static px4::atomic<uint32_t> params_active_rank[params_active_elements + 1] {};
+
+/**
+ * param_hash_check() cache. The hash is a CRC32 chain over the names and values of all used parameters in index order,
+ * which ground stations recompute from their parameter cache, so it can't be replaced by an incrementally updated
+ * order independent hash. Instead every change of a hashed input increments param_hash_generation and the hash is
+ * only recomputed on the first query after a change. param_hash_cache holds the generation the cached hash was
+ * computed for in the upper and the hash in the lower 32 bits.
+ */
+static px4::atomic<uint32_t> param_hash_generation{1};
+static px4::atomic<uint64_t> param_hash_cache{0};
+
+static inline void param_hash_invalidate() { param_hash_generation.fetch_add(1); }
+
+/**
+ * Current parameter values indexed by param_t. An entry is only valid if the parameter is changed or
+ * has a custom default (params_changed | params_custom_default), in which case it holds the changed
+ * value or otherwise the custom default. All other parameters are read from the static defaults.
+ */
+static union param_value_u param_values[param_info_count] {};
+
+// Storage for custom default parameter values.
 struct param_wbuf_s {
 	union param_value_u val;
 	param_t             param;
 };
 
-/** flexible array holding modified parameter values */
-UT_array *param_values{nullptr};
+/** flexible array holding custom default parameter values, only needed on reset and when saving */
 UT_array *param_custom_default_values{nullptr};
 
 const UT_icd param_icd = {sizeof(param_wbuf_s), nullptr, nullptr, nullptr};
@@ -223,21 +252,36 @@ param_compare_values(const void *a, const void *b)
 }
 
 /**
- * Locate the modified parameter structure for a parameter, if it exists.
+ * Locate the modified value of a parameter, if it exists.
  *
  * @param param			The parameter being searched.
- * @return			The structure holding the modified value, or
- *				nullptr if the parameter has not been modified.
+ * @return			The modified value, or nullptr if the parameter has not been modified.
  */
-static param_wbuf_s *
+static union param_value_u *
 param_find_changed(param_t param)
+{
+	if (handle_in_range(param) && params_changed[param]) {
+		return &param_values[param];
+	}
+
+	return nullptr;
+}
+
+/**
+ * Locate the custom default value of a parameter, if it exists.
+ *
+ * @param param			The parameter being searched.
+ * @return			The custom default value, or nullptr if the parameter has no custom default.
+ */
+static param_wbuf_s *
+param_find_custom_default(param_t param)
 {
 	param_assert_locked();
 
-	if (params_changed[param] && (param_values != nullptr)) {
+	if (params_custom_default[param] && (param_custom_default_values != nullptr)) {
 		param_wbuf_s key{};
 		key.param = param;
-		return (param_wbuf_s *)utarray_find(param_values, &key, param_compare_values);
+		return (param_wbuf_s *)utarray_find(param_custom_default_values, &key, param_compare_values);
 	}
 
 	return nullptr;
@@ -252,7 +296,7 @@ param_notify_changes()
 	pup.set_count = perf_event_count(param_set_perf);
 	pup.find_count = perf_event_count(param_find_perf);
 	pup.export_count = perf_event_count(param_export_perf);
-	pup.active = params_active.count();
+	pup.active = param_count_used();
 	pup.changed = params_changed.count();
 	pup.custom_default = params_custom_default.count();
 	pup.timestamp = hrt_absolute_time();
@@ -269,6 +313,25 @@ static param_t param_find_internal(const char *name, bool notification)
 {
 	perf_count(param_find_perf);
 
+#if !defined(CONSTRAINED_FLASH)
+	/* look up the generated perfect hash of the names, leaving a single string compare */
+	static constexpr size_t num_buckets = sizeof(px4::parameters_hash_seeds) / sizeof(px4::parameters_hash_seeds[0]);
+	static constexpr size_t num_slots = sizeof(px4::parameters_hash_slots) / sizeof(px4::parameters_hash_slots[0]);
+
+	const uint32_t hash = px4::parameters_name_hash(name);
+	const uint16_t seed = px4::parameters_hash_seeds[px4::parameters_hash_mix(hash, 0) % num_buckets];
+	const uint16_t slot = (seed & 0x8000) ? (seed & 0x7fff) : (px4::parameters_hash_mix(hash, seed) % num_slots);
+	const param_t param = px4::parameters_hash_slots[slot];
+
+	if (handle_in_range(param) && (strcmp(name, param_name(param)) == 0)) {
+		if (notification) {
+			param_set_used(param);
+		}
+
+		return param;
+	}
+
+#else
 	param_t middle;
 	param_t front = 0;
 	param_t last = param_info_count;
@@ -298,6 +361,8 @@ static param_t param_find_internal(const char *name, bool notification)
 		}
 	}
 
+#endif // !CONSTRAINED_FLASH
+
 	/* not found */
 	return PARAM_INVALID;
 }
@@ -319,7 +384,7 @@ unsigned param_count()
 
 unsigned param_count_used()
 {
-	return params_active.count();
+	return params_active_rank[params_active_elements].load();
 }
 
 param_t param_for_index(unsigned index)
@@ -333,24 +398,39 @@ param_t param_for_index(unsigned index)
 
 param_t param_for_used_index(unsigned index)
 {
-	// walk all params and count used params
-	if (index < param_info_count) {
-		unsigned used_count = 0;
-
-		for (int i = 0; i < params_active.size(); i++) {
-			if (params_active[i]) {
-				// we found the right used count,
-				//  return the param value
-				if (index == used_count) {
-					return static_cast<param_t>(i);
-				}
+	if (index >= param_count_used()) {
+		return PARAM_INVALID;
+	}
 
-				used_count++;
-			}
+	// find the last element with less than index + 1 used parameters before it
+	size_t low = 0;
+	size_t high = params_active_elements;
+
+	while (high - low > 1) {
+		const size_t middle = (low + high) / 2;
+
+		if (params_active_rank[middle].load() <= index) {
+			low = middle;
+
+		} else {
+			high = middle;
 		}
 	}
 
-	return PARAM_INVALID;
+	// select the remaining used parameter within the element
+	uint32_t element = params_active.element(low);
+
+	for (unsigned remaining = index - params_active_rank[low].load(); remaining > 0 && element != 0; remaining--) {
+		// clear the lowest set bit
+		element &= element - 1;
+	}
+
+	if (element == 0) {
+		// raced with param_set_used() updating the index
+		return PARAM_INVALID;
+	}
+
+	return static_cast<param_t>(low * params_per_element + __builtin_ctz(element));
 }
 
 int param_get_index(param_t param)
@@ -369,21 +449,12 @@ int param_get_used_index(param_t param)
 		return -1;
 	}
 
-	/* walk all params and count, now knowing that it has a valid index */
-	int used_count = 0;
-
-	for (int i = 0; i < params_active.size(); i++) {
-		if (params_active[i]) {
-
-			if (param == i) {
-				return used_count;
-			}
-
-			used_count++;
-		}
-	}
+	/* used params in the elements before plus the used params below it in its own element */
+	const size_t element_index = param / params_per_element;
+	const uint32_t below_mask = (1u << (param % params_per_element)) - 1;
 
-	return -1;
+	return params_active_rank[element_index].load()
+	       + __builtin_popcount(params_active.element(element_index) & below_mask);
 }
 
 const char *param_name(param_t param)
@@ -444,32 +515,17 @@ param_get_value_ptr(param_t param)
 	param_assert_locked();
 
 	if (handle_in_range(param)) {
-		/* work out whether we're fetching the default or a written value */
-		struct param_wbuf_s *s = param_find_changed(param);
-
-		if (s != nullptr) {
-			return &s->val;
-
-		} else {
-			if (params_custom_default[param] && param_custom_default_values) {
-				// get default from custom default storage
-				param_wbuf_s key{};
-				key.param = param;
-				param_wbuf_s *pbuf = (param_wbuf_s *)utarray_find(param_custom_default_values, &key, param_compare_values);
-
-				if (pbuf != nullptr) {
-					return &pbuf->val;
-				}
-			}
+		/* work out whether we're fetching the static default or a changed/custom default value */
+		if (params_changed[param] || params_custom_default[param]) {
+			return &param_values[param];
+		}
 
-			// otherwise return static default value
-			switch (param_type(param)) {
-			case PARAM_TYPE_INT32:
-				return &px4::parameters[param].val.i;
+		switch (param_type(param)) {
+		case PARAM_TYPE_INT32:
+			return &px4::parameters[param].val.i;
 
-			case PARAM_TYPE_FLOAT:
-				return &px4::parameters[param].val.f;
-			}
+		case PARAM_TYPE_FLOAT:
+			return &px4::parameters[param].val.f;
 		}
 	}
 
@@ -493,28 +549,31 @@ param_get(param_t param, void *val)
 	int result = PX4_ERROR;
 
 	if (val) {
-		if (!params_changed[param] && !params_custom_default[param]) {
-			// if parameter is unchanged (static default value) copy immediately and avoid locking
+		// a changed value is always stored before its flag is set, so a direct copy from the value table
+		// doesn't need the lock. Copy only the typed member, the union is 8 bytes on 64-bit targets.
+		if (params_changed[param] || params_custom_default[param]) {
 			switch (param_type(param)) {
 			case PARAM_TYPE_INT32:
-				memcpy(val, &px4::parameters[param].val.i, sizeof(px4::parameters[param].val.i));
+				memcpy(val, &param_values[param].i, sizeof(param_values[param].i));
 				return PX4_OK;
 
 			case PARAM_TYPE_FLOAT:
-				memcpy(val, &px4::parameters[param].val.f, sizeof(px4::parameters[param].val.f));
+				memcpy(val, &param_values[param].f, sizeof(param_values[param].f));
 				return PX4_OK;
 			}
+
+			return result;
 		}
 
-		param_lock_reader();
-		const void *v = param_get_value_ptr(param);
+		switch (param_type(param)) {
+		case PARAM_TYPE_INT32:
+			memcpy(val, &px4::parameters[param].val.i, sizeof(px4::parameters[param].val.i));
+			return PX4_OK;
 
-		if (v) {
-			memcpy(val, v, param_size(param));
-			result = PX4_OK;
+		case PARAM_TYPE_FLOAT:
+			memcpy(val, &px4::parameters[param].val.f, sizeof(px4::parameters[param].val.f));
+			return PX4_OK;
 		}
-
-		param_unlock_reader();
 	}
 
 	return result;
@@ -529,16 +588,12 @@ param_get_default_value_internal(param_t param, void *default_val)
 	}
 
 	if (default_val) {
-		if (params_custom_default[param] && param_custom_default_values) {
-			// get default from custom default storage
-			param_wbuf_s key{};
-			key.param = param;
-			param_wbuf_s *pbuf = (param_wbuf_s *)utarray_find(param_custom_default_values, &key, param_compare_values);
-
-			if (pbuf != nullptr) {
-				memcpy(default_val, &pbuf->val, param_size(param));
-				return PX4_OK;
-			}
+		// get default from custom default storage
+		param_wbuf_s *pbuf = param_find_custom_default(param);
+
+		if (pbuf != nullptr) {
+			memcpy(default_val, &pbuf->val, param_size(param));
+			return PX4_OK;
 		}
 
 		// otherwise return static default value
@@ -597,8 +652,8 @@ bool param_value_is_default(param_t param)
 		return true;
 
 	} else {
-		// the param_values dynamic array might carry things that have been set
-		// back to default, so we don't rely on the params_changed bitset here
+		// a changed value might have been set back to default, so we don't rely on
+		// the params_changed bitset here
 		switch (param_type(param)) {
 		case PARAM_TYPE_INT32: {
 				param_lock_reader();
@@ -763,83 +818,52 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 	}
 
 	int result = -1;
-	bool param_changed = false;
 
 	param_lock_writer();
 	perf_begin(param_set_perf);
 
-	// create the parameter store if it doesn't exist
-	if (param_values == nullptr) {
-		utarray_new(param_values, &param_icd);
+	// a parameter without a stored value is always considered changed
+	bool param_changed = !params_changed[param];
 
-		// mark all parameters unchanged (default)
-		params_changed.reset();
-		params_unsaved.reset();
-	}
-
-	if (param_values == nullptr) {
-		PX4_ERR("failed to allocate modified values array");
-		goto out;
-
-	} else {
-		param_wbuf_s *s = param_find_changed(param);
-
-		if (s == nullptr) {
-			/* construct a new parameter */
-			param_wbuf_s buf{};
-			buf.param = param;
+	union param_value_u &v = param_values[param];
 
+	/* update the changed value, the flag is only set once the value is stored */
+	switch (param_type(param)) {
+	case PARAM_TYPE_INT32:
+		if (param_changed || (v.i != *(int32_t *)val)) {
+			v.i = *(int32_t *)val;
 			param_changed = true;
-
-			/* add it to the array and sort */
-			utarray_push_back(param_values, &buf);
-			utarray_sort(param_values, param_compare_values);
-			params_changed.set(param, true);
-
-			/* find it after sorting */
-			s = param_find_changed(param);
 		}
 
-		if (s == nullptr) {
-			PX4_ERR("error param_values storage slot invalid");
+		params_changed.set(param, true);
+		params_unsaved.set(param, !mark_saved);
+		result = PX4_OK;
+		break;
 
-		} else {
-			/* update the changed value */
-			switch (param_type(param)) {
-			case PARAM_TYPE_INT32:
-				if (s->val.i != *(int32_t *)val) {
-					s->val.i = *(int32_t *)val;
-					param_changed = true;
-				}
+	case PARAM_TYPE_FLOAT:
+		if (param_changed || (fabsf(v.f - * (float *)val) > FLT_EPSILON)) {
+			v.f = *(float *)val;
+			param_changed = true;
+		}
 
-				params_changed.set(param, true);
-				params_unsaved.set(param, !mark_saved);
-				result = PX4_OK;
-				break;
+		params_changed.set(param, true);
+		params_unsaved.set(param, !mark_saved);
+		result = PX4_OK;
+		break;
 
-			case PARAM_TYPE_FLOAT:
-				if (fabsf(s->val.f - * (float *)val) > FLT_EPSILON) {
-					s->val.f = *(float *)val;
-					param_changed = true;
-				}
+	default:
+		PX4_ERR("param_set invalid param type for %s", param_name(param));
+		break;
+	}
 
-				params_changed.set(param, true);
-				params_unsaved.set(param, !mark_saved);
-				result = PX4_OK;
-				break;
+	if ((result == PX4_OK) && param_changed) {
+		param_hash_invalidate();
 
-			default:
-				PX4_ERR("param_set invalid param type for %s", param_name(param));
-				break;
-			}
-		}
-
-		if ((result == PX4_OK) && param_changed && !mark_saved) { // this is false when importing parameters
+		if (!mark_saved) { // this is false when importing parameters
 			param_autosave();
 		}
 	}
 
-out:
 	perf_end(param_set_perf);
 	param_unlock_writer();
 
@@ -864,6 +888,11 @@ const void *param_get_value_ptr_external(param_t param)
 {
 	return param_get_value_ptr(param);
 }
+
+const void *param_find_changed_external(param_t param)
+{
+	return param_find_changed(param);
+}
 #endif
 
 int param_set(param_t param, const void *val)
@@ -887,8 +916,13 @@ bool param_used(param_t param)
 
 void param_set_used(param_t param)
 {
-	if (handle_in_range(param)) {
-		params_active.set(param, true);
+	if (handle_in_range(param) && !params_active.test_and_set(param)) {
+		// newly used, update the rank of all following elements
+		for (size_t i = param / params_per_element + 1; i <= params_active_elements; i++) {
+			params_active_rank[i].fetch_add(1);
+		}
+
+		param_hash_invalidate();
 	}
 }
 
@@ -935,13 +969,7 @@ int param_set_default_value(param_t param, const void *val)
 	}
 
 	// find if custom default value is already set
-	param_wbuf_s *s = nullptr;
-
-	{
-		param_wbuf_s key{};
-		key.param = param;
-		s = (param_wbuf_s *)utarray_find(param_custom_default_values, &key, param_compare_values);
-	}
+	param_wbuf_s *s = param_find_custom_default(param);
 
 	if (setting_to_static_default) {
 		if (s != nullptr) {
@@ -973,22 +1001,33 @@ int param_set_default_value(param_t param, const void *val)
 			switch (param_type(param)) {
 			case PARAM_TYPE_INT32:
 				s->val.i = *(int32_t *)val;
-				params_custom_default.set(param, true);
 				result = PX4_OK;
 				break;
 
 			case PARAM_TYPE_FLOAT:
 				s->val.f = *(float *)val;
-				params_custom_default.set(param, true);
 				result = PX4_OK;
 				break;
 
 			default:
 				break;
 			}
+
+			if (result == PX4_OK) {
+				// the custom default becomes the current value unless the parameter is changed
+				if (!params_changed[param]) {
+					param_values[param] = s->val;
+				}
+
+				params_custom_default.set(param, true);
+			}
 		}
 	}
 
+	if (result == PX4_OK) {
+		param_hash_invalidate();
+	}
+
 	param_unlock_writer();
 
 	if ((result == PX4_OK) && param_used(param)) {
@@ -1001,19 +1040,23 @@ int param_set_default_value(param_t param, const void *val)
 
 static int param_reset_internal(param_t param, bool notify = true)
 {
-	param_wbuf_s *s = nullptr;
+	bool value_reset = false;
 	bool param_found = false;
 
 	param_lock_writer();
 
 	if (handle_in_range(param)) {
 		/* look for a saved value */
-		s = param_find_changed(param);
+		if (params_changed[param]) {
+			// fall back to the custom default value if there is one
+			param_wbuf_s *s = param_find_custom_default(param);
 
-		/* if we found one, erase it */
-		if (s != nullptr) {
-			int pos = utarray_eltidx(param_values, s);
-			utarray_erase(param_values, pos, 1);
+			if (s != nullptr) {
+				param_values[param] = s->val;
+			}
+
+			value_reset = true;
+			param_hash_invalidate();
 		}
 
 		params_changed.set(param, false);
@@ -1026,7 +1069,7 @@ static int param_reset_internal(param_t param, bool notify = true)
 
 	param_unlock_writer();
 
-	if (s != nullptr && notify) {
+	if (value_reset && notify) {
 		param_notify_changes();
 	}
 
@@ -1041,14 +1084,18 @@ param_reset_all_internal(bool auto_save)
 {
 	param_lock_writer();
 
-	if (param_values != nullptr) {
-		utarray_free(param_values);
+	// restore custom default values that were overridden by a changed value
+	if (param_custom_default_values != nullptr) {
+		param_wbuf_s *s = nullptr;
 
-		params_changed.reset();
+		while ((s = (param_wbuf_s *)utarray_next(param_custom_default_values, s)) != nullptr) {
+			param_values[s->param] = s->val;
+		}
 	}
 
-	/* mark as reset / deleted */
-	param_values = nullptr;
+	/* mark as reset */
+	params_changed.reset();
+	param_hash_invalidate();
 
 	if (auto_save) {
 		param_autosave();
@@ -1390,7 +1437,6 @@ param_export(int fd, param_filter_func filter)
 		return result;
 	}
 
-	param_wbuf_s *s = nullptr;
 	bson_encoder_s encoder{};
 
 	int shutdown_lock_ret = px4_shutdown_lock();
@@ -1411,25 +1457,22 @@ param_export(int fd, param_filter_func filter)
 		goto out;
 	}
 
-	// no modified parameters, export empty BSON document
-	if (param_values == nullptr) {
-		result = 0;
-		goto out;
-	}
+	// export all modified parameters (an empty BSON document if there are none)
+	for (param_t param = 0; handle_in_range(param); param++) {
+		const union param_value_u *v = param_find_changed(param);
 
-	while ((s = (struct param_wbuf_s *)utarray_next(param_values, s)) != nullptr) {
-		if (filter && !filter(s->param)) {
+		if ((v == nullptr) || (filter && !filter(param))) {
 			continue;
 		}
 
 		// don't export default values
-		switch (param_type(s->param)) {
+		switch (param_type(param)) {
 		case PARAM_TYPE_INT32: {
 				int32_t default_value = 0;
-				param_get_default_value_internal(s->param, &default_value);
+				param_get_default_value_internal(param, &default_value);
 
-				if (s->val.i == default_value) {
-					PX4_DEBUG("skipping %s %" PRIi32 " export", param_name(s->param), default_value);
+				if (v->i == default_value) {
+					PX4_DEBUG("skipping %s %" PRIi32 " export", param_name(param), default_value);
 					continue;
 				}
 			}
@@ -1437,24 +1480,24 @@ param_export(int fd, param_filter_func filter)
 
 		case PARAM_TYPE_FLOAT: {
 				float default_value = 0;
-				param_get_default_value_internal(s->param, &default_value);
+				param_get_default_value_internal(param, &default_value);
 
-				if (fabsf(s->val.f - default_value) <= FLT_EPSILON) {
-					PX4_DEBUG("skipping %s %.3f export", param_name(s->param), (double)default_value);
+				if (fabsf(v->f - default_value) <= FLT_EPSILON) {
+					PX4_DEBUG("skipping %s %.3f export", param_name(param), (double)default_value);
 					continue;
 				}
 			}
 			break;
 		}
 
-		const char *name = param_name(s->param);
-		const size_t size = param_size(s->param);
+		const char *name = param_name(param);
+		const size_t size = param_size(param);
 
 		/* append the appropriate BSON type object */
-		switch (param_type(s->param)) {
+		switch (param_type(param)) {
 		case PARAM_TYPE_INT32: {
-				const int32_t i = s->val.i;
-				PX4_DEBUG("exporting: %s (%d) size: %lu val: %" PRIi32, name, s->param, (long unsigned int)size, i);
+				const int32_t i = v->i;
+				PX4_DEBUG("exporting: %s (%d) size: %lu val: %" PRIi32, name, param, (long unsigned int)size, i);
 
 				if (bson_encoder_append_int(&encoder, name, i) != 0) {
 					PX4_ERR("BSON append failed for '%s'", name);
@@ -1464,8 +1507,8 @@ param_export(int fd, param_filter_func filter)
 			break;
 
 		case PARAM_TYPE_FLOAT: {
-				const double f = (double)s->val.f;
-				PX4_DEBUG("exporting: %s (%d) size: %lu val: %.3f", name, s->param, (long unsigned int)size, (double)f);
+				const double f = (double)v->f;
+				PX4_DEBUG("exporting: %s (%d) size: %lu val: %.3f", name, param, (long unsigned int)size, (double)f);
 
 				if (bson_encoder_append_double(&encoder, name, f) != 0) {
 					PX4_ERR("BSON append failed for '%s'", name);
@@ -1475,7 +1518,7 @@ param_export(int fd, param_filter_func filter)
 			break;
 
 		default:
-			PX4_ERR("%s unrecognized parameter type %d, skipping export", name, param_type(s->param));
+			PX4_ERR("%s unrecognized parameter type %d, skipping export", name, param_type(param));
 		}
 	}
 
@@ -1735,6 +1778,14 @@ param_foreach(void (*func)(void *arg, param_t param), void *arg, bool only_chang
 
 uint32_t param_hash_check()
 {
+	// any change after this is either included in the hash or invalidates the cached hash again
+	const uint32_t generation = param_hash_generation.load();
+	const uint64_t cache = param_hash_cache.load();
+
+	if ((cache >> 32) == generation) {
+		return static_cast<uint32_t>(cache);
+	}
+
 	uint32_t param_hash = 0;
 
 	param_lock_reader();
@@ -1753,6 +1804,8 @@ uint32_t param_hash_check()
 
 	param_unlock_reader();
 
+	param_hash_cache.store((static_cast<uint64_t>(generation) << 32) | param_hash);
+
 	return param_hash;
 }
 
@@ -1773,10 +1826,8 @@ void param_print_status()
 
 #endif /* FLASH_BASED_PARAMS */
 
-	if (param_values != nullptr) {
-		PX4_INFO("storage array: %d/%d elements (%zu bytes total)",
-			 utarray_len(param_values), param_values->n, param_values->n * sizeof(UT_icd));
-	}
+	PX4_INFO("storage: %zu changed, %zu custom default (%zu bytes total)",
+		 params_changed.count(), params_custom_default.count(), sizeof(param_values));
 
 	if (param_custom_default_values != nullptr) {
 		PX4_INFO("storage array (custom defaults): %d/%d elements (%zu bytes total)",
@@ -20,6 +20,82 @@ except ImportError as e:
 
 import os
 
+# keep in sync with parameters_name_hash() in templates/px4_parameters.hpp.jinja
+def param_name_hash(name, salt):
+    """ 32 bit FNV-1a of the name with a salted offset basis """
+    h = (2166136261 ^ salt) & 0xffffffff
+    for c in name.encode('ascii'):
+        h ^= c
+        h = (h * 16777619) & 0xffffffff
+    return h
+
+# keep in sync with parameters_hash_mix() in templates/px4_parameters.hpp.jinja
+def param_hash_mix(h, seed):
+    """ murmur3 finalizer of the name hash combined with a seed """
+    h = (h ^ (seed * 0x9e3779b9)) & 0xffffffff
+    h ^= h >> 16
+    h = (h * 0x85ebca6b) & 0xffffffff
+    h ^= h >> 13
+    h = (h * 0xc2b2ae35) & 0xffffffff
+    h ^= h >> 16
+    return h
+
+def generate_perfect_hash(names):
+    """
+    Build a minimal perfect hash over the parameter names (hash and displace).
+
+    Names are distributed into buckets by param_hash_mix(name hash, 0), then
+    for every bucket (largest first) a seed is searched that places all its
+    names into free slots of a table with one slot per parameter. Buckets with
+    a single name directly store a free slot instead (seed with the top bit set).
+
+    @return (salt, seed per bucket, parameter index per slot)
+    """
+    num_slots = max(len(names), 1)
+    num_buckets = max((len(names) + 3) // 4, 1)
+
+    if num_slots > 0x7fff:
+        raise Exception("too many parameters for the perfect hash")
+
+    # names with the same 32 bit hash can't be told apart, change the salt until all differ
+    for salt in range(0x100):
+        hashes = [param_name_hash(name, salt) for name in names]
+        if len(set(hashes)) == len(hashes):
+            break
+    else:
+        raise Exception("failed to generate unique parameter name hashes")
+
+    buckets = [[] for _ in range(num_buckets)]
+    for index, h in enumerate(hashes):
+        buckets[param_hash_mix(h, 0) % num_buckets].append(index)
+
+    seeds = [0] * num_buckets
+    slots = [0xffff] * num_slots
+
+    for bucket in sorted(range(num_buckets), key=lambda b: len(buckets[b]), reverse=True):
+        if len(buckets[bucket]) <= 1:
+            break
+
+        for seed in range(1, 0x8000):
+            positions = [param_hash_mix(hashes[i], seed) % num_slots for i in buckets[bucket]]
+            if len(set(positions)) == len(positions) and all(slots[p] == 0xffff for p in positions):
+                break
+        else:
+            raise Exception("failed to generate perfect hash for parameter names")
+
+        seeds[bucket] = seed
+        for index, position in zip(buckets[bucket], positions):
+            slots[position] = index
+
+    free_slots = [position for position in range(num_slots) if slots[position] == 0xffff]
+    for bucket in range(num_buckets):
+        if len(buckets[bucket]) == 1:
+            position = free_slots.pop()
+            seeds[bucket] = 0x8000 | position
+            slots[position] = buckets[bucket][0]
+
+    return salt, seeds, slots
+
 def generate(xml_file, dest='.'):
     """
     Generate px4 param source from xml.
@@ -40,6 +116,8 @@ def generate(xml_file, dest='.'):
 
     params = sorted(params, key=lambda name: name.attrib["name"])
 
+    hash_salt, hash_seeds, hash_slots = generate_perfect_hash([param.attrib["name"] for param in params])
+
     script_path = os.path.dirname(os.path.realpath(__file__))
 
     # for jinja docs see: http://jinja.pocoo.org/docs/2.9/api/
@@ -56,7 +134,8 @@ def generate(xml_file, dest='.'):
         template = env.get_template(template_file)
         with open(os.path.join(
                 dest, template_file.replace('.jinja','')), 'w') as fid:
-            fid.write(template.render(params=params))
+            fid.write(template.render(params=params, hash_salt=hash_salt,
+                                         hash_seeds=hash_seeds, hash_slots=hash_slots))
 
 if __name__ == "__main__":
     arg_parser = argparse.ArgumentParser()
@@ -45,6 +45,7 @@
 #include <drivers/drv_hrt.h>
 #include <math.h>
 #include <pthread.h>
+#include <px4_platform_common/atomic.h>
 #include <systemlib/err.h>
 
 #include "perf_counter.h"
@@ -92,6 +93,48 @@ struct perf_ctr_interval : public perf_ctr_header {
 	float			M2{0.0f};
 };
 
+/**
+ * PC_HISTOGRAM counter.
+ *
+ * Elapsed times are sorted into log-linear buckets with 4 sub-buckets per power of 2, times above
+ * ~29 s all go into the last bucket. Bucket updates are atomic, so a shared counter can be updated
+ * from multiple threads and printed concurrently without locking.
+ */
+static constexpr int PERF_HISTOGRAM_SUB_BUCKET_BITS = 2;
+static constexpr int PERF_HISTOGRAM_SUB_BUCKETS = 1 << PERF_HISTOGRAM_SUB_BUCKET_BITS;
+static constexpr int PERF_HISTOGRAM_BUCKETS = 96;
+
+struct perf_ctr_histogram : public perf_ctr_header {
+	uint64_t		time_start{0};
+	px4::atomic<uint32_t>	time_most{0};
+	px4::atomic<uint32_t>	buckets[PERF_HISTOGRAM_BUCKETS] {};
+};
+
+static int perf_histogram_bucket(uint32_t elapsed)
+{
+	if (elapsed < PERF_HISTOGRAM_SUB_BUCKETS) {
+		return elapsed;
+	}
+
+	const int exponent = 31 - __builtin_clz(elapsed);
+	const int shift = exponent - PERF_HISTOGRAM_SUB_BUCKET_BITS;
+	const int bucket = ((shift + 1) << PERF_HISTOGRAM_SUB_BUCKET_BITS) | ((elapsed >> shift) & (PERF_HISTOGRAM_SUB_BUCKETS - 1));
+
+	return (bucket < PERF_HISTOGRAM_BUCKETS) ? bucket : (PERF_HISTOGRAM_BUCKETS - 1);
+}
+
+static uint32_t perf_histogram_bucket_max(int bucket)
+{
+	if (bucket < PERF_HISTOGRAM_SUB_BUCKETS) {
+		return bucket;
+	}
+
+	const int shift = (bucket >> PERF_HISTOGRAM_SUB_BUCKET_BITS) - 1;
+	const uint32_t sub_bucket = bucket & (PERF_HISTOGRAM_SUB_BUCKETS - 1);
+
+	return ((PERF_HISTOGRAM_SUB_BUCKETS + sub_bucket + 1) << shift) - 1;
+}
+
 /**
  * List of all known counters.
  */
@@ -127,6 +170,10 @@ perf_alloc(enum perf_counter_type type, const char *name)
 		ctr = new perf_ctr_interval();
 		break;
 
+	case PC_HISTOGRAM:
+		ctr = new perf_ctr_histogram();
+		break;
+
 	default:
 		break;
 	}
@@ -218,6 +265,10 @@ perf_begin(perf_counter_t handle)
 		((struct perf_ctr_elapsed *)handle)->time_start = hrt_absolute_time();
 		break;
 
+	case PC_HISTOGRAM:
+		((struct perf_ctr_histogram *)handle)->time_start = hrt_absolute_time();
+		break;
+
 	default:
 		break;
 	}
@@ -240,6 +291,15 @@ perf_end(perf_counter_t handle)
 		}
 		break;
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			if (pch->time_start != 0) {
+				perf_set_elapsed(handle, hrt_elapsed_time(&pch->time_start));
+			}
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -280,6 +340,22 @@ perf_set_elapsed(perf_counter_t handle, int64_t elapsed)
 		}
 		break;
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			if (elapsed >= 0) {
+				const uint32_t time = (elapsed > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed;
+				pch->buckets[perf_histogram_bucket(time)].fetch_add(1);
+
+				uint32_t time_most = pch->time_most.load();
+
+				while ((time > time_most) && !pch->time_most.compare_exchange(&time_most, time)) {}
+
+				pch->time_start = 0;
+			}
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -373,6 +449,10 @@ perf_cancel(perf_counter_t handle)
 		}
 		break;
 
+	case PC_HISTOGRAM:
+		((struct perf_ctr_histogram *)handle)->time_start = 0;
+		break;
+
 	default:
 		break;
 	}
@@ -410,6 +490,21 @@ perf_reset(perf_counter_t handle)
 			pci->time_most = 0;
 			break;
 		}
+
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+			pch->time_start = 0;
+			pch->time_most.store(0);
+
+			for (auto &bucket : pch->buckets) {
+				bucket.store(0);
+			}
+
+			break;
+		}
+
+	default:
+		break;
 	}
 }
 
@@ -466,6 +561,22 @@ perf_print_counter_fd(int fd, perf_counter_t handle)
 			break;
 		}
 
+	case PC_HISTOGRAM: {
+			perf_histogram_summary summary;
+			perf_histogram(handle, &summary);
+
+			dprintf(fd, "%s: %" PRIu64 " events, p50 %" PRIu32 "us p90 %" PRIu32 "us p99 %" PRIu32 "us p99.9 %" PRIu32
+				"us max %" PRIu32 "us\n",
+				handle->name,
+				summary.event_count,
+				summary.p50,
+				summary.p90,
+				summary.p99,
+				summary.p999,
+				summary.max);
+			break;
+		}
+
 	default:
 		break;
 	}
@@ -518,6 +629,22 @@ perf_print_counter_buffer(char *buffer, int length, perf_counter_t handle)
 			break;
 		}
 
+	case PC_HISTOGRAM: {
+			perf_histogram_summary summary;
+			perf_histogram(handle, &summary);
+
+			num_written = snprintf(buffer, length,
+					       "%s: %" PRIu64 " events, p50 %" PRIu32 "us p90 %" PRIu32 "us p99 %" PRIu32 "us p99.9 %" PRIu32 "us max %" PRIu32 "us",
+					       handle->name,
+					       summary.event_count,
+					       summary.p50,
+					       summary.p90,
+					       summary.p99,
+					       summary.p999,
+					       summary.max);
+			break;
+		}
+
 	default:
 		break;
 	}
@@ -547,6 +674,17 @@ perf_event_count(perf_counter_t handle)
 			return pci->event_count;
 		}
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+			uint64_t event_count = 0;
+
+			for (const auto &bucket : pch->buckets) {
+				event_count += bucket.load();
+			}
+
+			return event_count;
+		}
+
 	default:
 		break;
 	}
@@ -554,6 +692,61 @@ perf_event_count(perf_counter_t handle)
 	return 0;
 }
 
+int
+perf_histogram(perf_counter_t handle, struct perf_histogram_summary *summary)
+{
+	if ((handle == nullptr) || (handle->type != PC_HISTOGRAM) || (summary == nullptr)) {
+		return -1;
+	}
+
+	struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+	// snapshot, the counter might be updated concurrently
+	uint32_t buckets[PERF_HISTOGRAM_BUCKETS];
+	uint64_t event_count = 0;
+
+	for (int i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+		buckets[i] = pch->buckets[i].load();
+		event_count += buckets[i];
+	}
+
+	summary->event_count = event_count;
+	summary->max = pch->time_most.load();
+
+	static constexpr uint32_t permille[] {500, 900, 990, 999};
+	uint32_t *percentiles[] {&summary->p50, &summary->p90, &summary->p99, &summary->p999};
+
+	for (int q = 0; q < 4; q++) {
+		// rank of the percentile (1 based), walk the cumulative distribution until it's reached
+		const uint64_t rank = (event_count * permille[q] + 999) / 1000;
+		uint64_t cumulative = 0;
+		*percentiles[q] = 0;
+
+		for (int i = 0; (i < PERF_HISTOGRAM_BUCKETS) && (rank > 0); i++) {
+			cumulative += buckets[i];
+
+			if (cumulative >= rank) {
+				// a bucket bound can't exceed the maximum seen
+				const uint32_t bucket_max = perf_histogram_bucket_max(i);
+				*percentiles[q] = (bucket_max < summary->max) ? bucket_max : summary->max;
+				break;
+			}
+		}
+	}
+
+	return 0;
+}
+
+const char *
+perf_name(perf_counter_t handle)
+{
+	if (handle == nullptr) {
+		return nullptr;
+	}
+
+	return handle->name;
+}
+
 float
 perf_mean(perf_counter_t handle)
 {
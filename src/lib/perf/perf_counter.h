@@ -48,7 +48,22 @@
 enum perf_counter_type {
 	PC_COUNT,		/**< count the number of times an event occurs */
 	PC_ELAPSED,		/**< measure the time elapsed performing an event */
-	PC_INTERVAL		/**< measure the interval between instances of an event */
+	PC_INTERVAL,		/**< measure the interval between instances of an event */
+	PC_HISTOGRAM		/**< measure the distribution of the time elapsed performing an event (lock-free) */
+};
+
+/**
+ * Percentiles of a PC_HISTOGRAM counter in us.
+ *
+ * Each value is the upper bound of the histogram bucket holding the percentile (at most 25% above the exact value).
+ */
+struct perf_histogram_summary {
+	uint64_t event_count;
+	uint32_t p50;
+	uint32_t p90;
+	uint32_t p99;
+	uint32_t p999;
+	uint32_t max;
 };
 
 struct perf_ctr_header;
@@ -97,7 +112,7 @@ __EXPORT extern void		perf_count(perf_counter_t handle);
 /**
  * Begin a performance event.
  *
- * This call applies to counters that operate over ranges of time; PC_ELAPSED etc.
+ * This call applies to counters that operate over ranges of time; PC_ELAPSED, PC_HISTOGRAM etc.
  *
  * @param handle		The handle returned from perf_alloc.
  */
@@ -234,6 +249,23 @@ __EXPORT extern void		perf_reset_all(void);
  */
 __EXPORT extern uint64_t	perf_event_count(perf_counter_t handle);
 
+/**
+ * Get the percentiles of a PC_HISTOGRAM counter.
+ *
+ * @param handle		The handle returned from perf_alloc.
+ * @param summary		Filled with the event count and percentiles.
+ * @return			0 on success, -1 if the handle is not a PC_HISTOGRAM counter
+ */
+__EXPORT extern int		perf_histogram(perf_counter_t handle, struct perf_histogram_summary *summary);
+
+/**
+ * Return the counter name
+ *
+ * @param handle		The handle returned from perf_alloc.
+ * @return			name, or NULL for an invalid handle
+ */
+__EXPORT extern const char	*perf_name(perf_counter_t handle);
+
 /**
  * Return current mean
  *
@@ -42,6 +42,7 @@
  */
 
 #include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/posix.h>
@@ -51,6 +52,11 @@
 #include <lib/parameters/param.h>
 #include <lib/perf/perf_counter.h>
 
+#if defined(__PX4_POSIX)
+#include <pthread.h>
+#include <sys/mman.h>
+#endif
+
 #include "dataman.h"
 
 __BEGIN_DECLS
@@ -73,6 +79,17 @@ static int  _ram_clear(dm_item_t item);
 static int _ram_initialize(unsigned max_offset);
 static void _ram_shutdown();
 
+#if defined(__PX4_POSIX)
+/* Private memory mapped file based Operations */
+static ssize_t _mmap_write(dm_item_t item, unsigned index, const void *buf, size_t count);
+static ssize_t _mmap_read(dm_item_t item, unsigned index, void *buf, size_t count);
+static int  _mmap_clear(dm_item_t item);
+static int _mmap_initialize(unsigned max_offset);
+static void _mmap_shutdown();
+static int _mmap_wait(px4_sem_t *sem);
+static int _mmap_commit();
+#endif
+
 typedef struct dm_operations_t {
 	ssize_t (*write)(dm_item_t item, unsigned index, const void *buf, size_t count);
 	ssize_t (*read)(dm_item_t item, unsigned index, void *buf, size_t count);
@@ -80,6 +97,8 @@ typedef struct dm_operations_t {
 	int (*initialize)(unsigned max_offset);
 	void (*shutdown)();
 	int (*wait)(px4_sem_t *sem);
+	int (*commit)();	/* make buffered writes persistent, nullptr if every write is */
+	bool direct;		/* read, write and clear are thread safe and run in the caller's thread */
 } dm_operations_t;
 
 static constexpr dm_operations_t dm_file_operations = {
@@ -89,6 +108,8 @@ static constexpr dm_operations_t dm_file_operations = {
 	.initialize = _file_initialize,
 	.shutdown = _file_shutdown,
 	.wait = px4_sem_wait,
+	.commit = nullptr,
+	.direct = false,
 };
 
 static constexpr dm_operations_t dm_ram_operations = {
@@ -98,7 +119,22 @@ static constexpr dm_operations_t dm_ram_operations = {
 	.initialize = _ram_initialize,
 	.shutdown = _ram_shutdown,
 	.wait = px4_sem_wait,
+	.commit = nullptr,
+	.direct = false,
+};
+
+#if defined(__PX4_POSIX)
+static constexpr dm_operations_t dm_mmap_operations = {
+	.write   = _mmap_write,
+	.read    = _mmap_read,
+	.clear   = _mmap_clear,
+	.initialize = _mmap_initialize,
+	.shutdown = _mmap_shutdown,
+	.wait = _mmap_wait,
+	.commit = _mmap_commit,
+	.direct = true,
 };
+#endif
 
 static const dm_operations_t *g_dm_ops;
 
@@ -111,10 +147,22 @@ static struct {
 			uint8_t *data;
 			uint8_t *data_end;
 		} ram;
+		struct {
+			int fd;
+			uint8_t *data;
+			size_t size;
+			size_t dirty_start;	/* byte range [dirty_start, dirty_end) written since the last commit */
+			size_t dirty_end;
+		} mmap;
 	};
 	bool running;
 } dm_operations_data;
 
+#if defined(__PX4_POSIX)
+/* Readers of the mapping share the lock, writers and (un)mapping take it exclusively */
+static pthread_rwlock_t g_mmap_lock = PTHREAD_RWLOCK_INITIALIZER;
+#endif
+
 /** Types of function calls supported by the worker task */
 typedef enum {
 	dm_write_func = 0,
@@ -152,7 +200,8 @@ typedef struct {
 const size_t k_work_item_allocation_chunk_size = 8;
 
 /* Usage statistics */
-static unsigned g_func_counts[dm_number_of_funcs];
+static px4::atomic<unsigned> g_func_counts[dm_number_of_funcs];
+static px4::atomic<unsigned> g_commit_count;
 
 /* table of maximum number of instances for each item type */
 static const unsigned g_per_item_max_index[DM_KEY_NUM_KEYS] = {
@@ -195,6 +244,7 @@ static enum {
 	BACKEND_NONE = 0,
 	BACKEND_FILE,
 	BACKEND_RAM,
+	BACKEND_MMAP,
 	BACKEND_LAST
 } backend = BACKEND_NONE;
 
@@ -781,6 +831,293 @@ _ram_shutdown()
 	dm_operations_data.running = false;
 }
 
+#if defined(__PX4_POSIX)
+
+/* Extend the not yet committed byte range, with g_mmap_lock held */
+static void
+_mmap_mark_dirty(size_t start, size_t end)
+{
+	if (start < dm_operations_data.mmap.dirty_start) {
+		dm_operations_data.mmap.dirty_start = start;
+	}
+
+	if (end > dm_operations_data.mmap.dirty_end) {
+		dm_operations_data.mmap.dirty_end = end;
+	}
+}
+
+/* write to the memory mapped data manager file, this only becomes persistent with the next commit */
+static ssize_t
+_mmap_write(dm_item_t item, unsigned index, const void *buf, size_t count)
+{
+	/* Get the offset for this item */
+	const int offset = calculate_offset(item, index);
+
+	/* If item type or index out of range, return error */
+	if (offset < 0) {
+		return -1;
+	}
+
+	/* Make sure caller has not given us more data than we can handle */
+	if (count > (g_per_item_size[item] - DM_SECTOR_HDR_SIZE)) {
+		return -E2BIG;
+	}
+
+	pthread_rwlock_wrlock(&g_mmap_lock);
+
+	if (dm_operations_data.mmap.data == nullptr) {
+		pthread_rwlock_unlock(&g_mmap_lock);
+		return -1;
+	}
+
+	uint8_t *buffer = &dm_operations_data.mmap.data[offset];
+
+	/* Write out the data, prefixed with length */
+	buffer[0] = count;
+	buffer[1] = 0;
+	buffer[2] = 0;
+	buffer[3] = 0;
+
+	if (count > 0) {
+		memcpy(buffer + DM_SECTOR_HDR_SIZE, buf, count);
+	}
+
+	_mmap_mark_dirty(offset, offset + DM_SECTOR_HDR_SIZE + count);
+
+	pthread_rwlock_unlock(&g_mmap_lock);
+
+	/* All is well... return the number of user data written */
+	return count;
+}
+
+/* Retrieve from the memory mapped data manager file */
+static ssize_t
+_mmap_read(dm_item_t item, unsigned index, void *buf, size_t count)
+{
+	/* Get the offset for this item */
+	const int offset = calculate_offset(item, index);
+
+	/* If item type or index out of range, return error */
+	if (offset < 0) {
+		return -1;
+	}
+
+	/* Make sure the caller hasn't asked for more data than we can handle */
+	if (count > (g_per_item_size[item] - DM_SECTOR_HDR_SIZE)) {
+		return -E2BIG;
+	}
+
+	pthread_rwlock_rdlock(&g_mmap_lock);
+
+	if (dm_operations_data.mmap.data == nullptr) {
+		pthread_rwlock_unlock(&g_mmap_lock);
+		return -1;
+	}
+
+	const uint8_t *buffer = &dm_operations_data.mmap.data[offset];
+	ssize_t len = buffer[0];
+
+	/* See if we got data */
+	if (len > 0) {
+		/* We got more than requested!!! */
+		if ((size_t)len > count) {
+			len = -1;
+
+		} else {
+			/* Looks good, copy it to the caller's buffer */
+			memcpy(buf, buffer + DM_SECTOR_HDR_SIZE, len);
+		}
+	}
+
+	pthread_rwlock_unlock(&g_mmap_lock);
+
+	/* Return the number of bytes of caller data read */
+	return len;
+}
+
+static int
+_mmap_clear(dm_item_t item)
+{
+	/* Get the offset of 1st item of this type */
+	int offset = calculate_offset(item, 0);
+
+	/* Check for item type out of range */
+	if (offset < 0) {
+		return -1;
+	}
+
+	pthread_rwlock_wrlock(&g_mmap_lock);
+
+	if (dm_operations_data.mmap.data == nullptr) {
+		pthread_rwlock_unlock(&g_mmap_lock);
+		return -1;
+	}
+
+	/* Clear all items of this type, only touching the pages of items that are set */
+	for (unsigned i = 0; i < g_per_item_max_index[item]; i++) {
+		uint8_t *buf = &dm_operations_data.mmap.data[offset];
+
+		if (buf[0]) {
+			buf[0] = 0;
+			_mmap_mark_dirty(offset, offset + 1);
+		}
+
+		offset += g_per_item_size[item];
+	}
+
+	pthread_rwlock_unlock(&g_mmap_lock);
+
+	return 0;
+}
+
+/* Write all items modified since the last commit to physical media, with a single msync */
+static int
+_mmap_commit()
+{
+	pthread_rwlock_wrlock(&g_mmap_lock);
+
+	uint8_t *data = dm_operations_data.mmap.data;
+	const size_t start = dm_operations_data.mmap.dirty_start;
+	const size_t end = dm_operations_data.mmap.dirty_end;
+
+	dm_operations_data.mmap.dirty_start = dm_operations_data.mmap.size;
+	dm_operations_data.mmap.dirty_end = 0;
+
+	pthread_rwlock_unlock(&g_mmap_lock);
+
+	if (data == nullptr || start >= end) {
+		return 0;
+	}
+
+	/* msync needs a page aligned address, writers can keep modifying the mapping meanwhile */
+	const size_t page_start = start - (start % sysconf(_SC_PAGESIZE));
+
+	if (msync(data + page_start, end - page_start, MS_SYNC) != 0) {
+		PX4_ERR("file commit msync failed %d", errno);
+
+		/* keep the range dirty to retry with the next commit */
+		pthread_rwlock_wrlock(&g_mmap_lock);
+		_mmap_mark_dirty(start, end);
+		pthread_rwlock_unlock(&g_mmap_lock);
+		return -1;
+	}
+
+	g_commit_count.fetch_add(1);
+	return 0;
+}
+
+/* Wait for work, committing writes that are not part of a transaction (no dm_unlock) every second */
+static int
+_mmap_wait(px4_sem_t *sem)
+{
+	struct timespec abstime;
+	px4_clock_gettime(CLOCK_MONOTONIC, &abstime);
+	abstime.tv_sec += 1;
+
+	const int ret = px4_sem_timedwait(sem, &abstime);
+
+	if (ret != 0 && errno == ETIMEDOUT) {
+		_mmap_commit();
+	}
+
+	return ret;
+}
+
+static int
+_mmap_initialize(unsigned max_offset)
+{
+	/* Open or create the data manager file, the layout is the same as for the file backend */
+	dm_operations_data.mmap.fd = open(k_data_manager_device_path, O_RDWR | O_CREAT | O_BINARY, PX4_O_MODE_666);
+
+	if (dm_operations_data.mmap.fd < 0) {
+		PX4_WARN("Could not open data manager file %s", k_data_manager_device_path);
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	/* Extending the file fills it with 0, which are empty entries */
+	if (ftruncate(dm_operations_data.mmap.fd, max_offset) != 0) {
+		close(dm_operations_data.mmap.fd);
+		PX4_WARN("Could not resize data manager file %s (%d)", k_data_manager_device_path, errno);
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	void *data = mmap(nullptr, max_offset, PROT_READ | PROT_WRITE, MAP_SHARED, dm_operations_data.mmap.fd, 0);
+
+	if (data == MAP_FAILED) {
+		close(dm_operations_data.mmap.fd);
+		PX4_WARN("Could not map data manager file %s (%d), use the file backend", k_data_manager_device_path, errno);
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	pthread_rwlock_wrlock(&g_mmap_lock);
+	dm_operations_data.mmap.data = (uint8_t *)data;
+	dm_operations_data.mmap.size = max_offset;
+	dm_operations_data.mmap.dirty_start = max_offset;
+	dm_operations_data.mmap.dirty_end = 0;
+	pthread_rwlock_unlock(&g_mmap_lock);
+
+	// Read the mission state and check the hash
+	struct dataman_compat_s compat_state;
+	int ret = _mmap_read(DM_KEY_COMPAT, 0, &compat_state, sizeof(compat_state));
+
+	if (ret != sizeof(compat_state) || compat_state.key != DM_COMPAT_KEY) {
+		pthread_rwlock_wrlock(&g_mmap_lock);
+		memset(dm_operations_data.mmap.data, 0, max_offset);
+		_mmap_mark_dirty(0, max_offset);
+		pthread_rwlock_unlock(&g_mmap_lock);
+	}
+
+	/* Write current compat info */
+	compat_state.key = DM_COMPAT_KEY;
+	ret = _mmap_write(DM_KEY_COMPAT, 0, &compat_state, sizeof(compat_state));
+
+	if (ret != sizeof(compat_state)) {
+		PX4_ERR("Failed writing compat: %d", ret);
+	}
+
+	_mmap_commit();
+	dm_operations_data.running = true;
+
+	return 0;
+}
+
+static void
+_mmap_shutdown()
+{
+	_mmap_commit();
+
+	pthread_rwlock_wrlock(&g_mmap_lock);
+	munmap(dm_operations_data.mmap.data, dm_operations_data.mmap.size);
+	dm_operations_data.mmap.data = nullptr;
+	close(dm_operations_data.mmap.fd);
+	pthread_rwlock_unlock(&g_mmap_lock);
+
+	dm_operations_data.running = false;
+}
+
+#endif // __PX4_POSIX
+
+/* Writes that complete a transaction: the mission state and the stats entry of the fence and safe points, which are
+ * written after all of their items */
+static bool
+is_commit_point(dm_item_t item, unsigned index)
+{
+	switch (item) {
+	case DM_KEY_MISSION_STATE:
+		return true;
+
+	case DM_KEY_FENCE_POINTS:
+	case DM_KEY_SAFE_POINTS:
+		return index == 0;
+
+	default:
+		return false;
+	}
+}
+
 /** Write to the data manager file */
 __EXPORT ssize_t
 dm_write(dm_item_t item, unsigned index, const void *buf, size_t count)
@@ -792,6 +1129,19 @@ dm_write(dm_item_t item, unsigned index, const void *buf, size_t count)
 		return -1;
 	}
 
+	if (g_dm_ops->direct) {
+		const hrt_abstime start = hrt_absolute_time();
+		g_func_counts[dm_write_func].fetch_add(1);
+		ssize_t ret = g_dm_ops->write(item, index, buf, count);
+
+		if (ret >= 0 && is_commit_point(item, index)) {
+			g_dm_ops->commit();
+		}
+
+		perf_set_elapsed(_dm_write_perf, hrt_elapsed_time(&start));
+		return ret;
+	}
+
 	perf_begin(_dm_write_perf);
 
 	/* get a work item and queue up a write request */
@@ -824,6 +1174,14 @@ dm_read(dm_item_t item, unsigned index, void *buf, size_t count)
 		return -1;
 	}
 
+	if (g_dm_ops->direct) {
+		const hrt_abstime start = hrt_absolute_time();
+		g_func_counts[dm_read_func].fetch_add(1);
+		ssize_t ret = g_dm_ops->read(item, index, buf, count);
+		perf_set_elapsed(_dm_read_perf, hrt_elapsed_time(&start));
+		return ret;
+	}
+
 	perf_begin(_dm_read_perf);
 
 	/* get a work item and queue up a read request */
@@ -856,6 +1214,17 @@ dm_clear(dm_item_t item)
 		return -1;
 	}
 
+	if (g_dm_ops->direct) {
+		g_func_counts[dm_clear_func].fetch_add(1);
+		int ret = g_dm_ops->clear(item);
+
+		if (ret == 0) {
+			ret = g_dm_ops->commit();
+		}
+
+		return ret;
+	}
+
 	/* get a work item and queue up a clear request */
 	if ((work = create_work_item()) == nullptr) {
 		PX4_ERR("dm_clear create_work_item failed");
@@ -927,6 +1296,11 @@ dm_unlock(dm_item_t item)
 	}
 
 	if (g_item_locks[item]) {
+		/* the transaction is complete, make it persistent before the next one can start */
+		if (g_dm_ops->commit) {
+			g_dm_ops->commit();
+		}
+
 		px4_sem_post(g_item_locks[item]);
 	}
 }
@@ -944,6 +1318,13 @@ task_main(int argc, char *argv[])
 		g_dm_ops = &dm_ram_operations;
 		break;
 
+#if defined(__PX4_POSIX)
+
+	case BACKEND_MMAP:
+		g_dm_ops = &dm_mmap_operations;
+		break;
+#endif
+
 	default:
 		PX4_WARN("No valid backend set.");
 		return -1;
@@ -962,9 +1343,11 @@ task_main(int argc, char *argv[])
 			      g_per_item_size[DM_KEY_NUM_KEYS - 1]);
 
 	for (unsigned i = 0; i < dm_number_of_funcs; i++) {
-		g_func_counts[i] = 0;
+		g_func_counts[i].store(0);
 	}
 
+	g_commit_count.store(0);
+
 	/* Initialize the item type locks, for now only DM_KEY_MISSION_STATE & DM_KEY_FENCE_POINTS supports locking */
 	px4_sem_init(&g_sys_state_mutex_mission, 1, 1); /* Initially unlocked */
 	px4_sem_init(&g_sys_state_mutex_fence, 1, 1); /* Initially unlocked */
@@ -1007,6 +1390,10 @@ task_main(int argc, char *argv[])
 		PX4_INFO("data manager RAM size is %u bytes", max_offset);
 		break;
 
+	case BACKEND_MMAP:
+		PX4_INFO("data manager mapped file '%s' size is %u bytes", k_data_manager_device_path, max_offset);
+		break;
+
 	default:
 		break;
 	}
@@ -1029,19 +1416,19 @@ task_main(int argc, char *argv[])
 			/* handle each work item with the appropriate handler */
 			switch (work->func) {
 			case dm_write_func:
-				g_func_counts[dm_write_func]++;
+				g_func_counts[dm_write_func].fetch_add(1);
 				work->result =
 					g_dm_ops->write(work->write_params.item, work->write_params.index, work->write_params.buf, work->write_params.count);
 				break;
 
 			case dm_read_func:
-				g_func_counts[dm_read_func]++;
+				g_func_counts[dm_read_func].fetch_add(1);
 				work->result =
 					g_dm_ops->read(work->read_params.item, work->read_params.index, work->read_params.buf, work->read_params.count);
 				break;
 
 			case dm_clear_func:
-				g_func_counts[dm_clear_func]++;
+				g_func_counts[dm_clear_func].fetch_add(1);
 				work->result = g_dm_ops->clear(work->clear_params.item);
 				break;
 
@@ -1121,9 +1508,14 @@ static void
 status()
 {
 	/* display usage statistics */
-	PX4_INFO("Writes   %u", g_func_counts[dm_write_func]);
-	PX4_INFO("Reads    %u", g_func_counts[dm_read_func]);
-	PX4_INFO("Clears   %u", g_func_counts[dm_clear_func]);
+	PX4_INFO("Writes   %u", g_func_counts[dm_write_func].load());
+	PX4_INFO("Reads    %u", g_func_counts[dm_read_func].load());
+	PX4_INFO("Clears   %u", g_func_counts[dm_clear_func].load());
+
+	if (g_dm_ops->commit) {
+		PX4_INFO("Commits  %u", g_commit_count.load());
+	}
+
 	PX4_INFO("Max Q lengths work %u, free %u", g_work_q.max_size, g_free_q.max_size);
 	perf_print_counter(_dm_read_perf);
 	perf_print_counter(_dm_write_perf);
@@ -1147,6 +1539,7 @@ Module to provide persistent storage for the rest of the system in form of a sim
 Multiple backends are supported:
 - a file (eg. on the SD card)
 - RAM (this is obviously not persistent)
+- a memory mapped file (POSIX only)
 
 It is used to store structured data of different types: mission waypoints, mission state and geofence polygons.
 Each type has a specific type and a fixed maximum amount of storage items, so that fast random access is possible.
@@ -1160,20 +1553,32 @@ which stores the number of items for these types. These items are always updated
 the mavlink mission manager). During that time, navigator will try to acquire the geofence item lock, fail, and will not
 check for geofence violations.
 
+With the memory mapped file backend, reads, writes and clears run in the caller's thread instead of being queued to the
+dataman task. Writes only modify the mapping and are written to the file with a single msync when a transaction is
+committed: on `dm_unlock`, `dm_clear`, when writing the mission state or the stats entry of the fence or safe points,
+and otherwise once per second.
+
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("dataman", "system");
 	PRINT_MODULE_USAGE_COMMAND("start");
 	PRINT_MODULE_USAGE_PARAM_STRING('f', nullptr, "<file>", "Storage file", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('r', "Use RAM backend (NOT persistent)", true);
-	PRINT_MODULE_USAGE_PARAM_COMMENT("The options -f and -r are mutually exclusive. If nothing is specified, a file 'dataman' is used");
+	PRINT_MODULE_USAGE_PARAM_FLAG('m', "Memory map the storage file (POSIX only)", true);
+	PRINT_MODULE_USAGE_PARAM_COMMENT("The option -r is mutually exclusive with -f and -m. If nothing is specified, a file 'dataman' is used");
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 }
 
-static int backend_check()
+/* -f and -m can be combined, -r can't be combined with either of them */
+static int backend_check(int option)
 {
-	if (backend != BACKEND_NONE) {
-		PX4_WARN("-f and -r are mutually exclusive");
+	const bool conflict = (backend == BACKEND_RAM)
+			      || (option == 'r' && backend != BACKEND_NONE)
+			      || (option == 'f' && k_data_manager_device_path != nullptr)
+			      || (option == 'm' && backend == BACKEND_MMAP);
+
+	if (conflict) {
+		PX4_WARN("-r is mutually exclusive with -f and -m");
 		usage();
 		return -1;
 	}
@@ -1202,26 +1607,42 @@ dataman_main(int argc, char *argv[])
 
 		/* jump over start and look at options first */
 
-		while ((ch = px4_getopt(argc, argv, "f:r", &dmoptind, &dmoptarg)) != EOF) {
+		while ((ch = px4_getopt(argc, argv, "f:rm", &dmoptind, &dmoptarg)) != EOF) {
 			switch (ch) {
 			case 'f':
-				if (backend_check()) {
+				if (backend_check(ch)) {
 					return -1;
 				}
 
-				backend = BACKEND_FILE;
+				if (backend == BACKEND_NONE) {
+					backend = BACKEND_FILE;
+				}
+
 				k_data_manager_device_path = strdup(dmoptarg);
 				PX4_INFO("dataman file set to: %s", k_data_manager_device_path);
 				break;
 
 			case 'r':
-				if (backend_check()) {
+				if (backend_check(ch)) {
 					return -1;
 				}
 
 				backend = BACKEND_RAM;
 				break;
 
+			case 'm':
+#if defined(__PX4_POSIX)
+				if (backend_check(ch)) {
+					return -1;
+				}
+
+				backend = BACKEND_MMAP;
+				break;
+#else
+				PX4_WARN("memory mapped backend not supported");
+				return -1;
+#endif
+
 			//no break
 			default:
 				usage();
@@ -1231,6 +1652,9 @@ dataman_main(int argc, char *argv[])
 
 		if (backend == BACKEND_NONE) {
 			backend = BACKEND_FILE;
+		}
+
+		if (backend != BACKEND_RAM && k_data_manager_device_path == nullptr) {
 			k_data_manager_device_path = strdup(default_device_path);
 		}
 
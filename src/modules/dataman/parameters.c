@@ -38,7 +38,7 @@
  * @value -1 Disabled
  * @value 0 default (SD card)
  * @value 1 RAM (not persistent)
- * @boolean
+ * @value 2 memory mapped file (POSIX only)
  * @reboot_required true
  */
 PARAM_DEFINE_INT32(SYS_DM_BACKEND, 0);
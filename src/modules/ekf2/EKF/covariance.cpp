@@ -487,7 +487,7 @@ void Ekf::predictCovariance()
 
 
 	// covariance update
-	SquareMatrix24f nextP;
+	SymmetricMatrix24f nextP;
 
 	// calculate variances and upper diagonal covariances for quaternion, velocity, position and gyro bias states
 
@@ -873,30 +873,20 @@ void Ekf::predictCovariance()
 		for (uint8_t i = 7; i <= 8; i++) {
 			for (uint8_t j = 0; j < _k_num_states; j++) {
 				nextP(i, j) = P(i, j);
-				nextP(j, i) = P(j, i);
 			}
 		}
 	}
 
-	// covariance matrix is symmetrical, so copy upper half to lower half
-	for (unsigned row = 1; row < _k_num_states; row++) {
-		for (unsigned column = 0 ; column < row; column++) {
-			P(row, column) = P(column, row) = nextP(column, row);
-		}
-	}
-
-	// copy variances (diagonals)
-	for (unsigned i = 0; i < _k_num_states; i++) {
-		P(i, i) = nextP(i, i);
-	}
+	// only the upper triangle is stored, so this is the whole covariance matrix
+	P = nextP;
 
 	// fix gross errors in the covariance matrix and ensure rows and
 	// columns for un-used states are zero
-	fixCovarianceErrors(false);
+	fixCovarianceErrors();
 
 }
 
-void Ekf::fixCovarianceErrors(bool force_symmetry)
+void Ekf::fixCovarianceErrors()
 {
 	// NOTE: This limiting is a last resort and should not be relied on
 	// TODO: Split covariance prediction into separate F*P*transpose(F) and Q contributions
@@ -933,11 +923,6 @@ void Ekf::fixCovarianceErrors(bool force_symmetry)
 		P(i, i) = math::constrain(P(i, i), 0.0f, P_lim[3]);
 	}
 
-	// force symmetry on the quaternion, velocity and position state covariances
-	if (force_symmetry) {
-		P.makeRowColSymmetric<13>(0);
-	}
-
 	// the following states are optional and are deactivated when not required
 	// by ensuring the corresponding covariance matrix values are kept at zero
 
@@ -1016,10 +1001,6 @@ void Ekf::fixCovarianceErrors(bool force_symmetry)
 			_fault_status.flags.bad_acc_bias = false;
 			_warning_events.flags.invalid_accel_bias_cov_reset = true;
 			ECL_WARN("invalid accel bias - covariance reset");
-
-		} else if (force_symmetry) {
-			// ensure the covariance values are symmetrical
-			P.makeRowColSymmetric<3>(13);
 		}
 
 	}
@@ -1037,13 +1018,6 @@ void Ekf::fixCovarianceErrors(bool force_symmetry)
 		for (int i = 19; i <= 21; i++) {
 			P(i, i) = math::constrain(P(i, i), 0.0f, P_lim[6]);
 		}
-
-		// force symmetry
-		if (force_symmetry) {
-			P.makeRowColSymmetric<3>(16);
-			P.makeRowColSymmetric<3>(19);
-		}
-
 	}
 
 	// wind velocity states
@@ -1055,17 +1029,12 @@ void Ekf::fixCovarianceErrors(bool force_symmetry)
 		for (int i = 22; i <= 23; i++) {
 			P(i, i) = math::constrain(P(i, i), 0.0f, P_lim[7]);
 		}
-
-		// force symmetry
-		if (force_symmetry) {
-			P.makeRowColSymmetric<2>(22);
-		}
 	}
 }
 
 // if the covariance correction will result in a negative variance, then
 // the covariance matrix is unhealthy and must be corrected
-bool Ekf::checkAndFixCovarianceUpdate(const SquareMatrix24f &KHP)
+bool Ekf::checkAndFixCovarianceUpdate(const SymmetricMatrix24f &KHP)
 {
 	bool healthy = true;
 
@@ -1161,7 +1130,6 @@ void Ekf::resetWindCovarianceUsingAirspeed()
 	P(22, 22) = R_TAS * sq(cos_yaw) + R_yaw * sq(-Wx * sin_yaw - Wy * cos_yaw) + initial_wind_var_body_y * sq(sin_yaw);
 	P(22, 23) = R_TAS * sin_yaw * cos_yaw + R_yaw * (-Wx * sin_yaw - Wy * cos_yaw) * (Wx * cos_yaw - Wy * sin_yaw) -
 		    initial_wind_var_body_y * sin_yaw * cos_yaw;
-	P(23, 22) = P(22, 23);
 	P(23, 23) = R_TAS * sq(sin_yaw) + R_yaw * sq(Wx * cos_yaw - Wy * sin_yaw) + initial_wind_var_body_y * sq(cos_yaw);
 
 	// Now add the variance due to uncertainty in vehicle velocity that was used to calculate the initial wind speed
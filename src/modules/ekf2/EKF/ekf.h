@@ -55,6 +55,7 @@ public:
 
 	typedef matrix::Vector<float, _k_num_states> Vector24f;
 	typedef matrix::SquareMatrix<float, _k_num_states> SquareMatrix24f;
+	typedef matrix::SymmetricMatrix<float, _k_num_states> SymmetricMatrix24f;
 	typedef matrix::SquareMatrix<float, 2> Matrix2f;
 	typedef matrix::Vector<float, 4> Vector4f;
 	template<int ... Idxs>
@@ -131,13 +132,13 @@ public:
 	const Vector2f &getWindVelocity() const { return _state.wind_vel; };
 
 	// get the wind velocity var
-	Vector2f getWindVelocityVariance() const { return P.slice<2, 2>(22, 22).diag(); }
+	Vector2f getWindVelocityVariance() const { return P.diag().slice<2, 1>(22, 0); }
 
 	// get the true airspeed in m/s
 	float getTrueAirspeed() const;
 
 	// get the full covariance matrix
-	const matrix::SquareMatrix<float, 24> &covariances() const { return P; }
+	matrix::SquareMatrix<float, 24> covariances() const { return P.full(); }
 
 	// get the diagonal elements of the covariance matrix
 	matrix::Vector<float, 24> covariances_diagonal() const { return P.diag(); }
@@ -183,9 +184,9 @@ public:
 	// Reset all magnetometer bias states and covariances to initial alignment values.
 	void resetMagBias();
 
-	Vector3f getVelocityVariance() const { return P.slice<3, 3>(4, 4).diag(); };
+	Vector3f getVelocityVariance() const { return P.diag().slice<3, 1>(4, 0); };
 
-	Vector3f getPositionVariance() const { return P.slice<3, 3>(7, 7).diag(); }
+	Vector3f getPositionVariance() const { return P.diag().slice<3, 1>(7, 0); }
 
 	// return an array containing the output predictor angular, velocity and position tracking
 	// error magnitudes (rad), (m/sec), (m)
@@ -415,7 +416,7 @@ private:
 	bool _non_mag_yaw_aiding_running_prev{false};  ///< true when heading is being fused from other sources that are not the magnetometer (for example EV or GPS).
 	bool _is_yaw_fusion_inhibited{false};		///< true when yaw sensor use is being inhibited
 
-	SquareMatrix24f P{};	///< state covariance matrix
+	SymmetricMatrix24f P{};	///< state covariance matrix
 
 	Vector3f _delta_vel_bias_var_accum{};		///< kahan summation algorithm accumulator for delta velocity bias variance
 	Vector3f _delta_angle_bias_var_accum{};	///< kahan summation algorithm accumulator for delta angle bias variance
@@ -725,29 +726,20 @@ private:
 	// matrix vector multiplication for computing K<24,1> * H<1,24> * P<24,24>
 	// that is optimized by exploring the sparsity in H
 	template <size_t ...Idxs>
-	SquareMatrix24f computeKHP(const Vector24f &K, const SparseVector24f<Idxs...> &H) const
+	SymmetricMatrix24f computeKHP(const Vector24f &K, const SparseVector24f<Idxs...> &H) const
 	{
-		SquareMatrix24f KHP;
-		constexpr size_t non_zeros = sizeof...(Idxs);
-		float KH[non_zeros];
+		// H * P, which is also (P * H^T)^T as P is symmetric
+		Vector24f HP;
 
-		for (unsigned row = 0; row < _k_num_states; row++) {
-			for (unsigned i = 0; i < H.non_zeros(); i++) {
-				KH[i] = K(row) * H.atCompressedIndex(i);
-			}
-
-			for (unsigned column = 0; column < _k_num_states; column++) {
-				float tmp = 0.f;
-
-				for (unsigned i = 0; i < H.non_zeros(); i++) {
-					const size_t index = H.index(i);
-					tmp += KH[i] * P(index, column);
-				}
-
-				KHP(row, column) = tmp;
-			}
+		for (unsigned i = 0; i < H.non_zeros(); i++) {
+			HP += H.atCompressedIndex(i) * P.row(H.index(i));
 		}
 
+		// K * H * P is only symmetric if K = P * H^T / S, use its symmetric part
+		// as some states are excluded from the update by zeroing their gain
+		SymmetricMatrix24f KHP;
+		KHP.setSymmetricOuterProduct(K, HP);
+
 		return KHP;
 	}
 
@@ -765,7 +757,7 @@ private:
 		// apply covariance correction via P_new = (I -K*H)*P
 		// first calculate expression for KHP
 		// then calculate P - KHP
-		const SquareMatrix24f KHP = computeKHP(K, H);
+		const SymmetricMatrix24f KHP = computeKHP(K, H);
 
 		const bool is_healthy = checkAndFixCovarianceUpdate(KHP);
 
@@ -773,7 +765,7 @@ private:
 			// apply the covariance corrections
 			P -= KHP;
 
-			fixCovarianceErrors(true);
+			fixCovarianceErrors();
 
 			// apply the state corrections
 			fuse(K, innovation);
@@ -784,11 +776,10 @@ private:
 
 	// if the covariance correction will result in a negative variance, then
 	// the covariance matrix is unhealthy and must be corrected
-	bool checkAndFixCovarianceUpdate(const SquareMatrix24f &KHP);
+	bool checkAndFixCovarianceUpdate(const SymmetricMatrix24f &KHP);
 
 	// limit the diagonal of the covariance matrix
-	// force symmetry when the argument is true
-	void fixCovarianceErrors(bool force_symmetry);
+	void fixCovarianceErrors();
 
 	// constrain the ekf states
 	void constrainStates();
@@ -679,24 +679,13 @@ void Ekf::updateQuaternion(const float innovation, const float variance, const f
 	// apply covariance correction via P_new = (I -K*H)*P
 	// first calculate expression for KHP
 	// then calculate P - KHP
-	SquareMatrix24f KHP;
-	float KH[4];
-
-	for (unsigned row = 0; row < _k_num_states; row++) {
-
-		KH[0] = Kfusion(row) * yaw_jacobian(0);
-		KH[1] = Kfusion(row) * yaw_jacobian(1);
-		KH[2] = Kfusion(row) * yaw_jacobian(2);
-		KH[3] = Kfusion(row) * yaw_jacobian(3);
-
-		for (unsigned column = 0; column < _k_num_states; column++) {
-			float tmp = KH[0] * P(0, column);
-			tmp += KH[1] * P(1, column);
-			tmp += KH[2] * P(2, column);
-			tmp += KH[3] * P(3, column);
-			KHP(row, column) = tmp;
-		}
-	}
+	SparseVector24f<0,1,2,3> Hfusion;
+	Hfusion.at<0>() = yaw_jacobian(0);
+	Hfusion.at<1>() = yaw_jacobian(1);
+	Hfusion.at<2>() = yaw_jacobian(2);
+	Hfusion.at<3>() = yaw_jacobian(3);
+
+	const SymmetricMatrix24f KHP = computeKHP(Kfusion, Hfusion);
 
 	const bool healthy = checkAndFixCovarianceUpdate(KHP);
 
@@ -706,7 +695,7 @@ void Ekf::updateQuaternion(const float innovation, const float variance, const f
 		// apply the covariance corrections
 		P -= KHP;
 
-		fixCovarianceErrors(true);
+		fixCovarianceErrors();
 
 		// apply the state corrections
 		fuse(Kfusion, _heading_innov);
@@ -189,18 +189,16 @@ void Ekf::fuseVelPosHeight(const float innov, const float innov_var, const int o
 	Vector24f Kfusion;  // Kalman gain vector for any single observation - sequential fusion is used.
 	const unsigned state_index = obs_index + 4;  // we start with vx and this is the 4. state
 
+	// H selects a single state, so H * P is a row of P
+	const Vector24f HP = P.row(state_index);
+
 	// calculate kalman gain K = PHS, where S = 1/innovation variance
 	for (int row = 0; row < _k_num_states; row++) {
-		Kfusion(row) = P(row, state_index) / innov_var;
+		Kfusion(row) = HP(row) / innov_var;
 	}
 
-	SquareMatrix24f KHP;
-
-	for (unsigned row = 0; row < _k_num_states; row++) {
-		for (unsigned column = 0; column < _k_num_states; column++) {
-			KHP(row, column) = Kfusion(row) * P(state_index, column);
-		}
-	}
+	SymmetricMatrix24f KHP;
+	KHP.setSymmetricOuterProduct(Kfusion, HP);
 
 	// if the covariance correction will result in a negative variance, then
 	// the covariance matrix is unhealthy and must be corrected
@@ -221,7 +219,7 @@ void Ekf::fuseVelPosHeight(const float innov, const float innov_var, const int o
 		// apply the covariance corrections
 		P -= KHP;
 
-		fixCovarianceErrors(true);
+		fixCovarianceErrors();
 
 		// apply the state corrections
 		fuse(Kfusion, innov);
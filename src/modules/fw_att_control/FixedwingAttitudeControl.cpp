@@ -39,6 +39,7 @@ using namespace time_literals;
 using math::constrain;
 using math::gradual;
 using math::radians;
+using fti::InjectionPoint;
 
 FixedwingAttitudeControl::FixedwingAttitudeControl(bool vtol) :
 	ModuleParams(nullptr),
@@ -295,6 +296,7 @@ void FixedwingAttitudeControl::Run()
 			// update parameters from storage
 			updateParams();
 			parameters_update();
+			_flight_test_input.parameters_update();
 		}
 
 		const float dt = math::constrain((att.timestamp - _last_run) * 1e-6f, 0.002f, 0.04f);
@@ -427,10 +429,9 @@ void FixedwingAttitudeControl::Run()
 			/* Prepare data for attitude controllers */
 			ECL_ControlData control_input{};
 
-			//injection WRAP THIS AS A FUNCTION OR SOME SHIT
-			_att_sp.roll_body = _flight_test_input.inject(7, _att_sp.roll_body);
-			_att_sp.pitch_body = _flight_test_input.inject(8, _att_sp.pitch_body);
-			_att_sp.yaw_body = _flight_test_input.inject(9, _att_sp.yaw_body);
+			/* INJECTION FOR ATTITUDE SETPOINTS */
+			_flight_test_input.inject<InjectionPoint::ATTITUDE_ROLL, InjectionPoint::ATTITUDE_PITCH, InjectionPoint::ATTITUDE_YAW>(
+				_att_sp.roll_body, _att_sp.pitch_body, _att_sp.yaw_body);
 
 			control_input.roll = euler_angles.phi();
 			control_input.pitch = euler_angles.theta();
@@ -533,9 +534,8 @@ void FixedwingAttitudeControl::Run()
 					control_input.yaw_rate_setpoint = _yaw_ctrl.get_desired_rate();
 
 					/*INJECTION FOR ATTITUDE RATES FOR SID */
-					control_input.roll_rate_setpoint = _flight_test_input.inject(4, control_input.roll_rate_setpoint);
-					control_input.pitch_rate_setpoint = _flight_test_input.inject(5, control_input.pitch_rate_setpoint);
-					control_input.yaw_rate_setpoint = _flight_test_input.inject(6, control_input.yaw_rate_setpoint);
+					_flight_test_input.inject<InjectionPoint::RATE_ROLL, InjectionPoint::RATE_PITCH, InjectionPoint::RATE_YAW>(
+						control_input.roll_rate_setpoint, control_input.pitch_rate_setpoint, control_input.yaw_rate_setpoint);
 
 					const hrt_abstime now = hrt_absolute_time();
 					autotune_attitude_control_status_s pid_autotune;
@@ -673,9 +673,9 @@ void FixedwingAttitudeControl::Run()
 
 
 		/*INJECTION FOR ACTUATORS*/
-		_actuators.control[0] = _flight_test_input.inject(1, _actuators.control[0]);
-		_actuators.control[1] = _flight_test_input.inject(2, _actuators.control[1]);
-		_actuators.control[2] = _flight_test_input.inject(3, _actuators.control[2]);
+		_flight_test_input.inject<InjectionPoint::ACTUATOR_ROLL, InjectionPoint::ACTUATOR_PITCH, InjectionPoint::ACTUATOR_YAW>(
+			_actuators.control[actuator_controls_s::INDEX_ROLL], _actuators.control[actuator_controls_s::INDEX_PITCH],
+			_actuators.control[actuator_controls_s::INDEX_YAW]);
 
 		/* Only publish if any of the proper modes are enabled */
 		if (_vcontrol_mode.flag_control_rates_enabled ||
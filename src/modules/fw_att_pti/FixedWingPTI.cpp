@@ -40,6 +40,7 @@ using namespace time_literals;
 using math::constrain;
 using math::gradual;
 using math::radians;
+using fti::InjectionPoint;
 
 FixedWingPTI::FixedWingPTI(bool vtol) :
 	ModuleParams(nullptr),
@@ -298,6 +299,7 @@ void FixedWingPTI::Run()
 			// update parameters from storage
 			updateParams();
 			parameters_update();
+			_flight_test_input.parameters_update();
 		}
 
 		const float dt = math::constrain((att.timestamp - _last_run) * 1e-6f, 0.002f, 0.04f);
@@ -432,10 +434,9 @@ void FixedWingPTI::Run()
 			// 		 (double)_att_sp.pitch_body,
 			// 		 (double)_att_sp.yaw_body);
 
-			//injection WRAP THIS AS A FUNCTION OR SOME SHIT
-			_att_sp.roll_body = _flight_test_input.inject(7, _att_sp.roll_body);
-			_att_sp.pitch_body = _flight_test_input.inject(8, _att_sp.pitch_body);
-			_att_sp.yaw_body = _flight_test_input.inject(9, _att_sp.yaw_body);
+			/* INJECTION FOR ATTITUDE SETPOINTS */
+			_flight_test_input.inject<InjectionPoint::ATTITUDE_ROLL, InjectionPoint::ATTITUDE_PITCH, InjectionPoint::ATTITUDE_YAW>(
+				_att_sp.roll_body, _att_sp.pitch_body, _att_sp.yaw_body);
 
 
 			// PX4_INFO("New:\t%8.4f\t%8.4f\t%8.4f",
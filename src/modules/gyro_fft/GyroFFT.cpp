@@ -57,21 +57,66 @@ GyroFFT::~GyroFFT()
 	perf_free(_cycle_perf);
 	perf_free(_cycle_interval_perf);
 	perf_free(_fft_perf);
+	perf_free(_fft_interval_perf);
 	perf_free(_gyro_generation_gap_perf);
 	perf_free(_gyro_fifo_generation_gap_perf);
 
+	FreeBuffers();
+}
+
+void GyroFFT::FreeBuffers()
+{
 	delete[] _gyro_data_buffer_x;
+	_gyro_data_buffer_x = nullptr;
+
 	delete[] _gyro_data_buffer_y;
+	_gyro_data_buffer_y = nullptr;
+
 	delete[] _gyro_data_buffer_z;
+	_gyro_data_buffer_z = nullptr;
+
 	delete[] _hanning_window;
+	_hanning_window = nullptr;
+
 	delete[] _fft_input_buffer;
+	_fft_input_buffer = nullptr;
+
 	delete[] _fft_outupt_buffer;
+	_fft_outupt_buffer = nullptr;
+
+#if defined(GYRO_FFT_F32)
+	delete[] _gyro_data_buffer_x_f32;
+	_gyro_data_buffer_x_f32 = nullptr;
+
+	delete[] _gyro_data_buffer_y_f32;
+	_gyro_data_buffer_y_f32 = nullptr;
+
+	delete[] _gyro_data_buffer_z_f32;
+	_gyro_data_buffer_z_f32 = nullptr;
+
+	delete[] _hanning_window_f32;
+	_hanning_window_f32 = nullptr;
+
+	delete[] _fft_input_buffer_f32;
+	_fft_input_buffer_f32 = nullptr;
+
+	delete[] _fft_output_buffer_f32;
+	_fft_output_buffer_f32 = nullptr;
+#endif // GYRO_FFT_F32
 }
 
 bool GyroFFT::init()
 {
 	bool buffers_allocated = false;
 
+	if (_param_imu_gyro_fft_f32.get()) {
+#if defined(GYRO_FFT_F32)
+		_fft_f32 = true;
+#else
+		PX4_WARN("float32 FFT not supported on this board, using q15");
+#endif // GYRO_FFT_F32
+	}
+
 	// arm_rfft_init_q15(&_rfft_q15, _imu_gyro_fft_len, 0, 1) manually inlined to save flash
 	_rfft_q15.pTwiddleAReal = (q15_t *) realCoefAQ15;
 	_rfft_q15.pTwiddleBReal = (q15_t *) realCoefBQ15;
@@ -91,6 +136,12 @@ bool GyroFFT::init()
 		_rfft_q15.fftLenReal = 256;
 		_rfft_q15.twidCoefRModifier = 32U;
 		_rfft_q15.pCfft = &arm_cfft_sR_q15_len128;
+#if defined(GYRO_FFT_F32)
+		// arm_rfft_fast_init_f32(&_rfft_f32, 256) manually inlined to only link the used tables
+		_rfft_f32.Sint = arm_cfft_sR_f32_len128;
+		_rfft_f32.fftLenRFFT = 256;
+		_rfft_f32.pTwiddleRFFT = (float32_t *)twiddleCoef_rfft_256;
+#endif // GYRO_FFT_F32
 		break;
 
 	case 512:
@@ -98,6 +149,12 @@ bool GyroFFT::init()
 		_rfft_q15.fftLenReal = 512;
 		_rfft_q15.twidCoefRModifier = 16U;
 		_rfft_q15.pCfft = &arm_cfft_sR_q15_len256;
+#if defined(GYRO_FFT_F32)
+		// arm_rfft_fast_init_f32(&_rfft_f32, 512) manually inlined to only link the used tables
+		_rfft_f32.Sint = arm_cfft_sR_f32_len256;
+		_rfft_f32.fftLenRFFT = 512;
+		_rfft_f32.pTwiddleRFFT = (float32_t *)twiddleCoef_rfft_512;
+#endif // GYRO_FFT_F32
 		break;
 
 	case 1024:
@@ -105,6 +162,12 @@ bool GyroFFT::init()
 		_rfft_q15.fftLenReal = 1024;
 		_rfft_q15.twidCoefRModifier = 8U;
 		_rfft_q15.pCfft = &arm_cfft_sR_q15_len512;
+#if defined(GYRO_FFT_F32)
+		// arm_rfft_fast_init_f32(&_rfft_f32, 1024) manually inlined to only link the used tables
+		_rfft_f32.Sint = arm_cfft_sR_f32_len512;
+		_rfft_f32.fftLenRFFT = 1024;
+		_rfft_f32.pTwiddleRFFT = (float32_t *)twiddleCoef_rfft_1024;
+#endif // GYRO_FFT_F32
 		break;
 
 	// case 2048:
@@ -119,6 +182,12 @@ bool GyroFFT::init()
 		_rfft_q15.fftLenReal = 4096;
 		_rfft_q15.twidCoefRModifier = 2U;
 		_rfft_q15.pCfft = &arm_cfft_sR_q15_len2048;
+#if defined(GYRO_FFT_F32)
+		// arm_rfft_fast_init_f32(&_rfft_f32, 4096) manually inlined to only link the used tables
+		_rfft_f32.Sint = arm_cfft_sR_f32_len2048;
+		_rfft_f32.fftLenRFFT = 4096;
+		_rfft_f32.pTwiddleRFFT = (float32_t *)twiddleCoef_rfft_4096;
+#endif // GYRO_FFT_F32
 		break;
 
 	// case 8192:
@@ -132,17 +201,49 @@ bool GyroFFT::init()
 		// otherwise default to 256
 		PX4_ERR("Invalid IMU_GYRO_FFT_LEN=%" PRId32 ", resetting", _param_imu_gyro_fft_len.get());
 		buffers_allocated = AllocateBuffers<256>();
+		_rfft_q15.fftLenReal = 256;
+		_rfft_q15.twidCoefRModifier = 32U;
+		_rfft_q15.pCfft = &arm_cfft_sR_q15_len128;
+#if defined(GYRO_FFT_F32)
+		_rfft_f32.Sint = arm_cfft_sR_f32_len128;
+		_rfft_f32.fftLenRFFT = 256;
+		_rfft_f32.pTwiddleRFFT = (float32_t *)twiddleCoef_rfft_256;
+#endif // GYRO_FFT_F32
 		_param_imu_gyro_fft_len.set(256);
 		_param_imu_gyro_fft_len.commit();
 		break;
 	}
 
+	switch (_param_imu_gyro_fft_ovl.get()) {
+	case 50:
+	case 75:
+		break;
+
+	default:
+		PX4_ERR("Invalid IMU_GYRO_FFT_OVL=%" PRId32 ", resetting", _param_imu_gyro_fft_ovl.get());
+		_param_imu_gyro_fft_ovl.set(75);
+		_param_imu_gyro_fft_ovl.commit();
+		break;
+	}
+
 	if (buffers_allocated) {
 		_imu_gyro_fft_len = _param_imu_gyro_fft_len.get();
+		_imu_gyro_fft_ovl = _param_imu_gyro_fft_ovl.get();
+		_fft_hop = _imu_gyro_fft_len * (100 - _imu_gyro_fft_ovl) / 100;
 
 		// init Hanning window
 		for (int n = 0; n < _imu_gyro_fft_len; n++) {
 			const float hanning_value = 0.5f * (1.f - cosf(2.f * M_PI_F * n / (_imu_gyro_fft_len - 1)));
+
+#if defined(GYRO_FFT_F32)
+
+			if (_fft_f32) {
+				_hanning_window_f32[n] = hanning_value;
+				continue;
+			}
+
+#endif // GYRO_FFT_F32
+
 			arm_float_to_q15(&hanning_value, &_hanning_window[n], 1);
 		}
 
@@ -154,12 +255,7 @@ bool GyroFFT::init()
 	}
 
 	PX4_ERR("failed to allocate buffers");
-	delete[] _gyro_data_buffer_x;
-	delete[] _gyro_data_buffer_y;
-	delete[] _gyro_data_buffer_z;
-	delete[] _hanning_window;
-	delete[] _fft_input_buffer;
-	delete[] _fft_outupt_buffer;
+	FreeBuffers();
 
 	return false;
 }
@@ -395,13 +491,27 @@ void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint
 {
 	q15_t *gyro_data_buffer[] {_gyro_data_buffer_x, _gyro_data_buffer_y, _gyro_data_buffer_z};
 
+#if defined(GYRO_FFT_F32)
+	float *gyro_data_buffer_f32[] {_gyro_data_buffer_x_f32, _gyro_data_buffer_y_f32, _gyro_data_buffer_z_f32};
+#endif // GYRO_FFT_F32
+
 	for (int axis = 0; axis < 3; axis++) {
 		int &buffer_index = _fft_buffer_index[axis];
 
 		for (int n = 0; n < N; n++) {
 			if (buffer_index < _imu_gyro_fft_len) {
-				// convert int16_t -> q15_t (scaling isn't relevant)
-				gyro_data_buffer[axis][buffer_index] = input[axis][n] / 2;
+#if defined(GYRO_FFT_F32)
+
+				if (_fft_f32) {
+					gyro_data_buffer_f32[axis][buffer_index] = input[axis][n];
+
+				} else
+#endif // GYRO_FFT_F32
+				{
+					// convert int16_t -> q15_t (scaling isn't relevant)
+					gyro_data_buffer[axis][buffer_index] = input[axis][n] / 2;
+				}
+
 				buffer_index++;
 			}
 
@@ -409,18 +519,41 @@ void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint
 			if ((buffer_index >= _imu_gyro_fft_len) && !_fft_updated) {
 				perf_begin(_fft_perf);
 
-				arm_mult_q15(gyro_data_buffer[axis], _hanning_window, _fft_input_buffer, _imu_gyro_fft_len);
-				arm_rfft_q15(&_rfft_q15, _fft_input_buffer, _fft_outupt_buffer);
+				if (axis == 0) {
+					perf_count(_fft_interval_perf);
+				}
+
+				// shift buffer (IMU_GYRO_FFT_OVL overlap)
+				const int overlap = _imu_gyro_fft_len - _fft_hop;
+
+#if defined(GYRO_FFT_F32)
+
+				if (_fft_f32) {
+					arm_mult_f32(gyro_data_buffer_f32[axis], _hanning_window_f32, _fft_input_buffer_f32,
+						     _imu_gyro_fft_len);
+					arm_rfft_fast_f32(&_rfft_f32, _fft_input_buffer_f32, _fft_output_buffer_f32, 0);
 
-				_fft_updated = true;
+					_fft_updated = true;
 
-				FindPeaks(timestamp_sample, axis, _fft_outupt_buffer);
+					FindPeaksF32(timestamp_sample, axis, _fft_output_buffer_f32);
 
-				// reset
-				// shift buffer (3/4 overlap)
-				const int overlap_start = _imu_gyro_fft_len / 4;
-				memmove(&gyro_data_buffer[axis][0], &gyro_data_buffer[axis][overlap_start], sizeof(q15_t) * overlap_start * 3);
-				buffer_index = overlap_start * 3;
+					memmove(&gyro_data_buffer_f32[axis][0], &gyro_data_buffer_f32[axis][_fft_hop],
+						sizeof(float) * overlap);
+
+				} else
+#endif // GYRO_FFT_F32
+				{
+					arm_mult_q15(gyro_data_buffer[axis], _hanning_window, _fft_input_buffer, _imu_gyro_fft_len);
+					arm_rfft_q15(&_rfft_q15, _fft_input_buffer, _fft_outupt_buffer);
+
+					_fft_updated = true;
+
+					FindPeaks(timestamp_sample, axis, _fft_outupt_buffer);
+
+					memmove(&gyro_data_buffer[axis][0], &gyro_data_buffer[axis][_fft_hop], sizeof(q15_t) * overlap);
+				}
+
+				buffer_index = overlap;
 
 				perf_end(_fft_perf);
 			}
@@ -511,6 +644,159 @@ void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *ff
 	}
 }
 
+#if defined(GYRO_FFT_F32)
+// magnitude squared of bin k > 0 of the arm_rfft_fast_f32 output
+//  [real[0], real[N/2], real[1], imag[1], ..., real[N/2-1], imag[N/2-1]]
+static inline float BinMagnitudeSquared(const float fft[], int k)
+{
+	return fft[2 * k] * fft[2 * k] + fft[2 * k + 1] * fft[2 * k + 1];
+}
+
+void GyroFFT::FindPeaksF32(const hrt_abstime &timestamp_sample, int axis, const float fft_output_buffer[])
+{
+	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
+
+	// bins in range, excluding the first and last bin so every bin has two neighbours
+	const int bin_min = math::max((int)ceilf(_param_imu_gyro_fft_min.get() / resolution_hz), 2);
+	const int bin_max = math::min((int)floorf(_param_imu_gyro_fft_max.get() / resolution_hz), _imu_gyro_fft_len / 2 - 2);
+
+	// sum total energy across all used bins for SNR
+	float bin_mag_sum = 0;
+
+	// find the largest local maxima, sorted by magnitude
+	int raw_peak_index[MAX_NUM_PEAKS] {};
+	float peak_magnitude[MAX_NUM_PEAKS] {};
+
+	float magnitude_prev = BinMagnitudeSquared(fft_output_buffer, bin_min - 1);
+	float magnitude = BinMagnitudeSquared(fft_output_buffer, bin_min);
+
+	for (int bin = bin_min; bin <= bin_max; bin++) {
+		const float magnitude_next = BinMagnitudeSquared(fft_output_buffer, bin + 1);
+		bin_mag_sum += magnitude;
+
+		if ((magnitude > magnitude_prev) && (magnitude >= magnitude_next)) {
+			for (int i = 0; i < MAX_NUM_PEAKS; i++) {
+				if (magnitude > peak_magnitude[i]) {
+					for (int j = MAX_NUM_PEAKS - 1; j > i; j--) {
+						peak_magnitude[j] = peak_magnitude[j - 1];
+						raw_peak_index[j] = raw_peak_index[j - 1];
+					}
+
+					peak_magnitude[i] = magnitude;
+					raw_peak_index[i] = bin;
+					break;
+				}
+			}
+		}
+
+		magnitude_prev = magnitude;
+		magnitude = magnitude_next;
+	}
+
+	static constexpr float MIN_SNR = 1.f;
+
+	int num_peaks_found = 0;
+	float peak_frequencies[MAX_NUM_PEAKS] {};
+	float peak_snr[MAX_NUM_PEAKS] {};
+
+	float *peak_frequencies_publish[] { _sensor_gyro_fft.peak_frequencies_x, _sensor_gyro_fft.peak_frequencies_y, _sensor_gyro_fft.peak_frequencies_z };
+
+	for (int peak_new = 0; peak_new < MAX_NUM_PEAKS; peak_new++) {
+		const int bin = raw_peak_index[peak_new];
+
+		if (bin > 0) {
+			// same SNR definition as the q15 FFT so IMU_GYRO_FFT_SNR applies to both
+			const float snr = 10.f * log10f((_imu_gyro_fft_len - 1) * peak_magnitude[peak_new] /
+							(bin_mag_sum - peak_magnitude[peak_new]));
+
+			if (snr > MIN_SNR) {
+				// quadratic interpolation of the peak magnitude and its neighbours
+				const float m0 = sqrtf(BinMagnitudeSquared(fft_output_buffer, bin - 1));
+				const float m1 = sqrtf(peak_magnitude[peak_new]);
+				const float m2 = sqrtf(BinMagnitudeSquared(fft_output_buffer, bin + 1));
+
+				const float denominator = m0 - 2.f * m1 + m2;
+				const float delta = (fabsf(denominator) > FLT_EPSILON) ? 0.5f * (m0 - m2) / denominator : 0.f;
+
+				const float freq_adjusted = (bin + math::constrain(delta, -0.5f, 0.5f)) * resolution_hz;
+
+				if (PX4_ISFINITE(freq_adjusted)
+				    && (freq_adjusted > _param_imu_gyro_fft_min.get())
+				    && (freq_adjusted < _param_imu_gyro_fft_max.get())) {
+
+					// only keep if we're already tracking this frequency or if the SNR is significant
+					for (int peak_prev = 0; peak_prev < MAX_NUM_PEAKS; peak_prev++) {
+						if ((snr > _param_imu_gyro_fft_snr.get())
+						    || (fabsf(freq_adjusted - peak_frequencies_publish[axis][peak_prev]) < (resolution_hz * 0.5f))) {
+							// keep
+							peak_frequencies[num_peaks_found] = freq_adjusted;
+							peak_snr[num_peaks_found] = snr;
+							num_peaks_found++;
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (num_peaks_found > 0) {
+		UpdateOutput(timestamp_sample, axis, peak_frequencies, peak_snr, num_peaks_found);
+	}
+}
+#endif // GYRO_FFT_F32
+
+float GyroFFT::FilterPeakFrequency(const hrt_abstime &timestamp_sample, int axis, int slot, float peak_frequency,
+				  bool new_peak)
+{
+#if defined(GYRO_FFT_F32)
+
+	if (_fft_f32) {
+		// interpolated peak frequency standard deviation relative to the FFT resolution
+		static constexpr float PEAK_FREQUENCY_NOISE = 0.25f;
+		// peak frequency rate of change standard deviation (Hz/s), e.g. motor spin up
+		static constexpr float PEAK_FREQUENCY_RATE_NOISE = 100.f;
+
+		PeakTracker &tracker = _peak_tracker[axis][slot];
+
+		const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
+		const float measurement_variance = math::sq(PEAK_FREQUENCY_NOISE * resolution_hz);
+
+		bool reset = new_peak || !PX4_ISFINITE(tracker.frequency) || (tracker.timestamp == 0)
+			     || (timestamp_sample <= tracker.timestamp);
+
+		if (!reset) {
+			const float dt = math::min((timestamp_sample - tracker.timestamp) * 1e-6f, 1.f);
+			const float variance = tracker.variance + math::sq(PEAK_FREQUENCY_RATE_NOISE * dt);
+			const float innovation = peak_frequency - tracker.frequency;
+			const float innovation_variance = variance + measurement_variance;
+
+			if (math::sq(innovation) < math::sq(3.f) * innovation_variance) {
+				const float gain = variance / innovation_variance;
+				tracker.frequency += gain * innovation;
+				tracker.variance = (1.f - gain) * variance;
+
+			} else {
+				// frequency jumped, start tracking the new peak
+				reset = true;
+			}
+		}
+
+		if (reset) {
+			tracker.frequency = peak_frequency;
+			tracker.variance = measurement_variance;
+		}
+
+		tracker.timestamp = timestamp_sample;
+
+		return tracker.frequency;
+	}
+
+#endif // GYRO_FFT_F32
+
+	return _median_filter[axis][slot].apply(peak_frequency);
+}
+
 void GyroFFT::UpdateOutput(const hrt_abstime &timestamp_sample, int axis, float peak_frequencies[MAX_NUM_PEAKS],
 			   float peak_snr[MAX_NUM_PEAKS], int num_peaks_found)
 {
@@ -566,7 +852,8 @@ void GyroFFT::UpdateOutput(const hrt_abstime &timestamp_sample, int axis, float
 
 		if (PX4_ISFINITE(smallest_diff) && (smallest_diff > 0)) {
 			// smallest diff found, copy newly found peak into same slot previously published
-			float peak_frequency = _median_filter[axis][closest_prev_peak].apply(peak_frequencies[closest_new_peak]);
+			float peak_frequency = FilterPeakFrequency(timestamp_sample, axis, closest_prev_peak,
+					       peak_frequencies[closest_new_peak], false);
 
 			if (peak_frequency > 0) {
 				peak_frequencies_publish[axis][closest_prev_peak] = peak_frequency;
@@ -617,7 +904,8 @@ void GyroFFT::UpdateOutput(const hrt_abstime &timestamp_sample, int axis, float
 
 				if (oldest_slot >= 0) {
 					// copy peak to output slot
-					float peak_frequency = _median_filter[axis][oldest_slot].apply(peak_frequencies[peak_new]);
+					float peak_frequency = FilterPeakFrequency(timestamp_sample, axis, oldest_slot,
+							       peak_frequencies[peak_new], true);
 
 					if (peak_frequency > 0) {
 						peak_frequencies_publish[axis][oldest_slot] = peak_frequency;
@@ -668,9 +956,28 @@ int GyroFFT::task_spawn(int argc, char *argv[])
 int GyroFFT::print_status()
 {
 	PX4_INFO("gyro sample rate: %.3f Hz", (double)_gyro_sample_rate_hz);
+
+	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
+	PX4_INFO("FFT: %s, length: %" PRId32 ", overlap: %" PRId32 "%%, resolution: %.1f Hz", _fft_f32 ? "float32" : "q15",
+		 _imu_gyro_fft_len, _imu_gyro_fft_ovl, (double)resolution_hz);
+
+	// a peak estimate is based on a window centered half the FFT length in the past and is refreshed every update interval
+	const float update_interval_s = perf_mean(_fft_interval_perf);
+	const float window_delay_s = 0.5f * _imu_gyro_fft_len / _gyro_sample_rate_hz;
+
+	if (update_interval_s > 0.f) {
+		// 3 FFTs (x, y, z) per update interval
+		const float cpu_load = 3.f * perf_mean(_fft_perf) / update_interval_s;
+
+		PX4_INFO("update interval: %.1f ms, latency: %.1f ms, FFT CPU load: %.2f%%",
+			 (double)(update_interval_s * 1e3f), (double)((window_delay_s + 0.5f * update_interval_s) * 1e3f),
+			 (double)(cpu_load * 100.f));
+	}
+
 	perf_print_counter(_cycle_perf);
 	perf_print_counter(_cycle_interval_perf);
 	perf_print_counter(_fft_perf);
+	perf_print_counter(_fft_interval_perf);
 	perf_print_counter(_gyro_generation_gap_perf);
 	perf_print_counter(_gyro_fifo_generation_gap_perf);
 	return 0;
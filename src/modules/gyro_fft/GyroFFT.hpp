@@ -87,6 +87,11 @@ private:
 	void Run() override;
 	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer);
 	inline float EstimatePeakFrequencyBin(q15_t fft[], int peak_index);
+#if defined(GYRO_FFT_F32)
+	inline void FindPeaksF32(const hrt_abstime &timestamp_sample, int axis, const float fft_output_buffer[]);
+#endif // GYRO_FFT_F32
+	inline float FilterPeakFrequency(const hrt_abstime &timestamp_sample, int axis, int slot, float peak_frequency,
+					 bool new_peak);
 	inline void Publish();
 	bool SensorSelectionUpdate(bool force = false);
 	void Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N);
@@ -94,9 +99,29 @@ private:
 				 float peak_snr[MAX_NUM_PEAKS], int num_peaks_found);
 	void VehicleIMUStatusUpdate(bool force = false);
 
+	void FreeBuffers();
+
 	template<size_t N>
 	bool AllocateBuffers()
 	{
+#if defined(GYRO_FFT_F32)
+
+		if (_fft_f32) {
+			_gyro_data_buffer_x_f32 = new float[N];
+			_gyro_data_buffer_y_f32 = new float[N];
+			_gyro_data_buffer_z_f32 = new float[N];
+			_hanning_window_f32 = new float[N];
+			_fft_input_buffer_f32 = new float[N];
+			_fft_output_buffer_f32 = new float[N];
+
+			return (_gyro_data_buffer_x_f32 && _gyro_data_buffer_y_f32 && _gyro_data_buffer_z_f32
+				&& _hanning_window_f32
+				&& _fft_input_buffer_f32
+				&& _fft_output_buffer_f32);
+		}
+
+#endif // GYRO_FFT_F32
+
 		_gyro_data_buffer_x = new q15_t[N];
 		_gyro_data_buffer_y = new q15_t[N];
 		_gyro_data_buffer_z = new q15_t[N];
@@ -123,6 +148,7 @@ private:
 	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": cycle")};
 	perf_counter_t _cycle_interval_perf{perf_alloc(PC_INTERVAL, MODULE_NAME": cycle interval")};
 	perf_counter_t _fft_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": FFT")};
+	perf_counter_t _fft_interval_perf{perf_alloc(PC_INTERVAL, MODULE_NAME": FFT interval (per axis)")};
 	perf_counter_t _gyro_generation_gap_perf{nullptr};
 	perf_counter_t _gyro_fifo_generation_gap_perf{nullptr};
 
@@ -139,6 +165,28 @@ private:
 	q15_t *_fft_input_buffer{nullptr};
 	q15_t *_fft_outupt_buffer{nullptr};
 
+#if defined(GYRO_FFT_F32)
+	arm_rfft_fast_instance_f32 _rfft_f32;
+
+	float *_gyro_data_buffer_x_f32{nullptr};
+	float *_gyro_data_buffer_y_f32{nullptr};
+	float *_gyro_data_buffer_z_f32{nullptr};
+	float *_hanning_window_f32{nullptr};
+	float *_fft_input_buffer_f32{nullptr};
+	float *_fft_output_buffer_f32{nullptr};
+
+	// Kalman filter of a published peak frequency (random walk)
+	struct PeakTracker {
+		float frequency{NAN};
+		float variance{0.f};
+		hrt_abstime timestamp{0};
+	};
+
+	PeakTracker _peak_tracker[3][MAX_NUM_PEAKS] {};
+#endif // GYRO_FFT_F32
+
+	bool _fft_f32{false};
+
 	float _gyro_sample_rate_hz{8000}; // 8 kHz default
 
 	float _fifo_last_scale{0};
@@ -154,6 +202,9 @@ private:
 	hrt_abstime _last_update[3][MAX_NUM_PEAKS] {};
 
 	int32_t _imu_gyro_fft_len{256};
+	int32_t _imu_gyro_fft_ovl{75};
+
+	int _fft_hop{64}; // new samples per FFT
 
 	bool _fft_updated{false};
 	bool _publish{false};
@@ -162,7 +213,9 @@ private:
 		(ParamInt<px4::params::IMU_GYRO_FFT_LEN>) _param_imu_gyro_fft_len,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MIN>) _param_imu_gyro_fft_min,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MAX>) _param_imu_gyro_fft_max,
-		(ParamFloat<px4::params::IMU_GYRO_FFT_SNR>) _param_imu_gyro_fft_snr
+		(ParamFloat<px4::params::IMU_GYRO_FFT_SNR>) _param_imu_gyro_fft_snr,
+		(ParamInt<px4::params::IMU_GYRO_FFT_OVL>) _param_imu_gyro_fft_ovl,
+		(ParamBool<px4::params::IMU_GYRO_FFT_F32>) _param_imu_gyro_fft_f32
 	)
 };
 
@@ -83,3 +83,30 @@ PARAM_DEFINE_INT32(IMU_GYRO_FFT_LEN, 512);
 * @group Sensors
 */
 PARAM_DEFINE_FLOAT(IMU_GYRO_FFT_SNR, 10.f);
+
+/**
+* IMU gyro FFT overlap.
+*
+* Percentage of the FFT buffer reused by the next FFT. A higher overlap
+* updates the peak frequencies more often at the cost of more CPU.
+*
+* @value 50 50%
+* @value 75 75%
+* @unit %
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_FFT_OVL, 75);
+
+/**
+* IMU gyro FFT float32 backend.
+*
+* Use a float32 FFT with Kalman smoothed peak frequency tracking instead of
+* the q15 FFT with median filtering. Only available on boards with an FPU
+* fast enough for it (STM32H7 and Linux), ignored otherwise.
+*
+* @boolean
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_FFT_F32, 0);
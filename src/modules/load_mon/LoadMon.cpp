@@ -101,6 +101,12 @@ void LoadMon::Run()
 
 	cpuload();
 
+	publish_perf_histogram();
+
+#if defined(ORB_TELEMETRY)
+	publish_uorb_stats();
+#endif
+
 #if defined(__PX4_NUTTX)
 
 	if (_param_sys_stck_en.get()) {
@@ -120,6 +126,60 @@ void LoadMon::Run()
 	perf_end(_cycle_perf);
 }
 
+void LoadMon::publish_perf_histogram()
+{
+	struct Iteration {
+		int index;
+		int num_counters;
+		bool found;
+		perf_histogram_s msg;
+	} iteration{};
+
+	iteration.index = _perf_histogram_index;
+
+	// the callback runs with the perf counter list locked, only collect here
+	perf_iterate_all([](perf_counter_t handle, void *user) {
+		Iteration *it = static_cast<Iteration *>(user);
+		perf_histogram_summary summary;
+
+		if (perf_histogram(handle, &summary) == 0) {
+			if (it->num_counters == it->index) {
+				strncpy(it->msg.name, perf_name(handle), sizeof(it->msg.name) - 1);
+				it->msg.event_count = summary.event_count;
+				it->msg.p50_us = summary.p50;
+				it->msg.p90_us = summary.p90;
+				it->msg.p99_us = summary.p99;
+				it->msg.p999_us = summary.p999;
+				it->msg.max_us = summary.max;
+				it->found = true;
+			}
+
+			it->num_counters++;
+		}
+	}, &iteration);
+
+	if (iteration.found) {
+		iteration.msg.index = iteration.index;
+		iteration.msg.num_counters = iteration.num_counters;
+		iteration.msg.timestamp = hrt_absolute_time();
+		_perf_histogram_pub.publish(iteration.msg);
+	}
+
+	// continue with the next counter in the next cycle
+	_perf_histogram_index = iteration.found ? ((iteration.index + 1) % iteration.num_counters) : 0;
+}
+
+#if defined(ORB_TELEMETRY)
+void LoadMon::publish_uorb_stats()
+{
+	uorb_stats_s stats;
+
+	if (uorb_stats_collect(&stats) == PX4_OK) {
+		_uorb_stats_pub.publish(stats);
+	}
+}
+#endif
+
 void LoadMon::cpuload()
 {
 #if defined(__PX4_LINUX)
@@ -308,6 +368,10 @@ usage and publish the `cpuload` topic.
 
 On NuttX it also checks the stack usage of each process and if it falls below 300 bytes, a warning is output,
 which will also appear in the log file.
+
+The percentiles of `PC_HISTOGRAM` perf counters are published round-robin as `perf_histogram`, one counter per cycle.
+
+If uORB is compiled with ORB_TELEMETRY, the `uorb_stats` topic is published as well.
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("load_mon", "system");
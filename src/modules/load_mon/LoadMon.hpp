@@ -46,8 +46,13 @@
 #include <px4_platform/cpuload.h>
 #include <uORB/Publication.hpp>
 #include <uORB/topics/cpuload.h>
+#include <uORB/topics/perf_histogram.h>
 #include <uORB/topics/task_stack_info.h>
 
+#if defined(ORB_TELEMETRY)
+#include <uORB/topics/uorb_stats.h>
+#endif
+
 #if defined(__PX4_LINUX)
 #include <sys/times.h>
 #endif
@@ -92,6 +97,20 @@ private:
 #endif
 	uORB::Publication<cpuload_s> _cpuload_pub {ORB_ID(cpuload)};
 
+	/** Publish the percentiles of the next PC_HISTOGRAM perf counter. */
+	void publish_perf_histogram();
+
+	int _perf_histogram_index{0};
+
+	uORB::Publication<perf_histogram_s> _perf_histogram_pub{ORB_ID(perf_histogram)};
+
+#if defined(ORB_TELEMETRY)
+	/** Publish the uORB publication/copy telemetry since the last cycle. */
+	void publish_uorb_stats();
+
+	uORB::Publication<uorb_stats_s> _uorb_stats_pub{ORB_ID(uorb_stats)};
+#endif
+
 #if defined(__PX4_LINUX)
 	FILE *_proc_fd = nullptr;
 	/* calculate usage directly from clock ticks on Linux */
@@ -124,6 +124,28 @@ public:
 		return 0;
 	}
 
+	size_t get_total_written_compressed_file(LogType type) const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_total_written_compressed(type); }
+
+		return 0;
+	}
+
+	void set_compression_file(LogType type, bool enable)
+	{
+		if (_log_writer_file) { _log_writer_file->set_compression(type, enable); }
+	}
+
+	void set_direct_io_file(LogType type, bool enable)
+	{
+		if (_log_writer_file) { _log_writer_file->set_direct_io(type, enable); }
+	}
+
+	void print_perf_file(LogType type)
+	{
+		if (_log_writer_file) { _log_writer_file->print_perf(type); }
+	}
+
 	size_t get_buffer_size_file(LogType type) const
 	{
 		if (_log_writer_file) { return _log_writer_file->get_buffer_size(type); }
@@ -35,9 +35,14 @@
 #include "messages.h"
 
 #include <fcntl.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
 
+#include <lz4_block/lz4_block.h>
 #include <mathlib/mathlib.h>
 #include <px4_platform_common/posix.h>
 #include <px4_platform_common/crypto.h>
@@ -53,6 +58,11 @@ namespace px4
 namespace logger
 {
 constexpr size_t LogWriterFile::_min_write_chunk;
+constexpr size_t LogWriterFile::_compress_block_size;
+constexpr size_t LogWriterFile::_compressed_buffer_size;
+constexpr size_t LogWriterFile::_direct_io_alignment;
+constexpr size_t LogWriterFile::_direct_io_buffer_size;
+constexpr off_t LogWriterFile::_direct_io_prealloc_size;
 
 LogWriterFile::LogWriterFile(size_t buffer_size)
 	: _buffers{
@@ -223,7 +233,7 @@ void LogWriterFile::start_log(LogType type, const char *filename)
 
 	unlock();
 
-	if (type == LogType::Full) {
+	if (type == LogType::Full && !_buffers[(int)type].compression_requested()) {
 		// register the current file with the hardfault handler: if the system crashes,
 		// the hardfault handler will append the crash log to that file on the next reboot.
 		// Note that we don't deregister it when closing the log, so that crashes after disarming
@@ -419,13 +429,13 @@ void LogWriterFile::run()
 
 #endif
 
-					int written = buffer.write_to_file(read_ptr, available, call_fsync);
+					int written = buffer.write_data(read_ptr, available, call_fsync);
 
 					if (written < 0) {
 						// retry once
 						PX4_ERR("write failed errno:%i (%s), retrying", errno, strerror(errno));
 						px4_usleep(10000); // 10 milliseconds
-						written = buffer.write_to_file(read_ptr, available, call_fsync);
+						written = buffer.write_data(read_ptr, available, call_fsync);
 					}
 
 					/* buffer.mark_read() requires _mtx to be locked */
@@ -557,6 +567,64 @@ int LogWriterFile::write(LogType type, void *ptr, size_t size, uint64_t dropout_
 	return 0;
 }
 
+int LatencyHistogram::bucket_index(uint32_t duration_us)
+{
+	if (duration_us < SUB_BUCKETS) {
+		return duration_us;
+	}
+
+	// the 2 bits after the most significant bit select the sub-bucket
+	const int msb = 31 - __builtin_clz(duration_us);
+	return (msb - 1) * SUB_BUCKETS + ((duration_us >> (msb - 2)) & (SUB_BUCKETS - 1));
+}
+
+uint32_t LatencyHistogram::bucket_upper_bound(int index)
+{
+	if (index < SUB_BUCKETS) {
+		return index;
+	}
+
+	const int msb = index / SUB_BUCKETS + 1;
+	const uint32_t lower = (uint32_t)(SUB_BUCKETS + index % SUB_BUCKETS) << (msb - 2);
+	return lower + ((1u << (msb - 2)) - 1);
+}
+
+void LatencyHistogram::record(uint32_t duration_us)
+{
+	_buckets[bucket_index(duration_us)]++;
+	_count++;
+
+	if (duration_us > _max) {
+		_max = duration_us;
+	}
+}
+
+uint32_t LatencyHistogram::percentile(float fraction) const
+{
+	const uint32_t target = math::max((uint32_t)ceilf(fraction * _count), (uint32_t)1);
+	uint32_t sum = 0;
+
+	for (int i = 0; i < NUM_BUCKETS && _count > 0; ++i) {
+		sum += _buckets[i];
+
+		if (sum >= target) {
+			return math::min(bucket_upper_bound(i), _max);
+		}
+	}
+
+	return 0;
+}
+
+void LatencyHistogram::reset()
+{
+	for (int i = 0; i < NUM_BUCKETS; ++i) {
+		_buckets[i] = 0;
+	}
+
+	_count = 0;
+	_max = 0;
+}
+
 const char *log_type_str(LogType type)
 {
 	switch (type) {
@@ -583,9 +651,15 @@ LogWriterFile::LogFileBuffer::~LogFileBuffer()
 	}
 
 	free(_buffer);
+	free(_compressed);
+	free(_compress_hash_table);
+#if defined(__PX4_LINUX)
+	free(_direct_io_buffer);
+#endif
 
 	perf_free(_perf_write);
 	perf_free(_perf_fsync);
+	perf_free(_perf_compress);
 }
 
 void LogWriterFile::LogFileBuffer::write_no_check(void *ptr, size_t size)
@@ -631,7 +705,15 @@ size_t LogWriterFile::LogFileBuffer::get_read_ptr(void **ptr, bool *is_part)
 
 bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 {
-	_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
+	_fd = -1;
+
+#if defined(__PX4_LINUX)
+	_direct_io_active = _direct_io && open_direct_io(filename);
+#endif
+
+	if (_fd < 0) {
+		_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
+	}
 
 	if (_fd < 0) {
 		PX4_ERR("Can't open log file %s, errno: %d", filename, errno);
@@ -653,12 +735,166 @@ bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 	_head = 0;
 	_count = 0;
 	_total_written = 0;
+	_total_compressed = 0;
+	_compressed_count = 0;
+	_compressing = false;
+
+	if (_compress) {
+		if (init_compression()) {
+			_compressing = true;
+
+		} else {
+			PX4_ERR("Can't init log compression, writing uncompressed");
+		}
+	}
 
 	_should_run = true;
 
 	return true;
 }
 
+bool LogWriterFile::LogFileBuffer::init_compression()
+{
+	if (_compressed == nullptr) {
+		_compressed = (uint8_t *)malloc(_compressed_buffer_size);
+		_compress_hash_table = (uint16_t *)malloc(lz4::HASH_TABLE_SIZE * sizeof(uint16_t));
+
+		if (_compressed == nullptr || _compress_hash_table == nullptr) {
+			free(_compressed);
+			free(_compress_hash_table);
+			_compressed = nullptr;
+			_compress_hash_table = nullptr;
+			return false;
+		}
+
+		_perf_compress = perf_alloc(PC_ELAPSED, "logger_sd_compress");
+	}
+
+	ulog_compressed_file_header_s header{};
+	memcpy(header.magic, ulog_compressed_magic, sizeof(header.magic));
+	header.version = ulog_compressed_version;
+	header.max_block_size = _compress_block_size;
+
+	memcpy(_compressed, &header, sizeof(header));
+	_compressed_count = sizeof(header);
+	return true;
+}
+
+void LogWriterFile::LogFileBuffer::compress_block(const uint8_t *data, size_t size)
+{
+	perf_begin(_perf_compress);
+
+	ulog_compressed_block_header_s header;
+	uint8_t *payload = _compressed + _compressed_count + sizeof(header);
+	const size_t capacity = _compressed_buffer_size - _compressed_count - sizeof(header);
+
+	// limit the output to the input size, so that a stored block always fits
+	size_t payload_size = lz4::compress(data, size, payload, math::min(capacity, size), _compress_hash_table);
+	header.data_size = size;
+
+	if (payload_size == 0) {
+		// incompressible: store the raw data
+		memcpy(payload, data, size);
+		payload_size = size;
+		header.data_size |= ULOG_COMPRESSED_BLOCK_STORED;
+	}
+
+	memcpy(header.sync, ulog_compressed_block_sync, sizeof(header.sync));
+	header.payload_size = payload_size;
+	header.checksum = ulog_compressed_checksum(payload, payload_size);
+	memcpy(_compressed + _compressed_count, &header, sizeof(header));
+	_compressed_count += sizeof(header) + payload_size;
+
+	perf_end(_perf_compress);
+}
+
+bool LogWriterFile::LogFileBuffer::flush_compressed()
+{
+	if (_compressed_count == 0) {
+		return true;
+	}
+
+	ssize_t ret = write_to_file(_compressed, _compressed_count, false);
+
+	if (ret != (ssize_t)_compressed_count) {
+		if (ret > 0) {
+			// partially written: keep the rest
+			memmove(_compressed, _compressed + ret, _compressed_count - ret);
+			_compressed_count -= ret;
+			_total_compressed += ret;
+		}
+
+		return false;
+	}
+
+	_total_compressed += _compressed_count;
+	_compressed_count = 0;
+	return true;
+}
+
+ssize_t LogWriterFile::LogFileBuffer::write_data(const void *buffer, size_t size, bool call_fsync)
+{
+	if (!_compressing) {
+		return write_to_file(buffer, size, call_fsync);
+	}
+
+	const uint8_t *data = static_cast<const uint8_t *>(buffer);
+	size_t consumed = 0;
+
+	while (consumed < size) {
+		const size_t block_size = math::min(size - consumed, _compress_block_size);
+
+		if (_compressed_count + sizeof(ulog_compressed_block_header_s) + block_size > _compressed_buffer_size) {
+			if (!flush_compressed()) {
+				break;
+			}
+		}
+
+		compress_block(data + consumed, block_size);
+		consumed += block_size;
+	}
+
+	if (_compressed_count >= _min_write_chunk) {
+		// on failure the data is kept and written with the next call
+		flush_compressed();
+	}
+
+	if (call_fsync) {
+		fsync();
+	}
+
+	if (consumed == 0) {
+		return -1;
+	}
+
+	return consumed;
+}
+
+void LogWriterFile::LogFileBuffer::print_perf() const
+{
+	perf_print_counter(_perf_write);
+	perf_print_counter(_perf_fsync);
+
+	if (_perf_compress) {
+		perf_print_counter(_perf_compress);
+	}
+
+	// the writer thread keeps recording, so print a copy
+	const LatencyHistogram write_latency = _write_latency;
+
+	if (write_latency.count() > 0) {
+		PX4_INFO("write latency: p50: %" PRIu32 " us, p99: %" PRIu32 " us, max: %" PRIu32 " us (%" PRIu32 " writes%s)",
+			 write_latency.percentile(0.5f), write_latency.percentile(0.99f), write_latency.max(),
+			 write_latency.count(),
+#if defined(__PX4_LINUX)
+			 _direct_io_active ? ", direct I/O" : "");
+#else
+			 "");
+#endif
+		_write_latency_reset.store(true);
+	}
+}
+
 void LogWriterFile::LogFileBuffer::fsync() const
 {
 	perf_begin(_perf_fsync);
@@ -666,18 +902,158 @@ void LogWriterFile::LogFileBuffer::fsync() const
 	perf_end(_perf_fsync);
 }
 
-ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync) const
+ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync)
+{
+	ssize_t ret;
+
+#if defined(__PX4_LINUX)
+
+	if (_direct_io_active) {
+		ret = write_direct_io(static_cast<const uint8_t *>(buffer), size);
+
+	} else
+#endif
+	{
+		ret = timed_write(buffer, size);
+	}
+
+	if (call_fsync) {
+		fsync();
+	}
+
+	return ret;
+}
+
+void LogWriterFile::LogFileBuffer::record_write_latency(const hrt_abstime &start)
+{
+	if (_write_latency_reset.load()) {
+		_write_latency.reset();
+		_write_latency_reset.store(false);
+	}
+
+	_write_latency.record(hrt_elapsed_time(&start));
+}
+
+ssize_t LogWriterFile::LogFileBuffer::timed_write(const void *buffer, size_t size)
 {
 	perf_begin(_perf_write);
+	const hrt_abstime start = hrt_absolute_time();
 	ssize_t ret = ::write(_fd, buffer, size);
+	record_write_latency(start);
 	perf_end(_perf_write);
+	return ret;
+}
 
-	if (call_fsync) {
-		fsync();
+#if defined(__PX4_LINUX)
+ssize_t LogWriterFile::LogFileBuffer::timed_pwrite(const void *buffer, size_t size, off_t offset)
+{
+	perf_begin(_perf_write);
+	const hrt_abstime start = hrt_absolute_time();
+	ssize_t ret = ::pwrite(_fd, buffer, size, offset);
+	record_write_latency(start);
+	perf_end(_perf_write);
+	return ret;
+}
+
+bool LogWriterFile::LogFileBuffer::open_direct_io(const char *filename)
+{
+	if (_direct_io_buffer == nullptr) {
+		if (posix_memalign((void **)&_direct_io_buffer, _direct_io_alignment, _direct_io_buffer_size) != 0) {
+			_direct_io_buffer = nullptr;
+			PX4_ERR("Can't allocate direct I/O buffer");
+			return false;
+		}
+	}
+
+	int fd = ::open(filename, O_CREAT | O_WRONLY | O_DIRECT, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		PX4_WARN("O_DIRECT not supported (%i), using buffered writes", errno);
+		return false;
+	}
+
+	// preallocate, so that the file system does not need to allocate blocks while logging.
+	// FALLOC_FL_KEEP_SIZE: the file size only grows with the written data
+	_preallocated = 0;
+
+	if (fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, _direct_io_prealloc_size) == 0) {
+		_preallocated = _direct_io_prealloc_size;
+
+	} else {
+		PX4_WARN("log file preallocation failed (%i)", errno);
+	}
+
+	_fd = fd;
+	_direct_io_count = 0;
+	_direct_io_offset = 0;
+	return true;
+}
+
+ssize_t LogWriterFile::LogFileBuffer::write_direct_io(const uint8_t *data, size_t size)
+{
+	size_t consumed = 0;
+
+	while (true) {
+		// write all complete blocks if the staging buffer is full, or at the end
+		const size_t aligned = _direct_io_count & ~(_direct_io_alignment - 1);
+
+		if (aligned > 0 && (_direct_io_count == _direct_io_buffer_size || consumed == size)) {
+			if (_preallocated > 0 && _direct_io_offset + (off_t)aligned > _preallocated) {
+				if (fallocate(_fd, FALLOC_FL_KEEP_SIZE, _preallocated, _direct_io_prealloc_size) == 0) {
+					_preallocated += _direct_io_prealloc_size;
+
+				} else {
+					_preallocated = 0; // stop trying
+				}
+			}
+
+			if (timed_pwrite(_direct_io_buffer, aligned, _direct_io_offset) != (ssize_t)aligned) {
+				// keep the data for the next call
+				break;
+			}
+
+			_direct_io_offset += aligned;
+			_direct_io_count -= aligned;
+			memmove(_direct_io_buffer, _direct_io_buffer + aligned, _direct_io_count);
+		}
+
+		if (consumed == size) {
+			break;
+		}
+
+		const size_t n = math::min(size - consumed, _direct_io_buffer_size - _direct_io_count);
+		memcpy(_direct_io_buffer + _direct_io_count, data + consumed, n);
+		_direct_io_count += n;
+		consumed += n;
+	}
+
+	if (consumed == 0 && size > 0) {
+		return -1;
 	}
 
+	return consumed;
+}
+
+bool LogWriterFile::LogFileBuffer::finish_direct_io()
+{
+	bool ret = true;
+
+	if (_direct_io_count > 0) {
+		// the last write needs to be aligned as well, the padding is truncated below
+		const size_t padded = (_direct_io_count + _direct_io_alignment - 1) & ~(_direct_io_alignment - 1);
+		memset(_direct_io_buffer + _direct_io_count, 0, padded - _direct_io_count);
+		ret = timed_pwrite(_direct_io_buffer, padded, _direct_io_offset) == (ssize_t)padded;
+	}
+
+	// removes the padding and the unused preallocated space
+	if (ftruncate(_fd, _direct_io_offset + _direct_io_count) != 0) {
+		ret = false;
+	}
+
+	_direct_io_count = 0;
 	return ret;
 }
+#endif // __PX4_LINUX
 
 void LogWriterFile::LogFileBuffer::close_file()
 {
@@ -685,6 +1061,21 @@ void LogWriterFile::LogFileBuffer::close_file()
 	_count = 0;
 
 	if (_fd >= 0) {
+		if (_compressing && !flush_compressed()) {
+			PX4_ERR("failed to write compressed data (%i)", errno);
+		}
+
+		_compressing = false;
+		_compressed_count = 0;
+
+#if defined(__PX4_LINUX)
+
+		if (_direct_io_active && !finish_direct_io()) {
+			PX4_ERR("failed to write the end of the log file (%i)", errno);
+		}
+
+#endif
+
 		int res = close(_fd);
 		_fd = -1;
 
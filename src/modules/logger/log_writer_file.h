@@ -36,10 +36,14 @@
 #include <px4_platform_common/defines.h>
 #include <stdint.h>
 #include <pthread.h>
+#include <sys/types.h>
 #include <drivers/drv_hrt.h>
 #include <perf/perf_counter.h>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/crypto.h>
 
+#include "messages.h"
+
 namespace px4
 {
 namespace logger
@@ -58,6 +62,38 @@ enum class LogType {
 
 const char *log_type_str(LogType type);
 
+/**
+ * @class LatencyHistogram
+ * Histogram of durations with 4 buckets per power of 2 (<= 25% bucket width), used to report percentiles
+ */
+class LatencyHistogram
+{
+public:
+	void record(uint32_t duration_us);
+
+	/**
+	 * @param fraction 0..1, e.g. 0.99 for the 99th percentile
+	 * @return upper bound of the bucket containing the percentile [us], 0 if empty
+	 */
+	uint32_t percentile(float fraction) const;
+
+	uint32_t max() const { return _max; }
+	uint32_t count() const { return _count; }
+
+	void reset();
+
+private:
+	static constexpr int SUB_BUCKETS = 4;
+	static constexpr int NUM_BUCKETS = 31 * SUB_BUCKETS;
+
+	static int bucket_index(uint32_t duration_us);
+	static uint32_t bucket_upper_bound(int index);
+
+	uint32_t _buckets[NUM_BUCKETS] {};
+	uint32_t _count{0};
+	uint32_t _max{0};
+};
+
 /**
  * @class LogWriterFile
  * Writes logging data to a file
@@ -107,6 +143,37 @@ public:
 		return _buffers[(int)type].total_written();
 	}
 
+	/**
+	 * @return bytes written to the file after compression (0 if compression is disabled)
+	 */
+	size_t get_total_written_compressed(LogType type) const
+	{
+		return _buffers[(int)type].total_written_compressed();
+	}
+
+	/**
+	 * Enable or disable compression for the next started log of the given type.
+	 * The file format is described in messages.h (ulog_compressed_file_header_s).
+	 */
+	void set_compression(LogType type, bool enable)
+	{
+		_buffers[(int)type].set_compression(enable);
+	}
+
+	/**
+	 * Use direct I/O (O_DIRECT, preallocated file) for the next started log of the given type (Linux only)
+	 */
+	void set_direct_io(LogType type, bool enable)
+	{
+		_buffers[(int)type].set_direct_io(enable);
+	}
+
+	/** print the write, fsync and compression perf counters and the write latency distribution */
+	void print_perf(LogType type)
+	{
+		_buffers[(int)type].print_perf();
+	}
+
 	size_t get_buffer_size(LogType type) const
 	{
 		return _buffers[(int)type].buffer_size();
@@ -159,6 +226,21 @@ private:
 	/* 512 didn't seem to work properly, 4096 should match the FAT cluster size */
 	static constexpr size_t	_min_write_chunk = 4096;
 
+	/* maximum uncompressed size of a compressed block */
+	static constexpr size_t	_compress_block_size = 2 * _min_write_chunk;
+
+	/* direct I/O: alignment of file offset, size and memory of writes, and size of the staging buffer */
+	static constexpr size_t	_direct_io_alignment = 4096;
+	static constexpr size_t	_direct_io_buffer_size = 16 * _direct_io_alignment;
+
+	/* direct I/O: the file is preallocated in steps of this size */
+	static constexpr off_t	_direct_io_prealloc_size = 64 * 1024 * 1024;
+
+	/* compressed blocks are collected until at least _min_write_chunk bytes can be written.
+	 * A block never gets larger than its input (it's stored uncompressed instead). */
+	static constexpr size_t	_compressed_buffer_size = _min_write_chunk + sizeof(ulog_compressed_block_header_s) +
+			_compress_block_size;
+
 	class LogFileBuffer
 	{
 	public:
@@ -181,18 +263,62 @@ private:
 
 		int fd() const { return _fd; }
 
-		inline ssize_t write_to_file(const void *buffer, size_t size, bool call_fsync) const;
+		inline ssize_t write_to_file(const void *buffer, size_t size, bool call_fsync);
+
+		/**
+		 * Write to the file, or compress and write once enough compressed data is collected
+		 * @return number of bytes consumed from buffer, <0 on error
+		 */
+		ssize_t write_data(const void *buffer, size_t size, bool call_fsync);
+
+		void set_compression(bool enable) { _compress = enable; }
+		void set_direct_io(bool enable) { _direct_io = enable; }
+		bool compression_requested() const { return _compress; }
 
 		inline void fsync() const;
 
 		void mark_read(size_t n) { _count -= n; _total_written += n; }
 
 		size_t total_written() const { return _total_written; }
+		size_t total_written_compressed() const { return _total_compressed; }
 		size_t buffer_size() const { return _buffer_size; }
 		size_t count() const { return _count; }
 
+		/** print perf counters and write latency, the histogram is reset by the writer thread */
+		void print_perf() const;
+
 		bool _should_run = false;
 	private:
+		bool init_compression();
+
+		/** compress a block and append it to _compressed */
+		void compress_block(const uint8_t *data, size_t size);
+
+		/** write all compressed data, which is kept if the write fails */
+		bool flush_compressed();
+
+		/** add a write duration to the histogram, resetting it first if print_perf() requested it */
+		void record_write_latency(const hrt_abstime &start);
+
+		/** write(2) to the file, with perf counter and latency histogram */
+		ssize_t timed_write(const void *buffer, size_t size);
+
+#if defined(__PX4_LINUX)
+		/** pwrite(2) at the given offset, with perf counter and latency histogram */
+		ssize_t timed_pwrite(const void *buffer, size_t size, off_t offset);
+
+		bool open_direct_io(const char *filename);
+
+		/**
+		 * Copy data into the aligned staging buffer and write all complete blocks
+		 * @return size on success, <0 on error
+		 */
+		ssize_t write_direct_io(const uint8_t *data, size_t size);
+
+		/** write the remaining (padded) data and truncate the file to the written size */
+		bool finish_direct_io();
+#endif
+
 		const size_t _buffer_size;
 		int	_fd = -1;
 		uint8_t *_buffer = nullptr;
@@ -201,6 +327,26 @@ private:
 		size_t _total_written = 0;
 		perf_counter_t _perf_write;
 		perf_counter_t _perf_fsync;
+
+		bool _compress = false; ///< compression requested for the next log
+		bool _compressing = false; ///< current file is compressed
+		uint8_t *_compressed = nullptr; ///< compressed blocks not yet written to the file
+		size_t _compressed_count = 0;
+		uint16_t *_compress_hash_table = nullptr;
+		size_t _total_compressed = 0;
+		perf_counter_t _perf_compress = nullptr;
+
+		LatencyHistogram _write_latency; ///< only modified by the writer thread
+		mutable px4::atomic_bool _write_latency_reset{false};
+
+		bool _direct_io = false; ///< direct I/O requested for the next log
+#if defined(__PX4_LINUX)
+		bool _direct_io_active = false; ///< current file is opened with O_DIRECT
+		uint8_t *_direct_io_buffer = nullptr; ///< aligned staging buffer
+		size_t _direct_io_count = 0; ///< bytes in _direct_io_buffer
+		off_t _direct_io_offset = 0; ///< file offset of _direct_io_buffer
+		off_t _preallocated = 0; ///< preallocated file size
+#endif
 	};
 
 	LogFileBuffer _buffers[(int)LogType::Count];
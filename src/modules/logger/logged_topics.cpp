@@ -52,6 +52,7 @@ void LoggedTopics::add_default_topics()
 	add_topic("actuator_controls_2", 100);
 	add_topic("actuator_controls_3", 100);
 	add_topic("flight_test_input", 100);
+	add_optional_topic("flight_test_frequency_response");
 	add_optional_topic("actuator_controls_status_0", 300);
 	add_topic("airspeed", 1000);
 	add_optional_topic("airspeed_validated", 200);
@@ -79,6 +80,7 @@ void LoggedTopics::add_default_topics()
 	add_topic("offboard_control_mode", 100);
 	add_topic("onboard_computer_status", 10);
 	add_topic("parameter_update");
+	add_optional_topic("perf_histogram");
 	add_topic("position_controller_status", 500);
 	add_topic("position_setpoint_triplet", 200);
 	add_optional_topic("px4io_status");
@@ -96,6 +98,7 @@ void LoggedTopics::add_default_topics()
 	add_optional_topic("tecs_status", 200);
 	add_topic("trajectory_setpoint", 200);
 	add_topic("transponder_report");
+	add_optional_topic("uorb_stats");
 	add_topic("vehicle_acceleration", 50);
 	add_topic("vehicle_air_data", 200);
 	add_topic("vehicle_angular_velocity", 20);
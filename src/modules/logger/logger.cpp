@@ -180,6 +180,15 @@ int Logger::print_status()
 	PX4_INFO("Running in mode: %s", configured_backend_mode());
 	PX4_INFO("Number of subscriptions: %i (%i bytes)", _num_subscriptions,
 		 (int)(_num_subscriptions * sizeof(LoggerSubscription)));
+	PX4_INFO("Scheduling: %s", _updated_topics ? "update notifications" : "check all topics");
+
+	if (_loop_count > 0) {
+		PX4_INFO("Topics checked per cycle: %.1f", (double)_topic_checks / _loop_count);
+		_loop_count = 0;
+		_topic_checks = 0;
+	}
+
+	perf_print_counter(_loop_perf);
 
 	bool is_logging = false;
 
@@ -229,8 +238,16 @@ void Logger::print_statistics(LogType type)
 		PX4_INFO("Wrote %4.2f MiB (avg %5.2f KiB/s)", (double)mebibytes, (double)(kibibytes / seconds));
 	}
 
+	const size_t compressed = _writer.get_total_written_compressed_file(type);
+
+	if (compressed > 0) {
+		PX4_INFO("Compressed to %4.2f KiB (ratio %.2f)", (double)(compressed / 1024.0f),
+			 (double)(_writer.get_total_written_file(type) / (float)compressed));
+	}
+
 	PX4_INFO("Since last status: dropouts: %zu (max len: %.3f s), max used buffer: %zu / %zu B",
 		 stats.write_dropouts, (double)stats.max_dropout_duration, stats.high_water, _writer.get_buffer_size_file(type));
+	_writer.print_perf_file(type);
 	stats.high_water = 0;
 	stats.write_dropouts = 0;
 	stats.max_dropout_duration = 0.f;
@@ -243,6 +260,7 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	Logger::LogMode log_mode = Logger::LogMode::while_armed;
 	bool error_flag = false;
 	bool log_name_timestamp = false;
+	bool event_driven = false;
 	LogWriter::Backend backend = LogWriter::BackendAll;
 	const char *poll_topic = nullptr;
 
@@ -250,7 +268,7 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	int ch;
 	const char *myoptarg = nullptr;
 
-	while ((ch = px4_getopt(argc, argv, "r:b:etfm:p:x", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "r:b:etfm:p:ux", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'r': {
 				unsigned long r = strtoul(myoptarg, nullptr, 10);
@@ -317,6 +335,10 @@ Logger *Logger::instantiate(int argc, char *argv[])
 			poll_topic = myoptarg;
 			break;
 
+		case 'u':
+			event_driven = true;
+			break;
+
 		case '?':
 			error_flag = true;
 			break;
@@ -332,7 +354,8 @@ Logger *Logger::instantiate(int argc, char *argv[])
 		return nullptr;
 	}
 
-	Logger *logger = new Logger(backend, log_buffer_size, log_interval, poll_topic, log_mode, log_name_timestamp);
+	Logger *logger = new Logger(backend, log_buffer_size, log_interval, poll_topic, log_mode, log_name_timestamp,
+				    event_driven);
 
 #if defined(DBGPRINT) && defined(__PX4_NUTTX)
 	struct mallinfo alloc_info = mallinfo();
@@ -360,11 +383,12 @@ Logger *Logger::instantiate(int argc, char *argv[])
 }
 
 Logger::Logger(LogWriter::Backend backend, size_t buffer_size, uint32_t log_interval, const char *poll_topic_name,
-	       LogMode log_mode, bool log_name_timestamp) :
+	       LogMode log_mode, bool log_name_timestamp, bool event_driven) :
 	ModuleParams(nullptr),
 	_log_mode(log_mode),
 	_log_name_timestamp(log_name_timestamp),
 	_event_subscription(ORB_ID::event),
+	_event_driven(event_driven),
 	_writer(backend, buffer_size),
 	_log_interval(log_interval)
 {
@@ -390,8 +414,12 @@ Logger::~Logger()
 		free(_replay_file_name);
 	}
 
+	free_update_notifiers();
+
 	delete[](_msg_buffer);
 	delete[](_subscriptions);
+
+	perf_free(_loop_perf);
 }
 
 void Logger::update_params()
@@ -446,6 +474,8 @@ bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
 				write_add_logged_msg(LogType::Mission, sub);
 			}
 
+			register_update_notifier(sub_idx);
+
 			// copy first data
 			updated = sub.copy(buffer);
 		}
@@ -454,6 +484,180 @@ bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
 	return updated;
 }
 
+bool Logger::write_subscription(int sub_idx, hrt_abstime loop_time, bool try_to_subscribe, uint32_t &total_bytes)
+{
+	LoggerSubscription &sub = _subscriptions[sub_idx];
+
+	/* if this topic has been updated, copy the new data into the message buffer
+	 * and write a message to the log
+	 */
+	if (!copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_header_s), try_to_subscribe)) {
+		return false;
+	}
+
+	// each message consists of a header followed by an orb data object
+	const size_t msg_size = sizeof(ulog_message_data_header_s) + sub.get_topic()->o_size_no_padding;
+	const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
+	const uint16_t write_msg_id = sub.msg_id;
+
+	//write one byte after another (necessary because of alignment)
+	_msg_buffer[0] = (uint8_t)write_msg_size;
+	_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
+	_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
+	_msg_buffer[3] = (uint8_t)write_msg_id;
+	_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+
+	// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
+
+	// full log
+	if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+
+#ifdef DBGPRINT
+		total_bytes += msg_size;
+#endif /* DBGPRINT */
+	}
+
+	// mission log
+	if (sub_idx < _num_mission_subs) {
+		if (_writer.is_started(LogType::Mission)) {
+			if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
+				unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+
+				if (delta_time > 0) {
+					_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
+				}
+
+				write_message(LogType::Mission, _msg_buffer, msg_size);
+			}
+		}
+	}
+
+	return true;
+}
+
+bool Logger::init_update_notifiers()
+{
+	free_update_notifiers();
+
+	if (!_event_driven || _num_subscriptions == 0) {
+		return true;
+	}
+
+	_num_updated_words = (_num_subscriptions + 31) / 32;
+	_updated_topics = new px4::atomic<uint32_t>[_num_updated_words];
+	_update_notifiers = new LoggerUpdateNotifier *[_num_subscriptions];
+
+	if (!_updated_topics || !_update_notifiers) {
+		PX4_ERR("alloc failed");
+		free_update_notifiers();
+		return false;
+	}
+
+	for (int i = 0; i < _num_updated_words; ++i) {
+		_updated_topics[i].store(0);
+	}
+
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		_update_notifiers[i] = nullptr;
+		register_update_notifier(i);
+	}
+
+	return true;
+}
+
+void Logger::free_update_notifiers()
+{
+	if (_update_notifiers) {
+		for (int i = 0; i < _num_subscriptions; ++i) {
+			// unregisters the callback
+			delete _update_notifiers[i];
+		}
+
+		delete[](_update_notifiers);
+		_update_notifiers = nullptr;
+	}
+
+	delete[](_updated_topics);
+	_updated_topics = nullptr;
+	_num_updated_words = 0;
+	_num_unnotified = 0;
+}
+
+void Logger::register_update_notifier(int sub_idx)
+{
+	if (!_update_notifiers || _update_notifiers[sub_idx] || !_subscriptions[sub_idx].valid()) {
+		return;
+	}
+
+	const LoggerSubscription &sub = _subscriptions[sub_idx];
+	px4::atomic<uint32_t> &updated = _updated_topics[sub_idx / 32];
+	const uint32_t mask = 1u << (sub_idx % 32);
+
+	LoggerUpdateNotifier *notifier = new LoggerUpdateNotifier(sub.get_topic(), sub.get_instance(), updated, mask);
+
+	// the topic exists already, so subscribing does not create it
+	if (notifier && notifier->subscribe() && notifier->registerCallback()) {
+		_update_notifiers[sub_idx] = notifier;
+
+	} else {
+		// fall back to checking it every iteration
+		PX4_WARN("no update notification for %s", sub.get_topic()->o_name);
+		delete notifier;
+		++_num_unnotified;
+		return;
+	}
+
+	// there might have been a publication before registration
+	updated.fetch_or(mask);
+}
+
+void Logger::mark_all_updated()
+{
+	for (int i = 0; i < _num_updated_words; ++i) {
+		const int remaining = _num_subscriptions - i * 32;
+		_updated_topics[i].store(remaining >= 32 ? UINT32_MAX : ((1u << remaining) - 1));
+	}
+}
+
+int Logger::write_updated_subscriptions(hrt_abstime loop_time, uint32_t &total_bytes)
+{
+	int checked = 0;
+
+	for (int word = 0; word < _num_updated_words; ++word) {
+		uint32_t updated = _updated_topics[word].fetch_and(0);
+		uint32_t still_pending = 0;
+
+		for (int bit = 0; updated != 0; ++bit, updated >>= 1) {
+			if ((updated & 1) == 0) {
+				continue;
+			}
+
+			const int sub_idx = word * 32 + bit;
+			write_subscription(sub_idx, loop_time, false, total_bytes);
+			++checked;
+
+			// rate-limited by interval_ms or more data queued: check again next iteration
+			if (_subscriptions[sub_idx].pending()) {
+				still_pending |= 1u << bit;
+			}
+		}
+
+		if (still_pending != 0) {
+			_updated_topics[word].fetch_or(still_pending);
+		}
+	}
+
+	// subscriptions without a notification (registration failed) are checked every time
+	for (int sub_idx = 0; _num_unnotified > 0 && sub_idx < _num_subscriptions; ++sub_idx) {
+		if (!_update_notifiers[sub_idx] && _subscriptions[sub_idx].valid()) {
+			write_subscription(sub_idx, loop_time, false, total_bytes);
+			++checked;
+		}
+	}
+
+	return checked;
+}
+
 const char *Logger::configured_backend_mode() const
 {
 	switch (_writer.backend()) {
@@ -570,6 +774,10 @@ void Logger::run()
 		return;
 	}
 
+	if (!init_update_notifiers()) {
+		return;
+	}
+
 	//all topics added. Get required message buffer size
 	int max_msg_size = 0;
 
@@ -693,6 +901,11 @@ void Logger::run()
 
 			if (!was_started) {
 				adjust_subscription_updates();
+
+				if (_updated_topics) {
+					// write the current state of all topics once
+					mark_all_updated();
+				}
 			}
 
 			/* check if we need to output the process load */
@@ -707,6 +920,8 @@ void Logger::run()
 				}
 			}
 
+			perf_begin(_loop_perf);
+
 			/* Check if parameters have changed */
 			if (!_should_stop_file_log) { // do not record param changes after disarming
 				if (parameter_update_sub.updated()) {
@@ -721,51 +936,21 @@ void Logger::run()
 			/* wait for lock on log buffer */
 			_writer.lock();
 
-			for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
-				LoggerSubscription &sub = _subscriptions[sub_idx];
-				/* if this topic has been updated, copy the new data into the message buffer
-				 * and write a message to the log
-				 */
-				const bool try_to_subscribe = (sub_idx == next_subscribe_topic_index);
+			if (_updated_topics) {
+				// only the topics that published since the last iteration
+				_topic_checks += write_updated_subscriptions(loop_time, total_bytes);
 
-				if (copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_header_s), try_to_subscribe)) {
-					// each message consists of a header followed by an orb data object
-					const size_t msg_size = sizeof(ulog_message_data_header_s) + sub.get_topic()->o_size_no_padding;
-					const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
-					const uint16_t write_msg_id = sub.msg_id;
-
-					//write one byte after another (necessary because of alignment)
-					_msg_buffer[0] = (uint8_t)write_msg_size;
-					_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
-					_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
-					_msg_buffer[3] = (uint8_t)write_msg_id;
-					_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
-
-					// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
-
-					// full log
-					if (write_message(LogType::Full, _msg_buffer, msg_size)) {
-
-#ifdef DBGPRINT
-						total_bytes += msg_size;
-#endif /* DBGPRINT */
-					}
-
-					// mission log
-					if (sub_idx < _num_mission_subs) {
-						if (_writer.is_started(LogType::Mission)) {
-							if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
-								unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
-
-								if (delta_time > 0) {
-									_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
-								}
+				if (next_subscribe_topic_index != -1 && !_subscriptions[next_subscribe_topic_index].valid()) {
+					write_subscription(next_subscribe_topic_index, loop_time, true, total_bytes);
+				}
 
-								write_message(LogType::Mission, _msg_buffer, msg_size);
-							}
-						}
-					}
+			} else {
+				for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+					const bool try_to_subscribe = (sub_idx == next_subscribe_topic_index);
+					write_subscription(sub_idx, loop_time, try_to_subscribe, total_bytes);
 				}
+
+				_topic_checks += _num_subscriptions;
 			}
 
 			// check for new events
@@ -841,6 +1026,9 @@ void Logger::run()
 
 			debug_print_buffer(total_bytes, timer_start);
 
+			perf_end(_loop_perf);
+			++_loop_count;
+
 			was_started = true;
 
 		} else { // not logging
@@ -850,7 +1038,9 @@ void Logger::run()
 			// - we'll get the data immediately once we start logging (no need to wait for the next subscribe timeout)
 			if (next_subscribe_topic_index != -1) {
 				if (!_subscriptions[next_subscribe_topic_index].valid()) {
-					_subscriptions[next_subscribe_topic_index].subscribe();
+					if (_subscriptions[next_subscribe_topic_index].subscribe()) {
+						register_update_notifier(next_subscribe_topic_index);
+					}
 				}
 
 				if (++next_subscribe_topic_index >= _num_subscriptions) {
@@ -906,6 +1096,8 @@ void Logger::run()
 	hrt_cancel(&timer_call);
 	px4_sem_destroy(&timer_callback_data.semaphore);
 
+	free_update_notifiers();
+
 	// stop the writer thread
 	_writer.thread_stop();
 
@@ -1269,15 +1461,19 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		replay_suffix = "_replayed";
 	}
 
-	const char *crypto_suffix = "";
+	const char *file_suffix = ""; // .ulgc: encrypted, .ulgz: compressed
 #if defined(PX4_CRYPTO)
 
 	if (_param_sdlog_crypto_algorithm.get() != 0) {
-		crypto_suffix = "c";
+		file_suffix = "c";
 	}
 
 #endif
 
+	if (type == LogType::Full && compress_log_file()) {
+		file_suffix = "z";
+	}
+
 	char *log_file_name = _file_name[(int)type].log_file_name;
 
 	if (time_ok) {
@@ -1290,7 +1486,7 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		char log_file_name_time[16] = "";
 		strftime(log_file_name_time, sizeof(log_file_name_time), "%H_%M_%S", &tt);
 		snprintf(log_file_name, sizeof(LogFileName::log_file_name), "%s%s.ulg%s", log_file_name_time, replay_suffix,
-			 crypto_suffix);
+			 file_suffix);
 		snprintf(file_name + n, file_name_size - n, "/%s", log_file_name);
 
 		if (notify) {
@@ -1321,7 +1517,7 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		while (file_number <= MAX_NO_LOGFILE) {
 			/* format log file path: e.g. /fs/microsd/log/sess001/log001.ulg */
 			snprintf(log_file_name, sizeof(LogFileName::log_file_name), "log%03" PRIu16 "%s.ulg%s", file_number, replay_suffix,
-				 crypto_suffix);
+				 file_suffix);
 			snprintf(file_name + n, file_name_size - n, "/%s", log_file_name);
 
 			if (!util::file_exist(file_name)) {
@@ -1359,6 +1555,19 @@ void Logger::setReplayFile(const char *file_name)
 	_replay_file_name = strdup(file_name);
 }
 
+bool Logger::compress_log_file() const
+{
+#if defined(PX4_CRYPTO)
+
+	if (_param_sdlog_crypto_algorithm.get() != 0) {
+		return false;
+	}
+
+#endif
+
+	return _param_sdlog_compress.get();
+}
+
 void Logger::start_log_file(LogType type)
 {
 	if (_writer.is_started(type, LogWriter::BackendFile) || (_writer.backend() & LogWriter::BackendFile) == 0) {
@@ -1379,6 +1588,9 @@ void Logger::start_log_file(LogType type)
 		return;
 	}
 
+	_writer.set_compression_file(type, type == LogType::Full && compress_log_file());
+	_writer.set_direct_io_file(type, type == LogType::Full && _param_sdlog_direct_io.get());
+
 #if defined(PX4_CRYPTO)
 	_writer.set_encryption_parameters(
 		(px4_crypto_algorithm_t)_param_sdlog_crypto_algorithm.get(),
@@ -2285,12 +2497,17 @@ The normal log is always a superset of the mission log.
 ### Implementation
 The implementation uses two threads:
 - The main thread, running at a fixed rate (or polling on a topic if started with -p) and checking for
-  data updates
+  data updates. By default every logged topic is checked in each iteration. With -u the topics register
+  an update notification instead and only the ones that published are checked (the topic intervals
+  still apply). `logger status` shows the checked topics per iteration and the time spent.
 - The writer thread, writing data to the file
 
 In between there is a write buffer with configurable size (and another fixed-size buffer for
 the mission log). It should be large to avoid dropouts.
 
+With SDLOG_COMPRESS set, the writer thread compresses the full log in independent LZ4 blocks
+(.ulgz files). Use Tools/decompress_ulog.py to convert them back to .ulg; replay reads them directly.
+
 ### Examples
 Typical usage to start logging immediately:
 $ logger start -e -t
@@ -2310,6 +2527,7 @@ $ logger on
 	PRINT_MODULE_USAGE_PARAM_INT('b', 12, 4, 10000, "Log buffer size in KiB", true);
 	PRINT_MODULE_USAGE_PARAM_STRING('p', nullptr, "<topic_name>",
 					 "Poll on a topic instead of running with fixed rate (Log rate and topic intervals are ignored if this is set)", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('u', "Only check topics with an update notification (event-driven)", true);
 	PRINT_MODULE_USAGE_COMMAND_DESCR("on", "start logging now, override arming (logger must be running)");
 	PRINT_MODULE_USAGE_COMMAND_DESCR("off", "stop logging now, override arming (logger must be running)");
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
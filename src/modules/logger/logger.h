@@ -37,8 +37,10 @@
 #include "messages.h"
 #include <containers/Array.hpp>
 #include "util.h"
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <drivers/drv_hrt.h>
+#include <perf/perf_counter.h>
 #include <version/version.h>
 #include <parameters/param.h>
 #include <px4_platform_common/printload.h>
@@ -47,6 +49,7 @@
 
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
 #include <uORB/SubscriptionInterval.hpp>
 #include <uORB/topics/logger_status.h>
 #include <uORB/topics/log_message.h>
@@ -76,9 +79,36 @@ struct LoggerSubscription : public uORB::SubscriptionInterval {
 		uORB::SubscriptionInterval(id, interval_ms * 1000, instance)
 	{}
 
+	/**
+	 * Check for a new publication, ignoring the interval.
+	 */
+	bool pending() { return _subscription.updated(); }
+
 	uint8_t msg_id{MSG_ID_INVALID};
 };
 
+/**
+ * Update notification for a logged topic (event-driven scheduling).
+ * call() runs in the context of the publisher, so it only marks the topic as updated.
+ */
+class LoggerUpdateNotifier : public uORB::SubscriptionCallback
+{
+public:
+	LoggerUpdateNotifier(const orb_metadata *meta, uint8_t instance, px4::atomic<uint32_t> &updated, uint32_t mask) :
+		uORB::SubscriptionCallback(meta, 0, instance),
+		_updated(updated),
+		_mask(mask)
+	{}
+
+	~LoggerUpdateNotifier() override = default;
+
+	void call() override { _updated.fetch_or(_mask); }
+
+private:
+	px4::atomic<uint32_t> &_updated;
+	const uint32_t _mask;
+};
+
 class Logger : public ModuleBase<Logger>, public ModuleParams
 {
 public:
@@ -90,7 +120,7 @@ public:
 	};
 
 	Logger(LogWriter::Backend backend, size_t buffer_size, uint32_t log_interval, const char *poll_topic_name,
-	       LogMode log_mode, bool log_name_timestamp);
+	       LogMode log_mode, bool log_name_timestamp, bool event_driven);
 
 	~Logger();
 
@@ -197,6 +227,9 @@ private:
 
 	void start_log_file(LogType type);
 
+	/** @return true if the full log should be compressed (SDLOG_COMPRESS, and not encrypted) */
+	bool compress_log_file() const;
+
 	void stop_log_file(LogType type);
 
 	void start_log_mavlink();
@@ -264,6 +297,37 @@ private:
 
 	inline bool copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe);
 
+	/**
+	 * Copy a subscription if updated and write it to the full and mission log.
+	 * Must be called with _writer.lock() held.
+	 * @return true if data was written
+	 */
+	bool write_subscription(int sub_idx, hrt_abstime loop_time, bool try_to_subscribe, uint32_t &total_bytes);
+
+	/**
+	 * Allocate the update flags for event-driven scheduling and register the notifications
+	 * for all valid subscriptions.
+	 * @return true on success
+	 */
+	bool init_update_notifiers();
+	void free_update_notifiers();
+
+	/**
+	 * Register the update notification of a (newly) valid subscription and mark it as updated.
+	 * Does nothing if event-driven scheduling is disabled.
+	 */
+	void register_update_notifier(int sub_idx);
+
+	/**
+	 * Write all subscriptions marked as updated since the last call (event-driven scheduling).
+	 * Topics that are still rate-limited by their interval stay marked.
+	 * @return number of subscriptions checked
+	 */
+	int write_updated_subscriptions(hrt_abstime loop_time, uint32_t &total_bytes);
+
+	/** mark all subscriptions as updated, so that they are checked in the next loop iteration */
+	void mark_all_updated();
+
 	/**
 	 * Write exactly one ulog message to the logger and handle dropouts.
 	 * Must be called with _writer.lock() held.
@@ -339,6 +403,16 @@ private:
 	MissionSubscription 				_mission_subscriptions[MAX_MISSION_TOPICS_NUM] {}; ///< additional data for mission subscriptions
 	int						_num_mission_subs{0};
 	LoggerSubscription				_event_subscription; ///< Subscription for the event topic (handled separately)
+
+	const bool					_event_driven; ///< only check topics with an update notification (-u)
+	LoggerUpdateNotifier				**_update_notifiers{nullptr}; ///< per subscription, allocated once valid
+	px4::atomic<uint32_t>				*_updated_topics{nullptr}; ///< bitset of updated subscriptions
+	int						_num_updated_words{0};
+	int						_num_unnotified{0}; ///< valid subscriptions that failed to register a notification
+
+	perf_counter_t					_loop_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": cycle")};
+	uint32_t					_loop_count{0}; ///< logging loop iterations since the last status
+	uint32_t					_topic_checks{0}; ///< subscriptions checked since the last status
 	uint16_t 					_event_sequence_offset{0}; ///< event sequence offset to account for skipped (not logged) messages
 	uint16_t 					_event_sequence_offset_mission{0};
 
@@ -373,7 +447,9 @@ private:
 		(ParamInt<px4::params::SDLOG_PROFILE>) _param_sdlog_profile,
 		(ParamInt<px4::params::SDLOG_MISSION>) _param_sdlog_mission,
 		(ParamBool<px4::params::SDLOG_BOOT_BAT>) _param_sdlog_boot_bat,
-		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid
+		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid,
+		(ParamBool<px4::params::SDLOG_COMPRESS>) _param_sdlog_compress,
+		(ParamBool<px4::params::SDLOG_DIRECT_IO>) _param_sdlog_direct_io
 #if defined(PX4_CRYPTO)
 		, (ParamInt<px4::params::SDLOG_ALGORITHM>) _param_sdlog_crypto_algorithm,
 		(ParamInt<px4::params::SDLOG_KEY>) _param_sdlog_crypto_key,
@@ -33,6 +33,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 enum class ULogMessageType : uint8_t {
@@ -88,6 +89,51 @@ struct ulog_key_header_s {
 	uint8_t	data[0];
 };
 
+/**
+ * Compressed log files (.ulgz, enabled with SDLOG_COMPRESS)
+ *
+ * The file starts with ulog_compressed_file_header_s, followed by a sequence of blocks. Each block consists
+ * of ulog_compressed_block_header_s and payload_size bytes of payload. Concatenating the decoded payloads
+ * results in the regular ULog file (starting with ulog_file_header_s).
+ *
+ * - The payload is an LZ4 block (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md), or the raw
+ *   data if ULOG_COMPRESSED_BLOCK_STORED is set in data_size (incompressible data).
+ * - Blocks are independent of each other. A truncated file can be decoded up to the last complete block.
+ *   After a corrupt block (checksum mismatch), a reader can continue at the next sync marker, and then
+ *   resynchronize the ULog stream with the ULog sync messages.
+ * - checksum is FNV-1a (32 bit) over the payload.
+ * - All fields are little endian.
+ */
+struct ulog_compressed_file_header_s {
+	uint8_t magic[7]; ///< 'U', 'L', 'o', 'g', 'L', 'Z', '4'
+	uint8_t version; ///< framing version, currently 1
+	uint32_t max_block_size; ///< maximum decoded size of a block
+};
+
+#define ULOG_COMPRESSED_BLOCK_STORED (1u << 31) ///< payload is stored uncompressed
+
+struct ulog_compressed_block_header_s {
+	uint8_t sync[4]; ///< 0xB7, 'L', 'Z', 0x4B
+	uint32_t data_size; ///< decoded size in bytes (| ULOG_COMPRESSED_BLOCK_STORED)
+	uint32_t payload_size; ///< size of the payload following this header
+	uint32_t checksum; ///< FNV-1a over the payload
+};
+
+static constexpr uint8_t ulog_compressed_magic[7] = {'U', 'L', 'o', 'g', 'L', 'Z', '4'};
+static constexpr uint8_t ulog_compressed_version = 1;
+static constexpr uint8_t ulog_compressed_block_sync[4] = {0xB7, 'L', 'Z', 0x4B};
+
+inline uint32_t ulog_compressed_checksum(const uint8_t *data, size_t size)
+{
+	uint32_t hash = 0x811c9dc5;
+
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ data[i]) * 0x1000193;
+	}
+
+	return hash;
+}
+
 #define ULOG_MSG_HEADER_LEN 3 //accounts for msg_size and msg_type
 struct ulog_message_header_s {
 	uint16_t msg_size;
@@ -174,6 +174,33 @@ PARAM_DEFINE_INT32(SDLOG_DIRS_MAX, 0);
  */
 PARAM_DEFINE_INT32(SDLOG_UUID, 1);
 
+/**
+ * Log compression
+ *
+ * If enabled, the full log is compressed on the fly (LZ4 blocks) and stored as .ulgz file.
+ * This reduces the file size and the write load for high-rate logging profiles, at the cost of
+ * CPU time in the log writer thread. Compressed logs need to be decompressed before they can be
+ * analyzed with ULog tools (replay supports them directly). Crash logs are not appended to compressed logs.
+ *
+ * Compression is not used together with log encryption.
+ *
+ * @boolean
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_COMPRESS, 0);
+
+/**
+ * Direct I/O for the log file (Linux only)
+ *
+ * If enabled, the full log file is preallocated and written with O_DIRECT in aligned blocks,
+ * bypassing the page cache. This avoids long stalls caused by kernel writeback of dirty pages.
+ * If the file system does not support it, buffered writes are used.
+ *
+ * @boolean
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_DIRECT_IO, 0);
+
 /**
  * Logfile Encryption algorithm
  *
@@ -35,9 +35,11 @@
 ///	@author px4dev, Don Gagne <don@thegagnes.com>
 
 #include <crc32.h>
+#include <lib/mathlib/mathlib.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <sys/stat.h>
 #include <errno.h>
 #include <cstring>
@@ -66,6 +68,7 @@ MavlinkFTP::~MavlinkFTP()
 {
 	delete[] _work_buffer1;
 	delete[] _work_buffer2;
+	delete[] _burst_buffer;
 }
 
 unsigned
@@ -86,6 +89,12 @@ MavlinkFTP::set_unittest_worker(ReceiveMessageFunc_t rcvMsgFunc, void *worker_da
 	_utRcvMsgFunc = rcvMsgFunc;
 	_worker_data = worker_data;
 }
+
+void
+MavlinkFTP::set_unittest_data_rate(int data_rate)
+{
+	_utDataRate = data_rate;
+}
 #endif
 
 uint8_t
@@ -541,6 +550,8 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 	_session_info.file_size = fileSize;
 	_session_info.stream_download = false;
 
+	_burstInvalidate();
+
 	payload->session = 0;
 	payload->size = sizeof(uint32_t);
 	std::memcpy(payload->data, &fileSize, payload->size);
@@ -595,7 +606,32 @@ MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t
 		return kErrInvalidSession;
 	}
 
-	PX4_DEBUG("FTP: burst offset:%" PRIu32, payload->offset);
+	if (_burst_buffer == nullptr) {
+		_burst_buffer = new uint8_t[2 * _burst_chunk_len];
+
+		if (_burst_buffer == nullptr) {
+			_our_errno = ENOMEM;
+			return kErrFailErrno;
+		}
+
+		_burstInvalidate();
+	}
+
+	// A 4 byte payload limits the burst to a window of that many bytes. The GCS uses this to download large
+	// files in big windows without the round trip every 35K, and to selectively retransmit lost packets.
+	uint32_t window_end = 0;
+
+	if (payload->size == sizeof(uint32_t)) {
+		uint32_t window_length;
+		std::memcpy(&window_length, payload->data, sizeof(window_length));
+
+		if (window_length > 0) {
+			window_end = math::min(static_cast<uint64_t>(payload->offset) + window_length,
+					       static_cast<uint64_t>(_session_info.file_size));
+		}
+	}
+
+	PX4_DEBUG("FTP: burst offset:%" PRIu32 " window end:%" PRIu32, payload->offset, window_end);
 	// Setup for streaming sends
 	_session_info.stream_download = true;
 	_session_info.stream_offset = payload->offset;
@@ -603,10 +639,107 @@ MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t
 	_session_info.stream_seq_number = payload->seq_number + 1;
 	_session_info.stream_target_system_id = target_system_id;
 	_session_info.stream_target_component_id = target_component_id;
+	_session_info.stream_window_end = window_end;
 
 	return kErrNone;
 }
 
+void
+MavlinkFTP::_burstInvalidate()
+{
+	_burst_chunk_size[0] = -1;
+	_burst_chunk_size[1] = -1;
+}
+
+unsigned
+MavlinkFTP::_burstRateBudget(int data_rate)
+{
+	const hrt_abstime now = hrt_absolute_time();
+	const float capacity = math::max(data_rate * (_burst_bucket_time * 1e-6f), static_cast<float>(get_size()));
+
+	// an idle link refills the bucket, but never beyond its capacity
+	const float refill = data_rate * (math::min(now - _last_burst_refill, _burst_bucket_time) * 1e-6f);
+	_burst_tokens = math::min(_burst_tokens + refill, capacity);
+	_last_burst_refill = now;
+
+	return static_cast<unsigned>(_burst_tokens);
+}
+
+bool
+MavlinkFTP::_burstLoadChunk(int slot, uint32_t chunk_offset)
+{
+	uint8_t *chunk = &_burst_buffer[slot * _burst_chunk_len];
+	int chunk_size = 0;
+
+	while (chunk_size < _burst_chunk_len) {
+		const ssize_t bytes_read = ::pread(_session_info.fd, &chunk[chunk_size], _burst_chunk_len - chunk_size,
+						   chunk_offset + chunk_size);
+
+		if (bytes_read < 0) {
+			_our_errno = errno;
+			_burst_chunk_size[slot] = -1;
+			return false;
+
+		} else if (bytes_read == 0) {
+			// end of file
+			break;
+		}
+
+		chunk_size += bytes_read;
+	}
+
+	_burst_chunk_offset[slot] = chunk_offset;
+	_burst_chunk_size[slot] = chunk_size;
+
+#if defined(__PX4_LINUX)
+
+	if (chunk_size == _burst_chunk_len) {
+		// let the kernel read the following chunk in the background while this one is sent
+		posix_fadvise(_session_info.fd, chunk_offset + _burst_chunk_len, _burst_chunk_len, POSIX_FADV_WILLNEED);
+	}
+
+#endif // __PX4_LINUX
+
+	return true;
+}
+
+int
+MavlinkFTP::_burstRead(uint32_t offset, uint8_t *dst, int len)
+{
+	int bytes_read = 0;
+
+	while (bytes_read < len) {
+		// consecutive chunks alternate between the two slots
+		const uint32_t chunk_offset = offset - (offset % _burst_chunk_len);
+		const int slot = (offset / _burst_chunk_len) % 2;
+
+		if ((_burst_chunk_size[slot] < 0) || (_burst_chunk_offset[slot] != chunk_offset)) {
+			if (!_burstLoadChunk(slot, chunk_offset)) {
+				return -1;
+			}
+		}
+
+		const int chunk_position = offset - chunk_offset;
+		const int available = _burst_chunk_size[slot] - chunk_position;
+
+		if (available <= 0) {
+			break;
+		}
+
+		const int bytes = math::min(available, len - bytes_read);
+		std::memcpy(&dst[bytes_read], &_burst_buffer[slot * _burst_chunk_len + chunk_position], bytes);
+		bytes_read += bytes;
+		offset += bytes;
+
+		if (_burst_chunk_size[slot] < _burst_chunk_len) {
+			// a partial chunk ends at the end of the file
+			break;
+		}
+	}
+
+	return bytes_read;
+}
+
 /// @brief Responds to a Write command
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workWrite(PayloadHeader *payload)
@@ -1041,6 +1174,11 @@ void MavlinkFTP::send()
 				delete[] _work_buffer2;
 				_work_buffer2 = nullptr;
 			}
+
+			if (_burst_buffer && !_session_info.stream_download) {
+				delete[] _burst_buffer;
+				_burst_buffer = nullptr;
+			}
 		}
 
 	} else if (_session_info.fd != -1) {
@@ -1059,16 +1197,37 @@ void MavlinkFTP::send()
 		return;
 	}
 
-#ifndef MAVLINK_FTP_UNIT_TEST
+	const unsigned packet_size = get_size();
+	bool rate_limited = false;
+
+#ifdef MAVLINK_FTP_UNIT_TEST
+	// everything is sent at once, unless the test limits the data rate
+	unsigned max_bytes_to_send = UINT_MAX;
+
+	if ((_session_info.stream_window_end > 0) && (_utDataRate > 0)) {
+		max_bytes_to_send = _burstRateBudget(_utDataRate);
+		rate_limited = true;
+	}
+
+#else
 	// Skip send if not enough room
 	unsigned max_bytes_to_send = _mavlink->get_free_tx_buf();
 	PX4_DEBUG("MavlinkFTP::send max_bytes_to_send(%u) get_free_tx_buf(%u)", max_bytes_to_send, _mavlink->get_free_tx_buf());
 
-	if (max_bytes_to_send < get_size()) {
-		return;
+#if defined(MAVLINK_UDP)
+
+	// UDP has no tx buffer to query, so a windowed burst is limited to the configured data rate of the link instead
+	if ((_session_info.stream_window_end > 0) && (_mavlink->get_protocol() == Protocol::UDP)) {
+		max_bytes_to_send = _burstRateBudget(_mavlink->get_data_rate());
+		rate_limited = true;
 	}
 
-#endif
+#endif // MAVLINK_UDP
+#endif // MAVLINK_FTP_UNIT_TEST
+
+	if (max_bytes_to_send < packet_size) {
+		return;
+	}
 
 	// Send stream packets until buffer is full
 
@@ -1086,6 +1245,7 @@ void MavlinkFTP::send()
 		payload->session = 0;
 		payload->opcode = kRspAck;
 		payload->req_opcode = kCmdBurstReadFile;
+		payload->burst_complete = false;
 		payload->offset = _session_info.stream_offset;
 		_session_info.stream_seq_number++;
 
@@ -1098,20 +1258,25 @@ void MavlinkFTP::send()
 		}
 
 		if (error_code == kErrNone) {
-			if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-				error_code = kErrFailErrno;
-				PX4_WARN("stream download: seek fail");
+			int bytes_to_read = kMaxDataLength;
+
+			if (_session_info.stream_window_end > 0) {
+				// don't send past the end of the window
+				const uint32_t remaining = _session_info.stream_window_end - payload->offset;
+				bytes_to_read = math::min(bytes_to_read, static_cast<int>(remaining));
 			}
-		}
 
-		if (error_code == kErrNone) {
-			int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+			int bytes_read = _burstRead(payload->offset, &payload->data[0], bytes_to_read);
 
 			if (bytes_read < 0) {
 				// Negative return indicates error other than eof
 				error_code = kErrFailErrno;
 				PX4_WARN("stream download: read fail");
 
+			} else if (bytes_read == 0) {
+				// the file got shorter since it was opened
+				error_code = kErrEOF;
+
 			} else {
 				payload->size = bytes_read;
 				_session_info.stream_offset += bytes_read;
@@ -1132,34 +1297,37 @@ void MavlinkFTP::send()
 
 			_session_info.stream_download = false;
 
-		} else {
-#ifndef MAVLINK_FTP_UNIT_TEST
-
-			if (max_bytes_to_send < (get_size() * 2)) {
-				more_data = false;
+		} else if ((_session_info.stream_window_end > 0)
+			   && (_session_info.stream_offset >= _session_info.stream_window_end)) {
+			// the requested window is complete
+			payload->burst_complete = true;
+			_session_info.stream_download = false;
 
-				/* perform transfers in 35K chunks - this is determined empirical */
-				if (_session_info.stream_chunk_transmitted > 35000) {
-					payload->burst_complete = true;
-					_session_info.stream_download = false;
-					_session_info.stream_chunk_transmitted = 0;
-				}
+		} else if (max_bytes_to_send < (packet_size * 2)) {
+			more_data = false;
 
-			} else {
-#endif
-				more_data = true;
-				payload->burst_complete = false;
-#ifndef MAVLINK_FTP_UNIT_TEST
-				max_bytes_to_send -= get_size();
+			/* perform transfers in 35K chunks - this is determined empirical */
+			if ((_session_info.stream_window_end == 0)
+			    && (_session_info.stream_chunk_transmitted > 35000)) {
+				payload->burst_complete = true;
+				_session_info.stream_download = false;
+				_session_info.stream_chunk_transmitted = 0;
 			}
 
-#endif
+		} else {
+			more_data = true;
+			payload->burst_complete = false;
+			max_bytes_to_send -= packet_size;
 		}
 
 		ftp_msg.target_system = _session_info.stream_target_system_id;
 		ftp_msg.target_network = 0;
 		ftp_msg.target_component = _session_info.stream_target_component_id;
 		_reply(&ftp_msg);
+
+		if (rate_limited) {
+			_burst_tokens -= packet_size;
+		}
 	} while (more_data);
 }
 
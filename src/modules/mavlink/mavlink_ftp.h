@@ -75,6 +75,10 @@ public:
 	///	@param worker_data Data to pass to worker
 	void set_unittest_worker(ReceiveMessageFunc_t rcvMsgFunc, void *worker_data);
 
+	/// @brief Limits windowed bursts to a data rate in unit test mode, as on a UDP link.
+	///	@param data_rate Link data rate in bytes/s, 0 to send without limit.
+	void set_unittest_data_rate(int data_rate);
+
 	/// @brief This is the payload which is in mavlink_file_transfer_protocol_t.payload.
 	/// This needs to be packed, because it's typecasted from mavlink_file_transfer_protocol_t.payload, which starts
 	/// at a 3 byte offset, causing an unaligned access to seq_number and offset
@@ -107,7 +111,7 @@ public:
 		kCmdTruncateFile,	///< Truncate file at <path> to <offset> length
 		kCmdRename,		///< Rename <path1> to <path2>
 		kCmdCalcFileCRC32,	///< Calculate CRC32 for file at <path>
-		kCmdBurstReadFile,	///< Burst download session file
+		kCmdBurstReadFile,	///< Burst download session file, <data> optionally limits the window
 
 		kRspAck = 128,		///< Ack response
 		kRspNak			///< Nak response
@@ -151,6 +155,20 @@ private:
 	ErrorCode	_workRename(PayloadHeader *payload);
 	ErrorCode	_workCalcFileCRC32(PayloadHeader *payload);
 
+	/**
+	 * read burst data of the session file through the read ahead buffer
+	 * @return number of bytes read (less than len at the end of the file), -1 on error with _our_errno set
+	 */
+	int		_burstRead(uint32_t offset, uint8_t *dst, int len);
+	bool		_burstLoadChunk(int slot, uint32_t chunk_offset);
+	void		_burstInvalidate();
+
+	/**
+	 * refill the token bucket that limits a windowed burst to the data rate of a link without tx buffer (UDP)
+	 * @return number of bytes that may be sent now
+	 */
+	unsigned	_burstRateBudget(int data_rate);
+
 	uint8_t _getServerSystemId(void);
 	uint8_t _getServerComponentId(void);
 	uint8_t _getServerChannel(void);
@@ -179,11 +197,13 @@ private:
 		uint8_t		stream_target_system_id;
 		uint8_t         stream_target_component_id;
 		unsigned	stream_chunk_transmitted;
+		uint32_t	stream_window_end;	///< end offset of a windowed burst, 0 for an unbounded burst
 	};
 	struct SessionInfo _session_info {};	///< Session info, fd=-1 for no active session
 
 	ReceiveMessageFunc_t	_utRcvMsgFunc{};	///< Unit test override for mavlink message sending
 	void			*_worker_data{nullptr};	///< Additional parameter to _utRcvMsgFunc;
+	int			_utDataRate{0};		///< Unit test data rate limit for windowed bursts
 
 	Mavlink *_mavlink;
 
@@ -198,6 +218,24 @@ private:
 	static constexpr int _work_buffer2_len = 256;
 	hrt_abstime _last_work_buffer_access{0}; ///< timestamp when the buffers were last accessed
 
+	/* burst read ahead buffer: the file is read in aligned chunks, the last two of which are kept (double
+	 * buffered) so packets crossing a chunk boundary and retransmits of recent data don't cause another read.
+	 * Allocated with the first burst and freed together with the work buffers. */
+#if defined(__PX4_POSIX)
+	static constexpr int _burst_chunk_len = 64 * 1024;
+#else
+	static constexpr int _burst_chunk_len = 2 * 1024;
+#endif
+	uint8_t *_burst_buffer{nullptr};
+	uint32_t _burst_chunk_offset[2] {};
+	int _burst_chunk_size[2] {-1, -1}; ///< valid bytes in each chunk, -1 if empty
+
+	/* token bucket of a rate limited burst: it fills at the link data rate up to _burst_bucket_time worth of data
+	 * (at least one packet), each packet sent takes its size out */
+	static constexpr hrt_abstime _burst_bucket_time = 20000; ///< [us]
+	float _burst_tokens{0.f}; ///< [bytes]
+	hrt_abstime _last_burst_refill{0};
+
 	// prepend a root directory to each file/dir access to avoid enumerating the full FS tree (e.g. on Linux).
 	// Note that requests can still fall outside of the root dir by using ../..
 #ifdef MAVLINK_FTP_UNIT_TEST
@@ -38,6 +38,13 @@
 #include <crc32.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <px4_platform_common/time.h>
+
+#if defined(__PX4_POSIX)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
 
 #include "mavlink_ftp_test.h"
 #include "../mavlink_ftp.h"
@@ -54,6 +61,9 @@ static const char *_test_files[] = {
 	PX4_MAVLINK_TEST_DATA_DIR  "/" "test_240.data"
 };
 
+static const char *_window_test_file = PX4_MAVLINK_TEST_DATA_DIR  "/" "window.data";
+static const char *_throughput_test_file = PX4_MAVLINK_TEST_DATA_DIR  "/" "throughput.data";
+
 constexpr uint32_t MAX_DATA_LEN = MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN - sizeof(
 		MavlinkFTP::PayloadHeader);
 
@@ -127,6 +137,23 @@ void MavlinkFtpTest::_cleanup()
 {
 	delete _ftp_server;
 
+	delete[] _burst_file_bytes;
+	_burst_file_bytes = nullptr;
+	delete[] _burst_received_bytes;
+	_burst_received_bytes = nullptr;
+	delete[] _burst_packet_received;
+	_burst_packet_received = nullptr;
+
+	if (_burst_client_fd >= 0) {
+		::close(_burst_client_fd);
+		_burst_client_fd = -1;
+	}
+
+	if (_burst_server_fd >= 0) {
+		::close(_burst_server_fd);
+		_burst_server_fd = -1;
+	}
+
 	_cleanup_microsd();
 	_remove_test_files();
 }
@@ -137,6 +164,9 @@ bool MavlinkFtpTest::_remove_test_files()
 		::unlink(_test_files[i]);
 	}
 
+	::unlink(_window_test_file);
+	::unlink(_throughput_test_file);
+
 	::rmdir(PX4_MAVLINK_TEST_DATA_DIR "/empty_dir");
 	::rmdir(PX4_MAVLINK_TEST_DATA_DIR);
 
@@ -644,6 +674,286 @@ bool MavlinkFtpTest::_burst_test()
 	return true;
 }
 
+/// @brief Tests that a windowed burst sends exactly the requested range, including single packet retransmits.
+bool MavlinkFtpTest::_burst_window_test()
+{
+	MavlinkFTP::PayloadHeader		payload {};
+	const MavlinkFTP::PayloadHeader		*reply;
+	const char				*file = _window_test_file;
+	const uint32_t				file_size = 10 * MAX_DATA_LEN + 17;
+
+	_burst_file_bytes = new uint8_t[file_size];
+	_burst_received_bytes = new uint8_t[file_size];
+	ut_assert("new failed", _burst_file_bytes != nullptr && _burst_received_bytes != nullptr);
+	uint8_t *bytes = _burst_file_bytes;
+	uint8_t *received = _burst_received_bytes;
+
+	for (uint32_t i = 0; i < file_size; i++) {
+		bytes[i] = static_cast<uint8_t>((i * 7) ^ (i >> 8));
+	}
+
+	int fd = ::open(file, O_CREAT | O_TRUNC | O_WRONLY, S_IRWXU | S_IRWXG | S_IRWXO);
+	ut_assert("open failed", fd != -1);
+	const ssize_t written = ::write(fd, bytes, file_size);
+	::close(fd);
+	ut_compare("write failed", written, file_size);
+
+	payload.opcode = MavlinkFTP::kCmdOpenFileRO;
+	payload.offset = 0;
+	payload.size = strlen(file) + 1;
+
+	bool success = _send_receive_msg(&payload,		// FTP payload header
+					 (uint8_t *)file,	// Data to start into FTP message payload
+					 payload.size,		// size in bytes of data
+					 &reply);		// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+	const uint8_t session = reply->session;
+
+	/// offset, length and expected number of packets of the requested windows
+	static const struct {
+		uint32_t offset;
+		uint32_t length;
+		int packets;
+	} windows[] = {
+		{ 2 * MAX_DATA_LEN + 5, 4 * MAX_DATA_LEN, 4 },	// unaligned window in the middle of the file
+		{ 3 * MAX_DATA_LEN, MAX_DATA_LEN, 1 },		// single packet retransmit
+		{ 5 * MAX_DATA_LEN, 3, 1 },			// window shorter than a packet
+		{ 9 * MAX_DATA_LEN, 5 * MAX_DATA_LEN, 2 },	// window past the end of the file
+	};
+
+	WindowInfo window_info;
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_window, &window_info);
+
+	for (size_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++) {
+		memset(received, 0, file_size);
+		window_info.received_bytes = received;
+		window_info.next_offset = windows[i].offset;
+		window_info.packet_count = 0;
+		window_info.nak_count = 0;
+		window_info.in_order = true;
+		window_info.burst_complete = false;
+
+		_window_request(session, windows[i].offset, windows[i].length);
+
+		const uint32_t end = windows[i].offset + windows[i].length < file_size ?
+				     windows[i].offset + windows[i].length : file_size;
+
+		ut_compare("Incorrect number of packets", window_info.packet_count, windows[i].packets);
+		ut_compare("Unexpected Nak", window_info.nak_count, 0);
+		ut_assert("Packets out of order", window_info.in_order);
+		ut_assert("burst_complete not set", window_info.burst_complete);
+		ut_compare("Window end incorrect", window_info.next_offset, end);
+		ut_compare("File contents differ", memcmp(&received[windows[i].offset], &bytes[windows[i].offset],
+				end - windows[i].offset), 0);
+		ut_compare("Stream still active", _ftp_server->get_size(), 0);
+	}
+
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_generic, this);
+
+	// Terminate session
+	payload.opcode = MavlinkFTP::kCmdTerminateSession;
+	payload.session = session;
+	payload.size = 0;
+
+	success = _send_receive_msg(&payload,	// FTP payload header
+				    nullptr,	// Data to start into FTP message payload
+				    0,		// size in bytes of data
+				    &reply);	// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	return true;
+}
+
+/// @brief Downloads a large file in windowed bursts through a UDP loopback socket with the data rate limit of a UDP
+/// link. send() is called at a fixed rate like from the mavlink loop, lost packets are retransmitted, and the
+/// throughput is reported.
+bool MavlinkFtpTest::_burst_throughput_test()
+{
+#if defined(__PX4_POSIX)
+	MavlinkFTP::PayloadHeader		payload {};
+	const MavlinkFTP::PayloadHeader		*reply;
+	const char				*file = _throughput_test_file;
+	const uint32_t				file_size = 2 * 1024 * 1024;
+	const uint32_t				window_length = (64 * 1024 / MAX_DATA_LEN) * MAX_DATA_LEN;
+	const uint32_t				packet_count = (file_size + MAX_DATA_LEN - 1) / MAX_DATA_LEN;
+	const int				data_rate = 5 * 1000 * 1000;	// bytes/s
+	const unsigned				packet_size = MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL_LEN +
+			MAVLINK_NUM_NON_PAYLOAD_BYTES;
+	const float				bucket_size = data_rate * (MavlinkFTP::_burst_bucket_time * 1e-6f);
+
+	_burst_file_bytes = new uint8_t[file_size];
+	_burst_received_bytes = new uint8_t[file_size];
+	_burst_packet_received = new bool[packet_count] {};
+	ut_assert("new failed", _burst_file_bytes != nullptr && _burst_received_bytes != nullptr
+		  && _burst_packet_received != nullptr);
+	uint8_t *bytes = _burst_file_bytes;
+	uint8_t *received = _burst_received_bytes;
+	bool *packet_received = _burst_packet_received;
+
+	uint32_t random = 1;
+
+	for (uint32_t i = 0; i < file_size; i++) {
+		random = random * 1103515245 + 12345;
+		bytes[i] = static_cast<uint8_t>(random >> 16);
+	}
+
+	int fd = ::open(file, O_CREAT | O_TRUNC | O_WRONLY, S_IRWXU | S_IRWXG | S_IRWXO);
+	ut_assert("open failed", fd != -1);
+	const ssize_t written = ::write(fd, bytes, file_size);
+	::close(fd);
+	ut_compare("write failed", written, file_size);
+
+	// client socket on an ephemeral loopback port, the server side sends to it
+	struct sockaddr_in addr {};
+	socklen_t addr_len = sizeof(addr);
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+
+	_burst_client_fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+	_burst_server_fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+	ut_assert("socket failed", _burst_client_fd >= 0 && _burst_server_fd >= 0);
+	const int client_fd = _burst_client_fd;
+
+	int rcvbuf = 4 * 1024 * 1024;
+	setsockopt(client_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+	fcntl(client_fd, F_SETFL, fcntl(client_fd, F_GETFL, 0) | O_NONBLOCK);
+
+	ut_compare("bind failed", ::bind(client_fd, (struct sockaddr *)&addr, sizeof(addr)), 0);
+	ut_compare("getsockname failed", getsockname(client_fd, (struct sockaddr *)&addr, &addr_len), 0);
+	ut_compare("connect failed", ::connect(_burst_server_fd, (struct sockaddr *)&addr, sizeof(addr)), 0);
+
+	payload.opcode = MavlinkFTP::kCmdOpenFileRO;
+	payload.offset = 0;
+	payload.size = strlen(file) + 1;
+
+	bool success = _send_receive_msg(&payload,		// FTP payload header
+					 (uint8_t *)file,	// Data to start into FTP message payload
+					 payload.size,		// size in bytes of data
+					 &reply);		// Payload inside FTP message response
+
+	ut_assert("open request failed", success);
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+	const uint8_t session = reply->session;
+
+	UdpInfo udp_info{_burst_server_fd, 0};
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_udp, &udp_info);
+	_ftp_server->set_unittest_data_rate(data_rate);
+
+	const hrt_abstime start = hrt_absolute_time();
+	uint32_t first_missing = 0;
+	unsigned packets_sent = 0;
+	int requests = 0;
+
+	while (first_missing < packet_count) {
+		// request the next run of missing packets, limited to the window length
+		uint32_t last_missing = first_missing;
+
+		while ((last_missing + 1 < packet_count) && !packet_received[last_missing + 1]
+		       && ((last_missing + 1 - first_missing) * MAX_DATA_LEN < window_length)) {
+			last_missing++;
+		}
+
+		const uint32_t length = (last_missing - first_missing + 1) * MAX_DATA_LEN;
+		int new_packets = 0;
+		udp_info.packet_count = 0;
+		_window_request(session, first_missing * MAX_DATA_LEN, length);
+		requests++;
+
+		while (true) {
+			// a single send() never exceeds the token bucket, however long ago the last one was
+			ut_assert("Burst exceeds the rate limit", udp_info.packet_count * packet_size <= bucket_size);
+			packets_sent += udp_info.packet_count;
+			udp_info.packet_count = 0;
+
+			// drain the client socket
+			uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+			ssize_t len;
+
+			while ((len = ::recv(client_fd, buffer, sizeof(buffer), 0)) > 0) {
+				mavlink_message_t msg;
+				mavlink_status_t status;
+
+				for (ssize_t i = 0; i < len; i++) {
+					if (!mavlink_parse_char(MAVLINK_COMM_1, buffer[i], &msg, &status)) {
+						continue;
+					}
+
+					mavlink_file_transfer_protocol_t ftp_msg;
+					mavlink_msg_file_transfer_protocol_decode(&msg, &ftp_msg);
+					const MavlinkFTP::PayloadHeader *data =
+						reinterpret_cast<const MavlinkFTP::PayloadHeader *>(ftp_msg.payload);
+
+					ut_compare("Didn't get Ack back", data->opcode, MavlinkFTP::kRspAck);
+					ut_assert("Offset out of range", data->offset + data->size <= file_size);
+					memcpy(&received[data->offset], data->data, data->size);
+
+					if (!packet_received[data->offset / MAX_DATA_LEN]) {
+						packet_received[data->offset / MAX_DATA_LEN] = true;
+						new_packets++;
+					}
+				}
+			}
+
+			if (_ftp_server->get_size() == 0) {
+				// window complete
+				break;
+			}
+
+			// the mavlink loop calls send() periodically
+			px4_usleep(1000);
+			_ftp_server->send();
+		}
+
+		ut_assert("Request made no progress", new_packets > 0);
+
+		while (first_missing < packet_count && packet_received[first_missing]) {
+			first_missing++;
+		}
+	}
+
+	const hrt_abstime elapsed = hrt_elapsed_time(&start);
+
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_generic, this);
+	_ftp_server->set_unittest_data_rate(0);
+
+	ut_compare("File contents differ", memcmp(received, bytes, file_size), 0);
+
+	// a full bucket at the start, then at most the data rate
+	ut_assert("Data rate exceeded", packets_sent * packet_size <= bucket_size + data_rate * (elapsed * 1e-6f));
+
+	printf("burst download: %" PRIu32 " bytes in %.3f s (%.2f MB/s at a %.2f MB/s limit), %d requests for %" PRIu32
+	       " windows, %u packets for %" PRIu32 "\n",
+	       file_size, (double)elapsed * 1e-6, (double)file_size / (double)elapsed, data_rate * 1e-6, requests,
+	       (file_size + window_length - 1) / window_length, packets_sent, packet_count);
+
+	// Terminate session
+	payload.opcode = MavlinkFTP::kCmdTerminateSession;
+	payload.session = session;
+	payload.size = 0;
+
+	success = _send_receive_msg(&payload,	// FTP payload header
+				    nullptr,	// Data to start into FTP message payload
+				    0,		// size in bytes of data
+				    &reply);	// Payload inside FTP message response
+
+	ut_assert("terminate request failed", success);
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+#endif // __PX4_POSIX
+
+	return true;
+}
+
 /// @brief Tests for correct reponse to a Read command on an invalid session.
 bool MavlinkFtpTest::_read_badsession_test()
 {
@@ -929,6 +1239,44 @@ bool MavlinkFtpTest::_receive_message_handler_burst(const mavlink_file_transfer_
 	return true;
 }
 
+/// Static method used as callback from MavlinkFTP for windowed burst testing. Collects the stream packets.
+void MavlinkFtpTest::receive_message_handler_window(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data)
+{
+	WindowInfo *window_info = (WindowInfo *)worker_data;
+	const MavlinkFTP::PayloadHeader *reply = reinterpret_cast<const MavlinkFTP::PayloadHeader *>(ftp_req->payload);
+
+	if (reply->opcode != MavlinkFTP::kRspAck) {
+		window_info->nak_count++;
+		return;
+	}
+
+	if (reply->offset != window_info->next_offset || window_info->burst_complete) {
+		window_info->in_order = false;
+	}
+
+	memcpy(&window_info->received_bytes[reply->offset], reply->data, reply->size);
+	window_info->next_offset = reply->offset + reply->size;
+	window_info->burst_complete = reply->burst_complete;
+	window_info->packet_count++;
+}
+
+/// Static method used as callback from MavlinkFTP for the throughput test. Sends the message to the loopback client.
+void MavlinkFtpTest::receive_message_handler_udp(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data)
+{
+#if defined(__PX4_POSIX)
+	UdpInfo *udp_info = (UdpInfo *)worker_data;
+	mavlink_message_t msg;
+	uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+
+	mavlink_msg_file_transfer_protocol_encode(serverSystemId, serverComponentId, &msg, ftp_req);
+	const uint16_t len = mavlink_msg_to_send_buffer(buffer, &msg);
+
+	// a full receive buffer drops the packet, just as a lossy link would
+	::send(udp_info->fd, buffer, len, 0);
+	udp_info->packet_count++;
+#endif // __PX4_POSIX
+}
+
 /// @brief Decode and validate the incoming message
 bool MavlinkFtpTest::_decode_message(const mavlink_file_transfer_protocol_t	*ftp_msg,	///< Incoming FTP message
 				     const MavlinkFTP::PayloadHeader		**payload)	///< Payload inside FTP message response
@@ -996,6 +1344,26 @@ bool MavlinkFtpTest::_send_receive_msg(MavlinkFTP::PayloadHeader	*payload_header
 	return _decode_message(&_reply_msg, payload_reply);
 }
 
+/// @brief Sends a windowed burst request, the stream packets go to the current unit test worker
+bool MavlinkFtpTest::_window_request(uint8_t session, uint32_t offset, uint32_t length)
+{
+	MavlinkFTP::PayloadHeader	payload {};
+	mavlink_message_t		msg;
+
+	payload.opcode = MavlinkFTP::kCmdBurstReadFile;
+	payload.session = session;
+	payload.offset = offset;
+	payload.size = sizeof(length);
+
+	_setup_ftp_msg(&payload, reinterpret_cast<const uint8_t *>(&length), sizeof(length), &msg);
+	_ftp_server->handle_message(&msg);
+
+	// the stream packets are sent from send()
+	_ftp_server->send();
+
+	return true;
+}
+
 /// @brief Cleans up an files created on microsd during testing
 void MavlinkFtpTest::_cleanup_microsd()
 {
@@ -1017,6 +1385,8 @@ bool MavlinkFtpTest::run_tests()
 	ut_run_test(_read_test);
 	ut_run_test(_read_badsession_test);
 	ut_run_test(_burst_test);
+	ut_run_test(_burst_window_test);
+	ut_run_test(_burst_throughput_test);
 	ut_run_test(_removedirectory_test);
 	ut_run_test(_createdirectory_test);
 	ut_run_test(_removefile_test);
@@ -65,6 +65,26 @@ public:
 
 	static void receive_message_handler_burst(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
 
+	/// Worker data for windowed burst handler
+	struct WindowInfo {
+		uint8_t		*received_bytes;	///< received data is copied here at the reply offset
+		uint32_t	next_offset;		///< offset the next reply is expected at
+		int		packet_count;
+		int		nak_count;
+		bool		in_order;		///< all replies were contiguous
+		bool		burst_complete;		///< last reply had burst_complete set
+	};
+
+	static void receive_message_handler_window(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
+
+	/// Worker data for UDP handler
+	struct UdpInfo {
+		int		fd;			///< socket the messages are sent to
+		unsigned	packet_count;		///< number of messages sent
+	};
+
+	static void receive_message_handler_udp(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
+
 	static const uint8_t serverSystemId = 50;	///< System ID for server
 	static const uint8_t serverComponentId = 1;	///< Component ID for server
 	static const uint8_t serverChannel = 0;		///< Channel to send to
@@ -93,6 +113,8 @@ private:
 	bool _read_test(void);
 	bool _read_badsession_test(void);
 	bool _burst_test(void);
+	bool _burst_window_test(void);
+	bool _burst_throughput_test(void);
 	bool _removedirectory_test(void);
 	bool _createdirectory_test(void);
 	bool _removefile_test(void);
@@ -128,10 +150,18 @@ private:
 	};
 
 	bool _receive_message_handler_burst(const mavlink_file_transfer_protocol_t *ftp_req, BurstInfo *burst_info);
+	bool _window_request(uint8_t session, uint32_t offset, uint32_t length);
 
 	MavlinkFTP	*_ftp_server;
 	uint16_t	_expected_seq_number;
 
+	/// Buffers and sockets of the burst tests, released in _cleanup() so a failed assertion doesn't leak them
+	uint8_t		*_burst_file_bytes{nullptr};
+	uint8_t		*_burst_received_bytes{nullptr};
+	bool		*_burst_packet_received{nullptr};
+	int		_burst_client_fd{-1};
+	int		_burst_server_fd{-1};
+
 	mavlink_file_transfer_protocol_t _reply_msg;
 
 	static const char _unittest_microsd_dir[];
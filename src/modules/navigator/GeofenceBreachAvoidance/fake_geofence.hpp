@@ -75,6 +75,18 @@ public:
 		}
 	}
 
+	int firstPointOutsidePolygonOrCircle(const matrix::Vector2<double> trajectory[], int num_points,
+					     float altitude) override
+	{
+		for (int i = 0; i < num_points; i++) {
+			if (!isInsidePolygonOrCircle(trajectory[i](0), trajectory[i](1), altitude)) {
+				return i;
+			}
+		}
+
+		return num_points;
+	}
+
 	enum class ProbeFunction {
 		ALL_POINTS_OUTSIDE = 0,
 		LEFT_INSIDE_RIGHT_OUTSIDE,
@@ -153,26 +153,33 @@ GeofenceBreachAvoidance::generateLoiterPointForMultirotor(geofence_violation_typ
 {
 
 	if (violation_type.flags.fence_violation) {
-		float current_distance = _test_point_distance * 0.5f;
 		float current_min = 0.0f;
 		float current_max = _test_point_distance;
-		Vector2d test_point;
+		Vector2d trajectory[NUM_TRAJECTORY_POINTS];
 
-		// binary search for the distance from the drone to the geofence in the given direction
-		while (abs(current_max - current_min) > 0.5f) {
-			test_point = waypointFromBearingAndDistance(_current_pos_lat_lon, _test_point_bearing, current_distance);
+		// search for the distance from the drone to the geofence in the given direction: check equally spaced points
+		// of the trajectory at once and continue between the last one inside and the first one outside of the fence
+		while (current_max - current_min > 0.5f) {
+			const float step = (current_max - current_min) / NUM_TRAJECTORY_POINTS;
 
-			if (!geofence->isInsidePolygonOrCircle(test_point(0), test_point(1), _current_alt_amsl)) {
-				current_max = current_distance;
+			for (int i = 0; i < NUM_TRAJECTORY_POINTS; i++) {
+				trajectory[i] = waypointFromBearingAndDistance(_current_pos_lat_lon, _test_point_bearing,
+						current_min + (i + 1) * step);
+			}
+
+			const int first_outside = geofence->firstPointOutsidePolygonOrCircle(trajectory, NUM_TRAJECTORY_POINTS,
+						  _current_alt_amsl);
 
-			} else {
-				current_min = current_distance;
+			if (first_outside < NUM_TRAJECTORY_POINTS) {
+				current_max = current_min + (first_outside + 1) * step;
 			}
 
-			current_distance = (current_max + current_min) * 0.5f;
+			current_min += first_outside * step;
 		}
 
-		test_point = waypointFromBearingAndDistance(_current_pos_lat_lon, _test_point_bearing, current_distance);
+		const float current_distance = (current_max + current_min) * 0.5f;
+		const Vector2d test_point = waypointFromBearingAndDistance(_current_pos_lat_lon, _test_point_bearing,
+					    current_distance);
 
 		if (_multirotor_braking_distance > current_distance - _min_hor_dist_to_fence_mc) {
 			return waypointFromBearingAndDistance(test_point, _test_point_bearing + M_PI_F, _min_hor_dist_to_fence_mc);
@@ -100,6 +100,8 @@ public:
 	void updateParameters();
 
 private:
+	static constexpr int NUM_TRAJECTORY_POINTS = 16; ///< points per geofence check of the multirotor loiter point search
+
 	struct {
 		param_t param_mpc_jerk_max;
 		param_t param_mpc_acc_hor;
@@ -0,0 +1,455 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2021 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file GeofenceTest.cpp
+ * Compares the cached local frame polygon and circle checks of the geofence against the
+ * lat/lon point in polygon test reading every vertex from dataman
+ */
+
+#include <gtest/gtest.h>
+#include "geofence.h"
+#include "navigation.h"
+#include <dataman/dataman.h>
+#include <parameters/param.h>
+
+#include <random>
+#include <vector>
+
+using namespace matrix;
+
+// fence items in dataman, index 0 holds the stats
+static std::vector<mission_fence_point_s> fence_points(1);
+static mission_stats_entry_s fence_stats{};
+
+extern "C" {
+	__EXPORT ssize_t
+	dm_read(dm_item_t item, unsigned index, void *buffer, size_t buflen)
+	{
+		if (item != DM_KEY_FENCE_POINTS) {
+			return -1;
+		}
+
+		if (index == 0) {
+			memcpy(buffer, &fence_stats, math::min(buflen, sizeof(fence_stats)));
+			return math::min(buflen, sizeof(fence_stats));
+		}
+
+		if (index >= fence_points.size()) {
+			return -1;
+		}
+
+		memcpy(buffer, &fence_points[index], math::min(buflen, sizeof(mission_fence_point_s)));
+		return math::min(buflen, sizeof(mission_fence_point_s));
+	}
+
+	__EXPORT ssize_t dm_write(dm_item_t item, unsigned index, const void *buffer, size_t buflen) { return -1; }
+	__EXPORT int dm_lock(dm_item_t item) { return 0; }
+	__EXPORT int dm_trylock(dm_item_t item) { return 0; }
+	__EXPORT void dm_unlock(dm_item_t item) {}
+	__EXPORT int dm_clear(dm_item_t item) { return 0; }
+}
+
+class GeofenceTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		param_control_autosave(false);
+
+		fence_points.resize(1);
+		_items.clear();
+	}
+
+	// points closer than this to a fence border may differ:
+	// edges are straight in the local frame instead of in lat/lon
+	static constexpr float BORDER_TOLERANCE = 0.5f; // [m]
+
+	static constexpr double LAT0 = 47.397742;
+	static constexpr double LON0 = 8.545594;
+
+	struct FenceItem {
+		int index; ///< first dataman index
+		int count;
+		uint16_t nav_cmd;
+	};
+
+	void addPolygon(const std::vector<Vector2f> &vertices_local, uint16_t nav_cmd)
+	{
+		_items.push_back({(int)fence_points.size(), (int)vertices_local.size(), nav_cmd});
+
+		for (const Vector2f &vertex_local : vertices_local) {
+			mission_fence_point_s vertex{};
+			_projection.reproject(vertex_local(0), vertex_local(1), vertex.lat, vertex.lon);
+			vertex.vertex_count = vertices_local.size();
+			vertex.nav_cmd = nav_cmd;
+			vertex.frame = NAV_FRAME_GLOBAL;
+			fence_points.push_back(vertex);
+		}
+	}
+
+	void addCircle(const Vector2f &center_local, float radius, uint16_t nav_cmd)
+	{
+		_items.push_back({(int)fence_points.size(), 1, nav_cmd});
+
+		mission_fence_point_s center{};
+		_projection.reproject(center_local(0), center_local(1), center.lat, center.lon);
+		center.circle_radius = radius;
+		center.nav_cmd = nav_cmd;
+		center.frame = NAV_FRAME_GLOBAL;
+		fence_points.push_back(center);
+	}
+
+	// star shaped polygon with a random radius per vertex, concave for rmin < rmax
+	void addStar(std::mt19937 &rng, const Vector2f &center, float rmin, float rmax, int num_vertices,
+		     uint16_t nav_cmd)
+	{
+		std::uniform_real_distribution<float> radius(rmin, rmax);
+		std::vector<Vector2f> vertices;
+
+		for (int i = 0; i < num_vertices; i++) {
+			const float angle = 2.f * M_PI_F * i / num_vertices;
+			const float r = radius(rng);
+			vertices.push_back(center + Vector2f(r * cosf(angle), r * sinf(angle)));
+		}
+
+		addPolygon(vertices, nav_cmd);
+	}
+
+	static bool isCircle(const FenceItem &item)
+	{
+		return item.nav_cmd == NAV_CMD_FENCE_CIRCLE_INCLUSION || item.nav_cmd == NAV_CMD_FENCE_CIRCLE_EXCLUSION;
+	}
+
+	static bool isInclusion(const FenceItem &item)
+	{
+		return item.nav_cmd == NAV_CMD_FENCE_CIRCLE_INCLUSION
+		       || item.nav_cmd == NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION;
+	}
+
+	// fence point in the local frame of the test
+	Vector2f local(int index) const
+	{
+		return _projection.project(fence_points[index].lat, fence_points[index].lon);
+	}
+
+	void updateFence()
+	{
+		fence_stats.num_items = fence_points.size() - 1;
+		fence_stats.update_counter++;
+	}
+
+	/**
+	 * Reference: the point in polygon test in lat/lon on the dataman vertices, as before the local frame cache.
+	 */
+	bool referenceInside(double lat, double lon) const
+	{
+		bool outside_exclusion = true;
+		bool inside_inclusion = false;
+		bool had_inclusion_areas = false;
+
+		for (const FenceItem &item : _items) {
+			bool inside = false;
+
+			if (isCircle(item)) {
+				const float radius = fence_points[item.index].circle_radius;
+				const Vector2f delta = _projection.project(lat, lon) - local(item.index);
+				inside = delta.norm_squared() < radius * radius;
+
+			} else {
+				for (int i = 0, j = item.count - 1; i < item.count; j = i++) {
+					const mission_fence_point_s &vi = fence_points[item.index + i];
+					const mission_fence_point_s &vj = fence_points[item.index + j];
+
+					if ((vi.lon >= lon) != (vj.lon >= lon) &&
+					    (lat <= (vj.lat - vi.lat) * (lon - vi.lon) / (vj.lon - vi.lon) + vi.lat)) {
+						inside = !inside;
+					}
+				}
+			}
+
+			if (isInclusion(item)) {
+				had_inclusion_areas = true;
+				inside_inclusion |= inside;
+
+			} else {
+				outside_exclusion &= !inside;
+			}
+		}
+
+		return (!had_inclusion_areas || inside_inclusion) && outside_exclusion;
+	}
+
+	// distance to the closest polygon edge or circle border [m]
+	float distanceToBorder(double lat, double lon) const
+	{
+		const Vector2f point = _projection.project(lat, lon);
+		float distance = INFINITY;
+
+		for (const FenceItem &item : _items) {
+			if (isCircle(item)) {
+				const Vector2f delta = point - local(item.index);
+				const float radius = fence_points[item.index].circle_radius;
+				distance = math::min(distance, fabsf(delta.norm() - radius));
+				continue;
+			}
+
+			for (int i = 0, j = item.count - 1; i < item.count; j = i++) {
+				const Vector2f a = local(item.index + j);
+				const Vector2f edge = local(item.index + i) - a;
+				const Vector2f to_point = point - a;
+				const float t = math::constrain(to_point.dot(edge) / edge.norm_squared(), 0.f, 1.f);
+				const Vector2f to_edge = to_point - edge * t;
+				distance = math::min(distance, to_edge.norm());
+			}
+		}
+
+		return distance;
+	}
+
+	/**
+	 * Check the geofence against the reference for all points not within BORDER_TOLERANCE of a border.
+	 * @return number of points compared
+	 */
+	int compare(Geofence &geofence, const std::vector<Vector2d> &points)
+	{
+		int compared = 0;
+
+		for (const Vector2d &point : points) {
+			if (distanceToBorder(point(0), point(1)) < BORDER_TOLERANCE) {
+				continue;
+			}
+
+			const bool expected = referenceInside(point(0), point(1));
+			EXPECT_EQ(geofence.isInsidePolygonOrCircle(point(0), point(1), 0.f), expected)
+					<< "lat " << point(0) << " lon " << point(1);
+			_inside += expected;
+			compared++;
+		}
+
+		return compared;
+	}
+
+	std::vector<Vector2d> randomPoints(std::mt19937 &rng, const Vector2f &min, const Vector2f &max,
+					   int num_points) const
+	{
+		std::uniform_real_distribution<float> x(min(0), max(0));
+		std::uniform_real_distribution<float> y(min(1), max(1));
+		std::vector<Vector2d> points;
+
+		for (int i = 0; i < num_points; i++) {
+			double lat, lon;
+			_projection.reproject(x(rng), y(rng), lat, lon);
+			points.emplace_back(lat, lon);
+		}
+
+		return points;
+	}
+
+	MapProjection _projection{LAT0, LON0};
+	std::vector<FenceItem> _items;
+	int _inside{0};
+};
+
+TEST_F(GeofenceTest, convexPolygon)
+{
+	std::mt19937 rng(1);
+	addStar(rng, Vector2f(0.f, 0.f), 500.f, 500.f, 12, NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION);
+	updateFence();
+
+	Geofence geofence(nullptr);
+	const int num_points = 20000;
+	EXPECT_GT(compare(geofence, randomPoints(rng, Vector2f(-700.f, -700.f), Vector2f(700.f, 700.f), num_points)),
+		  num_points * 99 / 100);
+	EXPECT_GT(_inside, num_points / 4);
+}
+
+TEST_F(GeofenceTest, concavePolygonManyVertices)
+{
+	std::mt19937 rng(2);
+	addStar(rng, Vector2f(0.f, 0.f), 300.f, 1000.f, 256, NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION);
+	updateFence();
+
+	Geofence geofence(nullptr);
+	const int num_points = 50000;
+	const std::vector<Vector2d> points = randomPoints(rng, Vector2f(-1100.f, -1100.f), Vector2f(1100.f, 1100.f),
+					     num_points);
+	EXPECT_GT(compare(geofence, points), num_points * 95 / 100);
+	EXPECT_GT(_inside, num_points / 5);
+}
+
+TEST_F(GeofenceTest, concaveComb)
+{
+	// teeth pointing north, with edges on many of the band boundaries
+	std::vector<Vector2f> comb{Vector2f(0.f, 0.f)};
+
+	for (int tooth = 0; tooth < 10; tooth++) {
+		comb.emplace_back(800.f, 100.f * tooth);
+		comb.emplace_back(800.f, 100.f * tooth + 50.f);
+		comb.emplace_back(200.f, 100.f * tooth + 50.f);
+		comb.emplace_back(200.f, 100.f * tooth + 100.f);
+	}
+
+	comb.emplace_back(0.f, 1000.f);
+	addPolygon(comb, NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION);
+	updateFence();
+
+	std::mt19937 rng(3);
+	Geofence geofence(nullptr);
+	const int num_points = 20000;
+	EXPECT_GT(compare(geofence, randomPoints(rng, Vector2f(-100.f, -100.f), Vector2f(900.f, 1100.f), num_points)),
+		  num_points * 95 / 100);
+	EXPECT_GT(_inside, num_points / 5);
+}
+
+TEST_F(GeofenceTest, inclusionExclusionPolygonsAndCircles)
+{
+	std::mt19937 rng(4);
+	addStar(rng, Vector2f(0.f, 0.f), 300.f, 1000.f, 200, NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION);
+	addStar(rng, Vector2f(200.f, 0.f), 50.f, 200.f, 20, NAV_CMD_FENCE_POLYGON_VERTEX_EXCLUSION);
+	addCircle(Vector2f(-300.f, 250.f), 150.f, NAV_CMD_FENCE_CIRCLE_EXCLUSION);
+	addCircle(Vector2f(1300.f, 1000.f), 200.f, NAV_CMD_FENCE_CIRCLE_INCLUSION);
+	addStar(rng, Vector2f(0.f, 1600.f), 100.f, 150.f, 4, NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION);
+	updateFence();
+
+	Geofence geofence(nullptr);
+	const int num_points = 50000;
+	const std::vector<Vector2d> points = randomPoints(rng, Vector2f(-1200.f, -1200.f), Vector2f(1600.f, 1900.f),
+					     num_points);
+	EXPECT_GT(compare(geofence, points), num_points * 95 / 100);
+	EXPECT_GT(_inside, num_points / 10);
+
+	// a fence update is picked up by the next check
+	fence_points.resize(1);
+	_items.clear();
+	addCircle(Vector2f(0.f, 0.f), 100.f, NAV_CMD_FENCE_CIRCLE_INCLUSION);
+	updateFence();
+
+	EXPECT_TRUE(geofence.isInsidePolygonOrCircle(LAT0, LON0, 0.f));
+	EXPECT_GT(compare(geofence, randomPoints(rng, Vector2f(-200.f, -200.f), Vector2f(200.f, 200.f), 1000)), 900);
+}
+
+TEST_F(GeofenceTest, bandBoundaries)
+{
+	std::mt19937 rng(5);
+	addStar(rng, Vector2f(0.f, 0.f), 300.f, 1000.f, 256, NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION);
+	updateFence();
+
+	// the geofence projects into the frame of the first vertex and splits the east extent into 32 bands
+	const mission_fence_point_s &first = fence_points[1];
+	const MapProjection fence_projection{first.lat, first.lon};
+	float min_y = INFINITY;
+	float max_y = -INFINITY;
+	std::vector<float> y_values;
+
+	for (size_t i = 1; i < fence_points.size(); i++) {
+		const float y = fence_projection.project(fence_points[i].lat, fence_points[i].lon)(1);
+		min_y = math::min(min_y, y);
+		max_y = math::max(max_y, y);
+		y_values.push_back(y); // rays through vertices
+	}
+
+	const int num_bands = 32;
+
+	for (int band = 0; band <= num_bands; band++) {
+		const float y = min_y + (max_y - min_y) * band / num_bands;
+		y_values.push_back(y);
+		y_values.push_back(nextafterf(y, -INFINITY));
+		y_values.push_back(nextafterf(y, INFINITY));
+	}
+
+	std::uniform_real_distribution<float> x(-1100.f, 1100.f);
+	std::vector<Vector2d> points;
+
+	for (float y : y_values) {
+		for (int i = 0; i < 20; i++) {
+			double lat, lon;
+			fence_projection.reproject(x(rng), y, lat, lon);
+			points.emplace_back(lat, lon);
+		}
+	}
+
+	Geofence geofence(nullptr);
+	EXPECT_GT(compare(geofence, points), (int)points.size() * 9 / 10);
+	EXPECT_GT(_inside, (int)points.size() / 5);
+}
+
+TEST_F(GeofenceTest, trajectoryLeavingTheFence)
+{
+	std::mt19937 rng(6);
+	addStar(rng, Vector2f(0.f, 0.f), 800.f, 1000.f, 256, NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION);
+	addStar(rng, Vector2f(100.f, 100.f), 30.f, 60.f, 10, NAV_CMD_FENCE_POLYGON_VERTEX_EXCLUSION);
+	updateFence();
+
+	Geofence geofence(nullptr);
+	std::uniform_real_distribution<float> heading(0.f, 2.f * M_PI_F);
+	const int num_points = 64;
+	int checked = 0;
+	int left_mid_way = 0;
+
+	for (int trajectory_idx = 0; trajectory_idx < 500; trajectory_idx++) {
+		// straight line from the center (inside) out to 1200 m (outside)
+		const float angle = heading(rng);
+		Vector2<double> trajectory[num_points];
+		int expected = num_points;
+		bool ambiguous = false;
+
+		for (int i = 0; i < num_points; i++) {
+			const float distance = 1200.f * i / (num_points - 1);
+			const Vector2f point_local(distance * cosf(angle), distance * sinf(angle));
+			_projection.reproject(point_local(0), point_local(1), trajectory[i](0), trajectory[i](1));
+
+			// points after the first one outside do not affect the result
+			if (expected < num_points) {
+				continue;
+			}
+
+			ambiguous |= distanceToBorder(trajectory[i](0), trajectory[i](1)) < BORDER_TOLERANCE;
+
+			if (!referenceInside(trajectory[i](0), trajectory[i](1))) {
+				expected = i;
+			}
+		}
+
+		if (ambiguous) {
+			continue;
+		}
+
+		EXPECT_EQ(geofence.firstPointOutsidePolygonOrCircle(trajectory, num_points, 0.f), expected);
+		left_mid_way += (expected > 0) && (expected < num_points);
+		checked++;
+	}
+
+	EXPECT_GT(checked, 400);
+	EXPECT_EQ(left_mid_way, checked);
+}
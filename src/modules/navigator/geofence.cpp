@@ -69,6 +69,10 @@ Geofence::~Geofence()
 	if (_polygons) {
 		delete[](_polygons);
 	}
+
+	delete[](_vertices);
+	delete[](_band_offsets);
+	delete[](_band_edges);
 }
 
 void Geofence::updateFence()
@@ -178,6 +182,186 @@ void Geofence::_updateFence()
 
 	}
 
+	loadGeometry();
+}
+
+void Geofence::loadGeometry()
+{
+	delete[](_vertices);
+	delete[](_band_offsets);
+	delete[](_band_edges);
+	_vertices = nullptr;
+	_band_offsets = nullptr;
+	_band_edges = nullptr;
+
+	int num_vertices = 0;
+	int num_band_offsets = 0;
+
+	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+		PolygonInfo &polygon = _polygons[polygon_idx];
+		polygon.valid = false;
+		polygon.num_bands = 0;
+
+		if (polygon.fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION || polygon.fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION) {
+			num_vertices += 1;
+
+		} else {
+			num_vertices += polygon.vertex_count;
+			num_band_offsets += math::min((int)polygon.vertex_count, MAX_BANDS) + 1;
+		}
+	}
+
+	if (num_vertices == 0) {
+		return;
+	}
+
+	_vertices = new matrix::Vector2f[num_vertices];
+	_band_offsets = new uint16_t[math::max(num_band_offsets, 1)];
+
+	if (!_vertices || !_band_offsets) {
+		PX4_ERR("alloc failed");
+		return;
+	}
+
+	// project all vertices into the local frame, with the first vertex as reference
+	int vertex_index = 0;
+	bool reference_set = false;
+
+	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+		PolygonInfo &polygon = _polygons[polygon_idx];
+		const bool is_circle = polygon.fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION
+				       || polygon.fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION;
+		const int count = is_circle ? 1 : polygon.vertex_count;
+		int i = 0;
+
+		for (; i < count; ++i) {
+			mission_fence_point_s vertex;
+
+			if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index + i, &vertex,
+				    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
+				PX4_ERR("dm_read failed");
+				break;
+			}
+
+			if (vertex.frame != NAV_FRAME_GLOBAL && vertex.frame != NAV_FRAME_GLOBAL_INT
+			    && vertex.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT
+			    && vertex.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
+				// TODO: handle different frames
+				PX4_ERR("Frame type %i not supported", (int)vertex.frame);
+				break;
+			}
+
+			if (!reference_set) {
+				_projection_reference.initReference(vertex.lat, vertex.lon);
+				reference_set = true;
+			}
+
+			_vertices[vertex_index + i] = _projection_reference.project(vertex.lat, vertex.lon);
+		}
+
+		polygon.vertex_index = vertex_index;
+		polygon.valid = (i == count);
+		vertex_index += count;
+
+		if (!polygon.valid || is_circle) {
+			continue;
+		}
+
+		polygon.min_x = polygon.max_x = _vertices[polygon.vertex_index](0);
+		polygon.min_y = polygon.max_y = _vertices[polygon.vertex_index](1);
+
+		for (i = 1; i < count; ++i) {
+			const matrix::Vector2f &vertex = _vertices[polygon.vertex_index + i];
+			polygon.min_x = math::min(polygon.min_x, vertex(0));
+			polygon.max_x = math::max(polygon.max_x, vertex(0));
+			polygon.min_y = math::min(polygon.min_y, vertex(1));
+			polygon.max_y = math::max(polygon.max_y, vertex(1));
+		}
+
+		polygon.num_bands = math::min(count, MAX_BANDS);
+		polygon.band_width = (polygon.max_y - polygon.min_y) / polygon.num_bands;
+
+		if (!(polygon.band_width > FLT_EPSILON)) {
+			polygon.band_width = 1.f; // degenerate polygon
+		}
+	}
+
+	// count the edges spanning each band: an edge can only be crossed by the test ray of a point in its east range
+	int band_index = 0;
+	int num_band_edges = 0;
+
+	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+		PolygonInfo &polygon = _polygons[polygon_idx];
+
+		if (polygon.fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION || polygon.fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION) {
+			continue;
+		}
+
+		polygon.band_index = band_index;
+		band_index += math::min((int)polygon.vertex_count, MAX_BANDS) + 1;
+
+		uint16_t *offsets = &_band_offsets[polygon.band_index];
+		memset(offsets, 0, (polygon.num_bands + 1) * sizeof(uint16_t));
+
+		const matrix::Vector2f *vertices = &_vertices[polygon.vertex_index];
+
+		for (int i = 0, j = polygon.vertex_count - 1; polygon.valid && i < polygon.vertex_count; j = i++) {
+			if (vertices[i](1) != vertices[j](1)) {
+				const int band_end = band(polygon, math::max(vertices[i](1), vertices[j](1)));
+
+				for (int b = band(polygon, math::min(vertices[i](1), vertices[j](1))); b <= band_end; ++b) {
+					++offsets[b + 1];
+				}
+			}
+		}
+
+		offsets[0] = num_band_edges;
+
+		for (int b = 0; b < polygon.num_bands; ++b) {
+			offsets[b + 1] += offsets[b];
+		}
+
+		num_band_edges = offsets[polygon.num_bands];
+	}
+
+	if (num_band_edges == 0) {
+		return;
+	}
+
+	_band_edges = new uint16_t[num_band_edges];
+
+	if (!_band_edges) {
+		PX4_ERR("alloc failed");
+
+		for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+			_polygons[polygon_idx].valid = false;
+		}
+
+		return;
+	}
+
+	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+		const PolygonInfo &polygon = _polygons[polygon_idx];
+
+		if (!polygon.valid || polygon.num_bands == 0) {
+			continue;
+		}
+
+		uint16_t next[MAX_BANDS];
+		memcpy(next, &_band_offsets[polygon.band_index], polygon.num_bands * sizeof(uint16_t));
+
+		const matrix::Vector2f *vertices = &_vertices[polygon.vertex_index];
+
+		for (int i = 0, j = polygon.vertex_count - 1; i < polygon.vertex_count; j = i++) {
+			if (vertices[i](1) != vertices[j](1)) {
+				const int band_end = band(polygon, math::max(vertices[i](1), vertices[j](1)));
+
+				for (int b = band(polygon, math::min(vertices[i](1), vertices[j](1))); b <= band_end; ++b) {
+					_band_edges[next[b]++] = i;
+				}
+			}
+		}
+	}
 }
 
 bool Geofence::checkAll(const struct vehicle_global_position_s &global_position)
@@ -312,10 +496,17 @@ bool Geofence::checkAll(double lat, double lon, float altitude)
 
 bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
 {
-	// the following uses dm_read, so first we try to lock all items. If that fails, it (most likely) means
+	const matrix::Vector2<double> point(lat, lon);
+	return firstPointOutsidePolygonOrCircle(&point, 1, altitude) == 1;
+}
+
+int Geofence::firstPointOutsidePolygonOrCircle(const matrix::Vector2<double> trajectory[], int num_points,
+		float altitude)
+{
+	// to check if the fence data got updated we first try to lock all items. If that fails, it (most likely) means
 	// the data is currently being updated (via a mavlink geofence transfer), and we do not check for a violation now
 	if (dm_trylock(DM_KEY_FENCE_POINTS) != 0) {
-		return true;
+		return num_points;
 	}
 
 	// we got the lock, now check if the fence data got updated
@@ -326,29 +517,41 @@ bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
 		_updateFence();
 	}
 
+	// the checks only use the cached geometry
+	dm_unlock(DM_KEY_FENCE_POINTS);
+
 	if (isEmpty()) {
-		dm_unlock(DM_KEY_FENCE_POINTS);
 		/* Empty fence -> accept all points */
-		return true;
+		return num_points;
 	}
 
 	/* Vertical check */
 	if (_altitude_max > _altitude_min) { // only enable vertical check if configured properly
 		if (altitude > _altitude_max || altitude < _altitude_min) {
-			dm_unlock(DM_KEY_FENCE_POINTS);
-			return false;
+			return 0;
+		}
+	}
+
+	/* Horizontal check */
+	for (int i = 0; i < num_points; ++i) {
+		if (!insidePolygonsAndCircles(_projection_reference.project(trajectory[i](0), trajectory[i](1)))) {
+			return i;
 		}
 	}
 
+	return num_points;
+}
 
-	/* Horizontal check: iterate all polygons & circles */
+bool Geofence::insidePolygonsAndCircles(const matrix::Vector2f &point) const
+{
+	/* iterate all polygons & circles */
 	bool outside_exclusion = true;
 	bool inside_inclusion = false;
 	bool had_inclusion_areas = false;
 
 	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
 		if (_polygons[polygon_idx].fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION) {
-			bool inside = insideCircle(_polygons[polygon_idx], lat, lon, altitude);
+			bool inside = insideCircle(_polygons[polygon_idx], point);
 
 			if (inside) {
 				inside_inclusion = true;
@@ -357,14 +560,14 @@ bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
 			had_inclusion_areas = true;
 
 		} else if (_polygons[polygon_idx].fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION) {
-			bool inside = insideCircle(_polygons[polygon_idx], lat, lon, altitude);
+			bool inside = insideCircle(_polygons[polygon_idx], point);
 
 			if (inside) {
 				outside_exclusion = false;
 			}
 
 		} else { // it's a polygon
-			bool inside = insidePolygon(_polygons[polygon_idx], lat, lon, altitude);
+			bool inside = insidePolygon(_polygons[polygon_idx], point);
 
 			if (_polygons[polygon_idx].fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION) {
 				if (inside) {
@@ -381,46 +584,49 @@ bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
 		}
 	}
 
-	dm_unlock(DM_KEY_FENCE_POINTS);
-
 	return (!had_inclusion_areas || inside_inclusion) && outside_exclusion;
 }
 
-bool Geofence::insidePolygon(const PolygonInfo &polygon, double lat, double lon, float altitude)
+int Geofence::band(const PolygonInfo &polygon, float y)
 {
+	const float band = (y - polygon.min_y) / polygon.band_width;
+
+	if (band >= polygon.num_bands - 1) {
+		return polygon.num_bands - 1;
+
+	} else if (band > 0.f) {
+		return (int)band;
+	}
+
+	return 0;
+}
+
+bool Geofence::insidePolygon(const PolygonInfo &polygon, const matrix::Vector2f &point) const
+{
+	if (!polygon.valid
+	    || !(point(0) >= polygon.min_x && point(0) <= polygon.max_x && point(1) >= polygon.min_y && point(1) <= polygon.max_y)) {
+		return false;
+	}
 
 	/* Adaptation of algorithm originally presented as
 	 * PNPOLY - Point Inclusion in Polygon Test
 	 * W. Randolph Franklin (WRF)
 	 * Only supports non-complex polygons (not self intersecting)
+	 *
+	 * Only the edges in the band of the point can be crossed by the test ray.
 	 */
 
-	mission_fence_point_s temp_vertex_i;
-	mission_fence_point_s temp_vertex_j;
+	const matrix::Vector2f *vertices = &_vertices[polygon.vertex_index];
+	const uint16_t *offsets = &_band_offsets[polygon.band_index + band(polygon, point(1))];
 	bool c = false;
 
-	for (unsigned i = 0, j = polygon.vertex_count - 1; i < polygon.vertex_count; j = i++) {
-		if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index + i, &temp_vertex_i,
-			    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-			break;
-		}
-
-		if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index + j, &temp_vertex_j,
-			    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-			break;
-		}
-
-		if (temp_vertex_i.frame != NAV_FRAME_GLOBAL && temp_vertex_i.frame != NAV_FRAME_GLOBAL_INT
-		    && temp_vertex_i.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT
-		    && temp_vertex_i.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
-			// TODO: handle different frames
-			PX4_ERR("Frame type %i not supported", (int)temp_vertex_i.frame);
-			break;
-		}
+	for (int k = offsets[0]; k < offsets[1]; ++k) {
+		const int i = _band_edges[k];
+		const int j = (i == 0) ? polygon.vertex_count - 1 : i - 1;
 
-		if (((double)temp_vertex_i.lon >= lon) != ((double)temp_vertex_j.lon >= lon) &&
-		    (lat <= (double)(temp_vertex_j.lat - temp_vertex_i.lat) * (lon - (double)temp_vertex_i.lon) /
-		     (double)(temp_vertex_j.lon - temp_vertex_i.lon) + (double)temp_vertex_i.lat)) {
+		if ((vertices[i](1) >= point(1)) != (vertices[j](1) >= point(1)) &&
+		    (point(0) <= (vertices[j](0) - vertices[i](0)) * (point(1) - vertices[i](1)) /
+		     (vertices[j](1) - vertices[i](1)) + vertices[i](0))) {
 			c = !c;
 		}
 	}
@@ -428,34 +634,14 @@ bool Geofence::insidePolygon(const PolygonInfo &polygon, double lat, double lon,
 	return c;
 }
 
-bool Geofence::insideCircle(const PolygonInfo &polygon, double lat, double lon, float altitude)
+bool Geofence::insideCircle(const PolygonInfo &polygon, const matrix::Vector2f &point) const
 {
-
-	mission_fence_point_s circle_point;
-
-	if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index, &circle_point,
-		    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-		PX4_ERR("dm_read failed");
+	if (!polygon.valid) {
 		return false;
 	}
 
-	if (circle_point.frame != NAV_FRAME_GLOBAL && circle_point.frame != NAV_FRAME_GLOBAL_INT
-	    && circle_point.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT
-	    && circle_point.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
-		// TODO: handle different frames
-		PX4_ERR("Frame type %i not supported", (int)circle_point.frame);
-		return false;
-	}
-
-	if (!_projection_reference.isInitialized()) {
-		_projection_reference.initReference(lat, lon);
-	}
-
-	float x1, y1, x2, y2;
-	_projection_reference.project(lat, lon, x1, y1);
-	_projection_reference.project(circle_point.lat, circle_point.lon, x2, y2);
-	float dx = x1 - x2, dy = y1 - y2;
-	return dx * dx + dy * dy < circle_point.circle_radius * circle_point.circle_radius;
+	const matrix::Vector2f delta = point - _vertices[polygon.vertex_index];
+	return delta.norm_squared() < polygon.circle_radius * polygon.circle_radius;
 }
 
 bool
@@ -105,6 +105,16 @@ public:
 
 	virtual bool isInsidePolygonOrCircle(double lat, double lon, float altitude);
 
+	/**
+	 * Check a whole trajectory (eg. predicted positions) against the polygons and circles, the fence data is only
+	 * checked for updates once for all points.
+	 *
+	 * @param trajectory lat/lon [deg] of the points, in the order they are reached
+	 * @return index of the first point outside of the fence, num_points if all points are inside
+	 */
+	virtual int firstPointOutsidePolygonOrCircle(const matrix::Vector2<double> trajectory[], int num_points,
+			float altitude);
+
 	int clearDm();
 
 	bool valid();
@@ -169,10 +179,28 @@ private:
 			uint16_t vertex_count;
 			float circle_radius;
 		};
+
+		// cached geometry in the local frame
+		bool valid; ///< false if the vertices could not be loaded
+		uint16_t vertex_index; ///< first vertex (or the circle center) in _vertices
+		uint16_t band_index; ///< first of the num_bands + 1 entries in _band_offsets
+		uint8_t num_bands;
+		float band_width; ///< [m]
+		float min_x, max_x, min_y, max_y; ///< bounding box [m]
 	};
 	PolygonInfo *_polygons{nullptr};
 	int _num_polygons{0};
 
+	/**
+	 * The polygon edges are bucketed into bands of equal width along the east axis, so that the point in polygon test
+	 * only needs to look at the few edges spanning the band of the point.
+	 */
+	static constexpr int MAX_BANDS = 32;
+
+	matrix::Vector2f *_vertices{nullptr}; ///< polygon vertices and circle centers, local frame [m]
+	uint16_t *_band_offsets{nullptr}; ///< per polygon band: start of its edges in _band_edges
+	uint16_t *_band_edges{nullptr}; ///< edge indices, edge i goes from vertex i-1 to vertex i
+
 	MapProjection _projection_reference{}; ///< class to convert (lon, lat) to local [m]
 
 	DEFINE_PARAMETERS(
@@ -194,6 +222,17 @@ private:
 	 */
 	void _updateFence();
 
+	/**
+	 * read the vertices of all polygons and circles from dataman into the local frame and build the edge bands
+	 */
+	void loadGeometry();
+
+	/**
+	 * Check if a point passes the polygons and circles.
+	 * @param point in the local frame [m]
+	 */
+	bool insidePolygonsAndCircles(const matrix::Vector2f &point) const;
+
 	/**
 	 * Check if a point passes the Geofence test.
 	 * This takes all polygons and minimum & maximum altitude into account
@@ -211,16 +250,21 @@ private:
 	bool checkAll(const vehicle_global_position_s &global_position);
 	bool checkAll(const vehicle_global_position_s &global_position, float baro_altitude_amsl);
 
+	/**
+	 * @return band of the polygon containing the east coordinate y
+	 */
+	static int band(const PolygonInfo &polygon, float y);
+
 	/**
 	 * Check if a single point is within a polygon
 	 * @return true if within polygon
 	 */
-	bool insidePolygon(const PolygonInfo &polygon, double lat, double lon, float altitude);
+	bool insidePolygon(const PolygonInfo &polygon, const matrix::Vector2f &point) const;
 
 	/**
 	 * Check if a single point is within a circle
 	 * @param polygon must be a circle!
 	 * @return true if within polygon the circle
 	 */
-	bool insideCircle(const PolygonInfo &polygon, double lat, double lon, float altitude);
+	bool insideCircle(const PolygonInfo &polygon, const matrix::Vector2f &point) const;
 };
@@ -48,6 +48,7 @@
 #include <px4_platform_common/shutdown.h>
 #include <lib/parameters/param.h>
 
+#include <algorithm>
 #include <cstring>
 #include <float.h>
 #include <fstream>
@@ -60,6 +61,7 @@
 #include <string>
 
 #include <logger/messages.h>
+#include <lz4_block/lz4_block.h>
 
 #include "Replay.hpp"
 #include "ReplayEkf2.hpp"
@@ -87,6 +89,10 @@ Replay::CompatSensorCombinedDtType::CompatSensorCombinedDtType(int gyro_integral
 Replay::~Replay()
 {
 	for (size_t i = 0; i < _subscriptions.size(); ++i) {
+		if (_subscriptions[i]) {
+			delete (_subscriptions[i]->compat);
+		}
+
 		delete (_subscriptions[i]);
 	}
 
@@ -121,9 +127,145 @@ Replay::setupReplayFile(const char *file_name)
 		free(_replay_file);
 	}
 
+	// compressed logs are replayed from a decompressed copy
+	ifstream file(file_name, ios::in | ios::binary);
+	ulog_compressed_file_header_s header{};
+	file.read((char *)&header, sizeof(header));
+	file.close();
+
+	if (memcmp(header.magic, ulog_compressed_magic, sizeof(header.magic)) == 0) {
+		string output_file_name = file_name;
+		const size_t extension = output_file_name.rfind(".ulgz");
+
+		if (extension != string::npos) {
+			output_file_name.erase(extension);
+		}
+
+		output_file_name += "_decompressed.ulg";
+
+		if (decompressLogFile(file_name, output_file_name.c_str())) {
+			_replay_file = strdup(output_file_name.c_str());
+			return;
+		}
+	}
+
 	_replay_file = strdup(file_name);
 }
 
+bool
+Replay::decompressLogFile(const char *file_name, const char *output_file_name)
+{
+	ifstream file(file_name, ios::in | ios::binary);
+	ofstream output_file(output_file_name, ios::out | ios::binary | ios::trunc);
+
+	if (!file.is_open() || !output_file.is_open()) {
+		PX4_ERR("Failed to open %s or %s", file_name, output_file_name);
+		return false;
+	}
+
+	ulog_compressed_file_header_s file_header;
+	file.read((char *)&file_header, sizeof(file_header));
+
+	if (!file || memcmp(file_header.magic, ulog_compressed_magic, sizeof(file_header.magic)) != 0
+	    || file_header.version != ulog_compressed_version || file_header.max_block_size > lz4::MAX_INPUT_SIZE) {
+		PX4_ERR("Unsupported compressed log file");
+		return false;
+	}
+
+	PX4_INFO("Decompressing %s to %s", file_name, output_file_name);
+
+	vector<uint8_t> payload(file_header.max_block_size);
+	vector<uint8_t> data(file_header.max_block_size);
+	int num_blocks = 0;
+	int num_corrupt = 0;
+	bool truncated = false;
+
+	while (true) {
+		const streampos block_start = file.tellg();
+		ulog_compressed_block_header_s header;
+		file.read((char *)&header, sizeof(header));
+
+		if (file.gcount() == 0) {
+			break; // end of file
+		}
+
+		const size_t data_size = header.data_size & ~ULOG_COMPRESSED_BLOCK_STORED;
+		const bool stored = header.data_size & ULOG_COMPRESSED_BLOCK_STORED;
+		bool valid = file && memcmp(header.sync, ulog_compressed_block_sync, sizeof(header.sync)) == 0
+			     && data_size <= file_header.max_block_size && header.payload_size <= file_header.max_block_size
+			     && (!stored || header.payload_size == data_size);
+
+		if (valid) {
+			file.read((char *)payload.data(), header.payload_size);
+
+			if (!file) {
+				truncated = true;
+				break;
+			}
+
+			valid = ulog_compressed_checksum(payload.data(), header.payload_size) == header.checksum;
+		}
+
+		if (valid) {
+			if (stored) {
+				output_file.write((const char *)payload.data(), data_size);
+
+			} else {
+				const int decompressed = lz4::decompress(payload.data(), header.payload_size, data.data(), data.size());
+				valid = decompressed == (int)data_size;
+
+				if (valid) {
+					output_file.write((const char *)data.data(), data_size);
+				}
+			}
+		}
+
+		if (valid) {
+			++num_blocks;
+			continue;
+		}
+
+		if (!file) {
+			truncated = true;
+			break;
+		}
+
+		// corrupt block: continue at the next sync marker
+		++num_corrupt;
+		file.clear();
+		file.seekg(block_start + (streamoff)1);
+		uint8_t window[sizeof(ulog_compressed_block_sync)] {};
+		size_t num_read = 0;
+		char c;
+
+		while (file.get(c)) {
+			memmove(window, window + 1, sizeof(window) - 1);
+			window[sizeof(window) - 1] = (uint8_t)c;
+
+			if (++num_read >= sizeof(window) && memcmp(window, ulog_compressed_block_sync, sizeof(window)) == 0) {
+				file.seekg(-(streamoff)sizeof(window), ios::cur);
+				break;
+			}
+		}
+
+		if (!file) {
+			break;
+		}
+	}
+
+	if (truncated) {
+		PX4_WARN("Compressed log is truncated, decoded up to the last complete block");
+	}
+
+	if (num_corrupt > 0) {
+		PX4_WARN("Skipped %i corrupt blocks", num_corrupt);
+	}
+
+	PX4_INFO("Decompressed %i blocks", num_blocks);
+
+	return output_file.good() && num_blocks > 0;
+}
+
 void
 Replay::setUserParams(const char *filename)
 {
@@ -183,16 +325,16 @@ Replay::setUserParams(const char *filename)
 }
 
 bool
-Replay::readFileHeader(std::ifstream &file)
+Replay::readFileHeader()
 {
-	file.seekg(0);
 	ulog_file_header_s msg_header;
-	file.read((char *)&msg_header, sizeof(msg_header));
 
-	if (!file) {
+	if (_file.size() < sizeof(msg_header)) {
 		return false;
 	}
 
+	memcpy(&msg_header, _file.data(), sizeof(msg_header));
+
 	_file_start_time = msg_header.timestamp;
 	//verify it's an ULog file
 	char magic[8];
@@ -207,76 +349,76 @@ Replay::readFileHeader(std::ifstream &file)
 }
 
 bool
-Replay::readFileDefinitions(std::ifstream &file)
+Replay::readFileDefinitions()
 {
-	PX4_INFO("Applying params from ULog file...");
+	if (_apply_params) {
+		PX4_INFO("Applying params from ULog file...");
+	}
 
-	ulog_message_header_s message_header;
-	file.seekg(sizeof(ulog_file_header_s));
+	uint64_t offset = sizeof(ulog_file_header_s);
 
 	while (true) {
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+		const ulog_message_header_s *message_header = _file.message(offset, _file.size());
 
-		if (!file) {
+		if (!message_header) {
 			return false;
 		}
 
-		switch (message_header.msg_type) {
+		const uint8_t *message = (const uint8_t *)message_header + ULOG_MSG_HEADER_LEN;
+
+		switch (message_header->msg_type) {
 		case (int)ULogMessageType::FLAG_BITS:
-			if (!readFlagBits(file, message_header.msg_size)) {
+			if (!readFlagBits(message, message_header->msg_size)) {
 				return false;
 			}
 
 			break;
 
 		case (int)ULogMessageType::FORMAT:
-			if (!readFormat(file, message_header.msg_size)) {
+			if (!readFormat(message, message_header->msg_size)) {
 				return false;
 			}
 
 			break;
 
 		case (int)ULogMessageType::PARAMETER:
-			if (!readAndApplyParameter(file, message_header.msg_size)) {
+			if (_apply_params && !readAndApplyParameter(message, message_header->msg_size)) {
 				return false;
 			}
 
 			break;
 
 		case (int)ULogMessageType::ADD_LOGGED_MSG:
-			_data_section_start = file.tellg() - (streamoff)ULOG_MSG_HEADER_LEN;
+			_data_section_start = offset;
 			return true;
 
 		case (int)ULogMessageType::INFO: //skip
 		case (int)ULogMessageType::INFO_MULTIPLE: //skip
 		case (int)ULogMessageType::PARAMETER_DEFAULT:
-			file.seekg(message_header.msg_size, ios::cur);
 			break;
 
 		default:
 			PX4_ERR("unknown log definition type %i, size %i (offset %i)",
-				(int)message_header.msg_type, (int)message_header.msg_size, (int)file.tellg());
-			file.seekg(message_header.msg_size, ios::cur);
+				(int)message_header->msg_type, (int)message_header->msg_size, (int)offset);
 			break;
 		}
+
+		offset += ULOG_MSG_HEADER_LEN + message_header->msg_size;
 	}
 
 	return true;
 }
 
 bool
-Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
+Replay::readFlagBits(const uint8_t *message, uint16_t msg_size)
 {
 	if (msg_size != 40) {
 		PX4_ERR("unsupported message length for FLAG_BITS message (%i)", msg_size);
 		return false;
 	}
 
-	_read_buffer.reserve(msg_size);
-	uint8_t *message = (uint8_t *)_read_buffer.data();
-	file.read((char *)message, msg_size);
-	//uint8_t *compat_flags = message;
-	uint8_t *incompat_flags = message + 8;
+	//const uint8_t *compat_flags = message;
+	const uint8_t *incompat_flags = message + 8;
 
 	// handle & validate the flags
 	bool contains_appended_data = incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK;
@@ -312,18 +454,10 @@ Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
 }
 
 bool
-Replay::readFormat(std::ifstream &file, uint16_t msg_size)
+Replay::readFormat(const uint8_t *message, uint16_t msg_size)
 {
-	_read_buffer.reserve(msg_size + 1);
-	char *format = (char *)_read_buffer.data();
-	file.read(format, msg_size);
-	format[msg_size] = 0;
-
-	if (!file) {
-		return false;
-	}
-
-	string str_format(format);
+	const char *format = (const char *)message;
+	string str_format(format, strnlen(format, msg_size));
 	size_t pos = str_format.find(':');
 
 	if (pos == string::npos) {
@@ -368,27 +502,21 @@ string Replay::parseOrbFields(const string &fields)
 }
 
 bool
-Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
+Replay::readAndAddSubscription(const uint8_t *message, uint16_t msg_size)
 {
-	_read_buffer.reserve(msg_size + 1);
-	char *message = (char *)_read_buffer.data();
-	streampos this_message_pos = file.tellg() - (streamoff)ULOG_MSG_HEADER_LEN;
-	file.read(message, msg_size);
-	message[msg_size] = 0;
-
-	if (!file) {
+	if (msg_size <= 3) {
 		return false;
 	}
 
-	if (file.tellg() <= _subscription_file_pos) { //already read this subscription
+	uint8_t multi_id = message[0];
+	uint16_t msg_id = ((uint16_t) message[1]) | (((uint16_t) message[2]) << 8);
+	string topic_name((const char *)message + 3, strnlen((const char *)message + 3, msg_size - 3));
+
+	if (msg_id < _subscriptions.size() && _subscriptions[msg_id]) {
+		PX4_ERR("msg_id %i used multiple times, ignoring topic %s", msg_id, topic_name.c_str());
 		return true;
 	}
 
-	_subscription_file_pos = file.tellg();
-
-	uint8_t multi_id = *(uint8_t *)message;
-	uint16_t msg_id = ((uint16_t) message[1]) | (((uint16_t) message[2]) << 8);
-	string topic_name(message + 3);
 	const orb_metadata *orb_meta = findTopic(topic_name);
 
 	if (!orb_meta) {
@@ -483,44 +611,25 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 	bool timestamp_found = findFieldOffset(orb_fields, "timestamp", subscription->timestamp_offset, field_size);
 
 	if (!timestamp_found) {
+		delete compat;
 		delete subscription;
 		return true;
 	}
 
 	if (field_size != 8) {
 		PX4_ERR("Unsupported timestamp with size %i, ignoring the topic %s", field_size, orb_meta->o_name);
+		delete compat;
 		delete subscription;
 		return true;
 	}
 
-	//find first data message (and the timestamp)
-	streampos cur_pos = file.tellg();
-	subscription->next_read_pos = this_message_pos; //this will be skipped
-
-	if (!nextDataMessage(file, *subscription, msg_id)) {
-		delete subscription;
-		return false;
-	}
-
-	file.seekg(cur_pos);
-
-	if (!subscription->orb_meta) {
-		//no message found. This is not a fatal error
-		delete subscription;
-		return true;
-	}
-
-	PX4_DEBUG("adding subscription for %s (msg_id %i)", subscription->orb_meta->o_name, msg_id);
-
-	//add subscription
+	//add subscription, the data messages are added by buildIndex()
 	if (_subscriptions.size() <= msg_id) {
 		_subscriptions.resize(msg_id + 1);
 	}
 
 	_subscriptions[msg_id] = subscription;
 
-	onSubscriptionAdded(*_subscriptions[msg_id], msg_id);
-
 	return true;
 }
 
@@ -555,52 +664,37 @@ Replay::findFieldOffset(const string &format, const string &field_name, int &off
 	return false;
 }
 
-bool
-Replay::readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position)
+void
+Replay::handleAdditionalMessages(uint64_t end_offset)
 {
-	ulog_message_header_s message_header;
+	while (_next_additional_message < _additional_messages.size()
+	       && _additional_messages[_next_additional_message] < end_offset) {
 
-	while (file.tellg() < end_position) {
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+		const uint64_t offset = _additional_messages[_next_additional_message++];
+		const ulog_message_header_s *message_header = _file.message(offset, _file.size());
+		const uint8_t *message = (const uint8_t *)message_header + ULOG_MSG_HEADER_LEN;
 
-		if (!file) {
-			return false;
-		}
-
-		switch (message_header.msg_type) {
+		switch (message_header->msg_type) {
 		case (int)ULogMessageType::PARAMETER:
-			if (!readAndApplyParameter(file, message_header.msg_size)) {
-				return false;
-			}
-
+			readAndApplyParameter(message, message_header->msg_size);
 			break;
 
 		case (int)ULogMessageType::DROPOUT:
-			readDropout(file, message_header.msg_size);
-			break;
-
-		default: //skip all others
-			file.seekg(message_header.msg_size, ios::cur);
+			readDropout(message, message_header->msg_size);
 			break;
 		}
 	}
-
-	return true;
 }
 
 bool
-Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
+Replay::readAndApplyParameter(const uint8_t *message, uint16_t msg_size)
 {
-	_read_buffer.reserve(msg_size);
-	uint8_t *message = (uint8_t *)_read_buffer.data();
-	file.read((char *)message, msg_size);
-
-	if (!file) {
+	if (msg_size < 1 || message[0] + 1 + sizeof(int32_t) > msg_size) {
 		return false;
 	}
 
 	uint8_t key_len = message[0];
-	string key((char *)message + 1, key_len);
+	string key((const char *)message + 1, key_len);
 
 	size_t pos = key.find(' ');
 
@@ -631,99 +725,181 @@ Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
 }
 
 bool
-Replay::readDropout(std::ifstream &file, uint16_t msg_size)
+Replay::readDropout(const uint8_t *message, uint16_t msg_size)
 {
 	uint16_t duration;
-	file.read((char *)&duration, sizeof(duration));
-
-	PX4_ERR("Dropout in replayed log, %i ms", (int)duration);
-	return file.good();
-}
-
-bool
-Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id)
-{
-	ulog_message_header_s message_header;
-	file.seekg(subscription.next_read_pos);
-	//ignore the first message (it's data we already read)
-	file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
 
-	if (file) {
-		file.seekg(message_header.msg_size, ios::cur);
+	if (msg_size < sizeof(duration)) {
+		return false;
 	}
 
-	uint16_t file_msg_id;
-	bool done = false;
+	memcpy(&duration, message, sizeof(duration));
 
-	while (file && !done) {
-		streampos cur_pos = file.tellg();
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	PX4_ERR("Dropout in replayed log, %i ms", (int)duration);
+	return true;
+}
 
-		if (!file) {
-			break;
-		}
+void
+Replay::buildIndex()
+{
+	const uint64_t end = std::min(_file.size(), (uint64_t)_read_until_file_position);
+	uint64_t offset = _data_section_start;
+	uint32_t num_messages = 0;
+	const ulog_message_header_s *message_header;
 
-		if (((streamoff)cur_pos) + ULOG_MSG_HEADER_LEN + message_header.msg_size > _read_until_file_position) {
-			file.setstate(std::ios::eofbit);
-			break;
-		}
+	while ((message_header = _file.message(offset, end)) != nullptr) {
+		const uint8_t *message = (const uint8_t *)message_header + ULOG_MSG_HEADER_LEN;
 
-		switch (message_header.msg_type) {
+		switch (message_header->msg_type) {
 		case (int)ULogMessageType::ADD_LOGGED_MSG:
-			readAndAddSubscription(file, message_header.msg_size);
+			readAndAddSubscription(message, message_header->msg_size);
 			break;
 
 		case (int)ULogMessageType::DATA:
-			file.read((char *)&file_msg_id, sizeof(file_msg_id));
-
-			if (file) {
-				if (msg_id == file_msg_id) {
-					if (message_header.msg_size == subscription.orb_meta->o_size_no_padding + 2) {
-						subscription.next_read_pos = cur_pos;
-						file.seekg(subscription.timestamp_offset, ios::cur);
-						file.read((char *)&subscription.next_timestamp, sizeof(subscription.next_timestamp));
-						done = true;
-
-					} else { //sanity check failed!
-						PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
-							subscription.orb_meta->o_name, message_header.msg_size,
-							subscription.orb_meta->o_size_no_padding + 2);
-						file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
-					}
+			if (message_header->msg_size >= sizeof(uint16_t)) {
+				uint16_t msg_id;
+				memcpy(&msg_id, message, sizeof(msg_id));
+				Subscription *subscription = msg_id < _subscriptions.size() ? _subscriptions[msg_id] : nullptr;
 
-				} else { //not the one we are looking for
-					file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
+				if (!subscription) {
+					break; // topic not replayed
+				}
+
+				if (message_header->msg_size == subscription->orb_meta->o_size_no_padding + 2) {
+					subscription->message_offsets.push_back(offset);
+					++num_messages;
+
+				} else { //sanity check failed!
+					PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
+						subscription->orb_meta->o_name, message_header->msg_size,
+						subscription->orb_meta->o_size_no_padding + 2);
 				}
 			}
 
 			break;
 
-		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
 		case (int)ULogMessageType::PARAMETER:
 		case (int)ULogMessageType::DROPOUT:
+			_additional_messages.push_back(offset);
+			break;
+
+		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
 		case (int)ULogMessageType::INFO:
 		case (int)ULogMessageType::INFO_MULTIPLE:
 		case (int)ULogMessageType::SYNC:
 		case (int)ULogMessageType::LOGGING:
+		case (int)ULogMessageType::LOGGING_TAGGED:
 		case (int)ULogMessageType::PARAMETER_DEFAULT:
-			file.seekg(message_header.msg_size, ios::cur);
 			break;
 
 		default:
 			//this really should not happen
 			PX4_ERR("unknown log message type %i, size %i (offset %i)",
-				(int)message_header.msg_type, (int)message_header.msg_size, (int)file.tellg());
-			file.seekg(message_header.msg_size, ios::cur);
+				(int)message_header->msg_type, (int)message_header->msg_size, (int)offset);
 			break;
 		}
+
+		offset += ULOG_MSG_HEADER_LEN + message_header->msg_size;
 	}
 
-	if (file.eof()) { //no more data messages for this subscription
-		subscription.orb_meta = nullptr;
-		file.clear();
+	int num_topics = 0;
+
+	for (size_t i = 0; i < _subscriptions.size(); ++i) {
+		Subscription *subscription = _subscriptions[i];
+
+		if (!subscription) {
+			continue;
+		}
+
+		if (subscription->message_offsets.empty()) {
+			//no message found. This is not a fatal error
+			delete subscription->compat;
+			delete subscription;
+			_subscriptions[i] = nullptr;
+			continue;
+		}
+
+		subscription->next_message = 0;
+		subscription->next_timestamp = readTimestamp(*subscription, 0);
+		++num_topics;
+
+		PX4_DEBUG("adding subscription for %s (msg_id %i)", subscription->orb_meta->o_name, (int)i);
+
+		onSubscriptionAdded(*subscription, i);
+	}
+
+	PX4_INFO("Indexed %u messages of %i topics", num_messages, num_topics);
+}
+
+uint64_t
+Replay::readTimestamp(const Subscription &sub, size_t message_index) const
+{
+	uint64_t timestamp;
+	memcpy(&timestamp, _file.data() + sub.message_offsets[message_index] + ULOG_MSG_HEADER_LEN + 2 + sub.timestamp_offset,
+	       sizeof(timestamp));
+	return timestamp;
+}
+
+bool
+Replay::nextDataMessage(Subscription &subscription)
+{
+	if (subscription.hasNextMessage()) {
+		++subscription.next_message;
+	}
+
+	if (!subscription.hasNextMessage()) {
+		return false;
+	}
+
+	subscription.next_timestamp = readTimestamp(subscription, subscription.next_message);
+	return true;
+}
+
+void
+Replay::initMessageQueue()
+{
+	_message_queue = MessageQueue();
+
+	for (size_t i = 0; i < _subscriptions.size(); ++i) {
+		const Subscription *subscription = _subscriptions[i];
+
+		if (subscription && !subscription->ignored && subscription->hasNextMessage()) {
+			_message_queue.emplace(subscription->next_timestamp, (uint16_t)i);
+		}
 	}
+}
+
+void
+Replay::seek(uint64_t file_timestamp)
+{
+	for (Subscription *subscription : _subscriptions) {
+		if (!subscription) {
+			continue;
+		}
+
+		// binary search: the messages of a topic are ordered by timestamp
+		size_t low = 0;
+		size_t high = subscription->message_offsets.size();
+
+		while (low < high) {
+			const size_t mid = low + (high - low) / 2;
+
+			if (readTimestamp(*subscription, mid) < file_timestamp) {
+				low = mid + 1;
+
+			} else {
+				high = mid;
+			}
+		}
+
+		subscription->next_message = low;
 
-	return file.good();
+		if (subscription->hasNextMessage()) {
+			subscription->next_timestamp = readTimestamp(*subscription, low);
+		}
+	}
+
+	initMessageQueue();
 }
 
 const orb_metadata *
@@ -799,7 +975,7 @@ Replay::sizeOfFullType(const std::string &type_name_full)
 }
 
 bool
-Replay::readDefinitionsAndApplyParams(std::ifstream &file)
+Replay::readDefinitionsAndApplyParams(bool apply_params)
 {
 	// log reader currently assumes little endian
 	int num = 1;
@@ -809,35 +985,40 @@ Replay::readDefinitionsAndApplyParams(std::ifstream &file)
 		return false;
 	}
 
-	if (!file.is_open()) {
+	if (!_file.open(_replay_file)) {
 		PX4_ERR("Failed to open replay file");
 		return false;
 	}
 
-	if (!readFileHeader(file)) {
+	_apply_params = apply_params;
+
+	if (!readFileHeader()) {
 		PX4_ERR("Failed to read file header. Not a valid ULog file");
 		return false;
 	}
 
 	//initialize the formats and apply the parameters from the log file
-	if (!readFileDefinitions(file)) {
+	if (!readFileDefinitions()) {
 		PX4_ERR("Failed to read ULog definitions section. Broken file?");
 		return false;
 	}
 
-	setUserParams(PARAMS_OVERRIDE_FILE);
+	if (apply_params) {
+		setUserParams(PARAMS_OVERRIDE_FILE);
+	}
+
 	return true;
 }
 
 void
 Replay::run()
 {
-	ifstream replay_file(_replay_file, ios::in | ios::binary);
-
-	if (!readDefinitionsAndApplyParams(replay_file)) {
+	if (!readDefinitionsAndApplyParams()) {
 		return;
 	}
 
+	buildIndex();
+
 	_speed_factor = 1.f;
 	const char *speedup = getenv("PX4_SIM_SPEED_FACTOR");
 
@@ -845,80 +1026,57 @@ Replay::run()
 		_speed_factor = atof(speedup);
 	}
 
-	onEnterMainLoop();
+	const char *start_time = getenv(replay::ENV_START_TIME);
+	const double start_time_s = start_time ? atof(start_time) : 0.;
 
-	_replay_start_time = hrt_absolute_time();
+	if (start_time_s > 0.) {
+		// replay as if the log started at the given time
+		PX4_INFO("Starting replay at %.3lf s", start_time_s);
+		_file_start_time += (uint64_t)(start_time_s * 1.e6);
+		seek(_file_start_time);
 
-	PX4_INFO("Replay in progress...");
+	} else {
+		initMessageQueue();
+	}
 
-	ulog_message_header_s message_header;
-	replay_file.seekg(_data_section_start);
+	onEnterMainLoop();
 
-	//we know the next message must be an ADD_LOGGED_MSG
-	replay_file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	_replay_start_time = hrt_absolute_time();
 
-	if (!readAndAddSubscription(replay_file, message_header.msg_size)) {
-		PX4_ERR("Failed to read subscription");
-		return;
-	}
+	PX4_INFO("Replay in progress...");
 
 	const uint64_t timestamp_offset = getTimestampOffset();
 	uint32_t nr_published_messages = 0;
-	streampos last_additional_message_pos = _data_section_start;
-
-	while (!should_exit() && replay_file) {
 
-		//Find the next message to publish. Messages from different subscriptions don't need
-		//to be in chronological order, so we need to check all subscriptions
-		uint64_t next_file_time = 0;
-		int next_msg_id = -1;
-		bool first_time = true;
+	while (!should_exit() && !_message_queue.empty()) {
 
-		for (size_t i = 0; i < _subscriptions.size(); ++i) {
-			const Subscription *subscription = _subscriptions[i];
-
-			if (!subscription) {
-				continue;
-			}
-
-			if (subscription->orb_meta && !subscription->ignored) {
-				if (first_time || subscription->next_timestamp < next_file_time) {
-					first_time = false;
-					next_msg_id = (int)i;
-					next_file_time = subscription->next_timestamp;
-				}
-			}
-		}
-
-		if (next_msg_id == -1) {
-			break; //no active subscription anymore. We're done.
-		}
+		//The next message to publish is the earliest of all subscriptions. Messages from different
+		//subscriptions don't need to be in chronological order
+		const uint16_t next_msg_id = _message_queue.top().second;
+		_message_queue.pop();
 
 		Subscription &sub = *_subscriptions[next_msg_id];
+		const uint64_t next_file_time = sub.next_timestamp;
 
-		if (next_file_time == 0) {
-			//someone didn't set the timestamp properly. Consider the message invalid
-			nextDataMessage(replay_file, sub, next_msg_id);
-			continue;
-		}
-
-		//handle additional messages between last and next published data
-		replay_file.seekg(last_additional_message_pos);
-		streampos next_additional_message_pos = sub.next_read_pos;
-		readAndHandleAdditionalMessages(replay_file, next_additional_message_pos);
-		last_additional_message_pos = next_additional_message_pos;
+		//if someone didn't set the timestamp properly, consider the message invalid
+		if (next_file_time != 0) {
+			//handle additional messages between last and next published data
+			handleAdditionalMessages(sub.message_offsets[sub.next_message]);
 
-		const uint64_t publish_timestamp = handleTopicDelay(next_file_time, timestamp_offset);
+			const uint64_t publish_timestamp = handleTopicDelay(next_file_time, timestamp_offset);
 
-		// It's time to publish
-		readTopicDataToBuffer(sub, replay_file);
-		memcpy(_read_buffer.data() + sub.timestamp_offset, &publish_timestamp, sizeof(uint64_t)); //adjust the timestamp
+			// It's time to publish
+			readTopicDataToBuffer(sub);
+			memcpy(_read_buffer.data() + sub.timestamp_offset, &publish_timestamp, sizeof(uint64_t)); //adjust the timestamp
 
-		if (handleTopicUpdate(sub, _read_buffer.data(), replay_file)) {
-			++nr_published_messages;
+			if (handleTopicUpdate(sub, _read_buffer.data())) {
+				++nr_published_messages;
+			}
 		}
 
-		nextDataMessage(replay_file, sub, next_msg_id);
+		if (nextDataMessage(sub)) {
+			_message_queue.emplace(sub.next_timestamp, next_msg_id);
+		}
 
 		// TODO: output status (eg. every sec), including total duration...
 	}
@@ -947,7 +1105,7 @@ Replay::run()
 	onExitMainLoop();
 
 	if (!should_exit()) {
-		replay_file.close();
+		_file.close();
 		px4_shutdown_request();
 		// we need to ensure the shutdown logic gets updated and eventually triggers shutdown
 		hrt_abstime t = hrt_absolute_time();
@@ -962,17 +1120,22 @@ Replay::run()
 }
 
 void
-Replay::readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file)
+Replay::readTopicDataToBuffer(const Subscription &sub)
 {
 	const size_t msg_read_size = sub.orb_meta->o_size_no_padding;
 	const size_t msg_write_size = sub.orb_meta->o_size;
-	_read_buffer.reserve(msg_write_size);
-	replay_file.seekg(sub.next_read_pos + (streamoff)(ULOG_MSG_HEADER_LEN + 2)); //skip header & msg id
-	replay_file.read((char *)_read_buffer.data(), msg_read_size);
+
+	if (_read_buffer.size() < msg_write_size) {
+		_read_buffer.resize(msg_write_size);
+	}
+
+	//skip header & msg id
+	memcpy(_read_buffer.data(), _file.data() + sub.message_offsets[sub.next_message] + ULOG_MSG_HEADER_LEN + 2,
+	       msg_read_size);
 }
 
 bool
-Replay::handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file)
+Replay::handleTopicUpdate(Subscription &sub, void *data)
 {
 	return publishTopic(sub, data);
 }
@@ -1067,6 +1230,10 @@ Replay::custom_command(int argc, char *argv[])
 		return Replay::task_spawn(argc, argv);
 	}
 
+	if (!strcmp(argv[0], "bench")) {
+		return Replay::benchmark(argc > 1 && !strcmp(argv[1], "baseline"));
+	}
+
 	return print_usage("unknown command");
 }
 
@@ -1118,9 +1285,7 @@ Replay::applyParams(bool quiet)
 		return -ENOMEM;
 	}
 
-	ifstream replay_file(_replay_file, ios::in | ios::binary);
-
-	if (!r->readDefinitionsAndApplyParams(replay_file)) {
+	if (!r->readDefinitionsAndApplyParams()) {
 		ret = -1;
 	}
 
@@ -1129,6 +1294,228 @@ Replay::applyParams(bool quiet)
 	return ret;
 }
 
+int
+Replay::benchmark(bool baseline)
+{
+	if (!isSetup()) {
+		PX4_ERR("no log file given (via env variable %s)", replay::ENV_FILENAME);
+		return -1;
+	}
+
+	Replay *r = new Replay();
+
+	if (r == nullptr) {
+		PX4_ERR("alloc failed");
+		return -ENOMEM;
+	}
+
+	int ret = r->runBenchmark(baseline);
+
+	delete r;
+
+	return ret;
+}
+
+uint32_t
+Replay::readSequentialBaseline()
+{
+	// the reader used before the index: an ifstream, and each topic searches forward for its next data message
+	struct BaselineTopic {
+		uint16_t msg_id;
+		uint16_t msg_size;
+		int timestamp_offset;
+		std::streamoff next_read_pos;
+		uint64_t next_timestamp;
+		bool active;
+	};
+
+	std::ifstream file(_replay_file, std::ios::in | std::ios::binary);
+	const std::streamoff end = std::min(_file.size(), (uint64_t)_read_until_file_position);
+	std::vector<BaselineTopic> topics;
+	std::vector<uint8_t> buffer;
+	ulog_message_header_s message_header;
+
+	// find the next data message of a topic, starting at (or after, if skip_current) its read position
+	auto next_data_message = [&](BaselineTopic & topic, bool skip_current) {
+		file.clear();
+		file.seekg(topic.next_read_pos);
+
+		if (skip_current && file.read((char *)&message_header, ULOG_MSG_HEADER_LEN)) {
+			file.seekg(message_header.msg_size, std::ios::cur);
+		}
+
+		while (file) {
+			const std::streamoff cur_pos = file.tellg();
+			file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+
+			if (!file || cur_pos + ULOG_MSG_HEADER_LEN + message_header.msg_size > end) {
+				break;
+			}
+
+			if (message_header.msg_type == (int)ULogMessageType::DATA) {
+				uint16_t file_msg_id;
+
+				if (file.read((char *)&file_msg_id, sizeof(file_msg_id)) && file_msg_id == topic.msg_id
+				    && message_header.msg_size == topic.msg_size) {
+					topic.next_read_pos = cur_pos;
+					file.seekg(topic.timestamp_offset, std::ios::cur);
+					file.read((char *)&topic.next_timestamp, sizeof(topic.next_timestamp));
+					return;
+				}
+
+				file.seekg(message_header.msg_size - sizeof(file_msg_id), std::ios::cur);
+
+			} else {
+				file.seekg(message_header.msg_size, std::ios::cur);
+			}
+		}
+
+		topic.active = false;
+	};
+
+	// the topic definitions come from the index, the old reader parsed them while reading
+	for (size_t i = 0; i < _subscriptions.size(); ++i) {
+		if (_subscriptions[i]) {
+			const Subscription &sub = *_subscriptions[i];
+			const uint16_t msg_size = sub.orb_meta->o_size_no_padding + 2;
+			const std::streamoff start = _data_section_start;
+			topics.push_back({(uint16_t)i, msg_size, sub.timestamp_offset, start, 0, true});
+			next_data_message(topics.back(), false);
+		}
+	}
+
+	std::streamoff last_additional_message_pos = _data_section_start;
+	uint32_t num_messages = 0;
+
+	while (true) {
+		BaselineTopic *next = nullptr;
+
+		for (BaselineTopic &topic : topics) {
+			if (topic.active && (!next || topic.next_timestamp < next->next_timestamp)) {
+				next = &topic;
+			}
+		}
+
+		if (!next) {
+			break;
+		}
+
+		// read the parameter and dropout messages up to the next data message, without applying them
+		file.clear();
+		file.seekg(last_additional_message_pos);
+
+		while (file.tellg() < next->next_read_pos && file.read((char *)&message_header, ULOG_MSG_HEADER_LEN)) {
+			if (message_header.msg_type == (int)ULogMessageType::PARAMETER
+			    || message_header.msg_type == (int)ULogMessageType::DROPOUT) {
+				buffer.resize(message_header.msg_size);
+				file.read((char *)buffer.data(), message_header.msg_size);
+
+			} else {
+				file.seekg(message_header.msg_size, std::ios::cur);
+			}
+		}
+
+		last_additional_message_pos = next->next_read_pos;
+
+		buffer.resize(next->msg_size - 2);
+		file.clear();
+		file.seekg(next->next_read_pos + ULOG_MSG_HEADER_LEN + 2);
+		file.read((char *)buffer.data(), buffer.size());
+		++num_messages;
+
+		next_data_message(*next, true);
+	}
+
+	return num_messages;
+}
+
+int
+Replay::runBenchmark(bool baseline)
+{
+	// the lockstep time does not advance while benchmarking, use the system time
+	auto now = []() {
+		struct timespec ts;
+		system_clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts_to_abstime(&ts);
+	};
+
+	hrt_abstime start = now();
+
+	if (!readDefinitionsAndApplyParams(false)) {
+		return -1;
+	}
+
+	buildIndex();
+
+	const hrt_abstime index_time = now() - start;
+
+	// read all messages in replay order, as in run()
+	start = now();
+	initMessageQueue();
+	uint32_t num_messages = 0;
+
+	while (!_message_queue.empty()) {
+		const uint16_t msg_id = _message_queue.top().second;
+		_message_queue.pop();
+
+		Subscription &sub = *_subscriptions[msg_id];
+		readTopicDataToBuffer(sub);
+		++num_messages;
+
+		if (nextDataMessage(sub)) {
+			_message_queue.emplace(sub.next_timestamp, msg_id);
+		}
+	}
+
+	const hrt_abstime heap_time = now() - start;
+
+	// for comparison: find the next message by checking all subscriptions
+	seek(0);
+	start = now();
+
+	while (true) {
+		Subscription *next = nullptr;
+
+		for (Subscription *subscription : _subscriptions) {
+			if (subscription && subscription->hasNextMessage()
+			    && (!next || subscription->next_timestamp < next->next_timestamp)) {
+				next = subscription;
+			}
+		}
+
+		if (!next) {
+			break;
+		}
+
+		readTopicDataToBuffer(*next);
+		nextDataMessage(*next);
+	}
+
+	const hrt_abstime scan_time = now() - start;
+
+	auto rate = [num_messages](hrt_abstime elapsed) {
+		return elapsed > 0 ? num_messages / (elapsed * 1.e-6) : 0.;
+	};
+
+	PX4_INFO("%u messages, %.1lf MB", num_messages, _file.size() / 1.e6);
+	PX4_INFO("index:              %8.3lf s", index_time * 1.e-6);
+	PX4_INFO("merge (min-heap):   %8.3lf s, %10.0lf msgs/s", heap_time * 1.e-6, rate(heap_time));
+	PX4_INFO("merge (topic scan): %8.3lf s, %10.0lf msgs/s", scan_time * 1.e-6, rate(scan_time));
+	PX4_INFO("index + min-heap:   %8.3lf s, %10.0lf msgs/s", (index_time + heap_time) * 1.e-6,
+		 rate(index_time + heap_time));
+
+	if (baseline) {
+		start = now();
+		const uint32_t num_baseline_messages = readSequentialBaseline();
+		const hrt_abstime baseline_time = now() - start;
+
+		PX4_INFO("baseline (ifstream): %7.3lf s, %10.0lf msgs/s%s", baseline_time * 1.e-6, rate(baseline_time),
+			 num_baseline_messages == num_messages ? "" : " (message count differs)");
+	}
+
+	return 0;
+}
+
 Replay *
 Replay::instantiate(int argc, char *argv[])
 {
@@ -1167,6 +1554,8 @@ the log file to be replayed. The second is the mode, specified via `replay_mode`
 - Generic otherwise: this can be used to replay any module(s), but the replay will be done with the same speed as the
   log was recorded.
 
+Optionally, `replay_start` can be set to a time in seconds after the start of the log, from where to start replay.
+
 The module is typically used together with uORB publisher rules, to specify which messages should be replayed.
 The replay module will just publish all messages that are found in the log. It also applies the parameters from
 the log.
@@ -1179,6 +1568,8 @@ page.
 	PRINT_MODULE_USAGE_COMMAND_DESCR("start", "Start replay, using log file from ENV variable 'replay'");
 	PRINT_MODULE_USAGE_COMMAND_DESCR("trystart", "Same as 'start', but silently exit if no log file given");
 	PRINT_MODULE_USAGE_COMMAND_DESCR("tryapplyparams", "Try to apply the parameters from the log file");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("bench", "Index the log file and measure the read rate (messages/s)");
+	PRINT_MODULE_USAGE_ARG("baseline", "Also measure the ifstream reader used before the index (slow)", true);
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 
 	return 0;
@@ -33,13 +33,15 @@
 
 #pragma once
 
-#include <fstream>
+#include <functional>
 #include <map>
+#include <queue>
 #include <vector>
 #include <set>
 #include <string>
 
 #include "definitions.hpp"
+#include "ULogFile.hpp"
 
 #include <px4_platform_common/module.h>
 #include <uORB/topics/uORBTopics.hpp>
@@ -51,8 +53,9 @@ namespace px4
 /**
  * @class Replay
  * Parses an ULog file and replays it in 'real-time'. The timestamp of each replayed message is offset
- * to match the starting time of replay. It keeps a stream for each subscription to find the next message
- * to replay. This is necessary because data messages from different subscriptions don't need to be in
+ * to match the starting time of replay. The file is memory-mapped and indexed once: each subscription
+ * stores the file offsets of all its data messages. The subscriptions are then merged by timestamp with a
+ * min-heap. This is necessary because data messages from different subscriptions don't need to be in
  * monotonic increasing order.
  */
 class Replay : public ModuleBase<Replay>
@@ -84,6 +87,13 @@ public:
 	 */
 	static int applyParams(bool quiet);
 
+	/**
+	 * Index the log file and measure how fast the messages can be read in replay order (without publishing)
+	 * @param baseline also measure the sequential ifstream reader used before the index
+	 * @return 0 on success
+	 */
+	static int benchmark(bool baseline);
+
 	/**
 	 * Tell the replay module that we want to use replay mode.
 	 * After that, only 'replay start' must be executed (typically the last step after startup).
@@ -93,6 +103,13 @@ public:
 
 	static bool isSetup() { return _replay_file; }
 
+	/**
+	 * Decompress a compressed log file (.ulgz, written with SDLOG_COMPRESS) to a regular ULog file.
+	 * Corrupt blocks are skipped, a truncated file is decoded up to the last complete block.
+	 * @return true on success
+	 */
+	static bool decompressLogFile(const char *file_name, const char *output_file_name);
+
 protected:
 
 	/**
@@ -134,8 +151,11 @@ protected:
 
 		bool ignored = false; ///< if true, it will not be considered for publication in the main loop
 
-		std::streampos next_read_pos;
-		uint64_t next_timestamp; ///< timestamp of the file
+		std::vector<uint64_t> message_offsets; ///< file offsets of all data messages (in file order)
+		size_t next_message = 0; ///< index into message_offsets of the next message to publish
+		uint64_t next_timestamp = 0; ///< timestamp of the file
+
+		bool hasNextMessage() const { return next_message < message_offsets.size(); }
 
 		CompatBase *compat = nullptr;
 
@@ -189,22 +209,25 @@ protected:
 	 * handle the publication of a topic update
 	 * @return true if published, false otherwise
 	 */
-	virtual bool handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file);
+	virtual bool handleTopicUpdate(Subscription &sub, void *data);
 
 	/**
-	 * read a topic from the file (offset given by the subscription) into _read_buffer
+	 * read the next message of a subscription from the file into _read_buffer
 	 */
-	void readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file);
+	void readTopicDataToBuffer(const Subscription &sub);
 
 	/**
-	 * Find next data message for this subscription, starting with the stored file offset.
-	 * Skip the first message, and if found, read the timestamp and store the new file offset.
-	 * This also takes care of new subscriptions and parameter updates. When reaching EOF,
-	 * the subscription is set to invalid.
-	 * File seek position is arbitrary after this call.
-	 * @return false on file error
+	 * Advance a subscription to its next data message and read the timestamp.
+	 * @return false if there are no more messages for this subscription
 	 */
-	bool nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id);
+	bool nextDataMessage(Subscription &subscription);
+
+	/**
+	 * Move all subscriptions to their first message with a timestamp >= file_timestamp.
+	 * Parameter changes are applied in file order and are not reverted when seeking backwards.
+	 * @param file_timestamp timestamp of the file
+	 */
+	void seek(uint64_t file_timestamp);
 
 	virtual uint64_t getTimestampOffset()
 	{
@@ -219,50 +242,81 @@ protected:
 	float _speed_factor{1.f}; ///< from PX4_SIM_SPEED_FACTOR env variable (set to 0 to avoid usleep = unlimited rate)
 
 private:
+	/** (timestamp, msg_id) of the next message of each subscription, earliest on top */
+	using MessageQueue = std::priority_queue<std::pair<uint64_t, uint16_t>, std::vector<std::pair<uint64_t, uint16_t>>,
+	      std::greater<std::pair<uint64_t, uint16_t>>>;
+
 	std::set<std::string> _overridden_params;
 	std::map<std::string, std::string> _file_formats; ///< all formats we read from the file
 
+	ULogFile _file;
+
 	uint64_t _file_start_time;
 	uint64_t _replay_start_time;
-	std::streampos _data_section_start; ///< first ADD_LOGGED_MSG message
-
-	/** keep track of file position to avoid adding a subscription multiple times. */
-	std::streampos _subscription_file_pos = 0;
+	uint64_t _data_section_start; ///< first ADD_LOGGED_MSG message
 
 	int64_t _read_until_file_position = 1ULL << 60; ///< read limit if log contains appended data
 
+	std::vector<uint64_t> _additional_messages; ///< file offsets of parameter and dropout messages in the data section
+	size_t _next_additional_message{0};
+
+	MessageQueue _message_queue;
+
+	bool _apply_params{true};
+
 	float _accumulated_delay{0.f};
 
-	bool readFileHeader(std::ifstream &file);
+	bool readFileHeader();
 
 	/**
 	 * Read definitions section: check formats, apply parameters and store
 	 * the start of the data section.
 	 * @return true on success
 	 */
-	bool readFileDefinitions(std::ifstream &file);
+	bool readFileDefinitions();
 
-	///file parsing methods. They return false, when further parsing should be aborted.
-	bool readFormat(std::ifstream &file, uint16_t msg_size);
-	bool readAndAddSubscription(std::ifstream &file, uint16_t msg_size);
-	bool readFlagBits(std::ifstream &file, uint16_t msg_size);
+	///message parsing methods, given the message payload. They return false, when further parsing should be aborted.
+	bool readFormat(const uint8_t *message, uint16_t msg_size);
+	bool readAndAddSubscription(const uint8_t *message, uint16_t msg_size);
+	bool readFlagBits(const uint8_t *message, uint16_t msg_size);
 
 	/**
-	 * Read the file header and definitions sections. Apply the parameters from this section
-	 * and apply user-defined overridden parameters.
+	 * Open the replay file and read the file header and definitions sections. Apply the parameters from this
+	 * section and apply user-defined overridden parameters.
+	 * @param apply_params set to false to only read the file
 	 * @return true on success
 	 */
-	bool readDefinitionsAndApplyParams(std::ifstream &file);
+	bool readDefinitionsAndApplyParams(bool apply_params = true);
 
 	/**
-	 * Read and handle additional messages starting at current file position, while position < end_position.
+	 * Read the data section in one pass: add the subscriptions and store the file offsets of their
+	 * data messages and of the additional messages. Subscriptions without data are removed.
+	 */
+	void buildIndex();
+
+	/** read the timestamp of a data message of a subscription */
+	uint64_t readTimestamp(const Subscription &sub, size_t message_index) const;
+
+	/** (re)initialize the message queue with the next message of all subscriptions that are not ignored */
+	void initMessageQueue();
+
+	/**
+	 * Handle additional messages located before end_offset that have not been handled yet.
 	 * This handles dropout and parameter update messages.
 	 * We need to handle these separately, because they have no timestamp. We look at the file position instead.
-	 * @return false on file error
 	 */
-	bool readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position);
-	bool readDropout(std::ifstream &file, uint16_t msg_size);
-	bool readAndApplyParameter(std::ifstream &file, uint16_t msg_size);
+	void handleAdditionalMessages(uint64_t end_offset);
+	bool readDropout(const uint8_t *message, uint16_t msg_size);
+	bool readAndApplyParameter(const uint8_t *message, uint16_t msg_size);
+
+	int runBenchmark(bool baseline);
+
+	/**
+	 * Read all messages in replay order like the reader before the index (ifstream, forward search per topic),
+	 * used as the benchmark baseline. Needs buildIndex() for the topic definitions.
+	 * @return number of data messages read
+	 */
+	uint32_t readSequentialBaseline();
 
 	static const orb_metadata *findTopic(const std::string &name);
 
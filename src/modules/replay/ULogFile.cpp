@@ -0,0 +1,126 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "ULogFile.hpp"
+
+#include <px4_platform_common/log.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace px4
+{
+
+ULogFile::~ULogFile()
+{
+	close();
+}
+
+bool
+ULogFile::open(const char *file_name)
+{
+	close();
+
+	int fd = ::open(file_name, O_RDONLY);
+
+	if (fd < 0) {
+		PX4_ERR("Failed to open %s (%i)", file_name, errno);
+		return false;
+	}
+
+	struct stat st;
+
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		::close(fd);
+		return false;
+	}
+
+	_size = st.st_size;
+	void *data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	if (data != MAP_FAILED) {
+		_data = (uint8_t *)data;
+		_mapped = true;
+
+	} else {
+		// not all file systems support mmap: read the whole file
+		_data = (uint8_t *)malloc(_size);
+		uint64_t num_read = 0;
+
+		while (_data && num_read < _size) {
+			const ssize_t ret = ::read(fd, _data + num_read, _size - num_read);
+
+			if (ret <= 0) {
+				free(_data);
+				_data = nullptr;
+
+			} else {
+				num_read += ret;
+			}
+		}
+	}
+
+	::close(fd);
+
+	if (!_data) {
+		PX4_ERR("Failed to read %s", file_name);
+		_size = 0;
+		return false;
+	}
+
+	return true;
+}
+
+void
+ULogFile::close()
+{
+	if (_data) {
+		if (_mapped) {
+			munmap(_data, _size);
+
+		} else {
+			free(_data);
+		}
+	}
+
+	_data = nullptr;
+	_size = 0;
+	_mapped = false;
+}
+
+} //namespace px4
@@ -0,0 +1,98 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include <logger/messages.h>
+
+namespace px4
+{
+
+/**
+ * @class ULogFile
+ * Read-only access to an ULog file. The file is memory-mapped, so that messages can be accessed
+ * in any order without seeking. If mapping fails, the file is read into memory instead.
+ */
+class ULogFile
+{
+public:
+	ULogFile() = default;
+	~ULogFile();
+
+	ULogFile(const ULogFile &) = delete;
+	ULogFile &operator=(const ULogFile &) = delete;
+
+	/**
+	 * Open and map a file. An already opened file is closed first.
+	 * @return true on success
+	 */
+	bool open(const char *file_name);
+
+	void close();
+
+	bool isOpen() const { return _data != nullptr; }
+
+	const uint8_t *data() const { return _data; }
+	uint64_t size() const { return _size; }
+
+	/**
+	 * Get the message at a file offset
+	 * @param offset file offset of the message header
+	 * @param end the message (including its payload) must end before this offset
+	 * @return message header, followed by the payload, or nullptr if the message exceeds end
+	 */
+	const ulog_message_header_s *message(uint64_t offset, uint64_t end) const
+	{
+		if (offset + ULOG_MSG_HEADER_LEN > end) {
+			return nullptr;
+		}
+
+		const ulog_message_header_s *header = (const ulog_message_header_s *)(_data + offset);
+
+		if (offset + ULOG_MSG_HEADER_LEN + header->msg_size > end) {
+			return nullptr;
+		}
+
+		return header;
+	}
+
+private:
+	uint8_t *_data{nullptr};
+	uint64_t _size{0};
+	bool _mapped{false}; ///< true if _data is mapped, false if it is allocated
+};
+
+} //namespace px4
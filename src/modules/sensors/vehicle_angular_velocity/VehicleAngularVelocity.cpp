@@ -166,12 +166,14 @@ void VehicleAngularVelocity::ResetFilters()
 		for (int axis = 0; axis < 3; axis++) {
 			// angular velocity low pass
 			_lp_filter_velocity[axis].set_cutoff_frequency(_filter_sample_rate_hz, _param_imu_gyro_cutoff.get());
-			_lp_filter_velocity[axis].reset(angular_velocity_uncalibrated(axis));
+			_filter_bank.setFilter(FILTER_STAGE_LOW_PASS, axis, _lp_filter_velocity[axis]);
+			_filter_bank.reset(FILTER_STAGE_LOW_PASS, axis, angular_velocity_uncalibrated(axis));
 
 			// angular velocity notch
 			_notch_filter_velocity[axis].setParameters(_filter_sample_rate_hz, _param_imu_gyro_nf_freq.get(),
 					_param_imu_gyro_nf_bw.get());
-			_notch_filter_velocity[axis].reset(angular_velocity_uncalibrated(axis));
+			_filter_bank.setFilter(FILTER_STAGE_NOTCH, axis, _notch_filter_velocity[axis]);
+			_filter_bank.reset(FILTER_STAGE_NOTCH, axis, angular_velocity_uncalibrated(axis));
 
 			// angular acceleration low pass
 			if ((_param_imu_dgyro_cutoff.get() > 0.f)
@@ -461,6 +463,7 @@ void VehicleAngularVelocity::DisableDynamicNotchEscRpm()
 			for (int esc = 0; esc < MAX_NUM_ESC_RPM; esc++) {
 				for (int harmonic = 0; harmonic < MAX_NUM_ESC_RPM_HARMONICS; harmonic++) {
 					_dynamic_notch_filter_esc_rpm[axis][esc][harmonic].setParameters(0, 0, 0);
+					_filter_bank.disable(FilterStageEscRpm(esc, harmonic), axis);
 				}
 
 				_esc_available.set(esc, false);
@@ -482,6 +485,7 @@ void VehicleAngularVelocity::DisableDynamicNotchFFT()
 		for (int axis = 0; axis < 3; axis++) {
 			for (int peak = 0; peak < MAX_NUM_FFT_PEAKS; peak++) {
 				_dynamic_notch_filter_fft[axis][peak].setParameters(0, 0, 0);
+				_filter_bank.disable(FilterStageFFT(peak), axis);
 			}
 		}
 
@@ -537,10 +541,12 @@ void VehicleAngularVelocity::UpdateDynamicNotchEscRpm(bool force)
 
 						for (int harmonic = 0; harmonic < MAX_NUM_ESC_RPM_HARMONICS; harmonic++) {
 							const float frequency_hz = esc_hz * (harmonic + 1);
+							const int stage = FilterStageEscRpm(esc, harmonic);
 
 							for (int axis = 0; axis < 3; axis++) {
 								_dynamic_notch_filter_esc_rpm[axis][esc][harmonic].setParameters(_filter_sample_rate_hz, frequency_hz,
 										_param_imu_gyro_dnf_bw.get());
+								_filter_bank.setFilter(stage, axis, _dynamic_notch_filter_esc_rpm[axis][esc][harmonic]);
 							}
 						}
 
@@ -552,7 +558,8 @@ void VehicleAngularVelocity::UpdateDynamicNotchEscRpm(bool force)
 
 						for (int axis = 0; axis < 3; axis++) {
 							for (int harmonic = 0; harmonic < MAX_NUM_ESC_RPM_HARMONICS; harmonic++) {
-								_dynamic_notch_filter_esc_rpm[axis][esc][harmonic].reset(reset_angular_velocity(axis));
+								_filter_bank.reset(FilterStageEscRpm(esc, harmonic), axis,
+										   reset_angular_velocity(axis));
 							}
 						}
 
@@ -573,6 +580,7 @@ void VehicleAngularVelocity::UpdateDynamicNotchEscRpm(bool force)
 					for (int axis = 0; axis < 3; axis++) {
 						for (int harmonic = 0; harmonic < MAX_NUM_ESC_RPM_HARMONICS; harmonic++) {
 							_dynamic_notch_filter_esc_rpm[axis][esc][harmonic].setParameters(0, 0, 0);
+							_filter_bank.disable(FilterStageEscRpm(esc, harmonic), axis);
 						}
 					}
 				}
@@ -628,13 +636,15 @@ void VehicleAngularVelocity::UpdateDynamicNotchFFT(bool force)
 						// update filter parameters if frequency changed or forced
 						if (force || reset || (notch_freq_diff > 0.1f)) {
 							nf.setParameters(_filter_sample_rate_hz, peak_freq, bandwidth);
+							_filter_bank.setFilter(FilterStageFFT(peak), axis, nf);
 							perf_count(_dynamic_notch_filter_fft_update_perf);
 						}
 
 						// force reset if the notch frequency jumps significantly
 						if (force || reset || (notch_freq_diff > bandwidth)) {
 							const Vector3f reset_angular_velocity{GetResetAngularVelocity()};
-							nf.reset(reset_angular_velocity(axis));
+							_filter_bank.reset(FilterStageFFT(peak), axis,
+									   reset_angular_velocity(axis));
 							perf_count(_dynamic_notch_filter_fft_reset_perf);
 						}
 
@@ -644,6 +654,7 @@ void VehicleAngularVelocity::UpdateDynamicNotchFFT(bool force)
 						// disable this notch filter (if it isn't already)
 						if (force || !reset) {
 							nf.setParameters(0, 0, 0);
+							_filter_bank.disable(FilterStageFFT(peak), axis);
 							perf_count(_dynamic_notch_filter_fft_disable_perf);
 						}
 					}
@@ -658,55 +669,25 @@ void VehicleAngularVelocity::UpdateDynamicNotchFFT(bool force)
 #endif // !CONSTRAINED_FLASH
 }
 
-float VehicleAngularVelocity::FilterAngularVelocity(int axis, float data[], int N)
+Vector3f VehicleAngularVelocity::FilterAngularVelocity(FilterSample data[], int N)
 {
-#if !defined(CONSTRAINED_FLASH)
-
-	// Apply dynamic notch filter from ESC RPM
-	if (_dynamic_notch_esc_rpm_available) {
-
-		for (int esc = 0; esc < MAX_NUM_ESC_RPM; esc++) {
-			if (_esc_available[esc]) {
-				// apply notch filters higher -> lowest frequency
-				for (int harmonic = MAX_NUM_ESC_RPM_HARMONICS - 1; harmonic >= 0; harmonic--) {
-					_dynamic_notch_filter_esc_rpm[axis][esc][harmonic].applyArray(data, N);
-				}
-			}
-		}
-	}
-
-	// Apply dynamic notch filter from FFT
-	if (_dynamic_notch_fft_available) {
-		for (int peak = MAX_NUM_FFT_PEAKS - 1; peak >= 0; peak--) {
-			if (_dynamic_notch_filter_fft[axis][peak].getNotchFreq() > 0.f) {
-				_dynamic_notch_filter_fft[axis][peak].applyArray(data, N);
-			}
-		}
-	}
-
-#endif // !CONSTRAINED_FLASH
-
-	// Apply general notch filter (IMU_GYRO_NF_FREQ)
-	if (_notch_filter_velocity[axis].getNotchFreq() > 0.f) {
-		_notch_filter_velocity[axis].applyArray(data, N);
-	}
-
-	// Apply general low-pass filter (IMU_GYRO_CUTOFF)
-	_lp_filter_velocity[axis].applyArray(data, N);
+	// Apply dynamic notch filters (ESC RPM, FFT), general notch filter (IMU_GYRO_NF_FREQ)
+	//  and general low-pass filter (IMU_GYRO_CUTOFF) to all axes
+	_filter_bank.apply(data, N);
 
 	// return last filtered sample
-	return data[N - 1];
+	return Vector3f{data[N - 1][0], data[N - 1][1], data[N - 1][2]};
 }
 
-float VehicleAngularVelocity::FilterAngularAcceleration(int axis, float inverse_dt_s, float data[], int N)
+float VehicleAngularVelocity::FilterAngularAcceleration(int axis, float inverse_dt_s, const FilterSample data[], int N)
 {
 	// angular acceleration: Differentiate & apply specific angular acceleration (D-term) low-pass (IMU_DGYRO_CUTOFF)
 	float angular_acceleration_filtered = 0.f;
 
 	for (int n = 0; n < N; n++) {
-		const float angular_acceleration = (data[n] - _angular_velocity_raw_prev(axis)) * inverse_dt_s;
+		const float angular_acceleration = (data[n][axis] - _angular_velocity_raw_prev(axis)) * inverse_dt_s;
 		angular_acceleration_filtered = _lp_filter_acceleration[axis].update(angular_acceleration);
-		_angular_velocity_raw_prev(axis) = data[n];
+		_angular_velocity_raw_prev(axis) = data[n][axis];
 	}
 
 	return angular_acceleration_filtered;
@@ -756,21 +737,21 @@ void VehicleAngularVelocity::Run()
 			static constexpr int FIFO_SIZE_MAX = sizeof(sensor_fifo_data.x) / sizeof(sensor_fifo_data.x[0]);
 
 			if ((sensor_fifo_data.dt > 0) && (N > 0) && (N <= FIFO_SIZE_MAX)) {
-				Vector3f angular_velocity_uncalibrated;
-				Vector3f angular_acceleration_uncalibrated;
+				// copy raw int16 sensor samples to float array for filtering
+				FilterSample data[FIFO_SIZE_MAX];
+
+				for (int n = 0; n < N; n++) {
+					data[n][0] = sensor_fifo_data.scale * sensor_fifo_data.x[n];
+					data[n][1] = sensor_fifo_data.scale * sensor_fifo_data.y[n];
+					data[n][2] = sensor_fifo_data.scale * sensor_fifo_data.z[n];
+					data[n][3] = 0.f;
+				}
 
-				int16_t *raw_data_array[] {sensor_fifo_data.x, sensor_fifo_data.y, sensor_fifo_data.z};
+				// save last filtered sample
+				const Vector3f angular_velocity_uncalibrated{FilterAngularVelocity(data, N)};
+				Vector3f angular_acceleration_uncalibrated;
 
 				for (int axis = 0; axis < 3; axis++) {
-					// copy raw int16 sensor samples to float array for filtering
-					float data[FIFO_SIZE_MAX];
-
-					for (int n = 0; n < N; n++) {
-						data[n] = sensor_fifo_data.scale * raw_data_array[axis][n];
-					}
-
-					// save last filtered sample
-					angular_velocity_uncalibrated(axis) = FilterAngularVelocity(axis, data, N);
 					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data, N);
 				}
 
@@ -801,17 +782,14 @@ void VehicleAngularVelocity::Run()
 							   0.00002f, 0.02f);
 				_timestamp_sample_last = sensor_data.timestamp_sample;
 
-				Vector3f angular_velocity_uncalibrated;
-				Vector3f angular_acceleration_uncalibrated;
+				// copy sensor sample to float array for filtering
+				FilterSample data[1] {{sensor_data.x, sensor_data.y, sensor_data.z, 0.f}};
 
-				float raw_data_array[] {sensor_data.x, sensor_data.y, sensor_data.z};
+				// save last filtered sample
+				const Vector3f angular_velocity_uncalibrated{FilterAngularVelocity(data)};
+				Vector3f angular_acceleration_uncalibrated;
 
 				for (int axis = 0; axis < 3; axis++) {
-					// copy sensor sample to float array for filtering
-					float data[1] {raw_data_array[axis]};
-
-					// save last filtered sample
-					angular_velocity_uncalibrated(axis) = FilterAngularVelocity(axis, data);
 					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data);
 				}
 
@@ -38,6 +38,7 @@
 #include <lib/mathlib/math/Limits.hpp>
 #include <lib/matrix/matrix/math.hpp>
 #include <lib/mathlib/math/filter/AlphaFilter.hpp>
+#include <lib/mathlib/math/filter/BiquadFilterBank.hpp>
 #include <lib/mathlib/math/filter/LowPassFilter2p.hpp>
 #include <lib/mathlib/math/filter/NotchFilter.hpp>
 #include <px4_platform_common/log.h>
@@ -79,8 +80,11 @@ private:
 	bool CalibrateAndPublish(const hrt_abstime &timestamp_sample, const matrix::Vector3f &angular_velocity_uncalibrated,
 				 const matrix::Vector3f &angular_acceleration_uncalibrated);
 
-	inline float FilterAngularVelocity(int axis, float data[], int N = 1);
-	inline float FilterAngularAcceleration(int axis, float inverse_dt_s, float data[], int N = 1);
+	// one sample of all axes for the filter bank (x, y, z, unused)
+	typedef float FilterSample[4];
+
+	inline matrix::Vector3f FilterAngularVelocity(FilterSample data[], int N = 1);
+	inline float FilterAngularAcceleration(int axis, float inverse_dt_s, const FilterSample data[], int N = 1);
 
 	void DisableDynamicNotchEscRpm();
 	void DisableDynamicNotchFFT();
@@ -130,7 +134,7 @@ private:
 
 	float _filter_sample_rate_hz{NAN};
 
-	// angular velocity filters
+	// angular velocity filter parameters, the filtering itself is done by _filter_bank
 	math::LowPassFilter2p<float> _lp_filter_velocity[3] {};
 	math::NotchFilter<float> _notch_filter_velocity[3] {};
 
@@ -152,6 +156,19 @@ private:
 	math::NotchFilter<float> _dynamic_notch_filter_esc_rpm[3][MAX_NUM_ESC_RPM][MAX_NUM_ESC_RPM_HARMONICS] {};
 	math::NotchFilter<float> _dynamic_notch_filter_fft[3][MAX_NUM_FFT_PEAKS] {};
 
+	static constexpr int FILTER_STAGE_ESC_RPM = 0;
+	static constexpr int FILTER_STAGE_FFT = FILTER_STAGE_ESC_RPM + MAX_NUM_ESC_RPM * MAX_NUM_ESC_RPM_HARMONICS;
+	static constexpr int FILTER_STAGE_NOTCH = FILTER_STAGE_FFT + MAX_NUM_FFT_PEAKS;
+
+	// notches are applied higher -> lowest frequency
+	static constexpr int FilterStageEscRpm(int esc, int harmonic)
+	{
+		return FILTER_STAGE_ESC_RPM + (esc * MAX_NUM_ESC_RPM_HARMONICS)
+		       + (MAX_NUM_ESC_RPM_HARMONICS - 1 - harmonic);
+	}
+
+	static constexpr int FilterStageFFT(int peak) { return FILTER_STAGE_FFT + (MAX_NUM_FFT_PEAKS - 1 - peak); }
+
 	px4::Bitset<MAX_NUM_ESC_RPM> _esc_available{};
 	hrt_abstime _last_esc_rpm_notch_update[MAX_NUM_ESC_RPM] {};
 
@@ -165,8 +182,16 @@ private:
 
 	bool _dynamic_notch_esc_rpm_available{false};
 	bool _dynamic_notch_fft_available{false};
+#else
+	static constexpr int FILTER_STAGE_NOTCH = 0;
 #endif // !CONSTRAINED_FLASH
 
+	static constexpr int FILTER_STAGE_LOW_PASS = FILTER_STAGE_NOTCH + 1;
+
+	// all angular velocity filters applied to all axes at once, in order of the stages:
+	//  dynamic notches (ESC RPM, FFT), notch (IMU_GYRO_NF_FREQ), low-pass (IMU_GYRO_CUTOFF)
+	math::BiquadFilterBank<FILTER_STAGE_LOW_PASS + 1> _filter_bank{};
+
 	// angular acceleration filter
 	AlphaFilter<float> _lp_filter_acceleration[3] {};
 
@@ -42,9 +42,13 @@
 __BEGIN_DECLS
 
 extern int test_microbench_atomic(int argc, char *argv[]);
+extern int test_microbench_dataman(int argc, char *argv[]);
+extern int test_microbench_filter(int argc, char *argv[]);
+extern int test_microbench_flight_test_input(int argc, char *argv[]);
 extern int test_microbench_hrt(int argc, char *argv[]);
 extern int test_microbench_math(int argc, char *argv[]);
 extern int test_microbench_matrix(int argc, char *argv[]);
+extern int test_microbench_param(int argc, char *argv[]);
 extern int test_microbench_uorb(int argc, char *argv[]);
 
 __END_DECLS
@@ -64,9 +68,13 @@ const struct {
 	{"all",		microbench_all,		OPT_NOALLTEST},
 
 	{"microbench_atomic",	test_microbench_atomic,	0},
+	{"microbench_dataman",	test_microbench_dataman,	0},
+	{"microbench_filter",	test_microbench_filter,	0},
+	{"microbench_flight_test_input",	test_microbench_flight_test_input,	0},
 	{"microbench_hrt",	test_microbench_hrt,	0},
 	{"microbench_math",	test_microbench_math,	0},
 	{"microbench_matrix",	test_microbench_matrix,	0},
+	{"microbench_param",	test_microbench_param,	0},
 	{"microbench_uorb",	test_microbench_uorb,	0},
 
 	{nullptr,			nullptr, 		0}
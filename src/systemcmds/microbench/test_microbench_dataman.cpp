@@ -0,0 +1,166 @@
+/****************************************************************************
+ *
+ *  Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file test_microbench_dataman.cpp
+ * Tests for the cost of dataman accesses (mission upload and random dm_read) with the running dataman backend.
+ */
+
+#include <unit_test.h>
+
+#include <stdlib.h>
+
+#include <drivers/drv_hrt.h>
+#include <perf/perf_counter.h>
+#include <px4_platform_common/px4_config.h>
+#include <dataman/dataman.h>
+
+namespace MicroBenchDataman
+{
+
+// dataman accesses block on IO, so unlike the other microbenchmarks this is not run in a critical section
+#define PERF(name, op, count) do { \
+		px4_usleep(1000); \
+		perf_counter_t p = perf_alloc(PC_ELAPSED, name); \
+		for (int i = 0; i < count; i++) { \
+			px4_usleep(1); \
+			perf_begin(p); \
+			op; \
+			perf_end(p); \
+		} \
+		perf_print_counter(p); \
+		perf_free(p); \
+	} while (0)
+
+class MicroBenchDataman : public UnitTest
+{
+public:
+	virtual bool run_tests();
+
+private:
+	bool time_mission_upload();
+	bool time_dm_read();
+
+	// write a mission into the offboard storage that is not in use, then commit it like MavlinkMissionManager
+	bool upload_mission();
+
+	// read a random item of the uploaded mission
+	void read_random_item();
+
+	static constexpr unsigned MISSION_SIZE = (DM_KEY_WAYPOINTS_OFFBOARD_0_MAX < 2000) ? DM_KEY_WAYPOINTS_OFFBOARD_0_MAX : 2000;
+
+	dm_item_t _dm_item{DM_KEY_WAYPOINTS_OFFBOARD_1};
+	mission_s _mission{};
+	mission_item_s _mission_item{};
+};
+
+bool MicroBenchDataman::run_tests()
+{
+	// the active mission is left untouched: only the other offboard storage is written and the current mission
+	// state is rewritten unchanged
+	if (dm_read(DM_KEY_MISSION_STATE, 0, &_mission, sizeof(mission_s)) < 0) {
+		PX4_ERR("dataman not running");
+		return false;
+	}
+
+	_dm_item = (_mission.dataman_id == DM_KEY_WAYPOINTS_OFFBOARD_0) ? DM_KEY_WAYPOINTS_OFFBOARD_1 :
+		   DM_KEY_WAYPOINTS_OFFBOARD_0;
+
+	ut_run_test(time_mission_upload);
+	ut_run_test(time_dm_read);
+
+	return (_tests_failed == 0);
+}
+
+ut_declare_test_c(test_microbench_dataman, MicroBenchDataman)
+
+bool MicroBenchDataman::upload_mission()
+{
+	bool success = true;
+
+	for (unsigned i = 0; i < MISSION_SIZE; i++) {
+		_mission_item.lat = 47.397742 + i * 1e-5;
+		_mission_item.lon = 8.545594;
+		_mission_item.altitude = 10.f;
+
+		success &= dm_write(_dm_item, i, &_mission_item, sizeof(mission_item_s)) == sizeof(mission_item_s);
+	}
+
+	// commit: rewrite the current mission state unchanged, it's re-read under the lock as it may have changed
+	// since run_tests()
+	int dm_lock_ret = dm_lock(DM_KEY_MISSION_STATE);
+	mission_s mission{};
+
+	if (dm_read(DM_KEY_MISSION_STATE, 0, &mission, sizeof(mission_s)) != sizeof(mission_s)) {
+		success = false;
+
+	} else if (mission.dataman_id == _dm_item) {
+		PX4_ERR("mission storage in use");
+		success = false;
+
+	} else {
+		success &= dm_write(DM_KEY_MISSION_STATE, 0, &mission, sizeof(mission_s)) == sizeof(mission_s);
+	}
+
+	if (dm_lock_ret == 0) {
+		dm_unlock(DM_KEY_MISSION_STATE);
+	}
+
+	return success;
+}
+
+void MicroBenchDataman::read_random_item()
+{
+	dm_read(_dm_item, rand() % MISSION_SIZE, &_mission_item, sizeof(mission_item_s));
+}
+
+bool MicroBenchDataman::time_mission_upload()
+{
+	bool success = true;
+
+	printf("%u mission items\n", MISSION_SIZE);
+	PERF("mission upload", success &= upload_mission(), 5);
+
+	return success;
+}
+
+bool MicroBenchDataman::time_dm_read()
+{
+	PERF("dm_read mission state", dm_read(DM_KEY_MISSION_STATE, 0, &_mission, sizeof(mission_s)), 1000);
+	PERF("dm_read random mission item", read_random_item(), 1000);
+
+	return true;
+}
+
+} // namespace MicroBenchDataman
@@ -0,0 +1,292 @@
+/****************************************************************************
+ *
+ *  Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file test_microbench_filter.cpp
+ * Microbenchmark of the gyro filter cascade, scalar filters per axis vs the biquad filter bank.
+ */
+
+#include <unit_test.h>
+
+#include <time.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <drivers/drv_hrt.h>
+#include <perf/perf_counter.h>
+#include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/micro_hal.h>
+
+#include <lib/mathlib/math/filter/BiquadFilterBank.hpp>
+#include <lib/mathlib/math/filter/LowPassFilter2p.hpp>
+#include <lib/mathlib/math/filter/NotchFilter.hpp>
+
+namespace MicroBenchFilter
+{
+
+#ifdef __PX4_NUTTX
+#include <nuttx/irq.h>
+static irqstate_t flags;
+#endif
+
+void lock()
+{
+#ifdef __PX4_NUTTX
+	flags = px4_enter_critical_section();
+#endif
+}
+
+void unlock()
+{
+#ifdef __PX4_NUTTX
+	px4_leave_critical_section(flags);
+#endif
+}
+
+// same as the other microbenchmarks, but also prints the mean time per sample of all axes
+#define PERF(name, op, count, samples) do { \
+		reset(); \
+		perf_counter_t p = perf_alloc(PC_ELAPSED, name); \
+		for (int rep = 0; rep < 10; rep++) { \
+			px4_usleep(1000); \
+			lock(); \
+			perf_begin(p); \
+			for (int i = 0; i < (count)/10; i++) { \
+				op; \
+				op; \
+				op; \
+				op; \
+				op; \
+				op; \
+				op; \
+				op; \
+				op; \
+				op; \
+			} \
+			perf_end(p); \
+			unlock(); \
+			reset(); \
+		} \
+		perf_print_counter(p); \
+		printf("%s: %.1f ns/sample\n", name, (double)(perf_mean(p) * 1e9f / ((count) * (samples)))); \
+		perf_free(p); \
+	} while (0)
+
+static constexpr float SAMPLE_RATE_HZ = 8000.f;
+static constexpr int FIFO_SIZE = 32;
+
+static constexpr int NUM_ESC = 4;
+static constexpr int NUM_ESC_HARMONICS = 3;
+static constexpr int NUM_FFT_PEAKS = 3;
+
+// ESC RPM notches, FFT notches, notch, low-pass
+static constexpr int NUM_STAGES = NUM_ESC * NUM_ESC_HARMONICS + NUM_FFT_PEAKS + 2;
+
+class MicroBenchFilter : public UnitTest
+{
+public:
+	virtual bool run_tests();
+
+private:
+	bool time_filter_notch_low_pass();
+	bool time_filter_dynamic_notch();
+
+	void reset();
+	void configure(bool dynamic_notch);
+
+	// the filter cascade of VehicleAngularVelocity, one axis at a time
+	void filterScalar(int N);
+
+	// the same cascade on all axes at once
+	void filterBank(int N);
+
+	math::NotchFilter<float> _esc_rpm_notch[3][NUM_ESC][NUM_ESC_HARMONICS];
+	math::NotchFilter<float> _fft_notch[3][NUM_FFT_PEAKS];
+	math::NotchFilter<float> _notch[3];
+	math::LowPassFilter2p<float> _low_pass[3];
+
+	math::BiquadFilterBank<NUM_STAGES> _bank;
+
+	bool _dynamic_notch{false};
+
+	int16_t _raw[3][FIFO_SIZE];
+	float _scale{1.f / 32.8f};
+
+	float _out[3];
+};
+
+bool MicroBenchFilter::run_tests()
+{
+	ut_run_test(time_filter_notch_low_pass);
+	ut_run_test(time_filter_dynamic_notch);
+
+	return (_tests_failed == 0);
+}
+
+void MicroBenchFilter::reset()
+{
+	srand(time(nullptr));
+
+	// initialize with random data
+	for (int axis = 0; axis < 3; axis++) {
+		for (int n = 0; n < FIFO_SIZE; n++) {
+			_raw[axis][n] = (rand() % 2000) - 1000;
+		}
+	}
+}
+
+void MicroBenchFilter::configure(bool dynamic_notch)
+{
+	_dynamic_notch = dynamic_notch;
+
+	for (int axis = 0; axis < 3; axis++) {
+		for (int esc = 0; esc < NUM_ESC; esc++) {
+			for (int harmonic = 0; harmonic < NUM_ESC_HARMONICS; harmonic++) {
+				auto &nf = _esc_rpm_notch[axis][esc][harmonic];
+				const int stage = esc * NUM_ESC_HARMONICS + (NUM_ESC_HARMONICS - 1 - harmonic);
+
+				if (dynamic_notch) {
+					nf.setParameters(SAMPLE_RATE_HZ, (150.f + 10.f * esc) * (harmonic + 1), 15.f);
+					_bank.setFilter(stage, axis, nf);
+
+				} else {
+					nf.setParameters(0.f, 0.f, 0.f);
+					_bank.disable(stage, axis);
+				}
+			}
+		}
+
+		for (int peak = 0; peak < NUM_FFT_PEAKS; peak++) {
+			auto &nf = _fft_notch[axis][peak];
+			const int stage = NUM_ESC * NUM_ESC_HARMONICS + (NUM_FFT_PEAKS - 1 - peak);
+
+			if (dynamic_notch) {
+				nf.setParameters(SAMPLE_RATE_HZ, 120.f + 80.f * peak + 5.f * axis, 10.f);
+				_bank.setFilter(stage, axis, nf);
+
+			} else {
+				nf.setParameters(0.f, 0.f, 0.f);
+				_bank.disable(stage, axis);
+			}
+		}
+
+		_notch[axis].setParameters(SAMPLE_RATE_HZ, 250.f, 20.f);
+		_bank.setFilter(NUM_STAGES - 2, axis, _notch[axis]);
+
+		_low_pass[axis].set_cutoff_frequency(SAMPLE_RATE_HZ, 80.f);
+		_bank.setFilter(NUM_STAGES - 1, axis, _low_pass[axis]);
+	}
+}
+
+void MicroBenchFilter::filterScalar(int N)
+{
+	for (int axis = 0; axis < 3; axis++) {
+		float data[FIFO_SIZE];
+
+		for (int n = 0; n < N; n++) {
+			data[n] = _scale * _raw[axis][n];
+		}
+
+		if (_dynamic_notch) {
+			for (int esc = 0; esc < NUM_ESC; esc++) {
+				for (int harmonic = NUM_ESC_HARMONICS - 1; harmonic >= 0; harmonic--) {
+					_esc_rpm_notch[axis][esc][harmonic].applyArray(data, N);
+				}
+			}
+
+			for (int peak = NUM_FFT_PEAKS - 1; peak >= 0; peak--) {
+				if (_fft_notch[axis][peak].getNotchFreq() > 0.f) {
+					_fft_notch[axis][peak].applyArray(data, N);
+				}
+			}
+		}
+
+		if (_notch[axis].getNotchFreq() > 0.f) {
+			_notch[axis].applyArray(data, N);
+		}
+
+		_low_pass[axis].applyArray(data, N);
+
+		_out[axis] = data[N - 1];
+	}
+}
+
+void MicroBenchFilter::filterBank(int N)
+{
+	math::BiquadFilterBank<NUM_STAGES>::Sample data[FIFO_SIZE];
+
+	for (int n = 0; n < N; n++) {
+		data[n][0] = _scale * _raw[0][n];
+		data[n][1] = _scale * _raw[1][n];
+		data[n][2] = _scale * _raw[2][n];
+		data[n][3] = 0.f;
+	}
+
+	_bank.apply(data, N);
+
+	for (int axis = 0; axis < 3; axis++) {
+		_out[axis] = data[N - 1][axis];
+	}
+}
+
+bool MicroBenchFilter::time_filter_notch_low_pass()
+{
+	configure(false);
+
+	PERF("filter notch + low-pass scalar (1 sample)", filterScalar(1), 1000, 1);
+	PERF("filter notch + low-pass bank (1 sample)", filterBank(1), 1000, 1);
+
+	PERF("filter notch + low-pass scalar (32 sample FIFO)", filterScalar(FIFO_SIZE), 100, FIFO_SIZE);
+	PERF("filter notch + low-pass bank (32 sample FIFO)", filterBank(FIFO_SIZE), 100, FIFO_SIZE);
+
+	return true;
+}
+
+bool MicroBenchFilter::time_filter_dynamic_notch()
+{
+	// 4 ESCs with 3 harmonics each, 3 FFT peaks, notch and low-pass
+	configure(true);
+
+	PERF("filter 17 stages scalar (1 sample)", filterScalar(1), 1000, 1);
+	PERF("filter 17 stages bank (1 sample)", filterBank(1), 1000, 1);
+
+	PERF("filter 17 stages scalar (32 sample FIFO)", filterScalar(FIFO_SIZE), 100, FIFO_SIZE);
+	PERF("filter 17 stages bank (32 sample FIFO)", filterBank(FIFO_SIZE), 100, FIFO_SIZE);
+
+	return true;
+}
+
+ut_declare_test_c(test_microbench_filter, MicroBenchFilter)
+
+} // namespace MicroBenchFilter
@@ -0,0 +1,217 @@
+/****************************************************************************
+ *
+ *  Copyright (C) 2021 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file test_microbench_flight_test_input.cpp
+ * Tests for the cost of flight test input injection points in a controller loop.
+ */
+
+#include <unit_test.h>
+
+#include <time.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <math.h>
+
+#include <drivers/drv_hrt.h>
+#include <perf/perf_counter.h>
+#include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/micro_hal.h>
+
+#include <FlightTestInput.hpp>
+#include <SweepSchedule.hpp>
+
+namespace MicroBenchFlightTestInput
+{
+
+using fti::InjectionPoint;
+
+#ifdef __PX4_NUTTX
+#include <nuttx/irq.h>
+static irqstate_t flags;
+#endif
+
+void lock()
+{
+#ifdef __PX4_NUTTX
+	flags = px4_enter_critical_section();
+#endif
+}
+
+void unlock()
+{
+#ifdef __PX4_NUTTX
+	px4_leave_critical_section(flags);
+#endif
+}
+
+#define PERF(name, op, count) do { \
+		reset(); \
+		perf_counter_t p = perf_alloc(PC_ELAPSED, name); \
+		for (int rep = 0; rep < 10; rep++) { \
+			px4_usleep(1000); \
+			lock(); \
+			perf_begin(p); \
+			for (int i = 0; i < (count)/10; i++) { \
+				op; \
+			} \
+			perf_end(p); \
+			unlock(); \
+			reset(); \
+		} \
+		perf_print_counter(p); \
+		perf_free(p); \
+	} while (0)
+
+class MicroBenchFlightTestInput : public UnitTest
+{
+public:
+	virtual bool run_tests();
+
+private:
+	bool time_inject_inactive();
+	bool time_sweep();
+
+	void reset();
+
+	// the nine injection points of a fixed wing attitude controller cycle
+	void cycle_baseline();
+	void cycle_inject();
+
+	FlightTestInput *_fti{nullptr};
+
+	volatile float f32[9];
+	volatile float f32_out[9];
+	volatile float t;
+};
+
+bool MicroBenchFlightTestInput::run_tests()
+{
+	ut_run_test(time_inject_inactive);
+	ut_run_test(time_sweep);
+
+	return (_tests_failed == 0);
+}
+
+template<typename T>
+T random(T min, T max)
+{
+	const T scale = rand() / (T) RAND_MAX; /* [0, 1.0] */
+	return min + scale * (max - min);      /* [min, max] */
+}
+
+void MicroBenchFlightTestInput::reset()
+{
+	srand(time(nullptr));
+
+	for (int i = 0; i < 9; i++) {
+		f32[i] = random(-1.f, 1.f);
+		f32_out[i] = random(-1.f, 1.f);
+	}
+
+	t = random(0.f, 10.f);
+}
+
+ut_declare_test_c(test_microbench_flight_test_input, MicroBenchFlightTestInput)
+
+void MicroBenchFlightTestInput::cycle_baseline()
+{
+	float v[9];
+
+	for (int i = 0; i < 9; i++) {
+		v[i] = f32[i];
+	}
+
+	for (int i = 0; i < 9; i++) {
+		f32_out[i] = v[i];
+	}
+}
+
+void MicroBenchFlightTestInput::cycle_inject()
+{
+	float v[9];
+
+	for (int i = 0; i < 9; i++) {
+		v[i] = f32[i];
+	}
+
+	_fti->inject<InjectionPoint::ATTITUDE_ROLL, InjectionPoint::ATTITUDE_PITCH, InjectionPoint::ATTITUDE_YAW>(v[6], v[7], v[8]);
+	_fti->inject<InjectionPoint::RATE_ROLL, InjectionPoint::RATE_PITCH, InjectionPoint::RATE_YAW>(v[3], v[4], v[5]);
+	_fti->inject<InjectionPoint::ACTUATOR_ROLL, InjectionPoint::ACTUATOR_PITCH, InjectionPoint::ACTUATOR_YAW>(v[0], v[1], v[2]);
+
+	for (int i = 0; i < 9; i++) {
+		f32_out[i] = v[i];
+	}
+}
+
+bool MicroBenchFlightTestInput::time_inject_inactive()
+{
+	_fti = new FlightTestInput();
+
+	if (_fti == nullptr) {
+		return false;
+	}
+
+	// update() is never called, so no test is armed and every injection point takes the inactive path.
+	// This also keeps the benchmark from touching the FTI parameters, which only update() writes.
+	PERF("9 points no injection (1k cycles)", cycle_baseline(), 1000);
+	PERF("9 points inject inactive (1k cycles)", cycle_inject(), 1000);
+
+	delete _fti;
+	_fti = nullptr;
+
+	return true;
+}
+
+bool MicroBenchFlightTestInput::time_sweep()
+{
+	SweepSchedule *schedule = new SweepSchedule();
+
+	if (schedule == nullptr) {
+		return false;
+	}
+
+	schedule->build(10.f, 0.1f, 3.f, 3.f, 0.1f, 0.2f);
+	SweepSchedule::Sample sample{};
+
+	// per sample cost of the direct evaluation the schedule replaces
+	PERF("sweep powf/sinf (1k ops)", f32_out[0] = 0.1f * sinf(2.f * M_PI_F * ((3.f - 0.1f) * powf(t / 10.f, 3.f) + 0.1f) * t), 1000);
+	PERF("sweep schedule (1k ops)", schedule->sample(t, sample); f32_out[0] = sample.output, 1000);
+
+	delete schedule;
+
+	return true;
+}
+
+} // namespace MicroBenchFlightTestInput
@@ -99,15 +99,22 @@ private:
 	bool time_matrix_quaternion();
 	bool time_matrix_dcm();
 	bool time_matrix_pseduo_inverse();
+	bool time_matrix_covariance_update();
 
 	void reset();
 
+	void fuseDense(unsigned state_index, float innov_var);
+	void fusePacked(unsigned state_index, float innov_var);
+
 	matrix::Quatf q;
 	matrix::Eulerf e;
 	matrix::Dcmf d;
 	matrix::Matrix<float, 16, 6> A16;
 	matrix::Matrix<float, 6, 16> B16;
 	matrix::Matrix<float, 6, 16> B16_4;
+
+	matrix::SquareMatrix<float, 24> P24;
+	matrix::SymmetricMatrix<float, 24> P24_packed;
 };
 
 bool MicroBenchMatrix::run_tests()
@@ -116,6 +123,7 @@ bool MicroBenchMatrix::run_tests()
 	ut_run_test(time_matrix_quaternion);
 	ut_run_test(time_matrix_dcm);
 	ut_run_test(time_matrix_pseduo_inverse);
+	ut_run_test(time_matrix_covariance_update);
 
 	return (_tests_failed == 0);
 }
@@ -145,6 +153,47 @@ void MicroBenchMatrix::reset()
 			B16_4(j, i) = random(-10.0, 10.0);
 		}
 	}
+
+	for (size_t j = 0; j < 24; j++) {
+		for (size_t i = j; i < 24; i++) {
+			P24(j, i) = P24(i, j) = (i == j) ? random(1.0, 2.0) : random(-0.1, 0.1);
+		}
+	}
+
+	P24_packed = matrix::SymmetricMatrix<float, 24>(P24);
+}
+
+// covariance update of a single state measurement on the full matrix, P -= K * H * P
+void MicroBenchMatrix::fuseDense(unsigned state_index, float innov_var)
+{
+	matrix::Vector<float, 24> K;
+
+	for (size_t row = 0; row < 24; row++) {
+		K(row) = P24(row, state_index) / innov_var;
+	}
+
+	matrix::SquareMatrix<float, 24> KHP;
+
+	for (size_t row = 0; row < 24; row++) {
+		for (size_t column = 0; column < 24; column++) {
+			KHP(row, column) = K(row) * P24(state_index, column);
+		}
+	}
+
+	P24 -= KHP;
+	P24.makeRowColSymmetric<13>(0);
+}
+
+// same update on the packed upper triangle
+void MicroBenchMatrix::fusePacked(unsigned state_index, float innov_var)
+{
+	const matrix::Vector<float, 24> HP = P24_packed.row(state_index);
+	const matrix::Vector<float, 24> K = HP / innov_var;
+
+	matrix::SymmetricMatrix<float, 24> KHP;
+	KHP.setSymmetricOuterProduct(K, HP);
+
+	P24_packed -= KHP;
 }
 
 bool MicroBenchMatrix::time_matrix_euler()
@@ -175,6 +224,14 @@ bool MicroBenchMatrix::time_matrix_pseduo_inverse()
 	return true;
 }
 
+bool MicroBenchMatrix::time_matrix_covariance_update()
+{
+	// EKF GPS fusion step: sequential fusion of 3 velocity and 3 position measurements into a 24 state covariance
+	PERF("matrix 24x24 dense covariance update (6 measurements)", for (unsigned s = 4; s < 10; s++) { fuseDense(s, 2.f); }, 100);
+	PERF("matrix 24x24 packed covariance update (6 measurements)", for (unsigned s = 4; s < 10; s++) { fusePacked(s, 2.f); }, 100);
+	return true;
+}
+
 ut_declare_test_c(test_microbench_matrix, MicroBenchMatrix)
 
 } // namespace MicroBenchMatrix
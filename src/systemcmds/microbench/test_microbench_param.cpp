@@ -0,0 +1,288 @@
+/****************************************************************************
+ *
+ *  Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file test_microbench_param.cpp
+ * Tests for the cost of parameter lookups and reads (param_find, param_get, ModuleParams::updateParams
+ * and a full MAVLink parameter list download).
+ */
+
+#include <unit_test.h>
+
+#include <time.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <drivers/drv_hrt.h>
+#include <perf/perf_counter.h>
+#include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/micro_hal.h>
+#include <px4_platform_common/module_params.h>
+#include <parameters/param.h>
+
+namespace MicroBenchParam
+{
+
+#ifdef __PX4_NUTTX
+#include <nuttx/irq.h>
+static irqstate_t flags;
+#endif
+
+void lock()
+{
+#ifdef __PX4_NUTTX
+	flags = px4_enter_critical_section();
+#endif
+}
+
+void unlock()
+{
+#ifdef __PX4_NUTTX
+	px4_leave_critical_section(flags);
+#endif
+}
+
+#define PERF(name, op, count) do { \
+		px4_usleep(1000); \
+		reset(); \
+		perf_counter_t p = perf_alloc(PC_ELAPSED, name); \
+		for (int i = 0; i < count; i++) { \
+			px4_usleep(1); \
+			lock(); \
+			perf_begin(p); \
+			op; \
+			perf_end(p); \
+			unlock(); \
+			reset(); \
+		} \
+		perf_print_counter(p); \
+		perf_free(p); \
+	} while (0)
+
+// a typical module parameter block
+class SystemParams : public ModuleParams
+{
+public:
+	SystemParams() : ModuleParams(nullptr) {}
+
+	void update() { updateParams(); }
+
+private:
+	DEFINE_PARAMETERS(
+		(ParamInt<px4::params::SYS_AUTOSTART>) _param_sys_autostart,
+		(ParamInt<px4::params::SYS_AUTOCONFIG>) _param_sys_autoconfig,
+		(ParamInt<px4::params::SYS_HITL>) _param_sys_hitl,
+		(ParamInt<px4::params::SYS_MC_EST_GROUP>) _param_sys_mc_est_group,
+		(ParamInt<px4::params::SYS_CAL_GYRO>) _param_sys_cal_gyro,
+		(ParamInt<px4::params::SYS_CAL_ACCEL>) _param_sys_cal_accel,
+		(ParamInt<px4::params::SYS_CAL_BARO>) _param_sys_cal_baro,
+		(ParamInt<px4::params::SYS_CAL_TDEL>) _param_sys_cal_tdel,
+		(ParamInt<px4::params::SYS_CAL_TMIN>) _param_sys_cal_tmin,
+		(ParamInt<px4::params::SYS_CAL_TMAX>) _param_sys_cal_tmax,
+		(ParamInt<px4::params::SYS_HAS_GPS>) _param_sys_has_gps,
+		(ParamInt<px4::params::SYS_HAS_MAG>) _param_sys_has_mag,
+		(ParamInt<px4::params::SYS_HAS_BARO>) _param_sys_has_baro,
+		(ParamInt<px4::params::SYS_FAC_CAL_MODE>) _param_sys_fac_cal_mode,
+		(ParamInt<px4::params::SYS_BL_UPDATE>) _param_sys_bl_update,
+		(ParamInt<px4::params::SYS_FAILURE_EN>) _param_sys_failure_en
+	)
+};
+
+class MicroBenchParam : public UnitTest
+{
+public:
+	virtual bool run_tests();
+
+private:
+	bool time_param_find();
+	bool time_param_get();
+	bool time_update_params();
+	bool time_param_list();
+
+	void reset();
+
+	void get(param_t param);
+
+	// equivalent of ModuleParams::updateParams() of every running module
+	void get_all_used();
+
+	// name lookup of every parameter (eg. all ModuleParams constructors)
+	void find_all();
+
+	// what MavlinkParametersManager does for a PARAM_REQUEST_LIST, for every used parameter
+	// its value, the used count and its used index
+	void list_all();
+
+	// PARAM_REQUEST_READ of every used parameter by index
+	void read_all_by_index();
+
+	param_t _default_param{PARAM_INVALID};
+	param_t _changed_param{PARAM_INVALID};
+
+	// plain 4 byte values as used by ModuleParams, so param_get() must not write more
+	int32_t _val_i{0};
+	float _val_f{0.f};
+};
+
+bool MicroBenchParam::run_tests()
+{
+	ut_run_test(time_param_find);
+	ut_run_test(time_param_get);
+	ut_run_test(time_update_params);
+	ut_run_test(time_param_list);
+
+	return (_tests_failed == 0);
+}
+
+void MicroBenchParam::reset()
+{
+	srand(time(nullptr));
+
+	// initialize with random data
+	_val_i = rand();
+}
+
+ut_declare_test_c(test_microbench_param, MicroBenchParam)
+
+void MicroBenchParam::get(param_t param)
+{
+	if (param_type(param) == PARAM_TYPE_FLOAT) {
+		param_get(param, &_val_f);
+
+	} else {
+		param_get(param, &_val_i);
+	}
+}
+
+void MicroBenchParam::get_all_used()
+{
+	for (unsigned i = 0; i < param_count_used(); i++) {
+		get(param_for_used_index(i));
+	}
+}
+
+void MicroBenchParam::find_all()
+{
+	for (unsigned i = 0; i < param_count(); i++) {
+		_val_i = param_find_no_notification(param_name(param_for_index(i)));
+	}
+}
+
+void MicroBenchParam::list_all()
+{
+	for (unsigned i = 0; i < param_count(); i++) {
+		const param_t param = param_for_index(i);
+
+		if (param_used(param)) {
+			get(param);
+			_val_i += param_count_used() + param_get_used_index(param);
+		}
+	}
+}
+
+void MicroBenchParam::read_all_by_index()
+{
+	for (unsigned i = 0; i < param_count_used(); i++) {
+		get(param_for_used_index(i));
+	}
+}
+
+bool MicroBenchParam::time_param_find()
+{
+	PERF("param_find SYS_AUTOSTART", _val_i = param_find_no_notification("SYS_AUTOSTART"), 1000);
+	PERF("param_find invalid", _val_i = param_find_no_notification("SYS_AUTOSTART_"), 1000);
+
+	printf("%u parameters\n", param_count());
+	PERF("param_find all parameters", find_all(), 10);
+
+	return true;
+}
+
+bool MicroBenchParam::time_param_get()
+{
+	// pick a used parameter at its default and one with a stored value
+	for (unsigned i = 0; i < param_count_used(); i++) {
+		const param_t param = param_for_used_index(i);
+
+		if (param_value_is_default(param)) {
+			if (_default_param == PARAM_INVALID) {
+				_default_param = param;
+			}
+
+		} else if (_changed_param == PARAM_INVALID) {
+			_changed_param = param;
+		}
+	}
+
+	if (_default_param != PARAM_INVALID) {
+		printf("default: %s\n", param_name(_default_param));
+		PERF("param_get default", get(_default_param), 1000);
+	}
+
+	if (_changed_param != PARAM_INVALID) {
+		printf("changed: %s\n", param_name(_changed_param));
+		PERF("param_get changed", get(_changed_param), 1000);
+	}
+
+	return true;
+}
+
+bool MicroBenchParam::time_update_params()
+{
+	SystemParams *system_params = new SystemParams();
+
+	if (system_params == nullptr) {
+		return false;
+	}
+
+	PERF("updateParams() 16 params", system_params->update(), 1000);
+
+	delete system_params;
+
+	printf("%u used parameters\n", param_count_used());
+	PERF("param_get all used parameters", get_all_used(), 100);
+
+	return true;
+}
+
+bool MicroBenchParam::time_param_list()
+{
+	printf("%u used parameters\n", param_count_used());
+	PERF("PARAM_REQUEST_LIST all used parameters", list_all(), 10);
+	PERF("PARAM_REQUEST_READ all used parameters by index", read_all_by_index(), 10);
+
+	return true;
+}
+
+} // namespace MicroBenchParam
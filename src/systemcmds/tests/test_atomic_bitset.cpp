@@ -44,6 +44,7 @@ private:
 	bool constructTest();
 	bool setAllTest();
 	bool setRandomTest();
+	bool testAndSetTest();
 
 };
 
@@ -52,6 +53,7 @@ bool AtomicBitsetTest::run_tests()
 	ut_run_test(constructTest);
 	ut_run_test(setAllTest);
 	ut_run_test(setRandomTest);
+	ut_run_test(testAndSetTest);
 
 	return (_tests_failed == 0);
 }
@@ -173,3 +175,23 @@ bool AtomicBitsetTest::setRandomTest()
 
 	return true;
 }
+
+bool AtomicBitsetTest::testAndSetTest()
+{
+	px4::AtomicBitset<70> test_bitset4;
+
+	ut_compare("bitset elements", test_bitset4.ARRAY_SIZE, 3);
+
+	ut_compare("test_and_set previously false", test_bitset4.test_and_set(33), false);
+	ut_compare("test_and_set previously true", test_bitset4.test_and_set(33), true);
+	ut_compare("test_and_set previously false", test_bitset4.test_and_set(69), false);
+	ut_compare("test_and_set previously false", test_bitset4.test_and_set(31), false);
+
+	ut_compare("bitset count", test_bitset4.count(), 3);
+
+	ut_compare("element 0", test_bitset4.element(0), 0x80000000u);
+	ut_compare("element 1", test_bitset4.element(1), 0x00000002u);
+	ut_compare("element 2", test_bitset4.element(2), 0x00000020u);
+
+	return true;
+}
@@ -68,5 +68,37 @@ test_perf(int argc, char *argv[])
 	perf_free(cc);
 	perf_free(ec);
 
+	perf_counter_t hc = perf_alloc(PC_HISTOGRAM, "test_histogram");
+
+	if (hc == NULL) {
+		printf("perf: histogram counter alloc failed\n");
+		return 1;
+	}
+
+	// 990 events at 100us, 9 at 1000us and a single one at 20000us
+	for (int i = 0; i < 1000; i++) {
+		perf_set_elapsed(hc, (i < 990) ? 100 : ((i < 999) ? 1000 : 20000));
+	}
+
+	struct perf_histogram_summary summary;
+
+	if ((perf_histogram(hc, &summary) != 0) || (summary.event_count != 1000)) {
+		printf("perf: histogram summary failed\n");
+		perf_free(hc);
+		return 1;
+	}
+
+	// percentiles are reported as upper bucket bounds, at most 25% above the value
+	if ((summary.p50 < 100) || (summary.p50 > 125) || (summary.p99 < 100) || (summary.p99 > 125)
+	    || (summary.p999 < 1000) || (summary.p999 > 1250) || (summary.max != 20000)) {
+		printf("perf: unexpected histogram percentiles\n");
+		perf_print_counter(hc);
+		perf_free(hc);
+		return 1;
+	}
+
+	perf_print_counter(hc);
+	perf_free(hc);
+
 	return OK;
 }
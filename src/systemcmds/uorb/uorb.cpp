@@ -59,6 +59,14 @@ int uorb_main(int argc, char *argv[])
 		return uorb_top(argv + 2, argc - 2);
 	}
 
+#ifdef ORB_TELEMETRY
+
+	if (!strcmp(argv[1], "stats")) {
+		return uorb_stats(argv + 2, argc - 2);
+	}
+
+#endif /* ORB_TELEMETRY */
+
 	usage();
 	return 0;
 }
@@ -84,6 +92,10 @@ modules are allowed to publish which topics. This is used for system-wide replay
 ### Examples
 Monitor topic publication rates. Besides `top`, this is an important command for general system inspection:
 $ uorb top
+
+If compiled with ORB_TELEMETRY, `uorb stats` shows the bytes published and copied per topic, copies of queued topics
+that lost messages because the subscriber lagged behind by more than the queue length, and the time spent in the
+callbacks of each publication. The same data is published periodically as `uorb_stats` (by load_mon).
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("uorb", "communication");
@@ -92,4 +104,8 @@ $ uorb top
 	PRINT_MODULE_USAGE_PARAM_FLAG('a', "print all instead of only currently publishing topics with subscribers", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('1', "run only once, then exit", true);
 	PRINT_MODULE_USAGE_ARG("<filter1> [<filter2>]", "topic(s) to match (implies -a)", true);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("stats", "Print topic publication/copy telemetry (ORB_TELEMETRY builds only)");
+	PRINT_MODULE_USAGE_PARAM_FLAG('a', "print all instead of only topics with traffic", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('r', "reset the counters after printing", true);
+	PRINT_MODULE_USAGE_ARG("<filter1> [<filter2>]", "topic(s) to match", true);
 }
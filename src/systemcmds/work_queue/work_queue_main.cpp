@@ -36,8 +36,58 @@
 #include <px4_platform_common/getopt.h>
 #include <px4_platform_common/px4_work_queue/WorkQueueManager.hpp>
 
+#include <stdlib.h>
+#include <string.h>
+
 static void	usage();
 
+#if defined(__PX4_LINUX)
+// parse a CPU list like "2,3" or "0-1,4" into a bitmask, returns false on error
+static bool
+parse_cpu_list(const char *list, uint32_t &cpu_mask)
+{
+	cpu_mask = 0;
+
+	while (*list != '\0') {
+		char *end = nullptr;
+		const long first = strtol(list, &end, 10);
+		long last = first;
+
+		if (end == list) {
+			return false;
+		}
+
+		if (*end == '-') {
+			list = end + 1;
+			last = strtol(list, &end, 10);
+
+			if (end == list) {
+				return false;
+			}
+		}
+
+		if ((first < 0) || (last < first) || (last > 31)) {
+			return false;
+		}
+
+		for (long cpu = first; cpu <= last; cpu++) {
+			cpu_mask |= 1u << cpu;
+		}
+
+		if (*end == ',') {
+			end++;
+
+		} else if (*end != '\0') {
+			return false;
+		}
+
+		list = end;
+	}
+
+	return true;
+}
+#endif // __PX4_LINUX
+
 extern "C" {
 	__EXPORT int work_queue_main(int argc, char *argv[]);
 }
@@ -45,6 +95,53 @@ extern "C" {
 int
 work_queue_main(int argc, char *argv[])
 {
+	if (argc < 2) {
+		usage();
+		return 1;
+	}
+
+#if defined(PX4_WORK_QUEUE_POOL)
+
+	if (!strcmp(argv[1], "pool") && (argc >= 3)) {
+		return (px4::WorkerPoolStart(atoi(argv[2]), argv + 3, argc - 3) == PX4_OK) ? 0 : 1;
+	}
+
+#endif // PX4_WORK_QUEUE_POOL
+
+#if defined(__PX4_LINUX)
+
+	if (!strcmp(argv[1], "affinity") && (argc >= 3)) {
+		uint32_t cpu_mask = 0;
+
+		if ((argc == 4) && !parse_cpu_list(argv[3], cpu_mask)) {
+			PX4_ERR("invalid CPU list %s", argv[3]);
+			return 1;
+		}
+
+		return (px4::WorkQueueSetAffinity(argv[2], cpu_mask) == PX4_OK) ? 0 : 1;
+
+	} else if (!strcmp(argv[1], "isolate")) {
+		uint32_t cpu_mask = 0;
+
+		if ((argc == 3) && !parse_cpu_list(argv[2], cpu_mask)) {
+			PX4_ERR("invalid CPU list %s", argv[2]);
+			return 1;
+		}
+
+		return (px4::WorkQueueIsolateCpus(cpu_mask) == PX4_OK) ? 0 : 1;
+	}
+
+#endif // __PX4_LINUX
+
+	if (!strcmp(argv[1], "latency") && (argc == 3)) {
+		if (!strcmp(argv[2], "on") || !strcmp(argv[2], "off")) {
+			return (px4::WorkQueueLatencyHistogram(!strcmp(argv[2], "on")) == PX4_OK) ? 0 : 1;
+		}
+
+		usage();
+		return 1;
+	}
+
 	if (argc != 2) {
 		usage();
 		return 1;
@@ -78,9 +175,40 @@ usage()
 
 Command-line tool to show work queue status.
 
+On POSIX (without lockstep) the non real-time work queues can share a pool of worker threads instead of running
+one thread each. The pool needs to be started before any of its queues are created, so early in the startup script.
+Work is never run concurrently with itself, but work items of the same queue can run in parallel.
+
+On Linux targets (not SITL) the work queue threads use SCHED_FIFO if permitted. On Linux they can be pinned to CPUs.
+In isolated mode, the CPUs given to `isolate` are reserved for the queues with an explicit affinity, all other
+queues are kept off them.
+
+With `latency on` the `status` output includes a histogram of the wakeup latency of each queue, the time from
+scheduling work on an idle queue until its thread runs. It's off by default as it timestamps every enqueue.
+
+### Examples
+Share hp_default and lp_default between 4 threads:
+$ work_queue pool 4 wq:hp_default wq:lp_default
+
+Run the rate controller alone on CPU 3 (eg with the isolcpus=3 kernel option):
+$ work_queue affinity wq:rate_ctrl 3
+$ work_queue isolate 3
+
+Check the wakeup latency:
+$ work_queue latency on
+$ work_queue status
+
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("work_queue", "system");
 	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("pool", "Start the shared worker pool (POSIX only)");
+	PRINT_MODULE_USAGE_ARG("<num_workers> [<queue> ...]", "Number of worker threads and queues to share (default hp_default and lp_default)", false);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("affinity", "Pin a work queue to CPUs (Linux only)");
+	PRINT_MODULE_USAGE_ARG("<queue> [<cpus>]", "Work queue name and CPU list (eg 2,3 or 2-3), none to reset", false);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("isolate", "Keep queues without affinity off the given CPUs (Linux only)");
+	PRINT_MODULE_USAGE_ARG("[<cpus>]", "CPU list, none to disable", true);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("latency", "Record the wakeup latency histogram");
+	PRINT_MODULE_USAGE_ARG("on|off", "Enable or disable", false);
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 }